@@ -45,6 +45,8 @@ cd "%BUILD_DIR%"
 cd common\benchmark\Release
 common-benchmark.exe
 IF ERRORLEVEL 1 GOTO ERROR
+common-tokenizer-benchmark.exe
+IF ERRORLEVEL 1 GOTO ERROR
 cd "%BUILD_DIR%"
 
 cpack
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureUploadQueue.h"
+#include "IO/Path.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static constexpr size_t NumQueuedTextures = 10000u;
+        static constexpr size_t QueuedTextureSize = 32u;
+        static constexpr size_t UploadBudget = 1024u * 1024u;
+
+        /**
+         * Counts the uploads instead of performing them.
+         */
+        class CountingUploadSink : public TextureUploadSink {
+        public:
+            size_t uploadCount = 0u;
+        private:
+            void upload(Texture&, GLuint) override {
+                ++uploadCount;
+            }
+        };
+
+        TEST_CASE("TextureUploadQueueBenchmark.drainQueue", "[TextureUploadQueueBenchmark]") {
+            auto textures = std::vector<Texture*>();
+            textures.reserve(NumQueuedTextures);
+            for (size_t i = 0u; i < NumQueuedTextures; ++i) {
+                auto* texture = new Texture("texture_" + std::to_string(i), QueuedTextureSize, QueuedTextureSize, Color(), TextureBuffer(QueuedTextureSize * QueuedTextureSize * 4u), GL_RGBA, TextureType::Opaque);
+                // a few textures are used a lot, most are not used at all
+                for (size_t j = 0u; j < (i % 97u == 0u ? i % 13u : 0u); ++j) {
+                    texture->incUsageCount();
+                }
+                textures.push_back(texture);
+            }
+
+            auto collection = TextureCollection(IO::Path("textures"), textures);
+            auto queue = TextureUploadQueue();
+            for (size_t i = 0u; i < collection.textureCount(); ++i) {
+                queue.enqueue(collection.textureByIndex(i), static_cast<GLuint>(i + 1u));
+            }
+
+            const auto totalBytes = queue.pendingBytes();
+
+            auto sink = CountingUploadSink();
+            size_t frameCount = 0u;
+            timeLambda([&]() {
+                while (!queue.empty()) {
+                    queue.upload(sink, UploadBudget);
+                    ++frameCount;
+                }
+            }, "schedule " + std::to_string(NumQueuedTextures) + " texture uploads");
+
+            std::printf("Uploaded %zu bytes in %zu frames\n", totalBytes, frameCount);
+            ASSERT_EQ(NumQueuedTextures, sink.uploadCount);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "Assets/EntityModel.h"
+#include "Assets/Palette.h"
+#include "IO/Bsp29Parser.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Md3Parser.h"
+#include "IO/MdlParser.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderFileSystem.h"
+#include "IO/Reader.h"
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumModelLoads = 100u;
+
+        using ParseModel = std::function<std::unique_ptr<Assets::EntityModel>(const char* begin, const char* end, Logger& logger)>;
+
+        /**
+         * Loads every frame of the given model file, which is what happens when the frames of an animated model are
+         * displayed one after the other.
+         */
+        template <typename Parser>
+        static std::unique_ptr<Assets::EntityModel> loadAllFrames(Parser& parser, Logger& logger) {
+            auto model = parser.initializeModel(logger);
+            for (size_t i = 0u; i < model->frameCount(); ++i) {
+                parser.loadFrame(i, *model, logger);
+            }
+            return model;
+        }
+
+        static void benchmarkModel(const FileSystem& fs, const Path& path, const ParseModel& parse) {
+            NullLogger logger;
+
+            const auto file = fs.openFile(path);
+            ASSERT_NE(nullptr, file);
+            const auto reader = file->reader().buffer();
+
+            std::unique_ptr<Assets::EntityModel> model;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumModelLoads; ++i) {
+                    model = parse(std::begin(reader), std::end(reader), logger);
+                }
+            }, "load " + path.lastComponent().asString() + " " + std::to_string(NumModelLoads) + " times");
+
+            const auto& arena = model->vertexArena();
+            std::printf("%s: %zu frames, %zu surfaces, %zu vertices in %zu blocks, %zu bytes\n",
+                path.lastComponent().asString().c_str(),
+                model->frameCount(),
+                model->surfaceCount(),
+                arena.vertexCount(),
+                arena.blockCount(),
+                arena.sizeInBytes());
+        }
+
+        TEST_CASE("EntityModelParserBenchmark.loadModels", "[EntityModelParserBenchmark]") {
+            const auto fixtureDir = Disk::getCurrentWorkingDir() + Path("fixture/test");
+            const auto fs = DiskFileSystem(fixtureDir);
+            const auto palette = Assets::Palette::loadFile(fs, Path("palette.lmp"));
+
+            benchmarkModel(fs, Path("IO/Mdl/armor.mdl"), [&](const char* begin, const char* end, Logger& logger) {
+                auto parser = MdlParser("armor", begin, end, palette);
+                return loadAllFrames(parser, logger);
+            });
+
+            benchmarkModel(fs, Path("Model/Game/Quake/id1/cube.bsp"), [&](const char* begin, const char* end, Logger& logger) {
+                auto parser = Bsp29Parser("cube", begin, end, palette, fs);
+                return loadAllFrames(parser, logger);
+            });
+
+            NullLogger logger;
+            std::shared_ptr<FileSystem> md3Fs = std::make_shared<DiskFileSystem>(fixtureDir + Path("IO/Md3/bfg"));
+            md3Fs = std::make_shared<Quake3ShaderFileSystem>(md3Fs, Path("scripts"), std::vector<Path>{ Path("models") }, logger);
+            benchmarkModel(*md3Fs, Path("models/weapons2/bfg/bfg.md3"), [&](const char* begin, const char* end, Logger& parserLogger) {
+                auto parser = Md3Parser("bfg", begin, end, *md3Fs);
+                return loadAllFrames(parser, parserLogger);
+            });
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/IO/TestEnvironment.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+
+#include <kdl/vector_utils.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumIncludedFgdFiles = 16u;
+        static constexpr size_t NumClassesPerFgdFile = 200u;
+        static constexpr size_t NumFgdLoads = 10u;
+
+        /**
+         * Generates a host file which defines the base classes and includes a number of files with point and solid
+         * classes, which is how large FGD files such as those for Half-Life mods are usually organized.
+         */
+        class GeneratedFgdEnvironment : public TestEnvironment {
+        public:
+            GeneratedFgdEnvironment() :
+            TestEnvironment("FgdParserBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                std::string host =
+                    "@BaseClass = Targetname [ targetname(target_source) : \"Name\" ]\n"
+                    "@BaseClass = Target [ target(target_destination) : \"Target\" killtarget(target_destination) : \"Kill target\" ]\n"
+                    "@BaseClass = Appearflags [\n"
+                    "    spawnflags(Flags) =\n"
+                    "    [\n"
+                    "        256 : \"Not on Easy\" : 0\n"
+                    "        512 : \"Not on Normal\" : 0\n"
+                    "        1024 : \"Not on Hard\" : 0\n"
+                    "        2048 : \"Not in Deathmatch\" : 0\n"
+                    "    ]\n"
+                    "]\n"
+                    "@BaseClass base(Targetname, Target, Appearflags) = Common [\n"
+                    "    rendermode(choices) : \"Render mode\" : 0 = [ 0 : \"Normal\" 1 : \"Color\" 2 : \"Texture\" ]\n"
+                    "    renderamt(integer) : \"FX amount (1 - 255)\"\n"
+                    "    rendercolor(color255) : \"FX color (R G B)\" : \"0 0 0\"\n"
+                    "]\n";
+
+                for (size_t i = 0u; i < NumIncludedFgdFiles; ++i) {
+                    const auto fileName = "entities_" + std::to_string(i) + ".fgd";
+                    host += "@include \"" + fileName + "\"\n";
+
+                    std::string str;
+                    for (size_t j = 0u; j < NumClassesPerFgdFile; ++j) {
+                        const auto name = std::to_string(i) + "_" + std::to_string(j);
+                        if (j % 2u == 0u) {
+                            str += "@PointClass base(Common) size(-16 -16 -16, 16 16 16) color(255 128 0) = point_" + name + " : \"Point entity " + name + "\"\n"
+                                   "[\n"
+                                   "    speed(integer) : \"Speed\" : 100\n"
+                                   "    wait(string) : \"Wait\" : \"1.5\"\n"
+                                   "    message(string) : \"Message\"\n"
+                                   "]\n";
+                        } else {
+                            str += "@SolidClass base(Common) = solid_" + name + " : \"Solid entity " + name + "\"\n"
+                                   "[\n"
+                                   "    lip(integer) : \"Lip\" : 8\n"
+                                   "    dmg(integer) : \"Damage\" : 2\n"
+                                   "]\n";
+                        }
+                    }
+                    createFile(Path(fileName), str);
+                }
+                createFile(Path("host.fgd"), host);
+            }
+        };
+
+        static std::vector<Assets::EntityDefinition*> loadGeneratedFgd(EntityDefinitionCache& cache, const Path& path, ParserStatus& status) {
+            const auto defaultColor = Color(1.0f, 1.0f, 1.0f, 1.0f);
+            return cache.loadDefinitions(status, path, defaultColor, [&](ParserStatus& parserStatus, const char* begin, const char* end, std::vector<Path>& includedFiles) {
+                FgdParser parser(begin, end, defaultColor, path);
+                auto definitions = parser.parseDefinitions(parserStatus);
+                includedFiles = parser.includedFiles();
+                return definitions;
+            });
+        }
+
+        TEST_CASE("FgdParserBenchmark.parseIncludes", "[FgdParserBenchmark]") {
+            GeneratedFgdEnvironment env;
+            const auto path = env.dir() + Path("host.fgd");
+            const auto file = Disk::openFile(path);
+            const auto reader = file->reader().buffer();
+
+            std::vector<Assets::EntityDefinition*> definitions;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumFgdLoads; ++i) {
+                    kdl::vec_clear_and_delete(definitions);
+
+                    TestParserStatus status;
+                    FgdParser parser(std::begin(reader), std::end(reader), Color(1.0f, 1.0f, 1.0f, 1.0f), path);
+                    definitions = parser.parseDefinitions(status);
+                }
+            }, "parse " + std::to_string(NumIncludedFgdFiles * NumClassesPerFgdFile) + " classes from " + std::to_string(NumIncludedFgdFiles) + " included files " + std::to_string(NumFgdLoads) + " times");
+
+            ASSERT_EQ(NumIncludedFgdFiles * NumClassesPerFgdFile, definitions.size());
+            kdl::vec_clear_and_delete(definitions);
+        }
+
+        TEST_CASE("FgdParserBenchmark.loadCachedDefinitions", "[FgdParserBenchmark]") {
+            GeneratedFgdEnvironment env;
+            const auto path = env.dir() + Path("host.fgd");
+
+            EntityDefinitionCache cache;
+            TestParserStatus status;
+
+            std::vector<Assets::EntityDefinition*> definitions;
+            timeLambda([&]() {
+                definitions = loadGeneratedFgd(cache, path, status);
+            }, "load " + std::to_string(NumIncludedFgdFiles * NumClassesPerFgdFile) + " classes into an empty cache");
+            ASSERT_EQ(NumIncludedFgdFiles * NumClassesPerFgdFile, definitions.size());
+
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumFgdLoads; ++i) {
+                    kdl::vec_clear_and_delete(definitions);
+                    definitions = loadGeneratedFgd(cache, path, status);
+                }
+            }, "load " + std::to_string(NumIncludedFgdFiles * NumClassesPerFgdFile) + " cached classes " + std::to_string(NumFgdLoads) + " times");
+            ASSERT_EQ(NumIncludedFgdFiles * NumClassesPerFgdFile, definitions.size());
+
+            std::printf("Definitions: %zu, warnings: %zu, errors: %zu\n", definitions.size(), status.countStatus(LogLevel::Warn), status.countStatus(LogLevel::Error));
+            kdl::vec_clear_and_delete(definitions);
+        }
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/IO/TestEnvironment.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/WadFileSystem.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumWadTextures = 2000u;
+        static constexpr size_t WadTextureSize = 256u;
+        static constexpr size_t WadMipLevels = 4u;
+
+        static void appendInt32(std::string& str, const size_t value) {
+            const auto i = static_cast<uint32_t>(value);
+            str.push_back(static_cast<char>(i & 0xFFu));
+            str.push_back(static_cast<char>((i >> 8u) & 0xFFu));
+            str.push_back(static_cast<char>((i >> 16u) & 0xFFu));
+            str.push_back(static_cast<char>((i >> 24u) & 0xFFu));
+        }
+
+        static void appendName(std::string& str, const std::string& name) {
+            auto padded = name;
+            padded.resize(16u, '\0');
+            str += padded;
+        }
+
+        static std::string wadTextureName(const size_t index) {
+            // every tenth texture is masked
+            return (index % 10u == 0u ? "{tex_" : "tex_") + std::to_string(index);
+        }
+
+        /**
+         * Generates a WAD2 file containing mip textures filled with pseudo random indices.
+         */
+        class GeneratedWadEnvironment : public TestEnvironment {
+        public:
+            GeneratedWadEnvironment() :
+            TestEnvironment("IdMipTextureReaderBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                static constexpr size_t HeaderSize = 12u;
+                static constexpr size_t MipHeaderSize = 40u;
+
+                std::string textures;
+                std::vector<size_t> addresses;
+                std::vector<size_t> sizes;
+
+                uint32_t random = 1u;
+                for (size_t i = 0u; i < NumWadTextures; ++i) {
+                    const auto address = HeaderSize + textures.size();
+
+                    appendName(textures, wadTextureName(i));
+                    appendInt32(textures, WadTextureSize);
+                    appendInt32(textures, WadTextureSize);
+
+                    auto mipOffset = MipHeaderSize;
+                    for (size_t j = 0u; j < WadMipLevels; ++j) {
+                        appendInt32(textures, mipOffset);
+                        mipOffset += (WadTextureSize >> j) * (WadTextureSize >> j);
+                    }
+
+                    for (size_t j = 0u; j < WadMipLevels; ++j) {
+                        for (size_t k = 0u; k < (WadTextureSize >> j) * (WadTextureSize >> j); ++k) {
+                            random = random * 1664525u + 1013904223u;
+                            textures.push_back(static_cast<char>(random >> 24u));
+                        }
+                    }
+
+                    addresses.push_back(address);
+                    sizes.push_back(HeaderSize + textures.size() - address);
+                }
+
+                std::string wad = "WAD2";
+                appendInt32(wad, NumWadTextures);
+                appendInt32(wad, HeaderSize + textures.size());
+                wad += textures;
+
+                for (size_t i = 0u; i < NumWadTextures; ++i) {
+                    appendInt32(wad, addresses[i]);
+                    appendInt32(wad, sizes[i]);
+                    appendInt32(wad, sizes[i]);
+                    wad += "D";
+                    wad += std::string(3u, '\0');
+                    appendName(wad, wadTextureName(i));
+                }
+
+                std::ofstream stream((dir() + Path("generated.wad")).asString(), std::ios::out | std::ios::binary);
+                stream.write(wad.data(), static_cast<std::streamsize>(wad.size()));
+            }
+        };
+
+        static Assets::Palette createWadPalette() {
+            auto data = std::vector<unsigned char>(768u);
+            for (size_t i = 0u; i < data.size(); ++i) {
+                data[i] = static_cast<unsigned char>(i * 7u);
+            }
+            return Assets::Palette(std::move(data));
+        }
+
+        TEST_CASE("IdMipTextureReaderBenchmark.convertIndexedToRgba", "[IdMipTextureReaderBenchmark]") {
+            const auto palette = createWadPalette();
+
+            auto indices = std::vector<unsigned char>(WadTextureSize * WadTextureSize);
+            uint32_t random = 1u;
+            for (auto& index : indices) {
+                random = random * 1664525u + 1013904223u;
+                index = static_cast<unsigned char>(random >> 24u);
+            }
+
+            auto rgba = std::vector<unsigned char>(indices.size() * 4u);
+            Color averageColor;
+            size_t transparentCount = 0u;
+
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumWadTextures; ++i) {
+                    if (palette.indexedToRgba(indices, indices.size(), rgba, Assets::PaletteTransparency::Index255Transparent, averageColor)) {
+                        ++transparentCount;
+                    }
+                }
+            }, "convert " + std::to_string(NumWadTextures) + " indexed images of " + std::to_string(WadTextureSize) + "x" + std::to_string(WadTextureSize) + " pixels to RGBA");
+
+            ASSERT_EQ(NumWadTextures, transparentCount);
+        }
+
+        TEST_CASE("IdMipTextureReaderBenchmark.loadWad", "[IdMipTextureReaderBenchmark]") {
+            GeneratedWadEnvironment env;
+
+            NullLogger logger;
+            DiskFileSystem fs(env.dir());
+            TextureReader::TextureNameStrategy nameStrategy;
+            IdMipTextureReader textureReader(nameStrategy, fs, logger, createWadPalette());
+
+            WadFileSystem wadFS(env.dir() + Path("generated.wad"), logger);
+            const auto paths = wadFS.findItems(Path(""));
+            ASSERT_EQ(NumWadTextures, paths.size());
+
+            size_t maskedCount = 0u;
+            timeLambda([&]() {
+                for (const auto& path : paths) {
+                    const auto texture = std::unique_ptr<Assets::Texture>(textureReader.readTexture(wadFS.openFile(path)));
+                    if (texture->type() == Assets::TextureType::Masked) {
+                        ++maskedCount;
+                    }
+                }
+            }, "load " + std::to_string(NumWadTextures) + " textures of " + std::to_string(WadTextureSize) + "x" + std::to_string(WadTextureSize) + " pixels from a wad file");
+
+            ASSERT_EQ(NumWadTextures / 10u, maskedCount);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/IO/TestEnvironment.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderFileSystem.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumShaderFiles = 200u;
+        static constexpr size_t NumShadersPerFile = 100u;
+        static constexpr size_t NumTextures = 20000u;
+
+        /**
+         * Generates shader scripts and texture images. Every other shader belongs to a texture, the remaining ones are
+         * standalone shaders, and half of the textures have no shader.
+         */
+        class GeneratedShaderEnvironment : public TestEnvironment {
+        public:
+            GeneratedShaderEnvironment() :
+            TestEnvironment("Quake3ShaderFileSystemBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                createDirectory(Path("scripts"));
+                createDirectory(Path("textures/generated"));
+
+                for (size_t i = 0u; i < NumShaderFiles; ++i) {
+                    std::string str;
+                    for (size_t j = 0u; j < NumShadersPerFile; ++j) {
+                        const auto index = i * NumShadersPerFile + j;
+                        const auto name = index % 2u == 0u ? "texture_" + std::to_string(index) : "shader_" + std::to_string(index);
+                        str += "textures/generated/" + name + "\n"
+                               "{\n"
+                               "    qer_editorimage textures/generated/texture_" + std::to_string(index) + ".tga\n"
+                               "    surfaceparm nonsolid\n"
+                               "    cull none\n"
+                               "    {\n"
+                               "        map $lightmap\n"
+                               "        rgbGen identity\n"
+                               "    }\n"
+                               "    {\n"
+                               "        map textures/generated/texture_" + std::to_string(index) + ".tga\n"
+                               "        blendFunc GL_DST_COLOR GL_ZERO\n"
+                               "    }\n"
+                               "}\n";
+                    }
+                    createFile(Path("scripts/generated_" + std::to_string(i) + ".shader"), str);
+                }
+
+                for (size_t i = 0u; i < NumTextures; ++i) {
+                    createFile(Path("textures/generated/texture_" + std::to_string(i) + ".tga"), "");
+                }
+            }
+        };
+
+        TEST_CASE("Quake3ShaderFileSystemBenchmark.loadAndLinkShaders", "[Quake3ShaderFileSystemBenchmark]") {
+            NullLogger logger;
+            GeneratedShaderEnvironment env;
+
+            std::shared_ptr<FileSystem> fs = std::make_shared<DiskFileSystem>(env.dir());
+            timeLambda([&]() {
+                fs = std::make_shared<Quake3ShaderFileSystem>(fs, Path("scripts"), std::vector<Path>{ Path("textures") }, logger);
+            }, "load " + std::to_string(NumShaderFiles * NumShadersPerFile) + " shaders and link them with " + std::to_string(NumTextures) + " textures");
+
+            const auto items = fs->findItems(Path("textures/generated"), FileExtensionMatcher(""));
+            std::printf("Linked shaders: %zu\n", items.size());
+
+            // one shader for every texture plus the standalone shaders
+            ASSERT_EQ(NumTextures + NumShaderFiles * NumShadersPerFile / 2u, items.size());
+        }
+    }
+}
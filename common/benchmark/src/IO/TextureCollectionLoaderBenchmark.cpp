@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/IO/TestEnvironment.h"
+
+#include "BenchmarkUtils.h"
+
+#include "FreeImage.h"
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/FreeImageTextureReader.h"
+#include "IO/ImageLoaderImpl.h"
+#include "IO/Path.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureCollectionLoader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumImages = 200u;
+        static constexpr size_t ImageSize = 512u;
+
+        /**
+         * Generates a directory of 24 bit PNG images filled with smooth gradients and some noise.
+         */
+        class GeneratedImageEnvironment : public TestEnvironment {
+        public:
+            GeneratedImageEnvironment() :
+            TestEnvironment("TextureCollectionLoaderBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                InitFreeImage::initialize();
+                createDirectory(Path("textures"));
+
+                uint32_t random = 1u;
+                for (size_t i = 0u; i < NumImages; ++i) {
+                    auto* bitmap = FreeImage_Allocate(static_cast<int>(ImageSize), static_cast<int>(ImageSize), 24);
+                    for (size_t y = 0u; y < ImageSize; ++y) {
+                        auto* line = FreeImage_GetScanLine(bitmap, static_cast<int>(y));
+                        for (size_t x = 0u; x < ImageSize; ++x) {
+                            random = random * 1664525u + 1013904223u;
+                            const auto noise = (random >> 24u) & 0x0Fu;
+                            line[x * 3u + FI_RGBA_RED] = static_cast<BYTE>((x + i) / 2u + noise);
+                            line[x * 3u + FI_RGBA_GREEN] = static_cast<BYTE>((y + i) / 2u + noise);
+                            line[x * 3u + FI_RGBA_BLUE] = static_cast<BYTE>((x + y) / 4u + noise);
+                        }
+                    }
+
+                    const auto path = dir() + Path("textures/image_" + std::to_string(i) + ".png");
+                    FreeImage_Save(FIF_PNG, bitmap, path.asString().c_str());
+                    FreeImage_Unload(bitmap);
+                }
+            }
+        };
+
+        TEST_CASE("TextureCollectionLoaderBenchmark.loadPngTextures", "[TextureCollectionLoaderBenchmark]") {
+            GeneratedImageEnvironment env;
+
+            NullLogger logger;
+            DiskFileSystem fs(env.dir());
+            TextureReader::TextureNameStrategy nameStrategy;
+            FreeImageTextureReader textureReader(nameStrategy, fs, logger);
+            DirectoryTextureCollectionLoader loader(logger, fs, {});
+
+            std::unique_ptr<Assets::TextureCollection> collection;
+            timeLambda([&]() {
+                collection = loader.loadTextureCollection(Path("textures"), { "png" }, textureReader);
+            }, "load " + std::to_string(NumImages) + " PNG images of " + std::to_string(ImageSize) + "x" + std::to_string(ImageSize) + " pixels and generate their mips");
+
+            ASSERT_EQ(NumImages, collection->textureCount());
+            for (const auto* texture : collection->textures()) {
+                ASSERT_EQ(Assets::mipLevelCount(ImageSize, ImageSize), texture->buffersIfUnprepared().size());
+            }
+        }
+
+        TEST_CASE("TextureCollectionLoaderBenchmark.loadPngTexturesWithCache", "[TextureCollectionLoaderBenchmark]") {
+            GeneratedImageEnvironment env;
+
+            NullLogger logger;
+            DiskFileSystem fs(env.dir());
+            TextureReader::TextureNameStrategy nameStrategy;
+            FreeImageTextureReader textureReader(nameStrategy, fs, logger);
+            DirectoryTextureCollectionLoader loader(logger, fs, {});
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            std::unique_ptr<Assets::TextureCollection> collection;
+            timeLambda([&]() {
+                collection = loader.loadTextureCollection(Path("textures"), { "png" }, textureReader, &cache, "textures");
+            }, "cold load of " + std::to_string(NumImages) + " PNG images, decoding them and writing the cache");
+            ASSERT_EQ(NumImages, collection->textureCount());
+
+            timeLambda([&]() {
+                collection = loader.loadTextureCollection(Path("textures"), { "png" }, textureReader, &cache, "textures");
+            }, "warm load of " + std::to_string(NumImages) + " PNG images from the cache");
+            ASSERT_EQ(NumImages, collection->textureCount());
+            for (const auto* texture : collection->textures()) {
+                ASSERT_EQ(Assets::mipLevelCount(ImageSize, ImageSize), texture->buffersIfUnprepared().size());
+            }
+        }
+
+        TEST_CASE("TextureCollectionLoaderBenchmark.generateMips", "[TextureCollectionLoaderBenchmark]") {
+            auto image = Assets::TextureBuffer(ImageSize * ImageSize * 4u);
+            for (size_t i = 0u; i < image.size(); ++i) {
+                image[i] = static_cast<unsigned char>(i * 7u);
+            }
+
+            size_t mipLevels = 0u;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumImages; ++i) {
+                    auto buffers = Assets::TextureBufferList{ image };
+                    Assets::generateMips(buffers, ImageSize, ImageSize, GL_RGBA);
+                    mipLevels += buffers.size();
+                }
+            }, "generate mips for " + std::to_string(NumImages) + " images of " + std::to_string(ImageSize) + "x" + std::to_string(ImageSize) + " pixels on one thread");
+
+            ASSERT_EQ(NumImages * Assets::mipLevelCount(ImageSize, ImageSize), mipLevels);
+        }
+    }
+}
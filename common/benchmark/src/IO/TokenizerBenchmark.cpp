@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "IO/DiskIO.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/StandardMapParser.h"
+
+#include <kdl/string_utils.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Count all heap allocations made by this executable so that we can report the allocations per token. This
+// benchmark is built into its own executable (common-tokenizer-benchmark) so that this does not affect the others.
+static std::atomic<size_t> allocationCount(0u);
+
+void* operator new(const std::size_t size) {
+    ++allocationCount;
+    if (void* result = std::malloc(size > 0u ? size : 1u)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumRepetitions = 20u;
+
+        /**
+         * Tokenizes the given string repeatedly and reads the value of every token, either as a view into the
+         * buffer or as a copy.
+         */
+        template <typename Tokenizer, typename TokenType>
+        static void tokenize(const std::string& name, const std::string& str, const TokenType numberType, const TokenType eofType, const bool copyValues) {
+            size_t tokenCount = 0u;
+            double checksum = 0.0;
+
+            const auto allocationsBefore = allocationCount.load();
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0u; i < NumRepetitions; ++i) {
+                Tokenizer tokenizer(str);
+                auto token = tokenizer.nextToken();
+                while (!token.hasType(eofType)) {
+                    if (token.hasType(numberType)) {
+                        checksum += copyValues ? kdl::str_to_double(token.data()).value_or(0.0) : token.template toFloat<double>();
+                    } else {
+                        checksum += static_cast<double>(copyValues ? token.data().size() : token.view().size());
+                    }
+                    ++tokenCount;
+                    token = tokenizer.nextToken();
+                }
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+            const auto allocations = allocationCount.load() - allocationsBefore;
+
+            const auto seconds = std::chrono::duration<double>(end - start).count();
+            std::printf("%s (%s): %zu tokens, %.0f tokens/s, %.3f allocations/token (checksum %f)\n",
+                name.c_str(), copyValues ? "copied values" : "viewed values",
+                tokenCount, static_cast<double>(tokenCount) / seconds,
+                static_cast<double>(allocations) / static_cast<double>(tokenCount), checksum);
+
+            if (!copyValues) {
+                // a few allocations for the tokenizer state are unavoidable
+                ASSERT_LT(allocations, tokenCount / 100u);
+            }
+        }
+
+        TEST_CASE("TokenizerBenchmark.tokenizeFgd", "[TokenizerBenchmark]") {
+            const auto str = Disk::readFile(Disk::getCurrentWorkingDir() + Path("fixture/games/Quake2/Quake2.fgd"));
+            tokenize<FgdTokenizer>("Quake2.fgd", str, FgdToken::Integer | FgdToken::Decimal, FgdToken::Eof, true);
+            tokenize<FgdTokenizer>("Quake2.fgd", str, FgdToken::Integer | FgdToken::Decimal, FgdToken::Eof, false);
+        }
+
+        TEST_CASE("TokenizerBenchmark.tokenizeMap", "[TokenizerBenchmark]") {
+            const auto str = Disk::readFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Map/rtz_q1.map"));
+            tokenize<QuakeMapTokenizer>("rtz_q1.map", str, QuakeMapToken::Number, QuakeMapToken::Eof, true);
+            tokenize<QuakeMapTokenizer>("rtz_q1.map", str, QuakeMapToken::Number, QuakeMapToken::Eof, false);
+        }
+    }
+}
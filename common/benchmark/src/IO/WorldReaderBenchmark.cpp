@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "IO/MapChunkReader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <tuple>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushesInHugeMap = 600000u;
+        static constexpr size_t NumBrushesInLargeMap = 20000u;
+        static constexpr size_t NumBrushesPerRow = 140u;
+
+        /**
+         * Generates a terrain-like map on the fly without storing it, so that huge maps can be read without having to
+         * write them to disk first. All brushes belong to worldspawn.
+         */
+        class GeneratedMapBuffer : public std::streambuf {
+        private:
+            size_t m_brushCount;
+            size_t m_index;
+            std::string m_current;
+        public:
+            explicit GeneratedMapBuffer(const size_t brushCount) :
+            m_brushCount(brushCount),
+            m_index(0u) {}
+        private:
+            int_type underflow() override {
+                if (m_index > m_brushCount + 1u) {
+                    return traits_type::eof();
+                }
+
+                if (m_index == 0u) {
+                    m_current = "// Game: Quake\n// Format: Standard\n{\n\"classname\" \"worldspawn\"\n";
+                } else if (m_index <= m_brushCount) {
+                    m_current = makeBrush(m_index - 1u);
+                } else {
+                    m_current = "}\n";
+                }
+                ++m_index;
+
+                setg(m_current.data(), m_current.data(), m_current.data() + m_current.size());
+                return traits_type::to_int_type(m_current.front());
+            }
+
+            static std::string makeBrush(const size_t index) {
+                static const int Points[6][9] = {
+                    {  0,  0, -16,    0,  0,   0,   64,  0, -16 },
+                    {  0,  0, -16,    0, 64, -16,    0,  0,   0 },
+                    {  0,  0, -16,   64,  0, -16,    0, 64, -16 },
+                    { 64, 64,   0,    0, 64,   0,   64, 64, -16 },
+                    { 64, 64,   0,   64, 64, -16,   64,  0,   0 },
+                    { 64, 64,   0,   64,  0,   0,    0, 64,   0 }
+                };
+
+                const auto x = static_cast<int>(index % NumBrushesPerRow) * 64 - 4480;
+                const auto y = static_cast<int>(index / NumBrushesPerRow) * 64 - 4480;
+                const auto z = static_cast<int>((index * 7u) % 13u) * 8;
+
+                std::string result = "{\n";
+                char line[256];
+                for (const auto& p : Points) {
+                    std::snprintf(line, sizeof(line), "( %d %d %d ) ( %d %d %d ) ( %d %d %d ) terrain 0 0 0 1 1\n",
+                        p[0] + x, p[1] + y, p[2] + z,
+                        p[3] + x, p[4] + y, p[5] + z,
+                        p[6] + x, p[7] + y, p[8] + z);
+                    result += line;
+                }
+                result += "}\n";
+                return result;
+            }
+        };
+
+        TEST_CASE("WorldReaderBenchmark.splitHugeMap", "[WorldReaderBenchmark]") {
+            GeneratedMapBuffer buffer(NumBrushesInHugeMap);
+            std::istream stream(&buffer);
+            MapChunkReader reader(stream);
+
+            size_t mapSize = 0u;
+            size_t chunkCount = 0u;
+            timeLambda([&]() {
+                auto [begin, end, line] = reader.nextChunk();
+                while (begin != end) {
+                    mapSize += static_cast<size_t>(end - begin);
+                    ++chunkCount;
+                    std::tie(begin, end, line) = reader.nextChunk();
+                }
+            }, "split map with " + std::to_string(NumBrushesInHugeMap) + " brushes into chunks");
+
+            std::printf("Map size: %zu MB, chunks: %zu, peak memory: %zu kB\n", mapSize / (1u << 20u), chunkCount, reader.peakBufferSize() / (1u << 10u));
+            ASSERT_LT(reader.peakBufferSize(), 4u * MapChunkReader::DefaultReadSize);
+        }
+
+        TEST_CASE("WorldReaderBenchmark.readLargeMap", "[WorldReaderBenchmark]") {
+            const auto worldBounds = vm::bbox3(16384.0);
+
+            GeneratedMapBuffer buffer(NumBrushesInLargeMap);
+            std::istream generator(&buffer);
+            std::stringstream data;
+            data << generator.rdbuf();
+            const auto str = data.str();
+
+            std::unique_ptr<Model::WorldNode> world;
+            timeLambda([&]() {
+                TestParserStatus status;
+                WorldReader reader(str);
+                world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "read map with " + std::to_string(NumBrushesInLargeMap) + " brushes from a buffer of " + std::to_string(str.size() / (1u << 10u)) + " kB");
+            ASSERT_EQ(NumBrushesInLargeMap, world->defaultLayer()->childCount());
+
+            timeLambda([&]() {
+                TestParserStatus status;
+                data.seekg(0);
+                WorldReader reader(data);
+                world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "read map with " + std::to_string(NumBrushesInLargeMap) + " brushes from a stream in chunks of " + std::to_string(MapChunkReader::DefaultReadSize / (1u << 10u)) + " kB");
+            ASSERT_EQ(NumBrushesInLargeMap, world->defaultLayer()->childCount());
+        }
+    }
+}
@@ -29,8 +29,12 @@
 #include "Model/BrushFace.h"
 #include "Model/WorldNode.h"
 #include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/GLVertexType.h"
+#include "Renderer/VertexEncoding.h"
 
+#include <cstdio>
 #include <vector>
 #include <chrono>
 #include <string>
@@ -129,6 +133,119 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+
+        static void validate(BrushRenderer& renderer) {
+            if (!renderer.valid()) {
+                renderer.validate();
+            }
+        }
+
+        TEST_CASE("BrushRendererBenchmark.selectionChange", "[BrushRendererBenchmark]") {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            // select every tenth brush
+            std::vector<Model::BrushNode*> selectedBrushes;
+            std::vector<Model::BrushNode*> unselectedBrushes;
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if ((i % 10) == 0) {
+                    selectedBrushes.push_back(brushes.at(i));
+                } else {
+                    unselectedBrushes.push_back(brushes.at(i));
+                }
+            }
+
+            const auto selectedCount = std::to_string(selectedBrushes.size());
+
+            BrushRenderer defaultRenderer;
+            BrushRenderer selectionRenderer;
+            defaultRenderer.addBrushes(brushes);
+            validate(defaultRenderer);
+
+            timeLambda([&](){
+                defaultRenderer.setBrushes(unselectedBrushes);
+                selectionRenderer.setBrushes(selectedBrushes);
+                validate(defaultRenderer);
+                validate(selectionRenderer);
+            }, "move " + selectedCount + " brushes between renderers by replacing all brushes");
+
+            defaultRenderer.setBrushes(brushes);
+            selectionRenderer.clear();
+            validate(defaultRenderer);
+
+            timeLambda([&](){
+                defaultRenderer.removeBrushes(selectedBrushes);
+                selectionRenderer.addBrushes(selectedBrushes);
+                validate(defaultRenderer);
+                validate(selectionRenderer);
+            }, "move " + selectedCount + " brushes between renderers incrementally");
+
+            timeLambda([&](){
+                selectionRenderer.invalidateBrushes(selectedBrushes);
+                validate(selectionRenderer);
+            }, "rewrite vertices and indices of " + selectedCount + " brushes");
+
+            timeLambda([&](){
+                selectionRenderer.invalidateBrushIndices(selectedBrushes);
+                validate(selectionRenderer);
+            }, "rewrite indices of " + selectedCount + " brushes");
+
+            ASSERT_TRUE(defaultRenderer.valid());
+            ASSERT_TRUE(selectionRenderer.valid());
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        /**
+         * Builds the vertices of the given brushes in the same way as BrushRendererBrushCache, using the given function
+         * to encode the normals.
+         */
+        template <typename VertexSpec, typename EncodeNormal>
+        static std::vector<typename VertexSpec::Vertex> buildBrushVertices(const std::vector<Model::BrushNode*>& brushes, const EncodeNormal& encodeNormal) {
+            std::vector<typename VertexSpec::Vertex> result;
+            for (const auto* brushNode : brushes) {
+                for (const auto& face : brushNode->brush().faces()) {
+                    const auto normal = encodeNormal(vm::vec3f(face.boundary().normal));
+                    for (const auto* vertex : face.vertices()) {
+                        const auto& position = vertex->position();
+                        result.emplace_back(vm::vec3f(position), normal, face.textureCoords(position));
+                    }
+                }
+            }
+            return result;
+        }
+
+        TEST_CASE("BrushRendererBenchmark.vertexFormats", "[BrushRendererBenchmark]") {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            std::vector<GLVertexTypes::P3NT2::Vertex> floatVertices;
+            timeLambda([&]() {
+                floatVertices = buildBrushVertices<GLVertexTypes::P3NT2>(brushes, [](const vm::vec3f& normal) { return normal; });
+            }, "build " + std::to_string(brushes.size()) + " brushes with float normals");
+
+            std::vector<GLVertexTypes::P3NbT2::Vertex> byteVertices;
+            timeLambda([&]() {
+                byteVertices = buildBrushVertices<GLVertexTypes::P3NbT2>(brushes, [](const vm::vec3f& normal) { return encodeByteNormal(normal); });
+            }, "build " + std::to_string(brushes.size()) + " brushes with byte normals");
+
+            const auto floatBytes = floatVertices.size() * sizeof(GLVertexTypes::P3NT2::Vertex);
+            const auto byteBytes = byteVertices.size() * sizeof(GLVertexTypes::P3NbT2::Vertex);
+            std::printf("Vertex data for %zu vertices: %.1f MiB with float normals, %.1f MiB with byte normals\n",
+                floatVertices.size(),
+                static_cast<double>(floatBytes) / 1024.0 / 1024.0,
+                static_cast<double>(byteBytes) / 1024.0 / 1024.0);
+
+            ASSERT_EQ(floatVertices.size(), byteVertices.size());
+            ASSERT_EQ(24u, sizeof(GLVertexTypes::P3NbT2::Vertex));
+            ASSERT_LT(byteBytes, floatBytes);
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
 
@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Renderer/DirtyRangeTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t DirtyRangeElementSize = 32u; // the size of a brush vertex
+        static constexpr size_t DirtyRangeBufferSize = 1000000u;
+        static constexpr size_t DirtyRangeBrushSize = 24u;
+        static constexpr size_t DirtyRangeFrames = 1000u;
+
+        using EditPattern = std::vector<DirtyRangeTracker::Range>;
+
+        /**
+         * Generates the ranges of the given number of brushes, starting at random positions within the given window
+         * of the buffer.
+         */
+        static EditPattern generateEditPattern(std::mt19937& rng, const size_t brushCount, const size_t windowSize) {
+            const auto windowStart = std::uniform_int_distribution<size_t>(0u, DirtyRangeBufferSize - windowSize)(rng);
+            auto brushPos = std::uniform_int_distribution<size_t>(0u, (windowSize - DirtyRangeBrushSize) / DirtyRangeBrushSize);
+
+            EditPattern result;
+            for (size_t i = 0u; i < brushCount; ++i) {
+                result.emplace_back(windowStart + brushPos(rng) * DirtyRangeBrushSize, DirtyRangeBrushSize);
+            }
+            return result;
+        }
+
+        static void replayEditPatterns(const std::string& name, const std::vector<EditPattern>& patterns, const size_t mergeGap) {
+            size_t uploadCount = 0u;
+            size_t uploadedElements = 0u;
+            size_t singleRangeElements = 0u;
+
+            timeLambda([&]() {
+                DirtyRangeTracker tracker(DirtyRangeBufferSize, mergeGap);
+                for (const auto& pattern : patterns) {
+                    for (const auto& range : pattern) {
+                        tracker.markDirty(range.pos, range.size);
+                    }
+
+                    const auto& ranges = tracker.ranges();
+                    uploadCount += ranges.size();
+                    uploadedElements += tracker.dirtySize();
+                    singleRangeElements += ranges.back().end() - ranges.front().pos;
+                    tracker.clear();
+                }
+            }, "track " + name + " with merge gap " + std::to_string(mergeGap));
+
+            std::printf("%s: %.1f uploads and %.1f KiB per frame (%.1f KiB with a single range)\n",
+                name.c_str(),
+                static_cast<double>(uploadCount) / static_cast<double>(patterns.size()),
+                static_cast<double>(uploadedElements * DirtyRangeElementSize) / 1024.0 / static_cast<double>(patterns.size()),
+                static_cast<double>(singleRangeElements * DirtyRangeElementSize) / 1024.0 / static_cast<double>(patterns.size()));
+
+            ASSERT_LE(uploadedElements, singleRangeElements);
+        }
+
+        TEST_CASE("DirtyRangeTrackerBenchmark.editPatterns", "[DirtyRangeTrackerBenchmark]") {
+            std::mt19937 rng(0u);
+
+            std::vector<EditPattern> scattered, clustered, single;
+            for (size_t i = 0u; i < DirtyRangeFrames; ++i) {
+                // a selection of brushes spread over the entire map
+                scattered.push_back(generateEditPattern(rng, 100u, DirtyRangeBufferSize));
+                // a selection of brushes which were created together and are therefore close in the buffer
+                clustered.push_back(generateEditPattern(rng, 100u, 100u * DirtyRangeBrushSize * 4u));
+                // a single brush at either end of the buffer
+                single.push_back({ DirtyRangeTracker::Range(0u, DirtyRangeBrushSize), DirtyRangeTracker::Range(DirtyRangeBufferSize - DirtyRangeBrushSize, DirtyRangeBrushSize) });
+            }
+
+            for (const size_t mergeGap : { size_t(0), size_t(4096u / DirtyRangeElementSize) }) {
+                replayEditPatterns("scattered edits", scattered, mergeGap);
+                replayEditPatterns("clustered edits", clustered, mergeGap);
+                replayEditPatterns("edits at both ends", single, mergeGap);
+            }
+        }
+    }
+}
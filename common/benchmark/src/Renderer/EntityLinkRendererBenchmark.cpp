@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/Model/TestGame.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Model/EditorContext.h"
+#include "Model/EntityAttributes.h"
+#include "Model/EntityNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/EntityLinkRenderer.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumLinkedEntities = 20000u;
+        static constexpr size_t NumLinkedEntitiesPerRow = 142u;
+
+        static std::string originAttribute(const size_t x, const size_t y) {
+            return std::to_string(x * 64u) + " " + std::to_string(y * 64u) + " 0";
+        }
+
+        TEST_CASE("EntityLinkRendererBenchmark.updateLinks", "[EntityLinkRendererBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = View::MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+            document->editorContext().setEntityLinkMode(Model::EditorContext::EntityLinkMode_All);
+
+            // a single chain of entities, each of which targets the next one
+            std::vector<Model::Node*> entities;
+            for (size_t i = 0u; i < NumLinkedEntities; ++i) {
+                auto* entity = document->world()->createEntity();
+                entity->addOrUpdateAttribute(Model::AttributeNames::Classname, "info_notnull");
+                entity->addOrUpdateAttribute(Model::AttributeNames::Origin, originAttribute(i % NumLinkedEntitiesPerRow, i / NumLinkedEntitiesPerRow));
+                entity->addOrUpdateAttribute(Model::AttributeNames::Targetname, "entity_" + std::to_string(i));
+                if (i + 1u < NumLinkedEntities) {
+                    entity->addOrUpdateAttribute(Model::AttributeNames::Target, "entity_" + std::to_string(i + 1u));
+                }
+                entities.push_back(entity);
+            }
+            document->addNodes(entities, document->parentForNodes());
+
+            EntityLinkRenderer renderer(document);
+            timeLambda([&]() {
+                renderer.validate();
+            }, "build links of " + std::to_string(NumLinkedEntities) + " entities");
+            ASSERT_EQ(NumLinkedEntities - 1u, renderer.linkCount());
+
+            // move an entity in the middle of the chain, which changes its incoming and its outgoing link
+            auto* movedEntity = static_cast<Model::EntityNode*>(entities[NumLinkedEntities / 2u]);
+            movedEntity->addOrUpdateAttribute(Model::AttributeNames::Origin, "-64 -64 0");
+
+            renderer.invalidateNodes({ movedEntity });
+            timeLambda([&]() {
+                renderer.validate();
+            }, "update links of one entity");
+            ASSERT_EQ(NumLinkedEntities - 1u, renderer.linkCount());
+
+            // retarget an entity so that it no longer links to its successor
+            auto* retargetedEntity = static_cast<Model::EntityNode*>(entities[NumLinkedEntities / 4u]);
+            retargetedEntity->addOrUpdateAttribute(Model::AttributeNames::Target, "entity_0");
+
+            renderer.invalidateNodes({ retargetedEntity });
+            timeLambda([&]() {
+                renderer.validate();
+            }, "update links of one retargeted entity");
+            ASSERT_EQ(NumLinkedEntities - 1u, renderer.linkCount());
+
+            renderer.invalidate();
+            timeLambda([&]() {
+                renderer.validate();
+            }, "rebuild links of " + std::to_string(NumLinkedEntities) + " entities");
+            std::printf("Links: %zu\n", renderer.linkCount());
+            ASSERT_EQ(NumLinkedEntities - 1u, renderer.linkCount());
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/EntityModel.h"
+#include "Assets/Texture.h"
+#include "Renderer/EntityModelBatches.h"
+#include "Renderer/GLVertex.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/TexturedIndexRangeRenderer.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumModels = 10u;
+        static constexpr size_t NumFramesPerModel = 4u;
+        static constexpr size_t NumEntitiesPerRow = 100u;
+        static constexpr size_t NumEntities = 5000u;
+        static constexpr size_t NumRenderedFrames = 100u;
+        static constexpr size_t MeshResolution = 32u;
+
+        /**
+         * Creates a closed, bumpy sphere-like mesh with 2 * MeshResolution^2 triangles.
+         */
+        static std::vector<Assets::EntityModelVertex> makeMesh(const size_t frameIndex) {
+            const auto pointAt = [&](const size_t i, const size_t j) {
+                const auto theta = static_cast<float>(i) / static_cast<float>(MeshResolution) * vm::constants<float>::pi();
+                const auto phi = static_cast<float>(j) / static_cast<float>(MeshResolution) * vm::constants<float>::two_pi();
+                const auto radius = 16.0f + static_cast<float>((i + j + frameIndex) % 3u);
+                const auto position = radius * vm::vec3f(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+                const auto texCoords = vm::vec2f(static_cast<float>(j), static_cast<float>(i)) / static_cast<float>(MeshResolution);
+                return Assets::EntityModelVertex(position, texCoords);
+            };
+
+            std::vector<Assets::EntityModelVertex> result;
+            for (size_t i = 0u; i < MeshResolution; ++i) {
+                for (size_t j = 0u; j < MeshResolution; ++j) {
+                    result.push_back(pointAt(i, j));
+                    result.push_back(pointAt(i + 1u, j));
+                    result.push_back(pointAt(i + 1u, j + 1u));
+                    result.push_back(pointAt(i, j));
+                    result.push_back(pointAt(i + 1u, j + 1u));
+                    result.push_back(pointAt(i, j + 1u));
+                }
+            }
+            return result;
+        }
+
+        static std::unique_ptr<Assets::EntityModel> makeModel(const size_t modelIndex) {
+            auto model = std::make_unique<Assets::EntityModel>("model " + std::to_string(modelIndex), Assets::PitchType::Normal);
+            model->addFrames(NumFramesPerModel);
+
+            auto& surface = model->addSurface("surface");
+            surface.addSkin(new Assets::Texture("skin " + std::to_string(modelIndex), 64, 64));
+
+            for (size_t i = 0u; i < NumFramesPerModel; ++i) {
+                auto& frame = model->loadFrame(i, "frame " + std::to_string(i), vm::bbox3f(20.0f));
+                const auto vertices = makeMesh(i);
+                surface.addIndexedMesh(frame, vertices, Assets::EntityModelIndices(PrimType::Triangles, 0u, vertices.size()));
+            }
+
+            return model;
+        }
+
+        TEST_CASE("EntityModelRendererBenchmark.batchEntities", "[EntityModelRendererBenchmark]") {
+            std::vector<std::unique_ptr<Assets::EntityModel>> models;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumModels; ++i) {
+                    models.push_back(makeModel(i));
+                }
+            }, "load " + std::to_string(NumModels * NumFramesPerModel) + " frames and generate their LOD meshes");
+
+            // one renderer and one LOD renderer per model and frame, like EntityModelManager caches them
+            std::vector<std::unique_ptr<TexturedRenderer>> renderers;
+            std::vector<std::unique_ptr<TexturedRenderer>> lodRenderers;
+            for (const auto& model : models) {
+                for (size_t i = 0u; i < NumFramesPerModel; ++i) {
+                    renderers.push_back(model->buildRenderer(0u, i));
+                    lodRenderers.push_back(model->buildLodRenderer(0u, i));
+                }
+            }
+
+            struct Entity {
+                TexturedRenderer* renderer;
+                TexturedRenderer* lodRenderer;
+                vm::bbox3f bounds;
+                vm::mat4x4f transformation;
+            };
+
+            std::vector<Entity> entities;
+            for (size_t i = 0u; i < NumEntities; ++i) {
+                const auto x = static_cast<float>(i % NumEntitiesPerRow) * 128.0f;
+                const auto y = static_cast<float>(i / NumEntitiesPerRow) * 128.0f;
+                const auto origin = vm::vec3f(x, y, 0.0f);
+                const auto rendererIndex = i % renderers.size();
+                entities.push_back({
+                    renderers[rendererIndex].get(),
+                    lodRenderers[rendererIndex].get(),
+                    vm::bbox3f(origin - vm::vec3f(20.0f, 20.0f, 20.0f), origin + vm::vec3f(20.0f, 20.0f, 20.0f)),
+                    vm::translation_matrix(origin)
+                });
+            }
+
+            EntityModelBatches batches;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumRenderedFrames; ++i) {
+                    batches.reset(vm::vec3f(static_cast<float>(i) * 64.0f, -256.0f, 128.0f));
+                    for (const auto& entity : entities) {
+                        batches.add(entity.renderer, entity.lodRenderer, entity.bounds, entity.transformation);
+                    }
+                }
+            }, "batch " + std::to_string(NumEntities) + " entities in " + std::to_string(NumRenderedFrames) + " frames");
+
+            printf("Draw batches: %zu (previously %zu)\n", batches.batches().size(), batches.instanceCount());
+            printf("Instances rendered with LOD meshes: %zu\n", batches.lodInstanceCount());
+            ASSERT_EQ(NumEntities, batches.instanceCount());
+            ASSERT_LE(batches.batches().size(), 2u * NumModels * NumFramesPerModel);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumRoomsPerAxis = 24u;
+        static constexpr size_t NumDetailBrushesPerAxis = 4u;
+        static constexpr FloatType RoomSize = 512.0;
+        static constexpr FloatType WallThickness = 16.0;
+        static constexpr FloatType RoomHeight = 256.0;
+        static constexpr FloatType DoorWidth = 96.0;
+        static constexpr size_t NumFrames = 200u;
+
+        /**
+         * Creates a grid of rooms. Every room has a floor, a ceiling and walls with a doorway to the neighbouring rooms,
+         * and contains a number of small detail brushes.
+         */
+        static std::vector<Model::BrushNode*> makeRooms(Model::WorldNode& world) {
+            const Model::BrushBuilder builder(&world, vm::bbox3(16384.0));
+
+            std::vector<Model::BrushNode*> result;
+            const auto addBrush = [&](const vm::vec3& min, const vm::vec3& max) {
+                auto* brushNode = world.createBrush(builder.createCuboid(vm::bbox3(min, max), "texture"));
+                world.defaultLayer()->addChild(brushNode);
+                result.push_back(brushNode);
+            };
+
+            const auto offset = -static_cast<FloatType>(NumRoomsPerAxis) * RoomSize / 2.0;
+            const auto doorMin = (RoomSize - DoorWidth) / 2.0;
+            const auto doorMax = (RoomSize + DoorWidth) / 2.0;
+            const auto detailSpacing = RoomSize / static_cast<FloatType>(NumDetailBrushesPerAxis);
+
+            for (size_t x = 0u; x < NumRoomsPerAxis; ++x) {
+                for (size_t y = 0u; y < NumRoomsPerAxis; ++y) {
+                    const auto origin = vm::vec3(offset + static_cast<FloatType>(x) * RoomSize, offset + static_cast<FloatType>(y) * RoomSize, 0.0);
+
+                    // floor and ceiling
+                    addBrush(origin + vm::vec3(0.0, 0.0, -WallThickness), origin + vm::vec3(RoomSize, RoomSize, 0.0));
+                    addBrush(origin + vm::vec3(0.0, 0.0, RoomHeight), origin + vm::vec3(RoomSize, RoomSize, RoomHeight + WallThickness));
+
+                    // walls at the low x and low y sides, split by a doorway
+                    addBrush(origin, origin + vm::vec3(WallThickness, doorMin, RoomHeight));
+                    addBrush(origin + vm::vec3(0.0, doorMax, 0.0), origin + vm::vec3(WallThickness, RoomSize, RoomHeight));
+                    addBrush(origin, origin + vm::vec3(doorMin, WallThickness, RoomHeight));
+                    addBrush(origin + vm::vec3(doorMax, 0.0, 0.0), origin + vm::vec3(RoomSize, WallThickness, RoomHeight));
+
+                    // detail
+                    for (size_t i = 0u; i < NumDetailBrushesPerAxis; ++i) {
+                        for (size_t j = 0u; j < NumDetailBrushesPerAxis; ++j) {
+                            const auto min = origin + vm::vec3(static_cast<FloatType>(i) * detailSpacing + 48.0, static_cast<FloatType>(j) * detailSpacing + 48.0, 0.0);
+                            addBrush(min, min + vm::vec3(16.0, 16.0, 32.0));
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        TEST_CASE("OcclusionCullerBenchmark.cullRooms", "[OcclusionCullerBenchmark]") {
+            Model::WorldNode world(Model::MapFormat::Standard);
+            const auto brushes = makeRooms(world);
+
+            // the camera walks through the rooms along the diagonal of the grid and looks around
+            std::vector<std::pair<vm::vec3f, vm::vec3f>> cameraPath;
+            const auto start = -static_cast<float>(NumRoomsPerAxis) * static_cast<float>(RoomSize) / 2.0f;
+            const auto length = static_cast<float>(NumRoomsPerAxis) * static_cast<float>(RoomSize);
+            for (size_t i = 0u; i < NumFrames; ++i) {
+                const auto t = static_cast<float>(i) / static_cast<float>(NumFrames);
+                const auto angle = t * 8.0f * vm::constants<float>::pi();
+                const auto position = vm::vec3f(start + t * length + 256.0f, start + t * length + 256.0f, 128.0f);
+                const auto direction = vm::vec3f(std::cos(angle), std::sin(angle), 0.0f);
+                cameraPath.emplace_back(position, direction);
+            }
+
+            PerspectiveCamera camera(90.0f, 1.0f, 32768.0f, Camera::Viewport(0, 0, 1920, 1080), cameraPath.front().first, cameraPath.front().second, vm::vec3f::pos_z());
+            OcclusionCuller culler;
+
+            size_t totalOccluders = 0u;
+            size_t totalVisible = 0u;
+            timeLambda([&]() {
+                for (const auto& [position, direction] : cameraPath) {
+                    camera.moveTo(position);
+                    camera.setDirection(direction, vm::vec3f::pos_z());
+
+                    culler.reset(camera);
+                    totalOccluders += culler.addOccluders(brushes);
+                    totalVisible += culler.findVisibleNodes(world).size();
+                }
+            }, "cull " + std::to_string(brushes.size()) + " brushes in " + std::to_string(NumFrames) + " frames");
+
+            const auto totalNodes = brushes.size() * NumFrames;
+            printf("Average occluders per frame: %f\n", static_cast<double>(totalOccluders) / static_cast<double>(NumFrames));
+            printf("Culled fraction: %f\n", 1.0 - static_cast<double>(totalVisible) / static_cast<double>(totalNodes));
+            ASSERT_LT(totalVisible, totalNodes);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Renderer/AttrString.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/GlyphRunCache.h"
+#include "Renderer/TextureFont.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumLabels = 2000u;
+        static constexpr size_t NumLabelFrames = 100u;
+
+        /**
+         * Creates a font with fixed size glyphs. Its texture is never uploaded, so no OpenGL context is required.
+         */
+        static std::unique_ptr<TextureFont> createSyntheticFont() {
+            const unsigned char firstChar = ' ';
+            const unsigned char charCount = '~' - ' ' + 1;
+            const size_t cellSize = 16u;
+
+            std::vector<FontGlyph> glyphs;
+            for (size_t i = 0u; i < charCount; ++i) {
+                glyphs.emplace_back((i % 16u) * cellSize, (i / 16u) * cellSize, 9u, 14u, 10u);
+            }
+            return std::make_unique<TextureFont>(std::make_unique<FontTexture>(charCount, cellSize, 2u), glyphs, 16, firstChar, charCount);
+        }
+
+        /**
+         * Creates entity labels with a classname and a targetname, as rendered by EntityRenderer.
+         */
+        static std::vector<AttrString> createLabels() {
+            std::vector<AttrString> result;
+            for (size_t i = 0u; i < NumLabels; ++i) {
+                AttrString label;
+                label.appendCentered("light_" + std::to_string(i % 50u));
+                label.appendCentered("target_" + std::to_string(i));
+                result.push_back(label);
+            }
+            return result;
+        }
+
+        TEST_CASE("TextureFontBenchmark.renderLabels", "[TextureFontBenchmark]") {
+            const auto font = createSyntheticFont();
+            const auto labels = createLabels();
+
+            // TextRenderer measures each label to cull it and then lays it out
+            size_t uncachedVertexCount = 0u;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumLabelFrames; ++i) {
+                    uncachedVertexCount = 0u;
+                    for (const auto& label : labels) {
+                        font->measure(label);
+                        uncachedVertexCount += font->quads(label, true).size();
+                        font->measure(label);
+                    }
+                }
+            }, "lay out " + std::to_string(NumLabels) + " labels in " + std::to_string(NumLabelFrames) + " frames without caching");
+
+            size_t cachedVertexCount = 0u;
+            timeLambda([&]() {
+                for (size_t i = 0u; i < NumLabelFrames; ++i) {
+                    cachedVertexCount = 0u;
+                    for (const auto& label : labels) {
+                        font->layout(label, true);
+                        cachedVertexCount += font->layout(label, true)->vertices.size();
+                    }
+                }
+            }, "lay out " + std::to_string(NumLabels) + " labels in " + std::to_string(NumLabelFrames) + " frames with caching");
+
+            std::printf("Vertices per frame: %zu\n", cachedVertexCount / 2u);
+            ASSERT_EQ(uncachedVertexCount, cachedVertexCount);
+        }
+    }
+}
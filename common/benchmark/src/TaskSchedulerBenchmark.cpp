@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "TaskScheduler.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    static constexpr size_t NumSmallTasks = 1000000u;
+    static constexpr size_t NumImbalancedTasks = 2000u;
+    static constexpr size_t NumOuterTasks = 64u;
+    static constexpr size_t NumInnerTasks = 256u;
+    static constexpr size_t NumMainThreadTasks = 100000u;
+
+    static double schedulerBenchmarkWork(const size_t iterations) {
+        auto result = 0.0;
+        for (size_t i = 0u; i < iterations; ++i) {
+            result += std::sqrt(static_cast<double>(i));
+        }
+        return result;
+    }
+
+    TEST_CASE("TaskSchedulerBenchmark.smallTasks", "[TaskSchedulerBenchmark]") {
+        auto& scheduler = TaskScheduler::instance();
+        std::printf("Worker threads: %zu\n", scheduler.threadCount());
+
+        std::vector<double> results(NumSmallTasks);
+        timeLambda([&]() {
+            for (size_t i = 0u; i < NumSmallTasks; ++i) {
+                results[i] = schedulerBenchmarkWork(16u);
+            }
+        }, "run " + std::to_string(NumSmallTasks) + " small tasks serially");
+
+        timeLambda([&]() {
+            scheduler.parallelFor(NumSmallTasks, [&](const size_t i) {
+                results[i] = schedulerBenchmarkWork(16u);
+            });
+        }, "run " + std::to_string(NumSmallTasks) + " small tasks with the task scheduler");
+    }
+
+    TEST_CASE("TaskSchedulerBenchmark.imbalancedTasks", "[TaskSchedulerBenchmark]") {
+        auto& scheduler = TaskScheduler::instance();
+
+        // the cost of the tasks grows with their index, so an even split of the range would be imbalanced
+        std::vector<double> results(NumImbalancedTasks);
+        timeLambda([&]() {
+            for (size_t i = 0u; i < NumImbalancedTasks; ++i) {
+                results[i] = schedulerBenchmarkWork(i * 100u);
+            }
+        }, "run " + std::to_string(NumImbalancedTasks) + " imbalanced tasks serially");
+
+        timeLambda([&]() {
+            scheduler.parallelFor(NumImbalancedTasks, [&](const size_t i) {
+                results[i] = schedulerBenchmarkWork(i * 100u);
+            });
+        }, "run " + std::to_string(NumImbalancedTasks) + " imbalanced tasks with the task scheduler");
+    }
+
+    TEST_CASE("TaskSchedulerBenchmark.nestedTaskGroups", "[TaskSchedulerBenchmark]") {
+        auto& scheduler = TaskScheduler::instance();
+
+        std::atomic<size_t> count(0u);
+        timeLambda([&]() {
+            TaskGroup outer(scheduler);
+            for (size_t i = 0u; i < NumOuterTasks; ++i) {
+                outer.run([&]() {
+                    TaskGroup inner(scheduler);
+                    for (size_t j = 0u; j < NumInnerTasks; ++j) {
+                        inner.run([&]() {
+                            schedulerBenchmarkWork(1000u);
+                            ++count;
+                        });
+                    }
+                    inner.wait();
+                });
+            }
+            outer.wait();
+        }, "run " + std::to_string(NumOuterTasks) + " task groups with " + std::to_string(NumInnerTasks) + " tasks each");
+
+        ASSERT_EQ(NumOuterTasks * NumInnerTasks, count.load());
+    }
+
+    TEST_CASE("TaskSchedulerBenchmark.mainThreadTasks", "[TaskSchedulerBenchmark]") {
+        auto& scheduler = TaskScheduler::instance();
+
+        size_t count = 0u;
+        timeLambda([&]() {
+            scheduler.parallelFor(NumMainThreadTasks, [&](const size_t) {
+                scheduler.postToMainThread([&]() { ++count; });
+            });
+            scheduler.runMainThreadTasks();
+        }, "post and run " + std::to_string(NumMainThreadTasks) + " main thread tasks");
+
+        ASSERT_EQ(NumMainThreadTasks, count);
+    }
+}
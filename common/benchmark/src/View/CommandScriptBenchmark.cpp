@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/Model/TestGame.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Profiler.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "Model/MapFormat.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/PasteType.h"
+
+#include <kdl/string_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static const auto FixtureDir = IO::Path("fixture");
+
+        static FloatType scriptArgument(const std::vector<std::string>& args, const size_t index) {
+            REQUIRE(index < args.size());
+            const auto value = kdl::str_to_double(args[index]);
+            REQUIRE(value.has_value());
+            return static_cast<FloatType>(*value);
+        }
+
+        /**
+         * Executes a single line of a command script. Supported commands are
+         *
+         * - load <path>: pastes the map at the given path, relative to the fixture directory, e.g. test/IO/Map/rtz_q1.map
+         * - selectAll, deselectAll
+         * - translate <x> <y> <z>
+         * - rotate <angle>: rotates the selection around the Z axis through the center of the selection bounds
+         * - duplicate, delete
+         * - undo, redo
+         */
+        static void executeScriptCommand(std::shared_ptr<MapDocument> document, const std::vector<std::string>& args) {
+            const auto& command = args.front();
+            const ProfilerZone zone("CommandScript", kdl::str_join(args, " "));
+
+            if (command == "load") {
+                REQUIRE(args.size() == 2u);
+                const auto str = IO::Disk::readFile(IO::Disk::getCurrentWorkingDir() + FixtureDir + IO::Path(args[1]));
+                ASSERT_EQ(PasteType::Node, document->paste(str));
+            } else if (command == "selectAll") {
+                document->selectAllNodes();
+            } else if (command == "deselectAll") {
+                document->deselectAll();
+            } else if (command == "translate") {
+                ASSERT_TRUE(document->translateObjects(vm::vec3(scriptArgument(args, 1u), scriptArgument(args, 2u), scriptArgument(args, 3u))));
+            } else if (command == "rotate") {
+                const auto center = document->selectionBounds().center();
+                ASSERT_TRUE(document->rotateObjects(center, vm::vec3::pos_z(), vm::to_radians(scriptArgument(args, 1u))));
+            } else if (command == "duplicate") {
+                ASSERT_TRUE(document->duplicateObjects());
+            } else if (command == "delete") {
+                ASSERT_TRUE(document->deleteObjects());
+            } else if (command == "undo") {
+                document->undoCommand();
+            } else if (command == "redo") {
+                document->redoCommand();
+            } else {
+                FAIL("unknown script command: " + command);
+            }
+        }
+
+        TEST_CASE("CommandScriptBenchmark.replayEditScript", "[CommandScriptBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const auto script = IO::Disk::readFile(IO::Disk::getCurrentWorkingDir() + FixtureDir + IO::Path("benchmark/View/CommandScript/edit.txt"));
+            const auto lines = kdl::str_split(script, "\n");
+
+            auto& profiler = Profiler::instance();
+            profiler.clear();
+            profiler.setEnabled(true);
+
+            timeLambda([&]() {
+                for (const auto& line : lines) {
+                    if (!line.empty() && line.front() != '#') {
+                        executeScriptCommand(document, kdl::str_split(line, " "));
+                    }
+                }
+            }, "replay edit script");
+
+            profiler.setEnabled(false);
+
+            const auto tracePath = IO::Disk::getCurrentWorkingDir() + IO::Path("CommandScriptBenchmark.trace.json");
+            std::ofstream stream(tracePath.asString());
+            profiler.writeTrace(stream);
+            std::printf("Wrote %zu profiler events to %s\n", profiler.eventCount(), tracePath.asString().c_str());
+
+            ASSERT_TRUE(stream.good());
+            profiler.clear();
+        }
+    }
+}
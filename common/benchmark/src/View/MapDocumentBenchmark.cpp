@@ -0,0 +1,378 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+#include "../../test/src/Model/TestGame.h"
+
+#include "BenchmarkUtils.h"
+
+#include "IO/NodeWriter.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Model/WorldNode.h"
+#include "View/BrushGeometryReleaser.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/PasteType.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t NumBrushesPerAxis = 142u;
+        static constexpr size_t NumBrushesPerAxisInLargeMap = 317u;
+        static constexpr size_t NumSelectedBrushesPerAxis = 32u;
+        static constexpr size_t NumMinuendsPerAxis = 71u;
+        static constexpr size_t NumSubtrahendsPerAxis = 10u;
+        static constexpr size_t NumDraggedBrushesPerAxis = 20u;
+        static constexpr size_t NumDragSteps = 32u;
+        static constexpr size_t NumMovedBrushesPerAxis = 71u;
+        static constexpr size_t NumMoveSteps = 64u;
+        static constexpr size_t NumBrushesPerAxisInLayeredMap = 224u;
+
+        TEST_CASE("MapDocumentBenchmark.pasteAndDeleteBrushes", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            // make a grid of ~20k brushes
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::Node*> brushes;
+            for (size_t x = 0u; x < NumBrushesPerAxis; ++x) {
+                for (size_t y = 0u; y < NumBrushesPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 64.0 - 8192.0, static_cast<FloatType>(y) * 64.0 - 8192.0, 0.0);
+                    brushes.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture")));
+                }
+            }
+
+            document->addNodes(brushes, document->parentForNodes());
+            document->selectAllNodes();
+            const std::string clipboard = document->serializeSelectedNodes();
+            document->deleteObjects();
+
+            PasteType result = PasteType::Failed;
+            timeLambda([&]() {
+                const Transaction transaction(document, "Paste");
+                result = document->paste(clipboard);
+            }, "paste " + std::to_string(brushes.size()) + " brushes");
+            ASSERT_EQ(PasteType::Node, result);
+
+            timeLambda([&]() {
+                document->deleteObjects();
+            }, "delete " + std::to_string(brushes.size()) + " brushes");
+
+            timeLambda([&]() {
+                document->undoCommand();
+            }, "undo deleting " + std::to_string(brushes.size()) + " brushes");
+        }
+
+        TEST_CASE("MapDocumentBenchmark.selectTouching", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            // make a grid of ~100k brushes
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::Node*> brushes;
+            for (size_t x = 0u; x < NumBrushesPerAxisInLargeMap; ++x) {
+                for (size_t y = 0u; y < NumBrushesPerAxisInLargeMap; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 48.0 - 8192.0, static_cast<FloatType>(y) * 48.0 - 8192.0, 0.0);
+                    brushes.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture")));
+                }
+            }
+            document->addNodes(brushes, document->parentForNodes());
+
+            // select ~1000 brushes spread over the grid, each of which touches some of its neighbours
+            std::vector<Model::Node*> selectionBrushes;
+            for (size_t x = 0u; x < NumSelectedBrushesPerAxis; ++x) {
+                for (size_t y = 0u; y < NumSelectedBrushesPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 480.0 - 8180.0, static_cast<FloatType>(y) * 480.0 - 8180.0, -8.0);
+                    selectionBrushes.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(80.0, 80.0, 48.0)), "texture")));
+                }
+            }
+            document->addNodes(selectionBrushes, document->parentForNodes());
+            document->select(selectionBrushes);
+
+            timeLambda([&]() {
+                document->selectTouching(false);
+            }, "select touching " + std::to_string(selectionBrushes.size()) + " brushes in a map with " + std::to_string(brushes.size()) + " brushes");
+
+            printf("Selected brushes: %zu\n", document->selectedNodes().brushCount());
+            ASSERT_EQ(4u * selectionBrushes.size(), document->selectedNodes().brushCount());
+        }
+
+        TEST_CASE("MapDocumentBenchmark.csgSubtract", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            // make a region of ~5k adjacent brushes
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::Node*> minuends;
+            for (size_t x = 0u; x < NumMinuendsPerAxis; ++x) {
+                for (size_t y = 0u; y < NumMinuendsPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 32.0, static_cast<FloatType>(y) * 32.0, 0.0);
+                    minuends.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 64.0)), "texture")));
+                }
+            }
+            document->addNodes(minuends, document->parentForNodes());
+
+            // make a grid of 100 subtrahends, each of which overlaps 9 minuends partially
+            std::vector<Model::Node*> subtrahendNodes;
+            for (size_t x = 0u; x < NumSubtrahendsPerAxis; ++x) {
+                for (size_t y = 0u; y < NumSubtrahendsPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 224.0 + 16.0, static_cast<FloatType>(y) * 224.0 + 16.0, 16.0);
+                    subtrahendNodes.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(64.0, 64.0, 64.0)), "texture")));
+                }
+            }
+            document->addNodes(subtrahendNodes, document->parentForNodes());
+
+            // compare with subtracting all subtrahends from every touched minuend without merging the fragments
+            const auto subtrahends = kdl::vec_transform(subtrahendNodes, [](const auto* node) { return &static_cast<const Model::BrushNode*>(node)->brush(); });
+            size_t unmergedFragmentCount = 0u;
+            size_t touchedMinuendCount = 0u;
+            timeLambda([&]() {
+                for (const auto* node : minuends) {
+                    const auto& minuend = static_cast<const Model::BrushNode*>(node)->brush();
+                    if (std::any_of(std::begin(subtrahends), std::end(subtrahends), [&](const auto* subtrahend) { return minuend.intersects(*subtrahend); })) {
+                        unmergedFragmentCount += minuend.subtract(*document->world(), document->worldBounds(), "texture", subtrahends).size();
+                        ++touchedMinuendCount;
+                    }
+                }
+            }, "subtract " + std::to_string(subtrahends.size()) + " brushes from " + std::to_string(minuends.size()) + " brushes serially without merging");
+
+            document->select(subtrahendNodes);
+            const auto brushCountBefore = document->currentLayer()->childCount();
+            timeLambda([&]() {
+                ASSERT_TRUE(document->csgSubtract(true));
+            }, "subtract " + std::to_string(subtrahends.size()) + " brushes from " + std::to_string(minuends.size()) + " brushes");
+
+            const auto fragmentCount = document->selectedNodes().brushCount();
+            printf("Touched minuends: %zu, fragments: %zu (%zu without merging)\n", touchedMinuendCount, fragmentCount, unmergedFragmentCount);
+            ASSERT_EQ(brushCountBefore - subtrahends.size() - touchedMinuendCount + fragmentCount, document->currentLayer()->childCount());
+            ASSERT_LE(fragmentCount, unmergedFragmentCount);
+        }
+
+        TEST_CASE("MapDocumentBenchmark.dragVertices", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            // make a grid of 400 brushes and select all of them
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::Node*> brushes;
+            std::map<vm::vec3, std::vector<Model::BrushNode*>> vertices;
+            for (size_t x = 0u; x < NumDraggedBrushesPerAxis; ++x) {
+                for (size_t y = 0u; y < NumDraggedBrushesPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 64.0, static_cast<FloatType>(y) * 64.0, 0.0);
+                    const auto max = min + vm::vec3(32.0, 32.0, 32.0);
+                    auto* brushNode = document->world()->createBrush(builder.createCuboid(vm::bbox3(min, max), "texture"));
+                    brushes.push_back(brushNode);
+                    vertices[max].push_back(brushNode);
+                }
+            }
+            document->addNodes(brushes, document->parentForNodes());
+            document->select(brushes);
+
+            // drag the top corner vertex of every brush upwards in small steps, as the vertex tool would do
+            const auto delta = vm::vec3(0.0, 0.0, 1.0);
+            size_t successfulSteps = 0u;
+            timeLambda([&]() {
+                const Transaction transaction(document, "Drag Vertices");
+                for (size_t i = 0u; i < NumDragSteps; ++i) {
+                    if (document->moveVertices(vertices, delta).success) {
+                        ++successfulSteps;
+                    }
+
+                    std::map<vm::vec3, std::vector<Model::BrushNode*>> movedVertices;
+                    for (const auto& entry : vertices) {
+                        movedVertices[entry.first + delta] = entry.second;
+                    }
+                    vertices = std::move(movedVertices);
+                }
+            }, "drag " + std::to_string(brushes.size()) + " vertices in " + std::to_string(NumDragSteps) + " steps");
+
+            ASSERT_EQ(NumDragSteps, successfulSteps);
+        }
+
+        TEST_CASE("MapDocumentBenchmark.moveBrushes", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            // make a grid of ~5k brushes and select all of them
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::Node*> brushes;
+            for (size_t x = 0u; x < NumMovedBrushesPerAxis; ++x) {
+                for (size_t y = 0u; y < NumMovedBrushesPerAxis; ++y) {
+                    const auto min = vm::vec3(static_cast<FloatType>(x) * 64.0, static_cast<FloatType>(y) * 64.0, 0.0);
+                    brushes.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture")));
+                }
+            }
+            document->addNodes(brushes, document->parentForNodes());
+            document->select(brushes);
+
+            const auto boundsBeforeMove = document->selectionBounds();
+
+            // move the brushes in small steps, as the move objects tool would do for every mouse move
+            const auto delta = vm::vec3(1.0, 0.0, 0.0);
+            document->startTransaction("Move Objects");
+            timeLambda([&]() {
+                ASSERT_TRUE(document->translateObjects(delta));
+            }, "first step of moving " + std::to_string(brushes.size()) + " brushes");
+
+            timeLambda([&]() {
+                for (size_t i = 1u; i < NumMoveSteps; ++i) {
+                    ASSERT_TRUE(document->translateObjects(delta));
+                }
+            }, "remaining " + std::to_string(NumMoveSteps - 1u) + " steps of moving " + std::to_string(brushes.size()) + " brushes");
+            document->commitTransaction();
+
+            ASSERT_EQ(boundsBeforeMove.translate(static_cast<FloatType>(NumMoveSteps) * delta), document->selectionBounds());
+
+            // the whole drag is undone at once
+            timeLambda([&]() {
+                document->undoCommand();
+            }, "undo moving " + std::to_string(brushes.size()) + " brushes");
+
+            ASSERT_EQ(boundsBeforeMove, document->selectionBounds());
+        }
+
+        /**
+         * Estimates the memory occupied by the geometry of the given brushes.
+         */
+        static size_t geometryMemory(const std::vector<Model::BrushNode*>& brushNodes) {
+            size_t result = 0u;
+            for (const auto* brushNode : brushNodes) {
+                if (!brushNode->hasReleasedGeometry()) {
+                    const auto& brush = brushNode->brush();
+                    result += sizeof(Model::BrushGeometry)
+                        + brush.vertexCount() * sizeof(Model::BrushVertex)
+                        + brush.edgeCount() * (sizeof(Model::BrushEdge) + 2u * sizeof(Model::BrushHalfEdge))
+                        + brush.faceCount() * sizeof(Model::BrushFaceGeometry);
+                }
+            }
+            return result;
+        }
+
+        TEST_CASE("MapDocumentBenchmark.releaseHiddenBrushGeometry", "[MapDocumentBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, vm::bbox3(16384.0), game);
+
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            auto* hiddenLayer = document->world()->createLayer("Hidden");
+            document->addNode(hiddenLayer, document->world());
+
+            // make a grid of ~50k brushes, 90% of which go into a layer that is hidden later on
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            std::vector<Model::BrushNode*> visibleBrushes;
+            std::vector<Model::BrushNode*> hiddenBrushes;
+            timeLambda([&]() {
+                for (size_t x = 0u; x < NumBrushesPerAxisInLayeredMap; ++x) {
+                    for (size_t y = 0u; y < NumBrushesPerAxisInLayeredMap; ++y) {
+                        const auto min = vm::vec3(static_cast<FloatType>(x) * 64.0 - 8192.0, static_cast<FloatType>(y) * 64.0 - 8192.0, 0.0);
+                        auto* brushNode = document->world()->createBrush(builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture"));
+                        if ((x * NumBrushesPerAxisInLayeredMap + y) % 10u == 0u) {
+                            visibleBrushes.push_back(brushNode);
+                        } else {
+                            hiddenBrushes.push_back(brushNode);
+                        }
+                    }
+                }
+                document->addNodes(kdl::vec_element_cast<Model::Node*>(visibleBrushes), document->world()->defaultLayer());
+                document->addNodes(kdl::vec_element_cast<Model::Node*>(hiddenBrushes), hiddenLayer);
+            }, "load " + std::to_string(visibleBrushes.size() + hiddenBrushes.size()) + " brushes");
+
+            document->hideLayers({ hiddenLayer });
+
+            const auto memoryBeforeRelease = geometryMemory(visibleBrushes) + geometryMemory(hiddenBrushes);
+
+            // release the geometry right away instead of waiting for the layer to be hidden for long
+            BrushGeometryReleaser releaser(document, std::chrono::milliseconds(0));
+            size_t releasedCount = 0u;
+            timeLambda([&]() {
+                releasedCount = releaser.triggerRelease();
+            }, "release geometry of " + std::to_string(hiddenBrushes.size()) + " hidden brushes");
+            ASSERT_EQ(hiddenBrushes.size(), releasedCount);
+
+            const auto memoryAfterRelease = geometryMemory(visibleBrushes) + geometryMemory(hiddenBrushes);
+            printf("Brush geometry memory: %zu KiB before, %zu KiB after releasing the hidden brushes\n", memoryBeforeRelease / 1024u, memoryAfterRelease / 1024u);
+
+            // saving only needs the face attributes, so it must not restore the released geometry
+            std::stringstream stream;
+            timeLambda([&]() {
+                IO::NodeWriter writer(*document->world(), stream);
+                writer.writeMap();
+            }, "save map with " + std::to_string(hiddenBrushes.size()) + " released brushes");
+            ASSERT_EQ(memoryAfterRelease, geometryMemory(visibleBrushes) + geometryMemory(hiddenBrushes));
+
+            // showing the layer and accessing the brushes, as the renderer would, restores their geometry
+            document->show({ hiddenLayer });
+            timeLambda([&]() {
+                for (const auto* brushNode : hiddenBrushes) {
+                    brushNode->brush();
+                }
+            }, "restore geometry of " + std::to_string(hiddenBrushes.size()) + " brushes");
+
+            ASSERT_EQ(memoryBeforeRelease, geometryMemory(visibleBrushes) + geometryMemory(hiddenBrushes));
+        }
+    }
+}
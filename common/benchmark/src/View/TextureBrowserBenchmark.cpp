@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "View/CellLayout.h"
+#include "View/TextureNameIndex.h"
+
+#include <kdl/string_compare.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <QVariant>
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t NumTextureNames = 50000u;
+
+        static std::vector<std::string> makeTextureNames() {
+            static const auto words = std::vector<std::string>{ "base", "wall", "floor", "metal", "rock", "trim", "light", "door", "sky", "water" };
+
+            auto result = std::vector<std::string>();
+            result.reserve(NumTextureNames);
+            for (size_t i = 0u; i < NumTextureNames; ++i) {
+                result.push_back("textures/" + words[i % words.size()] + "/" + words[(i / words.size()) % words.size()] + "_" + std::to_string(i));
+            }
+            return result;
+        }
+
+        TEST_CASE("TextureBrowserBenchmark.filter", "[TextureBrowserBenchmark]") {
+            const auto names = makeTextureNames();
+            // the keystrokes of typing a filter, each of which triggers a query
+            const auto patterns = std::vector<std::string>{ "m", "me", "met", "meta", "metal", "metal/", "metal/d", "metal/do", "metal/doo", "metal/door" };
+
+            size_t scanMatches = 0u;
+            timeLambda([&]() {
+                for (const auto& pattern : patterns) {
+                    scanMatches = 0u;
+                    for (const auto& name : names) {
+                        if (kdl::ci::str_contains(name, pattern)) {
+                            ++scanMatches;
+                        }
+                    }
+                }
+            }, "scan " + std::to_string(NumTextureNames) + " texture names for " + std::to_string(patterns.size()) + " patterns");
+
+            auto index = TextureNameIndex();
+            timeLambda([&]() {
+                index = TextureNameIndex(names);
+            }, "index " + std::to_string(NumTextureNames) + " texture names");
+
+            size_t indexMatches = 0u;
+            timeLambda([&]() {
+                for (const auto& pattern : patterns) {
+                    indexMatches = index.find(pattern).size();
+                }
+            }, "query index for " + std::to_string(patterns.size()) + " incrementally typed patterns");
+
+            timeLambda([&]() {
+                for (const auto& pattern : patterns) {
+                    auto freshIndex = index;
+                    indexMatches = freshIndex.find(pattern).size();
+                }
+            }, "query index for " + std::to_string(patterns.size()) + " unrelated patterns (includes copying the index)");
+
+            std::printf("Matches: %zu\n", indexMatches);
+            ASSERT_EQ(scanMatches, indexMatches);
+        }
+
+        TEST_CASE("TextureBrowserBenchmark.layout", "[TextureBrowserBenchmark]") {
+            const auto names = makeTextureNames();
+
+            auto layout = CellLayout();
+            layout.setOuterMargin(5.0f);
+            layout.setGroupMargin(5.0f);
+            layout.setRowMargin(15.0f);
+            layout.setCellMargin(10.0f);
+            layout.setTitleMargin(2.0f);
+            layout.setCellWidth(64.0f, 64.0f);
+            layout.setCellHeight(64.0f, 128.0f);
+            layout.setWidth(1024.0f);
+
+            timeLambda([&]() {
+                layout.clear();
+                for (size_t i = 0u; i < names.size(); ++i) {
+                    layout.addItem(QVariant::fromValue(i), 64.0f, 64.0f, layout.maxCellWidth(), 30.0f);
+                }
+            }, "lay out " + std::to_string(NumTextureNames) + " cells");
+
+            timeLambda([&]() {
+                layout.setWidth(800.0f);
+                layout.height();
+            }, "lay out " + std::to_string(NumTextureNames) + " cells again after resizing");
+
+            std::printf("Layout height: %f\n", static_cast<double>(layout.height()));
+        }
+    }
+}
@@ -28,8 +28,10 @@
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iosfwd>
+#include <iterator>
 #include <unordered_map>
 #include <vector>
 
@@ -484,18 +486,91 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects. The tree is built top down in one pass, which is
+         * considerably faster than inserting the objects one by one and yields a balanced tree.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates or if any bounds contain NaN
          */
         template <typename DataList, typename GetBounds>
         void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
             clear();
-            for (const U& object : objects) {
-                insert(getBounds(object), object);
+
+            std::vector<LeafNode*> leafs;
+            leafs.reserve(objects.size());
+
+            try {
+                for (const U& object : objects) {
+                    const Box bounds = getBounds(object);
+                    check(bounds);
+
+                    if (m_leafForData.find(object) != m_leafForData.end()) {
+                        throw NodeTreeException("Data already in tree");
+                    }
+
+                    auto* leaf = new LeafNode(bounds, object);
+                    leafs.push_back(leaf);
+                    m_leafForData[object] = leaf;
+                }
+            } catch (...) {
+                for (auto* leaf : leafs) {
+                    delete leaf;
+                }
+                m_leafForData.clear();
+                throw;
+            }
+
+            if (!leafs.empty()) {
+                m_root = buildSubtree(std::begin(leafs), std::end(leafs));
+            }
+        }
+    private:
+        using LeafIterator = typename std::vector<LeafNode*>::iterator;
+
+        /**
+         * Builds a balanced subtree containing the given leafs by recursively splitting them at the median of their
+         * centers along the axis in which the centers are spread the most.
+         *
+         * @param first the first leaf of the subtree
+         * @param last the end of the range of leafs
+         * @return the root of the subtree
+         */
+        static Node* buildSubtree(LeafIterator first, LeafIterator last) {
+            const auto count = std::distance(first, last);
+            assert(count > 0);
+
+            if (count == 1) {
+                return *first;
             }
+
+            auto centerMin = (*first)->bounds().center();
+            auto centerMax = centerMin;
+            for (auto it = std::next(first); it != last; ++it) {
+                const auto center = (*it)->bounds().center();
+                for (size_t i = 0; i < S; ++i) {
+                    centerMin[i] = std::min(centerMin[i], center[i]);
+                    centerMax[i] = std::max(centerMax[i], center[i]);
+                }
+            }
+
+            const auto spread = centerMax - centerMin;
+            size_t axis = 0;
+            for (size_t i = 1; i < S; ++i) {
+                if (spread[i] > spread[axis]) {
+                    axis = i;
+                }
+            }
+
+            const auto mid = std::next(first, count / 2);
+            std::nth_element(first, mid, last, [axis](const LeafNode* lhs, const LeafNode* rhs) {
+                return lhs->bounds().center()[axis] < rhs->bounds().center()[axis];
+            });
+
+            return new InnerNode(buildSubtree(first, mid), buildSubtree(mid, last));
         }
+    public:
 
         /**
          * Insert a node with the given bounds and data into this tree.
@@ -578,6 +653,7 @@ namespace TrenchBroom {
                 delete m_root;
                 m_root = nullptr;
             }
+            m_leafForData.clear();
         }
 
         /**
@@ -589,6 +665,15 @@ namespace TrenchBroom {
             return m_root == nullptr;
         }
 
+        /**
+         * Returns the number of data items in this tree.
+         *
+         * @return the number of data items
+         */
+        size_t size() const {
+            return m_leafForData.size();
+        }
+
         /**
          * Returns the bounds of all nodes in this tree.
          *
@@ -691,6 +776,36 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Finds every data item in this tree whose bounding box satisfies the given predicate and appends it to the
+         * given output iterator.
+         *
+         * Subtrees whose bounds do not satisfy the predicate are skipped, so the predicate must be monotonic: if it
+         * does not hold for a box, then it must not hold for any box contained in it either.
+         *
+         * @tparam P the predicate type, must accept a const reference to Box and return bool
+         * @tparam O the output iterator type
+         * @param predicate the predicate to test
+         * @param out the output iterator to append to
+         */
+        template <typename P, typename O>
+        void findMatching(const P& predicate, O out) const {
+            if (!empty()) {
+                LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return predicate(innerNode->bounds());
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (predicate(leaf->bounds())) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+                );
+                m_root->accept(visitor);
+            }
+        }
+
         /**
          * Prints a textual representation of this tree to the given output stream.
          *
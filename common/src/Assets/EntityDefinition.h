@@ -67,6 +67,13 @@ namespace TrenchBroom {
             void setIndex(size_t index);
 
             virtual EntityDefinitionType type() const = 0;
+
+            /**
+             * Returns a copy of this definition which shares the attribute definitions with this definition. The index
+             * and the usage count are not copied.
+             */
+            virtual EntityDefinition* clone() const = 0;
+
             const std::string& name() const;
             std::string shortName() const;
             std::string groupName() const;
@@ -96,6 +103,7 @@ namespace TrenchBroom {
             PointEntityDefinition(const std::string& name, const Color& color, const vm::bbox3& bounds, const std::string& description, const AttributeDefinitionList& attributeDefinitions, const ModelDefinition& modelDefinition);
 
             EntityDefinitionType type() const override;
+            EntityDefinition* clone() const override;
             const vm::bbox3& bounds() const;
             ModelSpecification model(const Model::EntityAttributes& attributes) const;
             ModelSpecification defaultModel() const;
@@ -106,6 +114,7 @@ namespace TrenchBroom {
         public:
             BrushEntityDefinition(const std::string& name, const Color& color, const std::string& description, const AttributeDefinitionList& attributeDefinitions);
             EntityDefinitionType type() const override;
+            EntityDefinition* clone() const override;
         };
     }
 }
@@ -20,6 +20,7 @@
 #include "EntityModel.h"
 
 #include "AABBTree.h"
+#include "Assets/EntityModelSimplifier.h"
 #include "Assets/TextureCollection.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/PrimType.h"
@@ -30,6 +31,7 @@
 #include <vecmath/bbox.h>
 #include <vecmath/intersection.h>
 
+#include <map>
 #include <string>
 
 namespace TrenchBroom {
@@ -52,7 +54,8 @@ namespace TrenchBroom {
         m_name(name),
         m_bounds(bounds),
         m_pitchType(pitchType),
-        m_spacialTree(std::make_unique<SpacialTree>()) {}
+        m_spacialTree(std::make_unique<SpacialTree>()),
+        m_spacialTreeValid(true) {}
 
         EntityModelLoadedFrame::~EntityModelLoadedFrame() = default;
 
@@ -75,6 +78,7 @@ namespace TrenchBroom {
         float EntityModelLoadedFrame::intersect(const vm::ray3f& ray) const {
             auto closestDistance = vm::nan<float>();
 
+            validateSpacialTree();
             const auto candidates = m_spacialTree->findIntersectors(ray);
             for (const TriNum triNum : candidates) {
                 const vm::vec3f& p1 = m_tris[triNum * 3 + 0];
@@ -86,7 +90,9 @@ namespace TrenchBroom {
             return closestDistance;
         }
 
-        void EntityModelLoadedFrame::addToSpacialTree(const std::vector<EntityModelVertex>& vertices, const Renderer::PrimType primType, const size_t index, const size_t count) {
+        void EntityModelLoadedFrame::addToSpacialTree(const EntityModelVertexArena::Range& vertices, const Renderer::PrimType primType, const size_t index, const size_t count) {
+            m_spacialTreeValid = false;
+
             switch (primType) {
                 case Renderer::PrimType::Points:
                 case Renderer::PrimType::Lines:
@@ -97,19 +103,12 @@ namespace TrenchBroom {
                     assert(count % 3 == 0);
                     m_tris.reserve(m_tris.size() + count);
                     for (size_t i = 0; i < count; i += 3) {
-                        vm::bbox3f::builder bounds;
                         const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
                         m_tris.push_back(p1);
                         m_tris.push_back(p2);
                         m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
@@ -120,18 +119,11 @@ namespace TrenchBroom {
 
                     const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
                     for (size_t i = 1; i < count - 1; ++i) {
-                        vm::bbox3f::builder bounds;
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
                         m_tris.push_back(p1);
                         m_tris.push_back(p2);
                         m_tris.push_back(p3);
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
@@ -141,15 +133,9 @@ namespace TrenchBroom {
                     assert(count > 2);
                     m_tris.reserve(m_tris.size() + (count - 2) * 3);
                     for (size_t i = 0; i < count-2; ++i) {
-                        vm::bbox3f::builder bounds;
                         const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
                         const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
                         const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-                        bounds.add(p1);
-                        bounds.add(p2);
-                        bounds.add(p3);
-
-                        const size_t triIndex = m_tris.size() / 3u;
                         if (i % 2 == 0) {
                             m_tris.push_back(p1);
                             m_tris.push_back(p2);
@@ -159,7 +145,6 @@ namespace TrenchBroom {
                             m_tris.push_back(p3);
                             m_tris.push_back(p2);
                         }
-                        m_spacialTree->insert(bounds.bounds(), triIndex);
                     }
                     break;
                 }
@@ -167,6 +152,26 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityModelLoadedFrame::validateSpacialTree() const {
+            if (m_spacialTreeValid) {
+                return;
+            }
+
+            std::vector<TriNum> triNums(m_tris.size() / 3u);
+            for (size_t i = 0u; i < triNums.size(); ++i) {
+                triNums[i] = i;
+            }
+
+            m_spacialTree->clearAndBuild(triNums, [&](const TriNum triNum) {
+                vm::bbox3f::builder bounds;
+                bounds.add(m_tris[triNum * 3 + 0]);
+                bounds.add(m_tris[triNum * 3 + 1]);
+                bounds.add(m_tris[triNum * 3 + 2]);
+                return bounds.bounds();
+            });
+            m_spacialTreeValid = true;
+        }
+
         // EntityModel::UnloadedFrame
 
         /**
@@ -212,14 +217,14 @@ namespace TrenchBroom {
          */
         class EntityModelMesh {
         private:
-            std::vector<EntityModelVertex> m_vertices;
+            EntityModelVertexArena::Range m_vertices;
         protected:
             /**
              * Creates a new frame mesh that uses the given vertices.
              *
-             * @param vertices the vertices
+             * @param vertices the vertices, stored in the model's vertex arena
              */
-            explicit EntityModelMesh(const std::vector<EntityModelVertex>& vertices) :
+            explicit EntityModelMesh(const EntityModelVertexArena::Range& vertices) :
             m_vertices(vertices) {}
         public:
             virtual ~EntityModelMesh() = default;
@@ -231,7 +236,7 @@ namespace TrenchBroom {
              * @return the renderer
              */
             std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(Assets::Texture* skin) {
-                const auto vertexArray = Renderer::VertexArray::ref(m_vertices);
+                const auto vertexArray = Renderer::VertexArray::ref(m_vertices.data(), m_vertices.size());
                 return doBuildRenderer(skin, vertexArray);
             }
         private:
@@ -261,13 +266,23 @@ namespace TrenchBroom {
              * @param vertices the vertices
              * @param indices the indices
              */
-            EntityModelIndexedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelIndices& indices) :
+            EntityModelIndexedMesh(EntityModelLoadedFrame& frame, const EntityModelVertexArena::Range& vertices, const EntityModelIndices& indices) :
             EntityModelMesh(vertices),
             m_indices(indices) {
                 m_indices.forEachPrimitive([&frame, &vertices](const Renderer::PrimType primType, const size_t index, const size_t count) {
                     frame.addToSpacialTree(vertices, primType, index, count);
                 });
-        }
+            }
+
+            /**
+             * Creates a new mesh with the given vertices and indices which is not used for hit testing.
+             *
+             * @param vertices the vertices
+             * @param indices the indices
+             */
+            EntityModelIndexedMesh(const EntityModelVertexArena::Range& vertices, const EntityModelIndices& indices) :
+            EntityModelMesh(vertices),
+            m_indices(indices) {}
         private:
             std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(Assets::Texture* skin, const Renderer::VertexArray& vertices) override {
                 const Renderer::TexturedIndexRangeMap texturedIndices(skin, m_indices);
@@ -291,24 +306,111 @@ namespace TrenchBroom {
              * @param vertices the vertices
              * @param indices the per texture indices
              */
-            EntityModelTexturedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelTexturedIndices& indices) :
+            EntityModelTexturedMesh(EntityModelLoadedFrame& frame, const EntityModelVertexArena::Range& vertices, const EntityModelTexturedIndices& indices) :
             EntityModelMesh(vertices),
             m_indices(indices) {
                 m_indices.forEachPrimitive([&frame, &vertices](const Assets::Texture* /* texture */, const Renderer::PrimType primType, const size_t index, const size_t count) {
                     frame.addToSpacialTree(vertices, primType, index, count);
                 });
             }
+
+            /**
+             * Creates a new mesh with the given vertices and per texture indices which is not used for hit testing.
+             *
+             * @param vertices the vertices
+             * @param indices the per texture indices
+             */
+            EntityModelTexturedMesh(const EntityModelVertexArena::Range& vertices, const EntityModelTexturedIndices& indices) :
+            EntityModelMesh(vertices),
+            m_indices(indices) {}
         private:
             std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(Assets::Texture* /* skin */, const Renderer::VertexArray& vertices) override {
                 return std::make_unique<Renderer::TexturedIndexRangeRenderer>(vertices, m_indices);
             }
         };
 
+        // EntityModel::LOD
+
+        /**
+         * Simplified meshes are only generated for meshes with at least this many triangles.
+         */
+        static constexpr size_t MinLodTriangleCount = 64u;
+
+        /**
+         * The number of grid cells per axis used when simplifying a mesh.
+         */
+        static constexpr size_t LodCellsPerAxis = 8u;
+
+        /**
+         * Simplifies the given triangle list. Returns an empty list if the given list is too small to be worth
+         * simplifying, or if simplifying it does not at least halve the number of triangles.
+         */
+        static std::vector<EntityModelVertex> simplifyLodTriangles(const std::vector<EntityModelVertex>& triangles) {
+            if (triangles.size() < 3u * MinLodTriangleCount) {
+                return {};
+            }
+
+            auto result = simplifyTriangles(triangles, LodCellsPerAxis);
+            if (2u * result.size() > triangles.size()) {
+                return {};
+            }
+            return result;
+        }
+
+        static std::unique_ptr<EntityModelMesh> buildLodMesh(EntityModelVertexArena& vertexArena, const std::vector<EntityModelVertex>& vertices, const EntityModelIndices& indices) {
+            std::vector<EntityModelVertex> triangles;
+            indices.forEachPrimitive([&](const Renderer::PrimType primType, const size_t index, const size_t count) {
+                appendTriangles(vertices, primType, index, count, triangles);
+            });
+
+            const auto lodVertices = simplifyLodTriangles(triangles);
+            if (lodVertices.empty()) {
+                return nullptr;
+            }
+
+            const auto lodIndices = EntityModelIndices(Renderer::PrimType::Triangles, 0u, lodVertices.size());
+            return std::make_unique<EntityModelIndexedMesh>(vertexArena.add(lodVertices), lodIndices);
+        }
+
+        static std::unique_ptr<EntityModelMesh> buildLodMesh(EntityModelVertexArena& vertexArena, const std::vector<EntityModelVertex>& vertices, const EntityModelTexturedIndices& indices) {
+            std::map<const Assets::Texture*, std::vector<EntityModelVertex>> trianglesPerTexture;
+            size_t triangleVertexCount = 0u;
+            indices.forEachPrimitive([&](const Assets::Texture* texture, const Renderer::PrimType primType, const size_t index, const size_t count) {
+                auto& triangles = trianglesPerTexture[texture];
+                const auto previousSize = triangles.size();
+                appendTriangles(vertices, primType, index, count, triangles);
+                triangleVertexCount += triangles.size() - previousSize;
+            });
+
+            if (triangleVertexCount < 3u * MinLodTriangleCount) {
+                return nullptr;
+            }
+
+            // the triangles of each texture are simplified separately so that they keep their texture
+            std::vector<EntityModelVertex> lodVertices;
+            EntityModelTexturedIndices lodIndices;
+            for (const auto& [texture, triangles] : trianglesPerTexture) {
+                const auto simplified = simplifyTriangles(triangles, LodCellsPerAxis);
+                if (!simplified.empty()) {
+                    lodIndices.add(texture, Renderer::PrimType::Triangles, lodVertices.size(), simplified.size());
+                    lodVertices.insert(std::end(lodVertices), std::begin(simplified), std::end(simplified));
+                }
+            }
+
+            if (lodVertices.empty() || 2u * lodVertices.size() > triangleVertexCount) {
+                return nullptr;
+            }
+
+            return std::make_unique<EntityModelTexturedMesh>(vertexArena.add(lodVertices), lodIndices);
+        }
+
         // EntityModel::Surface
 
-        EntityModelSurface::EntityModelSurface(const std::string& name, const size_t frameCount) :
+        EntityModelSurface::EntityModelSurface(const std::string& name, const size_t frameCount, EntityModelVertexArena& vertexArena) :
         m_name(name),
+        m_vertexArena(vertexArena),
         m_meshes(frameCount),
+        m_lodMeshes(frameCount),
         m_skins(std::make_unique<Assets::TextureCollection>()) {}
 
         EntityModelSurface::~EntityModelSurface() = default;
@@ -327,12 +429,14 @@ namespace TrenchBroom {
 
         void EntityModelSurface::addIndexedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelIndices& indices) {
             assert(frame.index() < frameCount());
-            m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(frame, vertices, indices);
+            m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(frame, m_vertexArena.add(vertices), indices);
+            m_lodMeshes[frame.index()] = buildLodMesh(m_vertexArena, vertices, indices);
         }
 
         void EntityModelSurface::addTexturedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelTexturedIndices& indices) {
             assert(frame.index() < frameCount());
-            m_meshes[frame.index()] = std::make_unique<EntityModelTexturedMesh>(frame, vertices, indices);
+            m_meshes[frame.index()] = std::make_unique<EntityModelTexturedMesh>(frame, m_vertexArena.add(vertices), indices);
+            m_lodMeshes[frame.index()] = buildLodMesh(m_vertexArena, vertices, indices);
         }
 
         void EntityModelSurface::addSkin(Assets::Texture* skin) {
@@ -370,11 +474,26 @@ namespace TrenchBroom {
             }
         }
 
+        bool EntityModelSurface::hasLodMesh(const size_t frameIndex) const {
+            return frameIndex < frameCount() && m_lodMeshes[frameIndex] != nullptr;
+        }
+
+        std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildLodRenderer(const size_t skinIndex, const size_t frameIndex) {
+            if (skinIndex >= skinCount() || !hasLodMesh(frameIndex)) {
+                return nullptr;
+            } else {
+                const auto& textures = m_skins->textures();
+                auto* skin = textures[skinIndex];
+                return m_lodMeshes[frameIndex]->buildRenderer(skin);
+            }
+        }
+
         // EntityModel
 
         EntityModel::EntityModel(const std::string& name, PitchType pitchType) :
         m_name(name),
         m_prepared(false),
+        m_vertexArena(std::make_unique<EntityModelVertexArena>()),
         m_pitchType(pitchType) {}
 
         std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildRenderer(const size_t skinIndex, const size_t frameIndex) const {
@@ -392,6 +511,25 @@ namespace TrenchBroom {
             }
         }
 
+        std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildLodRenderer(const size_t skinIndex, const size_t frameIndex) const {
+            bool hasLodMesh = false;
+            std::vector<std::unique_ptr<Renderer::TexturedIndexRangeRenderer>> renderers;
+            for (const auto& surface : m_surfaces) {
+                auto renderer = surface->hasLodMesh(frameIndex)
+                                ? surface->buildLodRenderer(skinIndex, frameIndex)
+                                : surface->buildRenderer(skinIndex, frameIndex);
+                if (renderer != nullptr) {
+                    hasLodMesh = hasLodMesh || surface->hasLodMesh(frameIndex);
+                    renderers.push_back(std::move(renderer));
+                }
+            }
+            if (!hasLodMesh) {
+                return nullptr;
+            } else {
+                return std::make_unique<Renderer::MultiTexturedIndexRangeRenderer>(std::move(renderers));
+            }
+        }
+
         vm::bbox3f EntityModel::bounds(const size_t frameIndex) const {
             if (frameIndex >= m_frames.size()) {
                 return vm::bbox3f(8.0f);
@@ -437,7 +575,7 @@ namespace TrenchBroom {
         }
 
         EntityModelSurface& EntityModel::addSurface(const std::string& name) {
-            m_surfaces.push_back(std::make_unique<EntityModelSurface>(name, frameCount()));
+            m_surfaces.push_back(std::make_unique<EntityModelSurface>(name, frameCount(), *m_vertexArena));
             return *m_surfaces.back();
         }
 
@@ -508,5 +646,9 @@ namespace TrenchBroom {
             }
             return nullptr;
         }
+
+        const EntityModelVertexArena& EntityModel::vertexArena() const {
+            return *m_vertexArena;
+        }
     }
 }
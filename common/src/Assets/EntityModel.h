@@ -21,6 +21,7 @@
 #define TrenchBroom_EntityModel
 
 #include "Assets/EntityModel_Forward.h"
+#include "Assets/EntityModelVertexArena.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
@@ -117,7 +118,11 @@ namespace TrenchBroom {
             std::vector<vm::vec3f> m_tris;
             using TriNum = size_t;
             using SpacialTree = AABBTree<float, 3, TriNum>;
-            std::unique_ptr<SpacialTree> m_spacialTree;
+            /**
+             * Built from m_tris in bulk when this frame is hit tested for the first time after triangles were added.
+             */
+            mutable std::unique_ptr<SpacialTree> m_spacialTree;
+            mutable bool m_spacialTreeValid;
         public:
             /**
              * Creates a new frame with the given index, name and bounds.
@@ -144,7 +149,9 @@ namespace TrenchBroom {
              * @param index the index of the first primitive's first vertex in the given vertex array
              * @param count the number of vertices that make up the primitive(s)
              */
-            void addToSpacialTree(const std::vector<EntityModelVertex>& vertices, Renderer::PrimType primType, size_t index, size_t count);
+            void addToSpacialTree(const EntityModelVertexArena::Range& vertices, Renderer::PrimType primType, size_t index, size_t count);
+        private:
+            void validateSpacialTree() const;
         };
 
         class EntityModelUnloadedFrame;
@@ -164,7 +171,9 @@ namespace TrenchBroom {
         class EntityModelSurface {
         private:
             std::string m_name;
+            EntityModelVertexArena& m_vertexArena;
             std::vector<std::unique_ptr<EntityModelMesh>> m_meshes;
+            std::vector<std::unique_ptr<EntityModelMesh>> m_lodMeshes;
             std::unique_ptr<TextureCollection> m_skins;
         public:
             /**
@@ -172,8 +181,9 @@ namespace TrenchBroom {
              *
              * @param name the surface's name
              * @param frameCount the number of frames
+             * @param vertexArena the arena that stores the vertices of the surface's meshes
              */
-            explicit EntityModelSurface(const std::string& name, size_t frameCount);
+            EntityModelSurface(const std::string& name, size_t frameCount, EntityModelVertexArena& vertexArena);
 
             ~EntityModelSurface();
 
@@ -201,7 +211,8 @@ namespace TrenchBroom {
             void setTextureMode(int minFilter, int magFilter);
 
             /**
-             * Adds a new mesh to this surface.
+             * Adds a new mesh to this surface. If the mesh is sufficiently complex, a simplified mesh is generated
+             * for rendering the frame at a distance.
              *
              * @param frame the frame which the mesh belongs to
              * @param vertices the mesh vertices
@@ -210,7 +221,8 @@ namespace TrenchBroom {
             void addIndexedMesh(EntityModelLoadedFrame& frame, const std::vector<EntityModelVertex>& vertices, const EntityModelIndices& indices);
 
             /**
-             * Adds a new multitextured mesh to this surface.
+             * Adds a new multitextured mesh to this surface. If the mesh is sufficiently complex, a simplified mesh
+             * is generated for rendering the frame at a distance.
              *
              * @param frame the frame which the mesh belongs to
              * @param vertices the mesh vertices
@@ -256,6 +268,23 @@ namespace TrenchBroom {
             Texture* skin(size_t index) const;
 
             std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(size_t skinIndex, size_t frameIndex);
+
+            /**
+             * Indicates whether a simplified mesh was generated for the given frame.
+             *
+             * @param frameIndex the index of the frame
+             * @return true if this surface has a simplified mesh for the given frame
+             */
+            bool hasLodMesh(size_t frameIndex) const;
+
+            /**
+             * Creates a renderer for the simplified mesh of the given frame.
+             *
+             * @param skinIndex the index of the skin to use
+             * @param frameIndex the index of the frame to render
+             * @return the renderer, or null if there is no simplified mesh for the given frame
+             */
+            std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildLodRenderer(size_t skinIndex, size_t frameIndex);
         };
 
         /**
@@ -267,6 +296,7 @@ namespace TrenchBroom {
         private:
             std::string m_name;
             bool m_prepared;
+            std::unique_ptr<EntityModelVertexArena> m_vertexArena;
             std::vector<std::unique_ptr<EntityModelFrame>> m_frames;
             std::vector<std::unique_ptr<EntityModelSurface>> m_surfaces;
             PitchType m_pitchType;
@@ -287,6 +317,16 @@ namespace TrenchBroom {
              */
             std::unique_ptr<Renderer::TexturedRenderer> buildRenderer(size_t skinIndex, size_t frameIndex) const;
 
+            /**
+             * Creates a renderer to render the simplified meshes of the given frame using the skin with the given index.
+             * Surfaces that do not have a simplified mesh for the given frame are rendered using their full mesh.
+             *
+             * @param skinIndex the index of the skin to use
+             * @param frameIndex the index of the frame to render
+             * @return the renderer, or null if none of the surfaces has a simplified mesh for the given frame
+             */
+            std::unique_ptr<Renderer::TexturedRenderer> buildLodRenderer(size_t skinIndex, size_t frameIndex) const;
+
             /**
              * Returns the bounds of the given frame of this model.
              *
@@ -412,6 +452,11 @@ namespace TrenchBroom {
              * @return the surface with the given name or null if no such surface was found
              */
             const EntityModelSurface* surface(const std::string& name) const;
+
+            /**
+             * Returns the arena which stores the vertices of all meshes of this model.
+             */
+            const EntityModelVertexArena& vertexArena() const;
         };
     }
 }
@@ -43,6 +43,7 @@ namespace TrenchBroom {
 
         void EntityModelManager::clear() {
             m_renderers.clear();
+            m_lodRenderers.clear();
             m_models.clear();
             m_rendererMismatches.clear();
             m_modelMismatches.clear();
@@ -96,6 +97,32 @@ namespace TrenchBroom {
             }
         }
 
+        Renderer::TexturedRenderer* EntityModelManager::lodRenderer(const Assets::ModelSpecification& spec) const {
+            // this also loads the model if necessary
+            if (renderer(spec) == nullptr) {
+                return nullptr;
+            }
+
+            auto it = m_lodRenderers.find(spec);
+            if (it != std::end(m_lodRenderers)) {
+                return it->second.get();
+            }
+
+            auto* entityModel = safeGetModel(spec.path);
+            assert(entityModel != nullptr);
+
+            // cache null renderers too so that we don't try again
+            const auto [pos, success] = m_lodRenderers.insert({ spec, entityModel->buildLodRenderer(spec.skinIndex, spec.frameIndex) });
+            assert(success); unused(success);
+
+            auto* result = pos->second.get();
+            if (result != nullptr) {
+                m_unpreparedRenderers.push_back(result);
+                m_logger.debug() << "Constructed entity model LOD renderer for " << spec;
+            }
+            return result;
+        }
+
         const EntityModelFrame* EntityModelManager::frame(const Assets::ModelSpecification& spec) const {
             auto* model = this->safeGetModel(spec.path);
             if (model == nullptr) {
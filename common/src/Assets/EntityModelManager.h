@@ -70,6 +70,7 @@ namespace TrenchBroom {
             mutable ModelMismatches m_modelMismatches;
             mutable RendererCache m_renderers;
             mutable RendererMismatches m_rendererMismatches;
+            mutable RendererCache m_lodRenderers;
 
             mutable ModelList m_unpreparedModels;
             mutable RendererList m_unpreparedRenderers;
@@ -83,6 +84,16 @@ namespace TrenchBroom {
             void setLoader(const IO::EntityModelLoader* loader);
             Renderer::TexturedRenderer* renderer(const ModelSpecification& spec) const;
 
+            /**
+             * Returns a renderer for the simplified meshes of the given model specification, which can be used to
+             * render the model at a distance.
+             *
+             * @param spec the model specification
+             * @return the renderer, or null if there is no renderer for the given specification or if the model has no
+             * simplified meshes
+             */
+            Renderer::TexturedRenderer* lodRenderer(const ModelSpecification& spec) const;
+
             const EntityModelFrame* frame(const ModelSpecification& spec) const;
         private:
             EntityModel* model(const IO::Path& path) const;
@@ -0,0 +1,157 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityModelSimplifier.h"
+
+#include "Ensure.h"
+#include "Macros.h"
+#include "Renderer/GLVertex.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <set>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Assets {
+        void appendTriangles(const std::vector<EntityModelVertex>& vertices, const Renderer::PrimType primType, const size_t index, const size_t count, std::vector<EntityModelVertex>& triangles) {
+            switch (primType) {
+                case Renderer::PrimType::Points:
+                case Renderer::PrimType::Lines:
+                case Renderer::PrimType::LineStrip:
+                case Renderer::PrimType::LineLoop:
+                    break;
+                case Renderer::PrimType::Triangles:
+                    assert(count % 3 == 0);
+                    triangles.insert(std::end(triangles), std::next(std::begin(vertices), static_cast<std::ptrdiff_t>(index)), std::next(std::begin(vertices), static_cast<std::ptrdiff_t>(index + count)));
+                    break;
+                case Renderer::PrimType::Polygon:
+                case Renderer::PrimType::TriangleFan:
+                    assert(count > 2);
+                    for (size_t i = 1; i < count - 1; ++i) {
+                        triangles.push_back(vertices[index]);
+                        triangles.push_back(vertices[index + i]);
+                        triangles.push_back(vertices[index + i + 1]);
+                    }
+                    break;
+                case Renderer::PrimType::Quads:
+                case Renderer::PrimType::QuadStrip:
+                case Renderer::PrimType::TriangleStrip:
+                    assert(count > 2);
+                    for (size_t i = 0; i < count - 2; ++i) {
+                        triangles.push_back(vertices[index + i]);
+                        if (i % 2 == 0) {
+                            triangles.push_back(vertices[index + i + 1]);
+                            triangles.push_back(vertices[index + i + 2]);
+                        } else {
+                            triangles.push_back(vertices[index + i + 2]);
+                            triangles.push_back(vertices[index + i + 1]);
+                        }
+                    }
+                    break;
+                switchDefault();
+            }
+        }
+
+        namespace {
+            struct Cluster {
+                vm::vec3f positionSum;
+                size_t vertexCount;
+                vm::vec2f texCoords;
+            };
+
+            size_t cellIndex(const float value, const float min, const float size, const size_t cellsPerAxis) {
+                if (size <= 0.0f) {
+                    return 0u;
+                }
+                const auto cell = static_cast<size_t>(std::max(0.0f, (value - min) / size * static_cast<float>(cellsPerAxis)));
+                return std::min(cell, cellsPerAxis - 1u);
+            }
+        }
+
+        std::vector<EntityModelVertex> simplifyTriangles(const std::vector<EntityModelVertex>& triangles, const size_t cellsPerAxis) {
+            ensure(cellsPerAxis > 0u, "cellsPerAxis must be greater than 0");
+            assert(triangles.size() % 3u == 0u);
+
+            if (triangles.empty()) {
+                return {};
+            }
+
+            vm::bbox3f::builder boundsBuilder;
+            for (const auto& vertex : triangles) {
+                boundsBuilder.add(Renderer::getVertexComponent<0>(vertex));
+            }
+            const auto bounds = boundsBuilder.bounds();
+            const auto size = bounds.size();
+
+            // assign every vertex to a cluster
+            std::vector<Cluster> clusters;
+            std::unordered_map<size_t, size_t> clusterForCell;
+            std::vector<size_t> clusterForVertex;
+            clusterForVertex.reserve(triangles.size());
+
+            for (const auto& vertex : triangles) {
+                const auto& position = Renderer::getVertexComponent<0>(vertex);
+                const auto x = cellIndex(position.x(), bounds.min.x(), size.x(), cellsPerAxis);
+                const auto y = cellIndex(position.y(), bounds.min.y(), size.y(), cellsPerAxis);
+                const auto z = cellIndex(position.z(), bounds.min.z(), size.z(), cellsPerAxis);
+                const auto cell = (x * cellsPerAxis + y) * cellsPerAxis + z;
+
+                const auto [it, inserted] = clusterForCell.emplace(cell, clusters.size());
+                if (inserted) {
+                    clusters.push_back({ position, 1u, Renderer::getVertexComponent<1>(vertex) });
+                } else {
+                    auto& cluster = clusters[it->second];
+                    cluster.positionSum = cluster.positionSum + position;
+                    ++cluster.vertexCount;
+                }
+                clusterForVertex.push_back(it->second);
+            }
+
+            // keep the triangles whose corners are in distinct clusters, and drop duplicates
+            std::set<std::array<size_t, 3>> visited;
+            std::vector<EntityModelVertex> result;
+            for (size_t i = 0u; i < clusterForVertex.size(); i += 3u) {
+                std::array<size_t, 3> corners = { clusterForVertex[i], clusterForVertex[i + 1u], clusterForVertex[i + 2u] };
+                if (corners[0] == corners[1] || corners[0] == corners[2] || corners[1] == corners[2]) {
+                    continue;
+                }
+
+                // rotate the smallest index to the front so that equal triangles compare equal regardless of their
+                // first vertex, but keep the winding order
+                std::rotate(std::begin(corners), std::min_element(std::begin(corners), std::end(corners)), std::end(corners));
+                if (!visited.insert(corners).second) {
+                    continue;
+                }
+
+                for (const auto index : corners) {
+                    const auto& cluster = clusters[index];
+                    result.emplace_back(cluster.positionSum / static_cast<float>(cluster.vertexCount), cluster.texCoords);
+                }
+            }
+
+            return result;
+        }
+    }
+}
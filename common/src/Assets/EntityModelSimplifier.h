@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityModelSimplifier
+#define TrenchBroom_EntityModelSimplifier
+
+#include "Assets/EntityModel_Forward.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        enum class PrimType;
+    }
+
+    namespace Assets {
+        /**
+         * Appends the triangles that make up the given range of primitives to the given triangle list. Every three
+         * consecutive vertices in the triangle list form one triangle. Points and lines are ignored.
+         *
+         * @param vertices the vertices
+         * @param primType the primitive type
+         * @param index the index of the first primitive's first vertex in the given vertex array
+         * @param count the number of vertices that make up the primitive(s)
+         * @param triangles the triangle list to append to
+         */
+        void appendTriangles(const std::vector<EntityModelVertex>& vertices, Renderer::PrimType primType, size_t index, size_t count, std::vector<EntityModelVertex>& triangles);
+
+        /**
+         * Simplifies the given triangle list by vertex clustering. The bounding box of the triangles is divided into a
+         * grid of cells, and all vertices within a cell are merged into one vertex located at their average position.
+         * The merged vertex uses the texture coordinates of the first vertex in the cell. Triangles which become
+         * degenerate or duplicate are removed.
+         *
+         * @param triangles the triangle list to simplify, every three consecutive vertices form one triangle
+         * @param cellsPerAxis the number of grid cells along each axis, must be greater than 0
+         * @return the simplified triangle list
+         */
+        std::vector<EntityModelVertex> simplifyTriangles(const std::vector<EntityModelVertex>& triangles, size_t cellsPerAxis);
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelSimplifier) */
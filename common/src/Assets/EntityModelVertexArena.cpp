@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityModelVertexArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace Assets {
+        EntityModelVertexArena::Range::Range() :
+        m_vertices(nullptr),
+        m_count(0u) {}
+
+        EntityModelVertexArena::Range::Range(const EntityModelVertex* vertices, const size_t count) :
+        m_vertices(vertices),
+        m_count(count) {}
+
+        const EntityModelVertex* EntityModelVertexArena::Range::data() const {
+            return m_vertices;
+        }
+
+        size_t EntityModelVertexArena::Range::size() const {
+            return m_count;
+        }
+
+        bool EntityModelVertexArena::Range::empty() const {
+            return m_count == 0u;
+        }
+
+        const EntityModelVertex* EntityModelVertexArena::Range::begin() const {
+            return m_vertices;
+        }
+
+        const EntityModelVertex* EntityModelVertexArena::Range::end() const {
+            return m_vertices + m_count;
+        }
+
+        const EntityModelVertex& EntityModelVertexArena::Range::operator[](const size_t index) const {
+            assert(index < m_count);
+            return m_vertices[index];
+        }
+
+        EntityModelVertexArena::EntityModelVertexArena() :
+        m_vertexCount(0u),
+        m_capacity(0u) {}
+
+        EntityModelVertexArena::Range EntityModelVertexArena::add(const std::vector<EntityModelVertex>& vertices) {
+            if (vertices.empty()) {
+                return Range();
+            }
+
+            if (m_blocks.empty() || m_blocks.back().capacity() - m_blocks.back().size() < vertices.size()) {
+                const auto blockSize = std::max({ vertices.size(), m_capacity, MinBlockSize });
+                m_blocks.emplace_back().reserve(blockSize);
+                m_capacity += m_blocks.back().capacity();
+            }
+
+            auto& block = m_blocks.back();
+            const auto offset = block.size();
+
+            // does not reallocate since the block has enough capacity
+            block.insert(std::end(block), std::begin(vertices), std::end(vertices));
+            m_vertexCount += vertices.size();
+
+            return Range(block.data() + offset, vertices.size());
+        }
+
+        size_t EntityModelVertexArena::vertexCount() const {
+            return m_vertexCount;
+        }
+
+        size_t EntityModelVertexArena::blockCount() const {
+            return m_blocks.size();
+        }
+
+        size_t EntityModelVertexArena::sizeInBytes() const {
+            return m_capacity * sizeof(EntityModelVertex);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityModelVertexArena
+#define TrenchBroom_EntityModelVertexArena
+
+#include "Assets/EntityModel_Forward.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * Stores the vertices of all meshes of an entity model in a few large blocks instead of one vector per mesh.
+         *
+         * Blocks are never reallocated, so the vertices added to the arena keep their addresses until the arena is
+         * destroyed. This allows the meshes and their renderers to reference the vertices directly. If a block is
+         * full, a new block is allocated which is at least as large as all previous blocks combined.
+         */
+        class EntityModelVertexArena {
+        public:
+            /**
+             * The minimum number of vertices in a block.
+             */
+            static constexpr size_t MinBlockSize = 256u;
+
+            /**
+             * A contiguous range of vertices in the arena.
+             */
+            class Range {
+            private:
+                const EntityModelVertex* m_vertices;
+                size_t m_count;
+            public:
+                Range();
+                Range(const EntityModelVertex* vertices, size_t count);
+
+                const EntityModelVertex* data() const;
+                size_t size() const;
+                bool empty() const;
+
+                const EntityModelVertex* begin() const;
+                const EntityModelVertex* end() const;
+
+                const EntityModelVertex& operator[](size_t index) const;
+            };
+        private:
+            std::vector<std::vector<EntityModelVertex>> m_blocks;
+            size_t m_vertexCount;
+            size_t m_capacity;
+        public:
+            EntityModelVertexArena();
+
+            /**
+             * Copies the given vertices into the arena.
+             *
+             * @param vertices the vertices to copy
+             * @return the range of the copied vertices
+             */
+            Range add(const std::vector<EntityModelVertex>& vertices);
+
+            /**
+             * Returns the number of vertices stored in the arena.
+             */
+            size_t vertexCount() const;
+
+            /**
+             * Returns the number of blocks allocated by the arena.
+             */
+            size_t blockCount() const;
+
+            /**
+             * Returns the number of bytes allocated by the arena, including unused space at the end of its blocks.
+             */
+            size_t sizeInBytes() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelVertexArena) */
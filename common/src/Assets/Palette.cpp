@@ -28,11 +28,79 @@
 
 #include <kdl/string_format.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace TrenchBroom {
     namespace Assets {
-        Palette::Data::Data(std::vector<unsigned char>&& data) :
-        m_data(std::move(data)) {
-            ensure(!m_data.empty(), "palette is empty");
+        Palette::Data::Data(std::vector<unsigned char>&& data) {
+            ensure(!data.empty(), "palette is empty");
+
+            const auto colorCount = std::min(data.size() / 3u, m_opaqueTable.size());
+            for (size_t i = 0u; i < m_opaqueTable.size(); ++i) {
+                unsigned char rgba[4] = { 0x00, 0x00, 0x00, 0xFF };
+                if (i < colorCount) {
+                    rgba[0] = data[i * 3u + 0u];
+                    rgba[1] = data[i * 3u + 1u];
+                    rgba[2] = data[i * 3u + 2u];
+                }
+
+                std::memcpy(&m_opaqueTable[i], rgba, sizeof(rgba));
+                rgba[3] = i == 255u ? 0x00 : 0xFF;
+                std::memcpy(&m_index255TransparentTable[i], rgba, sizeof(rgba));
+            }
+        }
+
+        bool Palette::Data::indexedToRgba(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
+            const auto& table = transparency == PaletteTransparency::Index255Transparent ? m_index255TransparentTable : m_opaqueTable;
+
+            // Instead of summing up the colors per pixel, we count how often each index occurs and compute the average
+            // color and the transparency from the counts. Consecutive pixels are counted in separate histograms so
+            // that runs of equal indices don't stall on incrementing the same counter.
+            std::array<std::array<uint32_t, 256>, 4> histograms{};
+
+            size_t i = 0u;
+            for (; i + 4u <= pixelCount; i += 4u) {
+                const auto i0 = indexedImage[i + 0u];
+                const auto i1 = indexedImage[i + 1u];
+                const auto i2 = indexedImage[i + 2u];
+                const auto i3 = indexedImage[i + 3u];
+
+                const uint32_t pixels[4] = { table[i0], table[i1], table[i2], table[i3] };
+                std::memcpy(rgbaImage + i * 4u, pixels, sizeof(pixels));
+
+                ++histograms[0][i0];
+                ++histograms[1][i1];
+                ++histograms[2][i2];
+                ++histograms[3][i3];
+            }
+            for (; i < pixelCount; ++i) {
+                const auto index = indexedImage[i];
+                std::memcpy(rgbaImage + i * 4u, &table[index], sizeof(uint32_t));
+                ++histograms[0][index];
+            }
+
+            uint64_t sum[3] = { 0u, 0u, 0u };
+            for (size_t index = 0u; index < table.size(); ++index) {
+                const auto count = static_cast<uint64_t>(histograms[0][index]) + histograms[1][index] + histograms[2][index] + histograms[3][index];
+
+                unsigned char rgba[4];
+                std::memcpy(rgba, &table[index], sizeof(rgba));
+                for (size_t j = 0u; j < 3u; ++j) {
+                    sum[j] += count * rgba[j];
+                }
+            }
+
+            for (size_t j = 0u; j < 3u; ++j) {
+                averageColor[j] = pixelCount > 0u ? static_cast<float>(static_cast<double>(sum[j]) / static_cast<double>(pixelCount) / static_cast<double>(0xFF)) : 0.0f;
+            }
+            averageColor[3] = 1.0f;
+
+            if (transparency == PaletteTransparency::Index255Transparent) {
+                return histograms[0][255] + histograms[1][255] + histograms[2][255] + histograms[3][255] > 0u;
+            } else {
+                return false;
+            }
         }
 
         Palette::Palette() {}
@@ -88,5 +156,9 @@ namespace TrenchBroom {
         bool Palette::initialized() const {
             return m_data.get() != nullptr;
         }
+
+        bool Palette::indexedToRgba(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
+            return m_data->indexedToRgba(indexedImage, pixelCount, rgbaImage, transparency, averageColor);
+        }
     }
 }
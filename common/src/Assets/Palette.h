@@ -23,7 +23,9 @@
 #include "Color.h"
 #include "IO/Reader.h"
 
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -42,10 +44,30 @@ namespace TrenchBroom {
         private:
             class Data {
             private:
-                std::vector<unsigned char> m_data;
+                /**
+                 * RGBA lookup tables with one entry per palette index. The bytes of each entry are stored in the same
+                 * order as the pixels in an RGBA image, so an entry can be copied to the image as a whole. Indices that
+                 * are not covered by the palette data map to black.
+                 */
+                std::array<uint32_t, 256> m_opaqueTable;
+                std::array<uint32_t, 256> m_index255TransparentTable;
             public:
                 Data(std::vector<unsigned char>&& data);
 
+                /**
+                 * Converts the given index buffer to an RGBA image. The average color and the transparency are
+                 * computed in the same pass.
+                 *
+                 * @param indexedImage the index buffer, must contain at least pixelCount indices
+                 * @param pixelCount the number of pixels
+                 * @param rgbaImage the pixel buffer, must have room for at least pixelCount * 4 bytes
+                 * @param transparency controls whether or not the given index buffer contains a transparent index
+                 * @param averageColor output parameter for the average color of the generated pixel buffer
+                 * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
+                 *     indicates that the image is opaque
+                 */
+                bool indexedToRgba(const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage, PaletteTransparency transparency, Color& averageColor) const;
+
                 /**
                  * Converts the given index buffer to an RGBA image.
                  *
@@ -61,12 +83,15 @@ namespace TrenchBroom {
                  */
                 template <typename IndexT, typename ColorT>
                 bool indexedToRgba(const std::vector<IndexT>& indexedImage, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    auto reader = IO::Reader::from(&indexedImage[0], &indexedImage[0] + pixelCount);
-                    return indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
+                    static_assert(sizeof(IndexT) == 1 && sizeof(ColorT) == 1, "indices and color components must be bytes");
+                    assert(indexedImage.size() >= pixelCount);
+                    assert(rgbaImage.size() >= pixelCount * 4);
+                    return indexedToRgba(reinterpret_cast<const unsigned char*>(indexedImage.data()), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.data()), transparency, averageColor);
                 }
 
                 /**
-                 * Converts the given index buffer to an RGBA image.
+                 * Converts the given index buffer to an RGBA image. The indices are read from the given reader at once,
+                 * and the reader is advanced past them.
                  *
                  * @tparam ColorT the pixel type
                  * @param reader the index buffer reader
@@ -76,37 +101,18 @@ namespace TrenchBroom {
                  * @param averageColor output parameter for the average color of the generated pixel buffer
                  * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
                  *     indicates that the image is opaque
+                 *
+                 * @throw ReaderException if the reader does not contain pixelCount more bytes
                  */
                 template <typename ColorT>
                 bool indexedToRgba(IO::Reader& reader, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    double avg[3];
-                    avg[0] = avg[1] = avg[2] = 0.0;
-                    bool hasTransparency = false;
-                    for (size_t i = 0; i < pixelCount; ++i) {
-                        const size_t index = reader.readSize<unsigned char>();
-                        assert(index < m_data.size());
-                        for (size_t j = 0; j < 3; ++j) {
-                            const unsigned char c = m_data[index * 3 + j];
-                            rgbaImage[i * 4 + j] = c;
-                            avg[j] += static_cast<double>(c);
-                        }
-                        switch (transparency) {
-                            case PaletteTransparency::Opaque:
-                                rgbaImage[i * 4 + 3] = 0xFF;
-                                break;
-                            case PaletteTransparency::Index255Transparent:
-                                rgbaImage[i * 4 + 3] = static_cast<ColorT>((index == 255) ? 0x00 : 0xFF);
-                                hasTransparency |= (index == 255);
-                                break;
-                        }
-                    }
-
-                    for (size_t i = 0; i < 3; ++i) {
-                        averageColor[i] = static_cast<float>(avg[i] / static_cast<double>(pixelCount) / static_cast<double>(0xFF));
-                    }
-                    averageColor[3] = 1.0f;
-
-                    return hasTransparency;
+                    static_assert(sizeof(ColorT) == 1, "color components must be bytes");
+                    assert(rgbaImage.size() >= pixelCount * 4);
+
+                    // buffering only copies the indices if the reader is not backed by memory
+                    const auto indexedImage = reader.subReaderFromCurrent(pixelCount).buffer();
+                    reader.seekForward(pixelCount);
+                    return indexedToRgba(reinterpret_cast<const unsigned char*>(indexedImage.begin()), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.data()), transparency, averageColor);
                 }
             };
 
@@ -124,6 +130,20 @@ namespace TrenchBroom {
 
             bool initialized() const;
 
+            /**
+             * Converts the given index buffer to an RGBA image. The average color and the transparency are computed in
+             * the same pass.
+             *
+             * @param indexedImage the index buffer, must contain at least pixelCount indices
+             * @param pixelCount the number of pixels
+             * @param rgbaImage the pixel buffer, must have room for at least pixelCount * 4 bytes
+             * @param transparency controls whether or not the given index buffer contains a transparent index
+             * @param averageColor output parameter for the average color of the generated pixel buffer
+             * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
+             *     indicates that the image is opaque
+             */
+            bool indexedToRgba(const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage, PaletteTransparency transparency, Color& averageColor) const;
+
             /**
              * Converts the given index buffer to an RGBA image.
              *
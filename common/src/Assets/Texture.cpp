@@ -22,7 +22,7 @@
 #include "Assets/TextureCollection.h"
 #include "Renderer/GL.h"
 
-#include <algorithm> // for std::max
+#include <algorithm> // for std::max, std::min
 #include <cassert>
 
 namespace TrenchBroom {
@@ -145,6 +145,10 @@ namespace TrenchBroom {
             m_culling = culling;
         }
 
+        const TextureBlendFunc& Texture::blendFunc() const {
+            return m_blendFunc;
+        }
+
         void Texture::setBlendFunc(GLenum srcFactor, GLenum destFactor) {
             m_blendFunc.enable = TextureBlendFunc::Enable::UseFactors;
             m_blendFunc.srcFactor = srcFactor;
@@ -186,6 +190,23 @@ namespace TrenchBroom {
             return m_textureId != 0;
         }
 
+        void Texture::generateMips() {
+            if (!isPrepared() && m_type != TextureType::Masked && m_buffers.size() == 1u) {
+                Assets::generateMips(m_buffers, m_width, m_height, m_format);
+            }
+        }
+
+        size_t Texture::uploadSize() const {
+            // Upload only the first mipmap for masked textures, see prepare().
+            const auto mipmapsToUpload = (m_type == TextureType::Masked) ? std::min(size_t(1), m_buffers.size()) : m_buffers.size();
+
+            size_t result = 0u;
+            for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                result += m_buffers[j].size();
+            }
+            return result;
+        }
+
         void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter) {
             assert(textureId > 0);
             assert(m_textureId == 0);
@@ -229,7 +250,8 @@ namespace TrenchBroom {
                                           0, m_format, GL_UNSIGNED_BYTE, data));
                 }
 
-                m_buffers.clear();
+                // release the memory right away instead of waiting for the texture to be destroyed
+                BufferList().swap(m_buffers);
                 m_textureId = textureId;
             }
         }
@@ -124,6 +124,7 @@ namespace TrenchBroom {
             TextureCulling culling() const;
             void setCulling(TextureCulling culling);
 
+            const TextureBlendFunc& blendFunc() const;
             void setBlendFunc(GLenum srcFactor, GLenum destFactor);
             void disableBlend();
 
@@ -134,12 +135,30 @@ namespace TrenchBroom {
             void setOverridden(bool overridden);
 
             bool isPrepared() const;
+
+            /**
+             * Generates the complete mip chain from the first mip level so that prepare() only has to upload the mip
+             * levels. Does nothing if the texture is prepared, is masked (only the first mip level of masked textures
+             * is used), or already has more than one mip level.
+             *
+             * Does not access any shared state, so it can be called for different textures concurrently.
+             */
+            void generateMips();
+
+            /**
+             * Returns the number of bytes that prepare() will upload, or 0 if the texture has no buffers.
+             */
+            size_t uploadSize() const;
+
+            /**
+             * Uploads the texture data to the given texture object and releases the buffers.
+             */
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
             void activate() const;
             void deactivate() const;
-        public: // exposed for tests only
+        public:
             /**
              * Returns the texture data in the format returned by format().
              * Once prepare() is called, this will be an empty vector.
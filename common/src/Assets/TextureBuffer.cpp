@@ -23,9 +23,11 @@
 
 #include <vecmath/vec.h>
 
-#include <FreeImage.h>
-
-#include <algorithm> // for std::max
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -63,32 +65,106 @@ namespace TrenchBroom {
             }
         }
 
-        void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize) {
-            if (oldSize == newSize)
-                return;
+        size_t mipLevelCount(const size_t width, const size_t height) {
+            assert(width > 0);
+            assert(height > 0);
+
+            size_t result = 1u;
+            for (auto size = std::max(width, height); size > 1u; size >>= 1u) {
+                ++result;
+            }
+            return result;
+        }
+
+        namespace {
+            // linear values are stored with 16 bits, and we use the upper 14 bits to look up their sRGB encoding
+            constexpr size_t LinearBits = 16u;
+            constexpr size_t LinearTableBits = 14u;
+
+            struct GammaTables {
+                std::array<uint16_t, 256u> toLinear;
+                std::array<unsigned char, 1u << LinearTableBits> toSrgb;
+
+                GammaTables() {
+                    for (size_t i = 0u; i < toLinear.size(); ++i) {
+                        const auto srgb = static_cast<double>(i) / 255.0;
+                        const auto linear = srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+                        toLinear[i] = static_cast<uint16_t>(std::round(linear * 65535.0));
+                    }
+                    for (size_t i = 0u; i < toSrgb.size(); ++i) {
+                        // sample the center of the range of linear values that map to this entry
+                        const auto linear = (static_cast<double>(i) + 0.5) / static_cast<double>(toSrgb.size());
+                        const auto srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                        toSrgb[i] = static_cast<unsigned char>(std::round(std::clamp(srgb, 0.0, 1.0) * 255.0));
+                    }
+                }
+            };
+
+            const GammaTables& gammaTables() {
+                static const GammaTables tables;
+                return tables;
+            }
+
+            /**
+             * Computes one mip level from the previous one. If a dimension of the source is odd, its last row or column
+             * is dropped, and if it is 1, the single row or column is sampled twice.
+             */
+            template <size_t BytesPerPixel, bool HasAlpha>
+            void downsample(const unsigned char* src, const size_t srcWidth, const size_t srcHeight, unsigned char* dst, const size_t dstWidth, const size_t dstHeight) {
+                const auto& tables = gammaTables();
+                constexpr auto ColorChannels = HasAlpha ? BytesPerPixel - 1u : BytesPerPixel;
+
+                for (size_t y = 0u; y < dstHeight; ++y) {
+                    const auto* row0 = src + std::min(2u * y, srcHeight - 1u) * srcWidth * BytesPerPixel;
+                    const auto* row1 = src + std::min(2u * y + 1u, srcHeight - 1u) * srcWidth * BytesPerPixel;
+                    auto* out = dst + y * dstWidth * BytesPerPixel;
+
+                    for (size_t x = 0u; x < dstWidth; ++x) {
+                        const auto x0 = std::min(2u * x, srcWidth - 1u) * BytesPerPixel;
+                        const auto x1 = std::min(2u * x + 1u, srcWidth - 1u) * BytesPerPixel;
+
+                        for (size_t c = 0u; c < ColorChannels; ++c) {
+                            const uint32_t sum =
+                                uint32_t(tables.toLinear[row0[x0 + c]]) + tables.toLinear[row0[x1 + c]] +
+                                uint32_t(tables.toLinear[row1[x0 + c]]) + tables.toLinear[row1[x1 + c]];
+                            // sum has LinearBits + 2 bits, divide by 4 and drop the bits not used by the table
+                            out[c] = tables.toSrgb[sum >> (LinearBits + 2u - LinearTableBits)];
+                        }
+                        if constexpr (HasAlpha) {
+                            const uint32_t sum =
+                                uint32_t(row0[x0 + 3u]) + row0[x1 + 3u] +
+                                uint32_t(row1[x0 + 3u]) + row1[x1 + 3u];
+                            out[3u] = static_cast<unsigned char>((sum + 2u) / 4u);
+                        }
+
+                        out += BytesPerPixel;
+                    }
+                }
+            }
+        }
 
-            for (size_t i = 0; i < buffers.size(); ++i) {
-                const auto div = size_t(1) << i;
-                const auto oldWidth = static_cast<int>(oldSize.x() / div);
-                const auto oldHeight = static_cast<int>(oldSize.y() / div);
-                const auto oldPitch = oldWidth * 3;
-                auto* oldPtr = buffers[i].data();
+        void generateMips(TextureBufferList& buffers, const size_t width, const size_t height, const GLenum format) {
+            ensure(!buffers.empty(), "buffers must contain the first mip level");
 
-                auto* oldBitmap = FreeImage_ConvertFromRawBits(oldPtr, oldWidth, oldHeight, oldPitch, 24, 0xFF0000, 0x00FF00, 0x0000FF, true);
-                ensure(oldBitmap != nullptr, "oldBitmap is null");
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            assert(buffers.front().size() >= bytesPerPixel * width * height);
 
-                const auto newWidth = static_cast<int>(newSize.x() / div);
-                const auto newHeight = static_cast<int>(newSize.y() / div);
-                const auto newPitch = newWidth * 3;
-                auto* newBitmap = FreeImage_Rescale(oldBitmap, newWidth, newHeight, FILTER_BICUBIC);
-                ensure(newBitmap != nullptr, "newBitmap is null");
+            const auto mipLevels = mipLevelCount(width, height);
+            buffers.resize(1u);
+            buffers.reserve(mipLevels);
 
-                buffers[i] = std::vector<unsigned char>(3 * newSize.x() * newSize.y());
-                auto* newPtr = buffers[i].data();
+            for (size_t level = 1u; level < mipLevels; ++level) {
+                const auto srcSize = sizeAtMipLevel(width, height, level - 1u);
+                const auto dstSize = sizeAtMipLevel(width, height, level);
 
-                FreeImage_ConvertToRawBits(newPtr, newBitmap, newPitch, 24, 0xFF0000, 0x00FF00, 0x0000FF, true);
-                FreeImage_Unload(oldBitmap);
-                FreeImage_Unload(newBitmap);
+                auto dst = TextureBuffer(bytesPerPixel * dstSize.x() * dstSize.y());
+                const auto* src = buffers.back().data();
+                if (bytesPerPixel == 4u) {
+                    downsample<4u, true>(src, srcSize.x(), srcSize.y(), dst.data(), dstSize.x(), dstSize.y());
+                } else {
+                    downsample<3u, false>(src, srcSize.x(), srcSize.y(), dst.data(), dstSize.x(), dstSize.y());
+                }
+                buffers.push_back(std::move(dst));
             }
         }
     }
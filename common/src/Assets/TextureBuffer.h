@@ -35,7 +35,24 @@ namespace TrenchBroom {
         size_t bytesPerPixelForFormat(GLenum format);
         void setMipBufferSize(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
-        void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize);
+        /**
+         * Returns the number of mip levels of a complete mip chain for an image of the given size, i.e., the number of
+         * levels until both dimensions have been reduced to 1.
+         */
+        size_t mipLevelCount(size_t width, size_t height);
+
+        /**
+         * Generates a complete mip chain from the first buffer of the given list, replacing any other buffers.
+         *
+         * Each mip level is computed from the previous one using a 2x2 box filter. The color channels are averaged in
+         * linear space, assuming that they are sRGB encoded, and the alpha channel (if any) is averaged as is.
+         *
+         * @param buffers the buffers, must contain at least one buffer holding the image data at full size
+         * @param width the width of the image
+         * @param height the height of the image
+         * @param format the format of the image data, one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA
+         */
+        void generateMips(TextureBufferList& buffers, size_t width, size_t height, GLenum format);
     }
 }
 
@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureUploadQueue.h"
 
 #include <kdl/vector_utils.h>
 
@@ -119,7 +120,7 @@ namespace TrenchBroom {
             return !m_textureIds.empty();
         }
 
-        void TextureCollection::prepare(const int minFilter, const int magFilter) {
+        void TextureCollection::prepare(TextureUploadQueue& uploadQueue) {
             assert(!prepared());
 
             m_textureIds.resize(textureCount());
@@ -127,8 +128,7 @@ namespace TrenchBroom {
                                    static_cast<GLuint*>(&m_textureIds.front())));
 
             for (size_t i = 0; i < textureCount(); ++i) {
-                Texture* texture = m_textures[i];
-                texture->prepare(m_textureIds[i], minFilter, magFilter);
+                uploadQueue.enqueue(m_textures[i], m_textureIds[i]);
             }
         }
 
@@ -30,6 +30,7 @@
 namespace TrenchBroom {
     namespace Assets {
         class Texture;
+        class TextureUploadQueue;
 
         class TextureCollection {
         private:
@@ -67,7 +68,12 @@ namespace TrenchBroom {
             size_t usageCount() const;
 
             bool prepared() const;
-            void prepare(int minFilter, int magFilter);
+
+            /**
+             * Allocates the texture objects for all textures of this collection and adds the textures to the given
+             * queue. The texture data is uploaded when the queue is processed.
+             */
+            void prepare(TextureUploadQueue& uploadQueue);
             void setTextureMode(int minFilter, int magFilter);
         private:
             void incUsageCount();
@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "Logger.h"
+#include "Profiler.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/TextureLoader.h"
@@ -55,8 +56,26 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Uploads textures using the filters that are current when the upload happens.
+         */
+        class GLTextureUploadSink : public TextureUploadSink {
+        private:
+            int m_minFilter;
+            int m_magFilter;
+        public:
+            GLTextureUploadSink(const int minFilter, const int magFilter) :
+            m_minFilter(minFilter),
+            m_magFilter(magFilter) {}
+
+            void upload(Texture& texture, const GLuint textureId) override {
+                texture.prepare(textureId, m_minFilter, m_magFilter);
+            }
+        };
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
+        m_uploadBudget(DefaultUploadBudget),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
         m_resetTextureMode(false) {}
@@ -66,6 +85,7 @@ namespace TrenchBroom {
         }
 
         void TextureManager::setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader) {
+            TB_PROFILE_ZONE("TextureManager::setTextureCollections");
             auto collections = collectionMap();
             m_collections.clear();
             clear();
@@ -123,8 +143,8 @@ namespace TrenchBroom {
         }
 
         void TextureManager::clear() {
-            kdl::vec_clear_and_delete(m_collections);
-            kdl::vec_clear_and_delete(m_toRemove);
+            deleteCollections(m_collections);
+            deleteCollections(m_toRemove);
 
             m_toPrepare.clear();
             m_texturesByName.clear();
@@ -139,10 +159,20 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        void TextureManager::setUploadBudget(const size_t uploadBudget) {
+            m_uploadBudget = uploadBudget;
+        }
+
         void TextureManager::commitChanges() {
+            TB_PROFILE_ZONE("TextureManager::commitChanges");
             resetTextureMode();
+            deleteCollections(m_toRemove);
             prepare();
-            kdl::vec_clear_and_delete(m_toRemove);
+            upload();
+        }
+
+        bool TextureManager::hasPendingUploads() const {
+            return !m_toPrepare.empty() || !m_uploadQueue.empty();
         }
 
         Texture* TextureManager::texture(const std::string& name) const {
@@ -180,10 +210,20 @@ namespace TrenchBroom {
 
         void TextureManager::prepare() {
             std::for_each(std::begin(m_toPrepare), std::end(m_toPrepare),
-                          [this](auto collection) { collection->prepare(m_minFilter, m_magFilter); });
+                          [this](auto collection) { collection->prepare(m_uploadQueue); });
             m_toPrepare.clear();
         }
 
+        void TextureManager::upload() {
+            auto sink = GLTextureUploadSink(m_minFilter, m_magFilter);
+            m_uploadQueue.upload(sink, m_uploadBudget);
+        }
+
+        void TextureManager::deleteCollections(std::vector<TextureCollection*>& collections) {
+            m_uploadQueue.remove(collections);
+            kdl::vec_clear_and_delete(collections);
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -21,6 +21,7 @@
 #define TrenchBroom_TextureManager
 
 #include "Notifier.h"
+#include "Assets/TextureUploadQueue.h"
 
 #include <map>
 #include <string>
@@ -39,6 +40,11 @@ namespace TrenchBroom {
         class TextureCollection;
 
         class TextureManager {
+        public:
+            /**
+             * The default number of texture bytes that are uploaded per call to commitChanges().
+             */
+            static constexpr size_t DefaultUploadBudget = 16u * 1024u * 1024u;
         private:
             using TextureCollectionMap = std::map<IO::Path, TextureCollection*>;
             using TextureCollectionMapEntry = std::pair<IO::Path, TextureCollection*>;
@@ -51,6 +57,9 @@ namespace TrenchBroom {
             std::vector<TextureCollection*> m_toPrepare;
             std::vector<TextureCollection*> m_toRemove;
 
+            TextureUploadQueue m_uploadQueue;
+            size_t m_uploadBudget;
+
             TextureMap m_texturesByName;
             std::vector<Texture*> m_textures;
 
@@ -72,8 +81,25 @@ namespace TrenchBroom {
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Sets the maximum number of texture bytes that are uploaded per call to commitChanges(). At least one
+             * texture is uploaded per call regardless of the budget.
+             */
+            void setUploadBudget(size_t uploadBudget);
+
+            /**
+             * Applies pending changes and uploads pending textures up to the upload budget. Must be called with an
+             * active GL context.
+             */
             void commitChanges();
 
+            /**
+             * Indicates whether there are textures left to upload. If so, the caller should render another frame so
+             * that commitChanges() is called again.
+             */
+            bool hasPendingUploads() const;
+
             Texture* texture(const std::string& name) const;
             const std::vector<Texture*>& textures() const;
             const std::vector<TextureCollection*>& collections() const;
@@ -81,6 +107,8 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void upload();
+            void deleteCollections(std::vector<TextureCollection*>& collections);
 
             void updateTextures();
         };
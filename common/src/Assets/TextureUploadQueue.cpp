@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureUploadQueue.h"
+
+#include "Assets/Texture.h"
+
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        TextureUploadSink::~TextureUploadSink() = default;
+
+        void TextureUploadQueue::enqueue(Texture* texture, const GLuint textureId) {
+            m_uploads.push_back({ texture, textureId, texture->uploadSize() });
+        }
+
+        void TextureUploadQueue::remove(const std::vector<TextureCollection*>& collections) {
+            if (m_uploads.empty() || collections.empty()) {
+                return;
+            }
+
+            const auto collectionSet = std::unordered_set<const TextureCollection*>(std::begin(collections), std::end(collections));
+            kdl::vec_erase_if(m_uploads, [&](const auto& upload) {
+                return collectionSet.count(upload.texture->collection()) > 0u;
+            });
+        }
+
+        void TextureUploadQueue::clear() {
+            m_uploads.clear();
+        }
+
+        bool TextureUploadQueue::empty() const {
+            return m_uploads.empty();
+        }
+
+        size_t TextureUploadQueue::pendingCount() const {
+            return m_uploads.size();
+        }
+
+        size_t TextureUploadQueue::pendingBytes() const {
+            return std::accumulate(std::begin(m_uploads), std::end(m_uploads), size_t(0), [](const size_t sum, const auto& upload) {
+                return sum + upload.size;
+            });
+        }
+
+        size_t TextureUploadQueue::upload(TextureUploadSink& sink, const size_t byteBudget) {
+            if (m_uploads.empty()) {
+                return 0u;
+            }
+
+            // usage counts change while the user edits the map, so the order is recomputed for every batch
+            std::stable_sort(std::begin(m_uploads), std::end(m_uploads), [](const auto& lhs, const auto& rhs) {
+                return lhs.texture->usageCount() > rhs.texture->usageCount();
+            });
+
+            size_t uploadedBytes = 0u;
+            auto it = std::begin(m_uploads);
+            while (it != std::end(m_uploads) && (uploadedBytes == 0u || uploadedBytes + it->size <= byteBudget)) {
+                sink.upload(*it->texture, it->textureId);
+                uploadedBytes += it->size;
+                ++it;
+            }
+
+            m_uploads.erase(std::begin(m_uploads), it);
+            return uploadedBytes;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureUploadQueue
+#define TrenchBroom_TextureUploadQueue
+
+#include "Renderer/GL.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+        class TextureCollection;
+
+        /**
+         * Performs the actual upload of a texture that was scheduled by a TextureUploadQueue.
+         */
+        class TextureUploadSink {
+        public:
+            virtual ~TextureUploadSink();
+
+            /**
+             * Uploads the given texture to the given texture object. The texture is expected to release its CPU side
+             * buffers once the upload has finished.
+             */
+            virtual void upload(Texture& texture, GLuint textureId) = 0;
+        };
+
+        /**
+         * Schedules the upload of textures over several frames. Every call to upload() uploads the pending textures
+         * with the highest usage counts until the given byte budget is exhausted, so that the textures which are
+         * visible in the map come first and a large texture collection does not block a single frame.
+         *
+         * The queue does not make any GL calls itself, these are left to the given upload sink.
+         */
+        class TextureUploadQueue {
+        private:
+            struct Upload {
+                Texture* texture;
+                GLuint textureId;
+                size_t size;
+            };
+
+            std::vector<Upload> m_uploads;
+        public:
+            /**
+             * Adds the given texture to the queue. The given texture object must have been allocated by the caller.
+             */
+            void enqueue(Texture* texture, GLuint textureId);
+
+            /**
+             * Removes the pending uploads of all textures which belong to any of the given collections. Must be called
+             * before the collections are deleted.
+             */
+            void remove(const std::vector<TextureCollection*>& collections);
+            void clear();
+
+            bool empty() const;
+            size_t pendingCount() const;
+            size_t pendingBytes() const;
+
+            /**
+             * Uploads pending textures in the order of descending usage counts until the next texture would exceed the
+             * given byte budget. Textures with equal usage counts are uploaded in the order in which they were
+             * enqueued. At least one texture is uploaded if the queue is not empty, even if it exceeds the budget on
+             * its own.
+             *
+             * @param sink the sink that performs the uploads
+             * @param byteBudget the maximum number of bytes to upload
+             * @return the number of bytes that were uploaded
+             */
+            size_t upload(TextureUploadSink& sink, size_t byteBudget);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureUploadQueue) */
@@ -378,7 +378,7 @@ namespace TrenchBroom {
 
         void AseParser::skipDirective(const std::string& name) {
             auto token = expect(AseToken::Directive, m_tokenizer.peekToken());
-            if (token.data() == name) {
+            if (token.view() == name) {
                 m_tokenizer.nextToken();
 
                 // skip arguments
@@ -417,9 +417,8 @@ namespace TrenchBroom {
 
         void AseParser::expectArgumentName(const std::string& expected) {
             const auto token = expect(AseToken::ArgumentName, m_tokenizer.nextToken());
-            const auto& actual = token.data();
-            if (actual != expected) {
-                throw ParserException(token.line(), token.column(), "Expected argument name '" + expected + "', but got '" + actual + "'");
+            if (token.view() != expected) {
+                throw ParserException(token.line(), token.column(), "Expected argument name '" + expected + "', but got '" + token.data() + "'");
             }
         }
 
@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BufferedParserStatus.h"
+
+#include "Logger.h"
+
+#include <cassert>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        NullLogger BufferedParserStatus::_logger;
+
+        BufferedParserStatus::BufferedParserStatus(ParserStatus* progressStatus) :
+        ParserStatus(_logger, ""),
+        m_progressStatus(progressStatus) {}
+
+        size_t BufferedParserStatus::messageCount() const {
+            return m_messages.size();
+        }
+
+        void BufferedParserStatus::replay(ParserStatus& status) const {
+            replay(status, 0u, m_messages.size());
+        }
+
+        void BufferedParserStatus::replay(ParserStatus& status, const size_t first, const size_t last) const {
+            assert(first <= last && last <= m_messages.size());
+            for (size_t i = first; i < last; ++i) {
+                const auto& [level, str] = m_messages[i];
+                status.forward(level, str);
+            }
+        }
+
+        void BufferedParserStatus::doProgress(const double progress) {
+            if (m_progressStatus != nullptr) {
+                m_progressStatus->progress(progress);
+            }
+        }
+
+        void BufferedParserStatus::doLog(const LogLevel level, const std::string& str) {
+            m_messages.emplace_back(level, str);
+        }
+    }
+}
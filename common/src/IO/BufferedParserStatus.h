@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_BufferedParserStatus
+#define TrenchBroom_BufferedParserStatus
+
+#include "IO/ParserStatus.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    class NullLogger;
+
+    namespace IO {
+        /**
+         * Records the messages reported by a parser instead of logging them, so that they can be passed on to another
+         * parser status later, e.g. when the parser runs on a worker thread or when its result is cached. Progress is
+         * not recorded, but it can be passed on to another parser status right away.
+         */
+        class BufferedParserStatus : public ParserStatus {
+        private:
+            static NullLogger _logger;
+            ParserStatus* m_progressStatus;
+            std::vector<std::pair<LogLevel, std::string>> m_messages;
+        public:
+            /**
+             * Creates a new parser status which passes on progress to the given parser status, if any.
+             */
+            explicit BufferedParserStatus(ParserStatus* progressStatus = nullptr);
+
+            /**
+             * Returns the number of messages recorded so far.
+             */
+            size_t messageCount() const;
+
+            /**
+             * Passes the recorded messages on to the given parser status in the order in which they were reported.
+             */
+            void replay(ParserStatus& status) const;
+
+            /**
+             * Passes the recorded messages with indices in the range [first, last) on to the given parser status in the
+             * order in which they were reported.
+             */
+            void replay(ParserStatus& status, size_t first, size_t last) const;
+        private:
+            void doProgress(double progress) override;
+            void doLog(LogLevel level, const std::string& str) override;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_BufferedParserStatus) */
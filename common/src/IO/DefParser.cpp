@@ -207,7 +207,7 @@ namespace TrenchBroom {
                 token = expect(status, DefToken::OParenthesis | DefToken::Word, m_tokenizer.peekToken());
                 if (token.hasType(DefToken::OParenthesis)) {
                     classInfo.setSize(parseBounds(status));
-                } else if (token.data() == "?") {
+                } else if (token.view() == "?") {
                     m_tokenizer.nextToken();
                 }
 
@@ -368,7 +368,7 @@ namespace TrenchBroom {
             if (token.type() == DefToken::CDefinition) {
                 return "";
             }
-            return m_tokenizer.readRemainder(DefToken::CDefinition);
+            return std::string(m_tokenizer.readRemainder(DefToken::CDefinition));
         }
 
         vm::vec3 DefParser::parseVector(ParserStatus& status) {
@@ -348,7 +348,7 @@ namespace TrenchBroom {
             if (token.hasType(ELToken::String)) {
                 m_tokenizer.nextToken();
                 // Escaping happens in EL::Value::appendToStream
-                std::string value = kdl::str_unescape(token.data(), "\\\"");
+                std::string value = kdl::str_unescape(token.view(), "\\\"");
                 return EL::Expression(EL::LiteralExpression(EL::Value(std::move(value))), token.line(), token.column());
             }
             if (token.hasType(ELToken::Number)) {
@@ -357,7 +357,7 @@ namespace TrenchBroom {
             }
             if (token.hasType(ELToken::Boolean)) {
                 m_tokenizer.nextToken();
-                return EL::Expression(EL::LiteralExpression(EL::Value(token.data() == "true")), token.line(), token.column());
+                return EL::Expression(EL::LiteralExpression(EL::Value(token.view() == "true")), token.line(), token.column());
             }
             if (token.hasType(ELToken::Null)) {
                 m_tokenizer.nextToken();
@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityDefinitionCache.h"
+
+#include "Exceptions.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string_view>
+
+namespace TrenchBroom {
+    namespace IO {
+        EntityDefinitionCache::EntityDefinitionCache() = default;
+
+        EntityDefinitionCache::~EntityDefinitionCache() = default;
+
+        EntityDefinitionCache& EntityDefinitionCache::instance() {
+            static EntityDefinitionCache cache;
+            return cache;
+        }
+
+        std::vector<Assets::EntityDefinition*> EntityDefinitionCache::loadDefinitions(ParserStatus& status, const Path& path, const Color& defaultColor, const ParseFunction& parse) {
+            const auto file = Disk::openFile(path);
+            const auto reader = file->reader().buffer();
+            const auto hostFile = makeSourceFile(path, std::begin(reader), std::end(reader));
+
+            std::shared_ptr<const Entry> cachedEntry;
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                const auto it = m_entries.find(path);
+                if (it != std::end(m_entries)) {
+                    cachedEntry = it->second;
+                }
+            }
+
+            if (cachedEntry != nullptr && isUpToDate(*cachedEntry, hostFile, defaultColor)) {
+                cachedEntry->status.replay(status);
+                return kdl::vec_transform(cachedEntry->definitions, [](const auto& definition) { return definition->clone(); });
+            }
+
+            auto entry = std::make_shared<Entry>();
+            entry->defaultColor = defaultColor;
+
+            std::vector<Path> includedFiles;
+            std::vector<Assets::EntityDefinition*> definitions;
+            try {
+                definitions = parse(entry->status, std::begin(reader), std::end(reader), includedFiles);
+                entry->status.replay(status);
+            } catch (...) {
+                entry->status.replay(status);
+                throw;
+            }
+
+            entry->sourceFiles.push_back(hostFile);
+            for (const auto& includedPath : includedFiles) {
+                entry->sourceFiles.push_back(makeSourceFile(includedPath));
+            }
+
+            for (const auto* definition : definitions) {
+                entry->definitions.emplace_back(definition->clone());
+            }
+
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            m_entries[path] = std::move(entry);
+            return definitions;
+        }
+
+        void EntityDefinitionCache::clear() {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            m_entries.clear();
+        }
+
+        EntityDefinitionCache::SourceFile EntityDefinitionCache::makeSourceFile(const Path& path, const char* begin, const char* end) {
+            const auto size = static_cast<size_t>(end - begin);
+            return SourceFile{ path, true, size, std::hash<std::string_view>{}(std::string_view(begin, size)) };
+        }
+
+        EntityDefinitionCache::SourceFile EntityDefinitionCache::makeSourceFile(const Path& path) {
+            try {
+                const auto file = Disk::openFile(path);
+                const auto reader = file->reader().buffer();
+                return makeSourceFile(path, std::begin(reader), std::end(reader));
+            } catch (const Exception&) {
+                // a missing file is recorded, too, so that the entry becomes outdated when it appears
+                return SourceFile{ path, false, 0u, 0u };
+            }
+        }
+
+        bool EntityDefinitionCache::isUpToDate(const SourceFile& sourceFile) {
+            try {
+                const auto file = Disk::openFile(sourceFile.path);
+                if (!sourceFile.exists || file->size() != sourceFile.size) {
+                    return false;
+                }
+
+                const auto reader = file->reader().buffer();
+                return makeSourceFile(sourceFile.path, std::begin(reader), std::end(reader)).hash == sourceFile.hash;
+            } catch (const Exception&) {
+                return !sourceFile.exists;
+            }
+        }
+
+        bool EntityDefinitionCache::isUpToDate(const Entry& entry, const SourceFile& file, const Color& defaultColor) {
+            if (entry.defaultColor != defaultColor) {
+                return false;
+            }
+
+            // the first source file is the host file, the others are the files it included
+            const auto& hostFile = entry.sourceFiles.front();
+            if (hostFile.size != file.size || hostFile.hash != file.hash) {
+                return false;
+            }
+
+            for (size_t i = 1u; i < entry.sourceFiles.size(); ++i) {
+                if (!isUpToDate(entry.sourceFiles[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
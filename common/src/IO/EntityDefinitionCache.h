@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityDefinitionCache
+#define TrenchBroom_EntityDefinitionCache
+
+#include "Color.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/Path.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class EntityDefinition;
+    }
+
+    namespace IO {
+        class ParserStatus;
+
+        /**
+         * Keeps the entity definitions parsed from a definition file, so that they can be reused when the same file
+         * is loaded again, e.g. when another map is opened or the definitions are reloaded.
+         *
+         * An entry is reused only if the contents of the file and of all files it included are unchanged, if every
+         * included file that was missing is still missing, and if the definitions were parsed with the same default
+         * entity color. The messages that were reported while
+         * parsing are recorded and reported again whenever the entry is reused.
+         */
+        class EntityDefinitionCache {
+        public:
+            /**
+             * Parses the given file contents and returns the definitions. The absolute paths of all files that were
+             * included while parsing must be added to the given vector, including the paths of files that could not be
+             * opened.
+             */
+            using ParseFunction = std::function<std::vector<Assets::EntityDefinition*>(ParserStatus& status, const char* begin, const char* end, std::vector<Path>& includedFiles)>;
+        private:
+            struct SourceFile {
+                Path path;
+                bool exists;
+                size_t size;
+                size_t hash;
+            };
+
+            struct Entry {
+                Color defaultColor;
+                std::vector<SourceFile> sourceFiles;
+                std::vector<std::unique_ptr<Assets::EntityDefinition>> definitions;
+                BufferedParserStatus status;
+            };
+
+            std::mutex m_mutex;
+            std::map<Path, std::shared_ptr<const Entry>> m_entries;
+        public:
+            EntityDefinitionCache();
+            ~EntityDefinitionCache();
+
+            /**
+             * Returns the cache shared by the entire application.
+             */
+            static EntityDefinitionCache& instance();
+
+            /**
+             * Returns the definitions of the file at the given path. If the cache contains an up to date entry for
+             * the file, copies of the cached definitions are returned. Otherwise, the file is parsed by the given
+             * function, and the result is stored in the cache. The caller takes ownership of the returned
+             * definitions.
+             *
+             * @param status the parser status to report messages to
+             * @param path the absolute path of the definition file
+             * @param defaultColor the default entity color that is passed to the parser
+             * @param parse the function that parses the file if necessary
+             * @return the entity definitions
+             *
+             * @throws FileSystemException if the file cannot be read
+             * @throws ParserException if the file cannot be parsed
+             */
+            std::vector<Assets::EntityDefinition*> loadDefinitions(ParserStatus& status, const Path& path, const Color& defaultColor, const ParseFunction& parse);
+
+            /**
+             * Removes all entries.
+             */
+            void clear();
+        private:
+            static SourceFile makeSourceFile(const Path& path, const char* begin, const char* end);
+            static SourceFile makeSourceFile(const Path& path);
+            static bool isUpToDate(const SourceFile& sourceFile);
+            static bool isUpToDate(const Entry& entry, const SourceFile& file, const Color& defaultColor);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityDefinitionCache) */
@@ -19,8 +19,11 @@
 
 #include "FgdParser.h"
 
+#include "Macros.h"
+#include "TaskScheduler.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/AttributeDefinition.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/ELParser.h"
@@ -130,12 +133,42 @@ namespace TrenchBroom {
             return Token(FgdToken::Eof, nullptr, nullptr, length(), line(), column());
         }
 
+        /**
+         * The classes and includes of a file in the order in which they appear. The messages reported while parsing a
+         * file are buffered until its classes are resolved, because included files are parsed by tasks. The message
+         * counts recorded with the classes and includes tell where the messages reported while resolving them belong.
+         */
+        struct FgdParser::ParsedFile {
+            struct Class {
+                ParsedClass parsedClass;
+                // the number of messages reported up to and including the parsing of the class
+                size_t messageCount;
+            };
+
+            struct Include {
+                // the number of classes of the including file which precede the include
+                size_t position;
+                // the number of messages of the including file which precede the messages of the included file
+                size_t messageCount;
+                std::unique_ptr<ParsedFile> file;
+            };
+
+            Path path;
+            std::vector<Class> classes;
+            std::vector<Include> includes;
+            BufferedParserStatus status;
+            bool failed = false;
+
+            explicit ParsedFile(ParserStatus* progressStatus = nullptr) :
+            status(progressStatus) {}
+        };
+
         FgdParser::FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, const Path& path) :
         m_defaultEntityColor(defaultEntityColor),
         m_tokenizer(FgdTokenizer(begin, end)) {
             if (!path.isEmpty() && path.isAbsolute()) {
                 m_fs = std::make_shared<DiskFileSystem>(path.deleteLastComponent());
-                pushIncludePath(path.lastComponent());
+                m_paths.push_back(path.lastComponent());
             }
         }
 
@@ -145,6 +178,16 @@ namespace TrenchBroom {
         FgdParser::FgdParser(const std::string& str, const Color& defaultEntityColor) :
         FgdParser(str, defaultEntityColor, Path()) {}
 
+        FgdParser::FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, std::shared_ptr<FileSystem> fs, std::vector<Path> paths) :
+        m_defaultEntityColor(defaultEntityColor),
+        m_paths(std::move(paths)),
+        m_fs(std::move(fs)),
+        m_tokenizer(FgdTokenizer(begin, end)) {}
+
+        const std::vector<Path>& FgdParser::includedFiles() const {
+            return m_includedFiles;
+        }
+
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
 
@@ -165,30 +208,6 @@ namespace TrenchBroom {
             return names;
         }
 
-        class FgdParser::PushIncludePath {
-        private:
-            FgdParser* m_parser;
-        public:
-            PushIncludePath(FgdParser* parser, const Path& path) :
-                m_parser(parser) {
-                m_parser->pushIncludePath(path);
-            }
-
-            ~PushIncludePath() {
-                m_parser->popIncludePath();
-            }
-        };
-
-        void FgdParser::pushIncludePath(const Path& path) {
-            assert(!isRecursiveInclude(path));
-            m_paths.push_back(path);
-        }
-
-        void FgdParser::popIncludePath() {
-            assert(!m_paths.empty());
-            m_paths.pop_back();
-        }
-
         Path FgdParser::currentRoot() const {
             if (!m_paths.empty()) {
                 assert(!m_paths.back().isEmpty());
@@ -208,13 +227,24 @@ namespace TrenchBroom {
         }
 
         FgdParser::EntityDefinitionList FgdParser::doParseDefinitions(ParserStatus& status) {
+            // the file must outlive the task group, whose destructor waits for the tasks that fill in the includes
+            ParsedFile file(&status);
+            m_includedFiles.clear();
+            try {
+                TaskGroup includeTasks;
+                parseFile(file.status, includeTasks, file);
+                includeTasks.wait();
+            } catch (...) {
+                // pass on the messages reported up to the error, including those of the classes parsed so far
+                EntityDefinitionList discarded;
+                resolveFile(status, file, discarded);
+                kdl::vec_clear_and_delete(discarded);
+                throw;
+            }
+
             EntityDefinitionList definitions;
             try {
-                auto token = m_tokenizer.peekToken();
-                while (!token.hasType(FgdToken::Eof)) {
-                    parseDefinitionOrInclude(status, definitions);
-                    token = m_tokenizer.peekToken();
-                }
+                resolveFile(status, file, definitions);
                 return definitions;
             } catch (...) {
                 kdl::vec_clear_and_delete(definitions);
@@ -222,39 +252,44 @@ namespace TrenchBroom {
             }
         }
 
-        void FgdParser::parseDefinitionOrInclude(ParserStatus& status, EntityDefinitionList& definitions) {
+        void FgdParser::parseFile(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file) {
+            auto token = m_tokenizer.peekToken();
+            while (!token.hasType(FgdToken::Eof)) {
+                parseDefinitionOrInclude(status, includeTasks, file);
+                token = m_tokenizer.peekToken();
+            }
+        }
+
+        void FgdParser::parseDefinitionOrInclude(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file) {
             auto token = expect(status, FgdToken::Eof | FgdToken::Word, m_tokenizer.peekToken());
             if (token.hasType(FgdToken::Eof)) {
                 return;
             }
 
-            if (kdl::ci::str_is_equal(token.data(), "@include")) {
-                const auto includedDefinitions = parseInclude(status);
-                kdl::vec_append(definitions, includedDefinitions);
+            if (kdl::ci::str_is_equal(token.view(), "@include")) {
+                parseInclude(status, includeTasks, file);
             } else {
-                auto* definition = parseDefinition(status);
+                auto parsedClass = parseDefinition(status);
                 status.progress(m_tokenizer.progress());
-                if (definition != nullptr) {
-                    definitions.push_back(definition);
+                if (parsedClass) {
+                    file.classes.push_back({ std::move(*parsedClass), file.status.messageCount() });
                 }
             }
         }
 
-        Assets::EntityDefinition* FgdParser::parseDefinition(ParserStatus& status) {
+        std::optional<FgdParser::ParsedClass> FgdParser::parseDefinition(ParserStatus& status) {
             auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
 
             const auto classname = token.data();
             if (kdl::ci::str_is_equal(classname, "@SolidClass")) {
-                return parseSolidClass(status);
+                return parseClass(status, ClassType::SolidClass);
             } else if (kdl::ci::str_is_equal(classname, "@PointClass")) {
-                return parsePointClass(status);
+                return parseClass(status, ClassType::PointClass);
             } else if (kdl::ci::str_is_equal(classname, "@BaseClass")) {
-                const auto baseClass = parseBaseClass(status);
-                m_baseClasses[baseClass.name()] = baseClass;
-                return nullptr;
+                return parseClass(status, ClassType::BaseClass);
             } else if (kdl::ci::str_is_equal(classname, "@Main")) {
                 skipMainClass(status);
-                return nullptr;
+                return std::nullopt;
             } else {
                 const auto msg = "Unknown entity definition class '" + classname + "'";
                 status.error(token.line(), token.column(), msg);
@@ -262,31 +297,7 @@ namespace TrenchBroom {
             }
         }
 
-        Assets::EntityDefinition* FgdParser::parseSolidClass(ParserStatus& status) {
-            EntityDefinitionClassInfo classInfo = parseClass(status);
-            if (classInfo.hasSize()) {
-                status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have a size");
-            }
-            if (classInfo.hasModelDefinition()) {
-                status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have model definitions");
-            }
-            return new Assets::BrushEntityDefinition(classInfo.name(), classInfo.color(), classInfo.description(), classInfo.attributeList());
-        }
-
-        Assets::EntityDefinition* FgdParser::parsePointClass(ParserStatus& status) {
-            const auto classInfo = parseClass(status);
-            return new Assets::PointEntityDefinition(classInfo.name(), classInfo.color(), classInfo.size(), classInfo.description(), classInfo.attributeList(), classInfo.modelDefinition());
-        }
-
-        EntityDefinitionClassInfo FgdParser::parseBaseClass(ParserStatus& status) {
-            const auto classInfo = parseClass(status);
-            if (m_baseClasses.count(classInfo.name()) > 0) {
-                status.warn(classInfo.line(), classInfo.column(), "Redefinition of base class '" + classInfo.name() + "'");
-            }
-            return classInfo;
-        }
-
-        EntityDefinitionClassInfo FgdParser::parseClass(ParserStatus& status) {
+        FgdParser::ParsedClass FgdParser::parseClass(ParserStatus& status, const ClassType type) {
             auto token = expect(status, FgdToken::Word | FgdToken::Equality, m_tokenizer.nextToken());
 
             std::vector<std::string> superClasses;
@@ -334,8 +345,7 @@ namespace TrenchBroom {
             }
 
             classInfo.addAttributeDefinitions(parseProperties(status));
-            classInfo.resolveBaseClasses(m_baseClasses, superClasses);
-            return classInfo;
+            return ParsedClass{type, std::move(classInfo), std::move(superClasses)};
         }
 
         void FgdParser::skipMainClass(ParserStatus& status) {
@@ -565,7 +575,7 @@ namespace TrenchBroom {
 
         bool FgdParser::parseReadOnlyFlag(ParserStatus& /* status */) {
             auto token = m_tokenizer.peekToken();
-            if (token.hasType(FgdToken::Word) && token.data() == "readonly") {
+            if (token.hasType(FgdToken::Word) && token.view() == "readonly") {
                 m_tokenizer.nextToken();
                 return true;
             } else {
@@ -694,11 +704,11 @@ namespace TrenchBroom {
             auto token = expect(status, FgdToken::String, m_tokenizer.nextToken());
             if (m_tokenizer.peekToken().hasType(FgdToken::Plus)) {
                 std::stringstream str;
-                str << token.data();
+                str << token.view();
                 do {
                     m_tokenizer.nextToken();
                     token = expect(status, FgdToken::String, m_tokenizer.nextToken());
-                    str << token.data();
+                    str << token.view();
                 } while (m_tokenizer.peekToken().hasType(FgdToken::Plus));
                 return str.str();
             } else {
@@ -706,43 +716,132 @@ namespace TrenchBroom {
             }
         }
 
-        FgdParser::EntityDefinitionList FgdParser::parseInclude(ParserStatus& status) {
+        void FgdParser::parseInclude(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file) {
             auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
-            assert(kdl::ci::str_is_equal(token.data(), "@include"));
+            assert(kdl::ci::str_is_equal(token.view(), "@include"));
 
             expect(status, FgdToken::String, token = m_tokenizer.nextToken());
             const auto path = Path(token.data());
-            return handleInclude(status, path);
-        }
+            const auto line = m_tokenizer.line();
 
-        FgdParser::EntityDefinitionList FgdParser::handleInclude(ParserStatus& status, const Path& path) {
             if (m_fs == nullptr) {
-                status.error(m_tokenizer.line(), kdl::str_to_string("Cannot include file without host file path"));
-                return {};
+                status.error(line, kdl::str_to_string("Cannot include file without host file path"));
+                return;
             }
-        
-            const auto snapshot = m_tokenizer.snapshot();
-            auto result = EntityDefinitionList{};
+
             try {
-                status.debug(m_tokenizer.line(), "Parsing included file '" + path.asString() + "'");
-                const auto file = m_fs->openFile(currentRoot() + path);
-                const auto filePath = file->path();
-                status.debug(m_tokenizer.line(), "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
-
-                if (!isRecursiveInclude(filePath)) {
-                    const PushIncludePath pushIncludePath(this, filePath);
-                    auto reader = file->reader().buffer();
-                    m_tokenizer.replaceState(std::begin(reader), std::end(reader));
-                    result = doParseDefinitions(status);
-                } else {
-                    status.error(m_tokenizer.line(), kdl::str_to_string("Skipping recursively included file: ", path.asString(), " (", filePath, ")"));
+                status.debug(line, "Parsing included file '" + path.asString() + "'");
+                const auto includedFile = m_fs->openFile(currentRoot() + path);
+                const auto filePath = includedFile->path();
+                status.debug(line, "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
+
+                if (isRecursiveInclude(filePath)) {
+                    status.error(line, kdl::str_to_string("Skipping recursively included file: ", path.asString(), " (", filePath, ")"));
+                    return;
+                }
+
+                auto parsedFile = std::make_unique<ParsedFile>();
+                parsedFile->path = m_fs->makeAbsolute(filePath);
+                file.includes.push_back({ file.classes.size(), file.status.messageCount(), std::move(parsedFile) });
+
+                includeTasks.run([&includeTasks, &parsedFile = *file.includes.back().file, includedFile, line, defaultEntityColor = m_defaultEntityColor, fs = m_fs, paths = kdl::vec_concat(m_paths, std::vector<Path>{ filePath })]() {
+                    try {
+                        auto reader = includedFile->reader().buffer();
+                        FgdParser parser(std::begin(reader), std::end(reader), defaultEntityColor, fs, paths);
+                        parser.parseFile(parsedFile.status, includeTasks, parsedFile);
+                    } catch (const Exception& e) {
+                        parsedFile.status.error(line, kdl::str_to_string("Failed to parse included file: ", e.what()));
+                        parsedFile.failed = true;
+                    }
+                });
+            } catch (const Exception& e) {
+                status.error(line, kdl::str_to_string("Failed to parse included file: ", e.what()));
+
+                // record the missing file so that callers who cache the definitions can tell when it appears
+                try {
+                    auto missingFile = std::make_unique<ParsedFile>();
+                    missingFile->path = m_fs->makeAbsolute(currentRoot() + path);
+                    missingFile->failed = true;
+                    file.includes.push_back({ file.classes.size(), file.status.messageCount(), std::move(missingFile) });
+                } catch (const Exception&) {
+                    // the path is invalid, so the file cannot appear later on
+                }
+            }
+        }
+
+        void FgdParser::resolveFile(ParserStatus& status, ParsedFile& file, EntityDefinitionList& definitions) {
+            // pass on the buffered messages in the order in which they would have been reported by a single pass
+            size_t replayedCount = 0u;
+            const auto replayUntil = [&](const size_t messageCount) {
+                file.status.replay(status, replayedCount, messageCount);
+                replayedCount = messageCount;
+            };
+
+            auto include = std::begin(file.includes);
+            for (size_t i = 0u; i <= file.classes.size(); ++i) {
+                for (; include != std::end(file.includes) && include->position == i; ++include) {
+                    replayUntil(include->messageCount);
+                    resolveInclude(status, *include->file, definitions);
+                }
+                if (i < file.classes.size()) {
+                    auto& parsedClass = file.classes[i];
+                    replayUntil(parsedClass.messageCount);
+
+                    auto* definition = resolveClass(status, parsedClass.parsedClass);
+                    if (definition != nullptr) {
+                        definitions.push_back(definition);
+                    }
+                }
+            }
+            replayUntil(file.status.messageCount());
+        }
+
+        void FgdParser::resolveInclude(ParserStatus& status, ParsedFile& file, EntityDefinitionList& definitions) {
+            m_includedFiles.push_back(file.path);
+
+            if (!file.failed) {
+                resolveFile(status, file, definitions);
+            } else {
+                // the definitions of a file that failed to parse are dropped, but its base classes remain available
+                EntityDefinitionList discarded;
+                resolveFile(status, file, discarded);
+                kdl::vec_clear_and_delete(discarded);
+            }
+        }
+
+        Assets::EntityDefinition* FgdParser::resolveClass(ParserStatus& status, ParsedClass& parsedClass) {
+            auto& classInfo = parsedClass.classInfo;
+            classInfo.resolveBaseClasses(m_baseClasses, parsedClass.superClasses);
+
+            switch (parsedClass.type) {
+                case ClassType::BaseClass: {
+                    const auto name = classInfo.name();
+                    if (m_baseClasses.count(name) > 0) {
+                        status.warn(classInfo.line(), classInfo.column(), "Redefinition of base class '" + name + "'");
+                    }
+                    m_baseClasses[name] = std::move(classInfo);
+                    return nullptr;
                 }
-            } catch (const Exception &e) {
-                status.error(m_tokenizer.line(), kdl::str_to_string("Failed to parse included file: ", e.what()));
+                case ClassType::PointClass:
+                    return resolvePointClass(classInfo);
+                case ClassType::SolidClass:
+                    return resolveSolidClass(status, classInfo);
+                switchDefault()
+            }
+        }
+
+        Assets::EntityDefinition* FgdParser::resolveSolidClass(ParserStatus& status, const EntityDefinitionClassInfo& classInfo) {
+            if (classInfo.hasSize()) {
+                status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have a size");
+            }
+            if (classInfo.hasModelDefinition()) {
+                status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have model definitions");
             }
+            return new Assets::BrushEntityDefinition(classInfo.name(), classInfo.color(), classInfo.description(), classInfo.attributeList());
+        }
 
-            m_tokenizer.restore(snapshot);
-            return result;
+        Assets::EntityDefinition* FgdParser::resolvePointClass(const EntityDefinitionClassInfo& classInfo) {
+            return new Assets::PointEntityDefinition(classInfo.name(), classInfo.color(), classInfo.size(), classInfo.description(), classInfo.attributeList(), classInfo.modelDefinition());
         }
     }
 }
@@ -27,12 +27,15 @@
 #include "IO/Parser.h"
 #include "IO/Tokenizer.h"
 
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
+    class TaskGroup;
+
     namespace Assets {
         class ModelDefinition;
     }
@@ -72,6 +75,23 @@ namespace TrenchBroom {
         private:
             using Token = FgdTokenizer::Token;
 
+            enum class ClassType {
+                BaseClass,
+                PointClass,
+                SolidClass
+            };
+
+            /**
+             * A class as it was parsed, before its base classes were resolved.
+             */
+            struct ParsedClass {
+                ClassType type;
+                EntityDefinitionClassInfo classInfo;
+                std::vector<std::string> superClasses;
+            };
+
+            struct ParsedFile;
+
             Color m_defaultEntityColor;
 
             std::vector<Path> m_paths;
@@ -79,28 +99,39 @@ namespace TrenchBroom {
 
             FgdTokenizer m_tokenizer;
             std::map<std::string, EntityDefinitionClassInfo> m_baseClasses;
+            std::vector<Path> m_includedFiles;
         public:
             FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, const Path& path);
             FgdParser(const std::string& str, const Color& defaultEntityColor, const Path& path);
             FgdParser(const std::string& str, const Color& defaultEntityColor);
+
+            /**
+             * Returns the absolute paths of the files which were included while parsing the definitions, directly or
+             * indirectly, in the order in which they were included. This includes the files which could not be opened.
+             */
+            const std::vector<Path>& includedFiles() const;
         private:
-            class PushIncludePath;
-            void pushIncludePath(const Path& path);
-            void popIncludePath();
+            FgdParser(const char* begin, const char* end, const Color& defaultEntityColor, std::shared_ptr<FileSystem> fs, std::vector<Path> paths);
 
             Path currentRoot() const;
             bool isRecursiveInclude(const Path& path) const;
         private:
             TokenNameMap tokenNames() const override;
+
+            /**
+             * Parsing happens in two steps. First, the classes of the host file are parsed without resolving their
+             * base classes, and every included file is parsed the same way by a task, so that independent include
+             * files are parsed concurrently. Then the base classes are resolved in the order in which the classes
+             * appear in the files, and the entity definitions are created. The messages of both steps are buffered and
+             * passed on in the order in which they would have been reported if everything was parsed in one pass.
+             */
             EntityDefinitionList doParseDefinitions(ParserStatus& status) override;
 
-            void parseDefinitionOrInclude(ParserStatus& status, EntityDefinitionList& definitions);
+            void parseFile(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file);
+            void parseDefinitionOrInclude(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file);
 
-            Assets::EntityDefinition* parseDefinition(ParserStatus& status);
-            Assets::EntityDefinition* parseSolidClass(ParserStatus& status);
-            Assets::EntityDefinition* parsePointClass(ParserStatus& status);
-            EntityDefinitionClassInfo parseBaseClass(ParserStatus& status);
-            EntityDefinitionClassInfo parseClass(ParserStatus& status);
+            std::optional<ParsedClass> parseDefinition(ParserStatus& status);
+            ParsedClass parseClass(ParserStatus& status, ClassType type);
             void skipMainClass(ParserStatus& status);
 
             std::vector<std::string> parseSuperClasses(ParserStatus& status);
@@ -130,8 +161,13 @@ namespace TrenchBroom {
             Color parseColor(ParserStatus& status);
             std::string parseString(ParserStatus& status);
 
-            EntityDefinitionList parseInclude(ParserStatus& status);
-            EntityDefinitionList handleInclude(ParserStatus& status, const Path& path);
+            void parseInclude(ParserStatus& status, TaskGroup& includeTasks, ParsedFile& file);
+
+            void resolveFile(ParserStatus& status, ParsedFile& file, EntityDefinitionList& definitions);
+            void resolveInclude(ParserStatus& status, ParsedFile& file, EntityDefinitionList& definitions);
+            Assets::EntityDefinition* resolveClass(ParserStatus& status, ParsedClass& parsedClass);
+            Assets::EntityDefinition* resolveSolidClass(ParserStatus& status, const EntityDefinitionClassInfo& classInfo);
+            Assets::EntityDefinition* resolvePointClass(const EntityDefinitionClassInfo& classInfo);
         };
     }
 }
@@ -186,9 +186,9 @@ namespace TrenchBroom {
 
             if (!token.hasType(MdlToken::CParenthesis)) {
                 do {
-                    if (kdl::ci::str_is_equal("skinKey", token.data())) {
+                    if (kdl::ci::str_is_equal("skinKey", token.view())) {
                         map.insert({ "skin", parseNamedValue(status, "skinKey") });
-                    } else if (kdl::ci::str_is_equal("frameKey", token.data())) {
+                    } else if (kdl::ci::str_is_equal("frameKey", token.view())) {
                         map.insert({ "frame", parseNamedValue(status, "frameKey") });
                     } else {
                         const std::string msg = "Expected 'skinKey' or 'frameKey', but found '" + token.data() + "'";
@@ -207,7 +207,7 @@ namespace TrenchBroom {
 
             const size_t line = token.line();
             const size_t column = token.column();
-            if (!kdl::ci::str_is_equal(name, token.data()))
+            if (!kdl::ci::str_is_equal(name, token.view()))
                 throw ParserException(line, column, "Expected '" + name + "', but got '" + token.data() + "'");
 
             expect(status, MdlToken::Equality, token = m_tokenizer.nextToken());
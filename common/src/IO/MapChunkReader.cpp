@@ -0,0 +1,222 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapChunkReader.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cassert>
+#include <istream>
+
+namespace TrenchBroom {
+    namespace IO {
+        const size_t MapChunkReader::DefaultReadSize = 1u << 20u;
+
+        static bool isWhitespace(const char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        static bool isNumberChar(const char c) {
+            return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' || c == 'e';
+        }
+
+        /**
+         * Counts the line breaks in the same way as TokenizerState::advance.
+         */
+        static size_t countLines(const char* begin, const char* end) {
+            size_t result = 0u;
+            for (const char* c = begin; c != end; ++c) {
+                if (*c == '\n' || (*c == '\r' && (c + 1 == end || *(c + 1) != '\n'))) {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        MapChunkReader::MapChunkReader(std::istream& stream, const size_t readSize) :
+        m_stream(stream),
+        m_readSize(readSize),
+        m_peakBufferSize(0u),
+        m_chunkEnd(0u),
+        m_line(1u),
+        m_scanPos(0u),
+        m_boundary(0u),
+        m_state(State::TokenStart),
+        m_depth(0u),
+        m_escaped(false),
+        m_numeric(false),
+        m_balanced(true) {
+            assert(m_readSize > 0u);
+        }
+
+        std::tuple<const char*, const char*, size_t> MapChunkReader::nextChunk() {
+            // release the previous chunk, the returned chunk always ends at the last boundary found so far
+            m_buffer.erase(std::begin(m_buffer), std::next(std::begin(m_buffer), static_cast<std::ptrdiff_t>(m_chunkEnd)));
+            m_scanPos -= m_chunkEnd;
+            m_chunkEnd = 0u;
+            m_boundary = 0u;
+
+            while (m_boundary == 0u && read()) {
+                scan();
+            }
+
+            // if no boundary was found, the stream is exhausted and we return the remainder
+            m_chunkEnd = m_boundary != 0u ? m_boundary : m_buffer.size();
+
+            const auto* begin = m_buffer.data();
+            const auto* end = begin + m_chunkEnd;
+            const auto line = m_line;
+            m_line += countLines(begin, end);
+
+            return std::make_tuple(begin, end, line);
+        }
+
+        size_t MapChunkReader::peakBufferSize() const {
+            return m_peakBufferSize;
+        }
+
+        bool MapChunkReader::read() {
+            if (!m_stream.good()) {
+                return false;
+            }
+
+            const auto oldSize = m_buffer.size();
+            m_buffer.resize(oldSize + m_readSize);
+            m_stream.read(m_buffer.data() + oldSize, static_cast<std::streamsize>(m_readSize));
+            if (m_stream.bad()) {
+                throw FileSystemException("Cannot read map file");
+            }
+
+            const auto count = static_cast<size_t>(m_stream.gcount());
+            m_buffer.resize(oldSize + count);
+            m_peakBufferSize = std::max(m_peakBufferSize, m_buffer.capacity());
+
+            return count > 0u;
+        }
+
+        void MapChunkReader::scan() {
+            while (m_scanPos < m_buffer.size()) {
+                const auto c = m_buffer[m_scanPos];
+                switch (m_state) {
+                    case State::TokenStart:
+                        switch (c) {
+                            case '"':
+                                m_state = State::QuotedString;
+                                m_escaped = false;
+                                break;
+                            case '/':
+                                m_state = State::Slash;
+                                break;
+                            case ';':
+                                m_state = State::Comment;
+                                break;
+                            case '{':
+                                if (m_depth < 2u) {
+                                    openBrace();
+                                } else {
+                                    m_state = State::OBrace;
+                                }
+                                break;
+                            case '}':
+                                closeBrace();
+                                break;
+                            case ' ':
+                            case '\t':
+                            case '\n':
+                            case '\r':
+                            case '(':
+                            case ')':
+                            case '[':
+                            case ']':
+                                break;
+                            default:
+                                m_state = State::Word;
+                                m_numeric = isNumberChar(c);
+                                break;
+                        }
+                        ++m_scanPos;
+                        break;
+                    case State::Word:
+                        // numbers are also delimited by closing parentheses, see QuakeMapTokenizer::NumberDelim
+                        if (isWhitespace(c) || (m_numeric && c == ')')) {
+                            m_state = State::TokenStart;
+                        } else {
+                            m_numeric = m_numeric && isNumberChar(c);
+                        }
+                        ++m_scanPos;
+                        break;
+                    case State::QuotedString:
+                        if (c == '"') {
+                            m_state = m_escaped ? State::EscapedQuote : State::TokenStart;
+                        }
+                        m_escaped = c == '\\' && !m_escaped;
+                        ++m_scanPos;
+                        break;
+                    case State::EscapedQuote:
+                        // an escaped quote followed by a line break or a closing brace ends the string, see
+                        // QuakeMapTokenizer::emitToken
+                        m_state = (c == '\n' || c == '}') ? State::TokenStart : State::QuotedString;
+                        break;
+                    case State::Slash:
+                        if (c == '/') {
+                            m_state = State::Comment;
+                            ++m_scanPos;
+                        } else {
+                            m_state = State::TokenStart;
+                        }
+                        break;
+                    case State::Comment:
+                        if (c == '\n' || c == '\r') {
+                            m_state = State::TokenStart;
+                        }
+                        ++m_scanPos;
+                        break;
+                    case State::OBrace:
+                        if (isWhitespace(c)) {
+                            openBrace();
+                            m_state = State::TokenStart;
+                        } else {
+                            // part of a texture name
+                            m_state = State::Word;
+                            m_numeric = false;
+                        }
+                        ++m_scanPos;
+                        break;
+                }
+            }
+        }
+
+        void MapChunkReader::openBrace() {
+            ++m_depth;
+        }
+
+        void MapChunkReader::closeBrace() {
+            if (m_depth == 0u) {
+                m_balanced = false;
+                return;
+            }
+
+            --m_depth;
+            if (m_balanced && m_depth <= 1u) {
+                m_boundary = m_scanPos + 1u;
+            }
+        }
+    }
+}
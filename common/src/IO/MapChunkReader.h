@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapChunkReader
+#define TrenchBroom_MapChunkReader
+
+#include <iosfwd>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Reads a map file from a stream through a sliding window and splits it into chunks which can be parsed one
+         * after another. A chunk always ends after a closing brace that ends an entity or a brush which belongs to an
+         * entity, so the parser can continue with the next chunk where it would otherwise have seen the end of the
+         * file. Only the unparsed remainder of the file and the data read ahead are kept in memory.
+         *
+         * The chunk boundaries are found by a scanner which mimics the QuakeMapTokenizer, skipping quoted strings and
+         * comments. Inside of brushes, an opening brace that is immediately followed by another character is taken to
+         * be part of a texture name such as "{FENCE". If the scanner finds a closing brace without a matching opening
+         * brace, it stops splitting and the remainder of the stream is returned as a single chunk.
+         */
+        class MapChunkReader {
+        public:
+            static const size_t DefaultReadSize;
+        private:
+            enum class State {
+                TokenStart,
+                Word,
+                QuotedString,
+                EscapedQuote,
+                Slash,
+                Comment,
+                OBrace
+            };
+
+            std::istream& m_stream;
+            size_t m_readSize;
+            std::vector<char> m_buffer;
+            size_t m_peakBufferSize;
+
+            size_t m_chunkEnd;
+            size_t m_line;
+
+            size_t m_scanPos;
+            size_t m_boundary;
+            State m_state;
+            size_t m_depth;
+            bool m_escaped;
+            bool m_numeric;
+            bool m_balanced;
+        public:
+            /**
+             * Creates a new chunk reader.
+             *
+             * @param stream the stream to read from
+             * @param readSize the number of bytes to read from the stream at once
+             */
+            explicit MapChunkReader(std::istream& stream, size_t readSize = DefaultReadSize);
+
+            /**
+             * Returns the next chunk and the line number at which it starts. The chunk is valid until this function
+             * is called again. An empty chunk is returned once the stream is exhausted.
+             *
+             * @throw FileSystemException if the stream cannot be read
+             */
+            std::tuple<const char*, const char*, size_t> nextChunk();
+
+            /**
+             * Returns the maximum number of bytes that were held in memory at once.
+             */
+            size_t peakBufferSize() const;
+        private:
+            bool read();
+            void scan();
+            void openBrace();
+            void closeBrace();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapChunkReader) */
@@ -75,6 +75,12 @@ namespace TrenchBroom {
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
+        MapReader::MapReader(std::istream& stream, const size_t readSize) :
+        StandardMapParser(stream, readSize),
+        m_factory(nullptr),
+        m_brushParent(nullptr),
+        m_currentNode(nullptr) {}
+
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
             parseEntities(format, status);
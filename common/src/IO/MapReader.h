@@ -28,6 +28,7 @@
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
 
+#include <iosfwd>
 #include <map>
 #include <string>
 #include <vector>
@@ -95,6 +96,7 @@ namespace TrenchBroom {
         protected:
             MapReader(const char* begin, const char* end);
             explicit MapReader(const std::string& str);
+            MapReader(std::istream& stream, size_t readSize);
 
             void readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
@@ -162,7 +162,7 @@ namespace TrenchBroom {
 
         void NodeSerializer::brush(const Model::BrushNode* brushNode) {
             beginBrush(brushNode);
-            brushFaces(brushNode->brush().faces());
+            brushFaces(brushNode->faces());
             endBrush(brushNode);
         }
 
@@ -67,14 +67,14 @@ namespace TrenchBroom {
             }
 
             void expect(const std::string& expected, const Token& token) const {
-                if (token.data() != expected) {
+                if (token.view() != expected) {
                     throw ParserException(token.line(), token.column(), "Expected string '" + expected + "', but got '" + token.data() + "'");
                 }
             }
 
             void expect(const std::vector<std::string>& expected, const Token& token) const {
                 for (const auto& str : expected) {
-                    if (token.data() == str) {
+                    if (token.view() == str) {
                         return;
                     }
                 }
@@ -82,7 +82,7 @@ namespace TrenchBroom {
             }
        private:
             std::string expectString(const std::string& expected, const Token& token) const {
-                return "Expected " + expected + ", but got " + tokenName(token.type()) + (!token.data().empty() ? " (raw data: '" + token.data() + "')" : "");
+                return "Expected " + expected + ", but got " + tokenName(token.type()) + (token.length() > 0u ? " (raw data: '" + token.data() + "')" : "");
             }
         protected:
             std::string tokenName(const TokenType typeMask) const {
@@ -101,6 +101,14 @@ namespace TrenchBroom {
             throw ParserException(buildMessage(str));
         }
 
+        void ParserStatus::forward(const LogLevel level, const std::string& str) {
+            if (!m_prefix.empty()) {
+                doLog(level, m_prefix + ": " + str);
+            } else {
+                doLog(level, str);
+            }
+        }
+
         void ParserStatus::log(const LogLevel level, const size_t line, const size_t column, const std::string& str) {
             doLog(level, buildMessage(line, column, str));
         }
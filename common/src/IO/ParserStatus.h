@@ -55,6 +55,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs the given message, which was already built by another parser status, without adding position
+             * information to it. The prefix of this parser status is prepended if it is not empty.
+             */
+            void forward(LogLevel level, const std::string& str);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
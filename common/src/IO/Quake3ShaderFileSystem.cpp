@@ -20,16 +20,20 @@
 #include "Quake3ShaderFileSystem.h"
 
 #include "Logger.h"
+#include "TaskScheduler.h"
 #include "Assets/Quake3Shader.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Quake3ShaderParser.h"
+#include "IO/Reader.h"
 #include "IO/SimpleParserStatus.h"
 
 #include <kdl/vector_utils.h>
 
+#include <iterator>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -54,17 +58,36 @@ namespace TrenchBroom {
 
             if (next().directoryExists(m_shaderSearchPath)) {
                 const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
+
+                // the file system is not thread safe, so the files are read up front
+                auto readers = std::vector<BufferedReader>();
+                readers.reserve(paths.size());
                 for (const auto& path : paths) {
                     const auto file = next().openFile(path);
-                    auto bufferedReader = file->reader().buffer();
+                    readers.push_back(file->reader().buffer());
+                }
+
+                // parse the files concurrently and collect their shaders and messages in the order of the files
+                auto shadersPerFile = std::vector<std::vector<Assets::Quake3Shader>>(paths.size());
+                auto loggers = std::vector<BufferedLogger>(paths.size());
+                TaskScheduler::instance().parallelFor(paths.size(), [&](const size_t i) {
+                    const auto& path = paths[i];
+                    const auto& reader = readers[i];
+                    auto& logger = loggers[i];
 
                     try {
-                        Quake3ShaderParser parser(std::begin(bufferedReader), std::end(bufferedReader));
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        kdl::vec_append(result, parser.parse(status));
+                        Quake3ShaderParser parser(std::begin(reader), std::end(reader));
+                        SimpleParserStatus status(logger, path.asString());
+                        shadersPerFile[i] = parser.parse(status);
                     } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
                     }
+                });
+
+                for (size_t i = 0u; i < paths.size(); ++i) {
+                    loggers[i].flush(m_logger);
+                    auto& shaders = shadersPerFile[i];
+                    result.insert(std::end(result), std::make_move_iterator(std::begin(shaders)), std::make_move_iterator(std::end(shaders)));
                 }
             }
 
@@ -89,24 +112,32 @@ namespace TrenchBroom {
 
         void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders) {
             m_logger.debug() << "Linking textures...";
+
+            // If there are several shaders with the same path, only the first one is linked to a texture.
+            auto shaderIndices = std::unordered_map<std::string, size_t>();
+            shaderIndices.reserve(shaders.size());
+            for (size_t i = 0u; i < shaders.size(); ++i) {
+                shaderIndices.emplace(shaders[i].shaderPath.asString("/"), i);
+            }
+
+            auto linked = std::vector<bool>(shaders.size(), false);
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
 
                 // Only link a shader if it has not been linked yet.
                 if (!fileExists(shaderPath)) {
-                    const auto shaderIt = std::find_if(std::begin(shaders), std::end(shaders), [&shaderPath](const auto& shader){
-                        return shaderPath == shader.shaderPath;
-                    });
-
-                    if (shaderIt != std::end(shaders)) {
+                    const auto indexIt = shaderIndices.find(shaderPath.asString("/"));
+                    if (indexIt != std::end(shaderIndices)) {
                         // Found a matching shader.
-                        auto& shader = *shaderIt;
+                        const auto index = indexIt->second;
+                        auto& shader = shaders[index];
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
                         m_root.addFile(shaderPath, shaderFile);
 
-                        // Remove the shader so that we don't revisit it when linking standalone shaders.
-                        shaders.erase(shaderIt);
+                        // Mark the shader so that we don't revisit it when linking standalone shaders.
+                        linked[index] = true;
+                        shaderIndices.erase(indexIt);
                     } else {
                         // No matching shader found, generate one.
                         auto shader = Assets::Quake3Shader();
@@ -118,6 +149,16 @@ namespace TrenchBroom {
                     }
                 }
             }
+
+            // Remove the linked shaders in one pass, keeping the order of the remaining ones.
+            auto remaining = std::vector<Assets::Quake3Shader>();
+            remaining.reserve(shaders.size());
+            for (size_t i = 0u; i < shaders.size(); ++i) {
+                if (!linked[i]) {
+                    remaining.push_back(std::move(shaders[i]));
+                }
+            }
+            shaders = std::move(remaining);
         }
 
         void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
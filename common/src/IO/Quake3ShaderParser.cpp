@@ -165,7 +165,7 @@ namespace TrenchBroom {
         void Quake3ShaderParser::parseBodyEntry(Assets::Quake3Shader& shader, ParserStatus& /* status */) {
             auto token = m_tokenizer.nextToken(Quake3ShaderToken::Eol);
             expect(Quake3ShaderToken::String, token);
-            const auto key = token.data();
+            const auto key = token.view();
             if (key == "qer_editorimage") {
                 token = expect(Quake3ShaderToken::String, m_tokenizer.nextToken());
                 shader.editorImage = Path(token.data());
@@ -177,7 +177,7 @@ namespace TrenchBroom {
                 shader.surfaceParms.insert(token.data());
             } else if (key == "cull") {
                 token = expect(Quake3ShaderToken::String, m_tokenizer.nextToken());
-                const auto value = token.data();
+                const auto value = token.view();
                 if (value == "front") {
                     shader.culling = Assets::Quake3Shader::Culling::Front;
                 } else if (value == "back") {
@@ -193,7 +193,7 @@ namespace TrenchBroom {
         void Quake3ShaderParser::parseStageEntry(Assets::Quake3ShaderStage& stage, ParserStatus& status) {
             auto token = m_tokenizer.nextToken(Quake3ShaderToken::Eol);
             expect(Quake3ShaderToken::String, token);
-            const auto key = token.data();
+            const auto key = token.view();
             if (key == "map") {
                 token = expect(Quake3ShaderToken::String | Quake3ShaderToken::Variable, m_tokenizer.nextToken());
                 stage.map = Path(token.data());
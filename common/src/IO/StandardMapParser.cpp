@@ -19,16 +19,17 @@
 
 #include "StandardMapParser.h"
 
+#include "IO/MapChunkReader.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityAttributes.h"
 
 #include <kdl/invoke.h>
-#include <kdl/vector_set.h>
 
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -149,6 +150,11 @@ namespace TrenchBroom {
         m_tokenizer(QuakeMapTokenizer(str)),
         m_format(Model::MapFormat::Unknown) {}
 
+        StandardMapParser::StandardMapParser(std::istream& stream, const size_t readSize) :
+        m_tokenizer(QuakeMapTokenizer(nullptr, nullptr)),
+        m_format(Model::MapFormat::Unknown),
+        m_chunkReader(std::make_unique<MapChunkReader>(stream, readSize)) {}
+
         StandardMapParser::~StandardMapParser() = default;
 
         Model::MapFormat StandardMapParser::detectFormat() {
@@ -208,11 +214,11 @@ namespace TrenchBroom {
         void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status) {
             setFormat(format);
 
-            auto token = m_tokenizer.peekToken();
+            auto token = peekTokenOrLoadChunk();
             while (token.type() != QuakeMapToken::Eof) {
                 expect(QuakeMapToken::OBrace, token);
                 parseEntity(status);
-                token = m_tokenizer.peekToken();
+                token = peekTokenOrLoadChunk();
             }
         }
 
@@ -249,6 +255,20 @@ namespace TrenchBroom {
             formatSet(format);
         }
 
+        StandardMapParser::Token StandardMapParser::peekTokenOrLoadChunk() {
+            auto token = m_tokenizer.peekToken();
+            while (token.type() == QuakeMapToken::Eof && m_chunkReader != nullptr) {
+                const auto [begin, end, line] = m_chunkReader->nextChunk();
+                if (begin == end) {
+                    break;
+                }
+
+                m_tokenizer.rebase(begin, end, line);
+                token = m_tokenizer.peekToken();
+            }
+            return token;
+        }
+
         void StandardMapParser::parseEntity(ParserStatus& status) {
             Token token = m_tokenizer.nextToken();
             if (token.type() == QuakeMapToken::Eof) {
@@ -260,7 +280,6 @@ namespace TrenchBroom {
             auto beginEntityCalled = false;
 
             auto attributes = std::vector<Model::EntityAttribute>();
-            auto attributeNames = AttributeNames();
 
             auto extraAttributes = ExtraAttributes();
             const auto startLine = token.line();
@@ -273,7 +292,7 @@ namespace TrenchBroom {
                         parseExtraAttributes(extraAttributes, status);
                         break;
                     case QuakeMapToken::String:
-                        parseEntityAttribute(attributes, attributeNames, status);
+                        parseEntityAttribute(attributes, status);
                         break;
                     case QuakeMapToken::OBrace:
                         if (!beginEntityCalled) {
@@ -293,26 +312,29 @@ namespace TrenchBroom {
                         expect(QuakeMapToken::Comment | QuakeMapToken::String | QuakeMapToken::OBrace | QuakeMapToken::CBrace, token);
                 }
 
-                token = m_tokenizer.peekToken();
+                token = peekTokenOrLoadChunk();
             }
         }
 
-        void StandardMapParser::parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, AttributeNames& names, ParserStatus& status) {
+        void StandardMapParser::parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, ParserStatus& status) {
             auto token = m_tokenizer.nextToken();
             assert(token.type() == QuakeMapToken::String);
-            const auto name = token.data();
+            const auto name = token.view();
 
             const auto line = token.line();
             const auto column = token.column();
 
             expect(QuakeMapToken::String, token = m_tokenizer.nextToken());
-            const auto value = token.data();
 
-            if (names.count(name) == 0) {
-                attributes.push_back(Model::EntityAttribute(name, value, nullptr));
-                names.insert(name);
+            // entities have few attributes, so a linear search is cheaper than maintaining a set of names
+            const auto isDuplicate = std::any_of(std::begin(attributes), std::end(attributes), [&](const auto& attribute) {
+                return attribute.name() == name;
+            });
+
+            if (!isDuplicate) {
+                attributes.push_back(Model::EntityAttribute(std::string(name), token.data(), nullptr));
             } else {
-                status.warn(line, column, "Ignoring duplicate entity property '" + name + "'");
+                status.warn(line, column, "Ignoring duplicate entity property '" + std::string(name) + "'");
             }
         }
 
@@ -332,7 +354,7 @@ namespace TrenchBroom {
                 expect(QuakeMapToken::String | QuakeMapToken::OParenthesis, token);
                 if (token.hasType(QuakeMapToken::String)) {
                     expect(std::vector<std::string>({ BrushPrimitiveId, PatchId }), token);
-                    if (token.data() == BrushPrimitiveId) {
+                    if (token.view() == BrushPrimitiveId) {
                         parseBrushPrimitive(status, startLine);
                     } else {
                         parsePatch(status, startLine);
@@ -677,7 +699,7 @@ namespace TrenchBroom {
         }
 
         std::string StandardMapParser::parseTextureName(ParserStatus& /* status */) {
-            return m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
+            return std::string(m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace()));
         }
 
         std::tuple<vm::vec3, float, vm::vec3, float> StandardMapParser::parseValveTextureAxes(ParserStatus& /* status */) {
@@ -26,16 +26,17 @@
 #include "IO/Tokenizer.h"
 #include "Model/MapFormat.h"
 
-#include <kdl/vector_set_forward.h>
-
 #include <vecmath/forward.h>
 
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        class MapChunkReader;
         class ParserStatus;
 
         namespace QuakeMapToken {
@@ -71,17 +72,26 @@ namespace TrenchBroom {
         class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
         private:
             using Token = QuakeMapTokenizer::Token;
-            using AttributeNames = kdl::vector_set<std::string>;
 
             static const std::string BrushPrimitiveId;
             static const std::string PatchId;
 
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
+            std::unique_ptr<MapChunkReader> m_chunkReader;
         public:
             StandardMapParser(const char* begin, const char* end);
             explicit StandardMapParser(const std::string& str);
 
+            /**
+             * Creates a parser which reads the given stream in chunks instead of requiring the entire file to be held
+             * in memory. Only parseEntities is supported in this mode.
+             *
+             * @param stream the stream to read from
+             * @param readSize the number of bytes to read from the stream at once
+             */
+            StandardMapParser(std::istream& stream, size_t readSize);
+
             ~StandardMapParser() override;
         protected:
             Model::MapFormat detectFormat();
@@ -94,8 +104,15 @@ namespace TrenchBroom {
         private:
             void setFormat(Model::MapFormat format);
 
+            /**
+             * Returns the next token without consuming it. When reading from a stream, the next chunk is loaded if the
+             * current chunk is exhausted. Must only be called where a chunk can end, that is, between entities or
+             * between the brushes of an entity.
+             */
+            Token peekTokenOrLoadChunk();
+
             void parseEntity(ParserStatus& status);
-            void parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, AttributeNames& names, ParserStatus& status);
+            void parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, ParserStatus& status);
 
             void parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status);
             void parseBrushPrimitive(ParserStatus& status, size_t startLine);
@@ -0,0 +1,302 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskIO.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string_view>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace TextureCacheLayout {
+            static const std::string Magic = "TBTC";
+            // increment whenever the layout or the decoding of textures changes
+            static constexpr uint32_t Version = 1u;
+            static const std::string Extension = "texcache";
+        }
+
+        TextureCache::Collection::Collection() :
+        m_begin(nullptr),
+        m_end(nullptr) {}
+
+        TextureCache::Collection::Collection(std::unique_ptr<QFile> file, const char* begin, const char* end, const std::string& key) :
+        m_file(std::move(file)),
+        m_begin(begin),
+        m_end(end) {
+            auto reader = Reader::from(m_begin, m_end);
+            if (reader.readString(TextureCacheLayout::Magic.size()) != TextureCacheLayout::Magic ||
+                reader.readUnsignedInt<uint32_t>() != TextureCacheLayout::Version ||
+                reader.readString(reader.readSize<uint32_t>()) != key) {
+                // a stale cache file or a hash collision between two keys
+                return;
+            }
+
+            const auto entryCount = reader.readSize<uint32_t>();
+            for (size_t i = 0u; i < entryCount; ++i) {
+                const auto entrySize = reader.readSize<uint64_t>();
+                const auto offset = reader.position();
+
+                const auto path = reader.readString(reader.readSize<uint32_t>());
+                const auto contentHash = reader.read<uint64_t, uint64_t>();
+                m_index[path] = Index{contentHash, offset};
+
+                reader.seekFromBegin(offset + entrySize);
+            }
+        }
+
+        TextureCache::Collection::~Collection() = default;
+
+        TextureCache::Collection::Collection(Collection&& other) noexcept = default;
+        TextureCache::Collection& TextureCache::Collection::operator=(Collection&& other) noexcept = default;
+
+        size_t TextureCache::Collection::textureCount() const {
+            return m_index.size();
+        }
+
+        std::unique_ptr<Assets::Texture> TextureCache::Collection::readTexture(const Path& path, const uint64_t contentHash) const {
+            const auto it = m_index.find(path.asString("/"));
+            if (it == std::end(m_index) || it->second.contentHash != contentHash) {
+                return nullptr;
+            }
+
+            auto reader = Reader::from(m_begin, m_end);
+            reader.seekFromBegin(it->second.offset);
+            reader.seekForward(reader.readSize<uint32_t>()); // path
+            reader.seekForward(sizeof(uint64_t)); // content hash
+
+            const auto name = reader.readString(reader.readSize<uint32_t>());
+            const auto width = reader.readSize<uint32_t>();
+            const auto height = reader.readSize<uint32_t>();
+            const auto format = static_cast<GLenum>(reader.readUnsignedInt<uint32_t>());
+            const auto type = static_cast<Assets::TextureType>(reader.readUnsignedChar<uint8_t>());
+            const auto culling = static_cast<Assets::TextureCulling>(reader.readUnsignedChar<uint8_t>());
+            const auto blendEnable = static_cast<Assets::TextureBlendFunc::Enable>(reader.readUnsignedChar<uint8_t>());
+            const auto srcFactor = static_cast<GLenum>(reader.readUnsignedInt<uint32_t>());
+            const auto destFactor = static_cast<GLenum>(reader.readUnsignedInt<uint32_t>());
+
+            Color averageColor;
+            for (size_t i = 0u; i < 4u; ++i) {
+                averageColor[i] = reader.readFloat<float>();
+            }
+
+            std::set<std::string> surfaceParms;
+            const auto surfaceParmCount = reader.readSize<uint32_t>();
+            for (size_t i = 0u; i < surfaceParmCount; ++i) {
+                surfaceParms.insert(reader.readString(reader.readSize<uint32_t>()));
+            }
+
+            const auto bytesPerPixel = Assets::bytesPerPixelForFormat(format);
+            Assets::TextureBufferList buffers(reader.readSize<uint32_t>());
+            for (size_t level = 0u; level < buffers.size(); ++level) {
+                const auto size = Assets::sizeAtMipLevel(width, height, level);
+                buffers[level].resize(bytesPerPixel * size.x() * size.y());
+                reader.read(buffers[level].data(), buffers[level].size());
+            }
+
+            auto texture = std::make_unique<Assets::Texture>(name, width, height, averageColor, std::move(buffers), format, type);
+            texture->setSurfaceParms(surfaceParms);
+            texture->setCulling(culling);
+            switch (blendEnable) {
+                case Assets::TextureBlendFunc::Enable::UseFactors:
+                    texture->setBlendFunc(srcFactor, destFactor);
+                    break;
+                case Assets::TextureBlendFunc::Enable::DisableBlend:
+                    texture->disableBlend();
+                    break;
+                case Assets::TextureBlendFunc::Enable::UseDefault:
+                    break;
+            }
+            return texture;
+        }
+
+        TextureCache::TextureCache(const Path& directory, const size_t maxSize) :
+        m_directory(directory),
+        m_maxSize(maxSize) {}
+
+        const Path& TextureCache::directory() const {
+            return m_directory;
+        }
+
+        size_t TextureCache::maxSize() const {
+            return m_maxSize;
+        }
+
+        TextureCache::Collection TextureCache::readCollection(const std::string& key) const {
+            const auto path = cacheFilePath(key);
+
+            auto file = std::make_unique<QFile>(pathAsQString(path));
+            if (!file->open(QIODevice::ReadOnly) || file->size() == 0) {
+                return Collection();
+            }
+
+            auto* memory = file->map(0, file->size());
+            if (memory == nullptr) {
+                return Collection();
+            }
+
+            // the modification time of a cache file is its last use for evicting the least recently used files
+            file->setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+            const auto* begin = reinterpret_cast<const char*>(memory);
+            const auto* end = begin + file->size();
+            try {
+                return Collection(std::move(file), begin, end, key);
+            } catch (const ReaderException&) {
+                return Collection();
+            }
+        }
+
+        template <typename T>
+        static void write(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void writeString(std::ostream& stream, const std::string& str) {
+            write(stream, static_cast<uint32_t>(str.size()));
+            stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+
+        static void writeEntry(std::ostream& stream, const TextureCache::Entry& entry) {
+            const auto& texture = *entry.texture;
+            const auto& blendFunc = texture.blendFunc();
+            const auto& averageColor = texture.averageColor();
+
+            writeString(stream, entry.path.asString("/"));
+            write(stream, entry.contentHash);
+            writeString(stream, texture.name());
+            write(stream, static_cast<uint32_t>(texture.width()));
+            write(stream, static_cast<uint32_t>(texture.height()));
+            write(stream, static_cast<uint32_t>(texture.format()));
+            write(stream, static_cast<uint8_t>(texture.type()));
+            write(stream, static_cast<uint8_t>(texture.culling()));
+            write(stream, static_cast<uint8_t>(blendFunc.enable));
+            write(stream, static_cast<uint32_t>(blendFunc.srcFactor));
+            write(stream, static_cast<uint32_t>(blendFunc.destFactor));
+            for (size_t i = 0u; i < 4u; ++i) {
+                write(stream, averageColor[i]);
+            }
+
+            write(stream, static_cast<uint32_t>(texture.surfaceParms().size()));
+            for (const auto& surfaceParm : texture.surfaceParms()) {
+                writeString(stream, surfaceParm);
+            }
+
+            const auto& buffers = texture.buffersIfUnprepared();
+            const auto bytesPerPixel = Assets::bytesPerPixelForFormat(texture.format());
+            write(stream, static_cast<uint32_t>(buffers.size()));
+            for (size_t level = 0u; level < buffers.size(); ++level) {
+                const auto size = Assets::sizeAtMipLevel(texture.width(), texture.height(), level);
+                stream.write(reinterpret_cast<const char*>(buffers[level].data()), static_cast<std::streamsize>(bytesPerPixel * size.x() * size.y()));
+            }
+        }
+
+        void TextureCache::writeCollection(const std::string& key, const std::vector<Entry>& entries) const {
+            Disk::ensureDirectoryExists(m_directory);
+
+            const auto path = cacheFilePath(key);
+            const auto tempPath = path.replaceExtension("tmp");
+
+            {
+                auto stream = std::ofstream(tempPath.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!stream) {
+                    throw FileSystemException("Could not open texture cache file '" + tempPath.asString() + "' for writing");
+                }
+
+                stream.write(TextureCacheLayout::Magic.data(), static_cast<std::streamsize>(TextureCacheLayout::Magic.size()));
+                write(stream, TextureCacheLayout::Version);
+                writeString(stream, key);
+
+                std::vector<const Entry*> validEntries;
+                for (const auto& entry : entries) {
+                    if (!entry.texture->buffersIfUnprepared().empty()) {
+                        validEntries.push_back(&entry);
+                    }
+                }
+
+                write(stream, static_cast<uint32_t>(validEntries.size()));
+                for (const auto* entry : validEntries) {
+                    // every entry is prefixed with its size so that the index can be built without parsing the textures
+                    std::ostringstream entryStream;
+                    writeEntry(entryStream, *entry);
+                    const auto entryData = entryStream.str();
+
+                    write(stream, static_cast<uint64_t>(entryData.size()));
+                    stream.write(entryData.data(), static_cast<std::streamsize>(entryData.size()));
+                }
+
+                if (!stream) {
+                    throw FileSystemException("Could not write texture cache file '" + tempPath.asString() + "'");
+                }
+            }
+
+            Disk::moveFile(tempPath, path, true);
+            evict(path);
+        }
+
+        uint64_t TextureCache::contentHash(const char* begin, const char* end) {
+            return static_cast<uint64_t>(std::hash<std::string_view>()(std::string_view(begin, static_cast<size_t>(end - begin))));
+        }
+
+        Path TextureCache::cacheFilePath(const std::string& key) const {
+            std::stringstream str;
+            str << std::hex << std::setw(16) << std::setfill('0') << static_cast<uint64_t>(std::hash<std::string>()(key));
+            return m_directory + Path(str.str()).addExtension(TextureCacheLayout::Extension);
+        }
+
+        void TextureCache::evict(const Path& keep) const {
+            auto dir = QDir(pathAsQString(m_directory));
+            const auto files = dir.entryInfoList(
+                QStringList() << QString::fromStdString("*." + TextureCacheLayout::Extension),
+                QDir::Files, QDir::Time | QDir::Reversed);
+
+            qint64 totalSize = 0;
+            for (const auto& file : files) {
+                totalSize += file.size();
+            }
+
+            // the files are sorted from the least recently used to the most recently used
+            const auto keepPath = pathAsQString(keep);
+            for (const auto& file : files) {
+                if (totalSize <= static_cast<qint64>(m_maxSize)) {
+                    break;
+                }
+                if (QFileInfo(keepPath) != file && QFile::remove(file.absoluteFilePath())) {
+                    totalSize -= file.size();
+                }
+            }
+        }
+    }
+}
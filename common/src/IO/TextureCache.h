@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureCache
+#define TrenchBroom_TextureCache
+
+#include "Macros.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QFile;
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace IO {
+        /**
+         * A disk cache for decoded textures, so that unchanged textures need not be decoded again.
+         *
+         * The cache stores one file per texture collection. A cache file contains the decoded mip levels of the
+         * textures of the collection along with their other properties (average color, type, surface parameters and
+         * so on). Each texture is stored under the path of its source file and the hash of the source file's contents,
+         * so a texture is decoded again if its source file has changed.
+         *
+         * The callers are responsible for including everything else that affects decoding in the collection key, such
+         * as the texture format or the palette.
+         *
+         * Cache files are memory mapped when they are read. Whenever a cache file is written, the least recently used
+         * cache files are deleted until the total size of the cache is below its maximum size.
+         */
+        class TextureCache {
+        public:
+            static constexpr size_t DefaultMaxSize = 1024u * 1024u * 1024u;
+
+            /**
+             * A texture to store in a cache file.
+             */
+            struct Entry {
+                Path path;
+                uint64_t contentHash;
+                const Assets::Texture* texture;
+            };
+
+            /**
+             * The cached textures of a texture collection, read from a memory mapped cache file.
+             */
+            class Collection {
+            private:
+                std::unique_ptr<QFile> m_file;
+                const char* m_begin;
+                const char* m_end;
+
+                struct Index {
+                    uint64_t contentHash;
+                    size_t offset;
+                };
+                std::unordered_map<std::string, Index> m_index;
+            public:
+                /**
+                 * Creates an empty collection.
+                 */
+                Collection();
+
+                /**
+                 * Creates a collection from the given mapped cache file.
+                 *
+                 * @throw ReaderException if the cache file is malformed
+                 */
+                Collection(std::unique_ptr<QFile> file, const char* begin, const char* end, const std::string& key);
+
+                ~Collection();
+
+                Collection(Collection&& other) noexcept;
+                Collection& operator=(Collection&& other) noexcept;
+
+                size_t textureCount() const;
+
+                /**
+                 * Returns the texture that was read from a file with the given path and the given content hash, or
+                 * null if no such texture is cached.
+                 *
+                 * @throw ReaderException if the cache file is malformed
+                 */
+                std::unique_ptr<Assets::Texture> readTexture(const Path& path, uint64_t contentHash) const;
+
+                deleteCopy(Collection)
+            };
+        private:
+            Path m_directory;
+            size_t m_maxSize;
+        public:
+            explicit TextureCache(const Path& directory, size_t maxSize = DefaultMaxSize);
+
+            const Path& directory() const;
+            size_t maxSize() const;
+
+            /**
+             * Returns the cached textures of the collection with the given key. If no valid cache file exists for the
+             * collection, an empty collection is returned.
+             */
+            Collection readCollection(const std::string& key) const;
+
+            /**
+             * Replaces the cache file of the collection with the given key by a cache file containing the given
+             * textures. Textures without image data are skipped. Afterwards, the least recently used cache files are
+             * deleted if the cache exceeds its maximum size.
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void writeCollection(const std::string& key, const std::vector<Entry>& entries) const;
+
+            /**
+             * Computes the content hash of the given memory region. The hash is only stable for the same build of the
+             * application, which is good enough for a cache.
+             */
+            static uint64_t contentHash(const char* begin, const char* end);
+        private:
+            Path cacheFilePath(const std::string& key) const;
+            void evict(const Path& keep) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCache) */
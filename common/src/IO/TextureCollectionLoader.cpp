@@ -19,12 +19,18 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "TaskScheduler.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
+#include "IO/Reader.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
@@ -39,16 +45,57 @@ namespace TrenchBroom {
 
         TextureCollectionLoader::~TextureCollectionLoader() = default;
 
-        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, const TextureCache* textureCache, const std::string& textureCacheKey) {
+            TB_PROFILE_ZONE_DETAIL("TextureCollectionLoader::loadTextureCollection", path.asString());
             auto collection = std::make_unique<Assets::TextureCollection>(path);
+            std::vector<Assets::Texture*> textures;
+
+            auto cachedTextures = textureCache != nullptr ? textureCache->readCollection(textureCacheKey) : TextureCache::Collection();
+            std::vector<TextureCache::Entry> cacheEntries;
+            bool decodedTextures = false;
 
             for (const auto& file : doFindTextures(path, textureExtensions)) {
                 const auto name = file->path().lastComponent().deleteExtension().asString();
                 if (shouldExclude(name)) {
                     continue;
                 }
-                auto* texture = textureReader.readTexture(file);
+
+                Assets::Texture* texture = nullptr;
+                if (textureCache != nullptr) {
+                    const auto contents = file->reader().buffer();
+                    const auto contentHash = TextureCache::contentHash(contents.begin(), contents.end());
+                    try {
+                        texture = cachedTextures.readTexture(file->path(), contentHash).release();
+                    } catch (const ReaderException& e) {
+                        m_logger.warn() << "Could not read texture '" << file->path() << "' from cache: " << e.what();
+                    }
+
+                    if (texture == nullptr) {
+                        texture = textureReader.readTexture(file);
+                        decodedTextures = true;
+                    }
+                    cacheEntries.push_back(TextureCache::Entry{file->path(), contentHash, texture});
+                } else {
+                    texture = textureReader.readTexture(file);
+                }
+
                 collection->addTexture(texture);
+                textures.push_back(texture);
+            }
+
+            // the texture readers access the file systems and the logger, so only the mip generation runs in parallel
+            TaskScheduler::instance().parallelFor(textures.size(), [&](const size_t i) {
+                textures[i]->generateMips();
+            });
+
+            if (textureCache != nullptr && (decodedTextures || cacheEntries.size() != cachedTextures.textureCount())) {
+                // unmap the cache file before it is replaced
+                cachedTextures = TextureCache::Collection();
+                try {
+                    textureCache->writeCollection(textureCacheKey, cacheEntries);
+                } catch (const Exception& e) {
+                    m_logger.warn() << "Could not write texture cache for '" << path << "': " << e.what();
+                }
             }
 
             return collection;
@@ -36,6 +36,7 @@ namespace TrenchBroom {
         class File;
         class FileSystem;
         class Path;
+        class TextureCache;
         class TextureReader;
 
         class TextureCollectionLoader {
@@ -49,7 +50,14 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            /**
+             * Loads the textures of the collection with the given path.
+             *
+             * If a texture cache is given, textures whose source files have not changed are read from the cache
+             * instead of being decoded, and the cache is updated if any textures had to be decoded. The cache key must
+             * identify the collection and everything that affects the decoding of its textures.
+             */
+            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader, const TextureCache* textureCache = nullptr, const std::string& textureCacheKey = "");
         private:
             bool shouldExclude(const std::string& textureName);
             virtual FileList doFindTextures(const Path& path, const std::vector<std::string>& extensions) = 0;
@@ -24,26 +24,34 @@
 #include "Assets/Palette.h"
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
+#include "IO/File.h"
 #include "IO/FileSystem.h"
 #include "IO/FreeImageTextureReader.h"
 #include "IO/HlMipTextureReader.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/M8TextureReader.h"
 #include "IO/Quake3ShaderTextureReader.h"
+#include "IO/Reader.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureCollectionLoader.h"
 #include "IO/WalTextureReader.h"
 #include "IO/Path.h"
 #include "Model/GameConfig.h"
 
+#include <kdl/string_utils.h>
+
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger) :
+        TextureLoader::TextureLoader(const FileSystem& gameFS, const std::vector<IO::Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, const TextureCache* textureCache) :
         m_textureExtensions(getTextureExtensions(textureConfig)),
         m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
-        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
+        m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)),
+        m_textureCache(textureCache),
+        m_textureCacheKey(textureCache != nullptr ? getTextureCacheKey(gameFS, textureConfig) : "") {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
         }
@@ -103,8 +111,33 @@ namespace TrenchBroom {
             }
         }
 
+        std::string TextureLoader::getTextureCacheKey(const FileSystem& gameFS, const Model::TextureConfig& textureConfig) {
+            if (textureConfig.format.format == "q3shader") {
+                // shaders refer to images in other files, so we cannot tell whether a shader texture has changed
+                return "";
+            }
+
+            // the palette and the root directory (which determines the texture names) affect the decoded textures
+            uint64_t paletteHash = 0u;
+            if (!textureConfig.palette.isEmpty()) {
+                try {
+                    const auto file = gameFS.openFile(textureConfig.palette);
+                    const auto reader = file->reader().buffer();
+                    paletteHash = TextureCache::contentHash(reader.begin(), reader.end());
+                } catch (const Exception&) {
+                    // loading the palette will fail and report the error
+                }
+            }
+
+            return kdl::str_to_string(textureConfig.format.format, "|", textureConfig.package.rootDirectory.asString("/"), "|", paletteHash, "|");
+        }
+
         std::unique_ptr<Assets::TextureCollection> TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+            if (m_textureCache != nullptr && !m_textureCacheKey.empty()) {
+                return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader, m_textureCache, m_textureCacheKey + path.asString("/"));
+            } else {
+                return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+            }
         }
 
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
@@ -42,6 +42,7 @@ namespace TrenchBroom {
     namespace IO {
         class FileSystem;
         class Path;
+        class TextureCache;
         class TextureCollectionLoader;
         class TextureReader;
 
@@ -50,14 +51,21 @@ namespace TrenchBroom {
             std::vector<std::string> m_textureExtensions;
             std::unique_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
+            const TextureCache* m_textureCache;
+            std::string m_textureCacheKey;
         public:
-            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            /**
+             * Creates a texture loader. If a texture cache is given, the decoded textures are stored in it and reused
+             * when the same textures are loaded again, unless the texture format does not support caching.
+             */
+            TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger, const TextureCache* textureCache = nullptr);
             ~TextureLoader();
         private:
             static std::vector<std::string> getTextureExtensions(const Model::TextureConfig& textureConfig);
             static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
+            static std::string getTextureCacheKey(const FileSystem& gameFS, const Model::TextureConfig& textureConfig);
         public:
             std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path);
             void loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager);
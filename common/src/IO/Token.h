@@ -21,7 +21,11 @@
 #define TrenchBroom_Token
 
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <string_view>
 
 #include <kdl/string_utils.h>
 
@@ -30,6 +34,8 @@ namespace TrenchBroom {
         template <typename Type>
         class TokenTemplate {
         private:
+            static constexpr size_t MaxNumberLength = 63u;
+
             Type m_type;
             const char* m_begin;
             const char* m_end;
@@ -71,10 +77,20 @@ namespace TrenchBroom {
                 return m_end;
             }
 
+            /**
+             * Returns a copy of the token's text. Prefer view() unless the text must outlive the tokenizer's buffer.
+             */
             const std::string data() const {
                 return std::string(m_begin, length());
             }
 
+            /**
+             * Returns the token's text without copying it. The returned view points into the tokenizer's buffer.
+             */
+            std::string_view view() const {
+                return std::string_view(m_begin, length());
+            }
+
             size_t position() const {
                 return m_position;
             }
@@ -93,12 +109,45 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                char buffer[MaxNumberLength + 1u];
+                if (!copyToBuffer(buffer)) {
+                    return static_cast<T>(kdl::str_to_double(data()).value_or(0.0));
+                }
+
+                // same semantics as kdl::str_to_double, but without allocating a string
+                char* end = nullptr;
+                errno = 0;
+                const auto value = std::strtod(buffer, &end);
+                return static_cast<T>(end == buffer || errno == ERANGE ? 0.0 : value);
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                char buffer[MaxNumberLength + 1u];
+                if (!copyToBuffer(buffer)) {
+                    return static_cast<T>(kdl::str_to_long(data()).value_or(0l));
+                }
+
+                // same semantics as kdl::str_to_long, but without allocating a string
+                char* end = nullptr;
+                errno = 0;
+                const auto value = std::strtol(buffer, &end, 10);
+                return static_cast<T>(end == buffer || errno == ERANGE ? 0l : value);
+            }
+        private:
+            /**
+             * Copies the token's text into the given buffer and terminates it with a null character, unless the text
+             * is too long to fit.
+             */
+            bool copyToBuffer(char (&buffer)[MaxNumberLength + 1u]) const {
+                if (length() > MaxNumberLength) {
+                    return false;
+                }
+                if (length() > 0u) {
+                    std::memcpy(buffer, m_begin, length());
+                }
+                buffer[length()] = 0;
+                return true;
             }
         };
     }
@@ -25,6 +25,7 @@
 #include <kdl/string_format.h>
 
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -42,6 +43,15 @@ namespace TrenchBroom {
             return new TokenizerState(begin, end, m_escapableChars, m_escapeChar);
         }
 
+        void TokenizerState::rebase(const char* begin, const char* end, const size_t line) {
+            m_begin = begin;
+            m_cur = m_begin;
+            m_end = end;
+            m_line = line;
+            m_column = 1;
+            m_escaped = false;
+        }
+
         size_t TokenizerState::length() const {
             return static_cast<size_t>(m_end - m_begin);
         }
@@ -82,7 +92,7 @@ namespace TrenchBroom {
             return !eof() && m_escaped && m_escapableChars.find(curChar()) != std::string::npos;
         }
 
-        std::string TokenizerState::unescape(const std::string& str) {
+        std::string TokenizerState::unescape(const std::string_view str) {
             return kdl::str_unescape(str, m_escapableChars, m_escapeChar);
         }
 
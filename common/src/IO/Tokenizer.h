@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -42,6 +43,11 @@ namespace TrenchBroom {
 
             TokenizerState* clone(const char* begin, const char* end) const;
 
+            /**
+             * Continues with the given buffer, starting at the given line.
+             */
+            void rebase(const char* begin, const char* end, size_t line);
+
             size_t length() const;
             const char* begin() const;
             const char* end() const;
@@ -55,7 +61,7 @@ namespace TrenchBroom {
             size_t column() const;
 
             bool escaped() const;
-            std::string unescape(const std::string& str);
+            std::string unescape(std::string_view str);
             void resetEscaped();
 
             bool eof() const;
@@ -142,9 +148,9 @@ namespace TrenchBroom {
                 discardWhile("\n");
             }
 
-            std::string readRemainder(const TokenType delimiterType) {
+            std::string_view readRemainder(const TokenType delimiterType) {
                 if (eof()) {
-                    return "";
+                    return std::string_view();
                 }
 
                 Token token = peekToken();
@@ -155,19 +161,19 @@ namespace TrenchBroom {
                     endPos = std::end(token);
                 } while (peekToken().hasType(delimiterType) == 0 && !eof());
 
-                return std::string(startPos, static_cast<size_t>(endPos - startPos));
+                return std::string_view(startPos, static_cast<size_t>(endPos - startPos));
             }
 
-            std::string readAnyString(const std::string& delims) {
+            std::string_view readAnyString(const std::string& delims) {
                 while (isWhitespace(curChar())) {
                     advance();
                 }
                 const char* startPos = curPos();
                 const char* endPos = (curChar() == '"' ? readQuotedString() : readUntil(delims));
-                return std::string(startPos, static_cast<size_t>(endPos - startPos));
+                return std::string_view(startPos, static_cast<size_t>(endPos - startPos));
             }
 
-            std::string unescapeString(const std::string& str) const {
+            std::string unescapeString(const std::string_view str) const {
                 return m_state->unescape(str);
             }
 
@@ -208,6 +214,10 @@ namespace TrenchBroom {
                 m_state.reset(m_state->clone(begin, end));
             }
 
+            void rebase(const char* begin, const char* end, const size_t line) {
+                m_state->rebase(begin, end, line);
+            }
+
             void restore(const TokenizerState& snapshot) {
                 m_state->restore(snapshot);
             }
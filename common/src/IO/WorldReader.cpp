@@ -39,6 +39,9 @@ namespace TrenchBroom {
         WorldReader::WorldReader(const std::string& str) :
         MapReader(str) {}
 
+        WorldReader::WorldReader(std::istream& stream, const size_t readSize) :
+        MapReader(stream, readSize) {}
+
         std::unique_ptr<Model::WorldNode> WorldReader::read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             readEntities(format, worldBounds, status);
             sanitizeLayerSortIndicies(status);
@@ -20,8 +20,10 @@
 #ifndef TrenchBroom_WorldReader
 #define TrenchBroom_WorldReader
 
+#include "IO/MapChunkReader.h"
 #include "IO/MapReader.h"
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,6 +45,15 @@ namespace TrenchBroom {
             WorldReader(const char* begin, const char* end);
             explicit WorldReader(const std::string& str);
 
+            /**
+             * Creates a reader which parses the given stream in chunks, so that the map file does not need to be held
+             * in memory entirely.
+             *
+             * @param stream the stream to read from
+             * @param readSize the number of bytes to read from the stream at once
+             */
+            explicit WorldReader(std::istream& stream, size_t readSize = MapChunkReader::DefaultReadSize);
+
             std::unique_ptr<Model::WorldNode> read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
         private:            
             void sanitizeLayerSortIndicies(ParserStatus& status);            
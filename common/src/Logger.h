@@ -22,6 +22,8 @@
 
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 class QString;
 
@@ -87,6 +89,23 @@ namespace TrenchBroom {
         void doLog(LogLevel level, const std::string& message) override;
         void doLog(LogLevel level, const QString& message) override;
     };
+
+    /**
+     * Records the logged messages so that they can be passed on to another logger later. This is useful to collect the
+     * messages of work done on another thread and log them in a deterministic order.
+     */
+    class BufferedLogger : public Logger {
+    private:
+        std::vector<std::pair<LogLevel, std::string>> m_messages;
+    public:
+        /**
+         * Passes the recorded messages to the given logger in the order in which they were logged and clears them.
+         */
+        void flush(Logger& logger);
+    private:
+        void doLog(LogLevel level, const std::string& message) override;
+        void doLog(LogLevel level, const QString& message) override;
+    };
 }
 
 #endif /* defined(TrenchBroom_Logger) */
@@ -41,6 +41,7 @@
 
 #include <algorithm> // for std::remove
 #include <iterator>
+#include <numeric>
 #include <set>
 #include <string>
 #include <vector>
@@ -141,6 +142,64 @@ namespace TrenchBroom {
             return m_geometry->bounds();
         }
 
+        bool Brush::hasGeometry() const {
+            return m_geometry != nullptr;
+        }
+
+        void Brush::releaseGeometry() {
+            for (BrushFace& face : m_faces) {
+                face.setGeometry(nullptr);
+            }
+            m_geometry.reset();
+        }
+
+        void Brush::restoreGeometry(const vm::bbox3& worldBounds) {
+            assert(m_geometry == nullptr);
+
+            // Clip in the order established by BrushFace::sortFaces to obtain the same geometry as before, but sort
+            // indices instead of the faces to keep the face indices stable.
+            std::vector<size_t> clipOrder(m_faces.size());
+            std::iota(std::begin(clipOrder), std::end(clipOrder), 0u);
+            std::sort(std::begin(clipOrder), std::end(clipOrder), [&](const size_t lhs, const size_t rhs) {
+                return BrushFace::sortsBefore(m_faces[lhs], m_faces[rhs]);
+            });
+
+            auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+            for (const size_t i : clipOrder) {
+                const auto result = geometry->clip(m_faces[i].boundary());
+                if (result.success()) {
+                    result.face()->setPayload(i);
+                } else if (result.empty()) {
+                    throw GeometryException("Brush is empty");
+                }
+            }
+
+            geometry->correctVertexPositions();
+            if (!geometry->healEdges()) {
+                throw GeometryException("Brush is invalid");
+            }
+
+            // every face was part of the geometry before it was released, so none of them may have been dropped now
+            if (geometry->faceCount() != m_faces.size()) {
+                throw GeometryException("Brush geometry could not be restored");
+            }
+
+            for (const BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                if (!faceGeometry->payload()) {
+                    throw GeometryException("Brush is not fully specified");
+                }
+            }
+
+            // only link the faces once the geometry is known to be valid so that they are never left dangling
+            for (BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                m_faces[*faceGeometry->payload()].setGeometry(faceGeometry);
+            }
+
+            m_geometry = std::move(geometry);
+
+            assert(checkFaceLinks());
+        }
+
         std::optional<size_t> Brush::findFace(const std::string& textureName) const {
             return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().textureName() == textureName; });
         }
@@ -642,24 +701,25 @@ namespace TrenchBroom {
                 }
             }
 
-            BrushGeometry remaining(remainingPoints);
-            BrushGeometry moving(movingPoints);
-            BrushGeometry result(resultPoints);
-
-            // Will the result go out of world bounds?
-            if (!worldBounds.contains(result.bounds())) {
+            // Will the result go out of world bounds? The bounds of the result are the bounds of its points, so we
+            // can check this before building any geometry.
+            vm::bbox3::builder resultBounds;
+            resultBounds.add(std::begin(resultPoints), std::end(resultPoints));
+            if (!worldBounds.contains(resultBounds.bounds())) {
                 return CanMoveVerticesResult::rejectVertexMove();
             }
 
+            BrushGeometry result(resultPoints);
+
             // Special case, takes care of the first column.
-            if (moving.vertexCount() == vertexCount()) {
+            if (movingPoints.size() == vertexCount()) {
                 return CanMoveVerticesResult::acceptVertexMove(std::move(result));
             }
 
             // Will vertices be removed?
             if (!allowVertexRemoval) {
                 // All moving vertices must still be present in the result
-                for (const auto& movingVertex : moving.vertexPositions()) {
+                for (const auto& movingVertex : movingPoints) {
                     if (!result.hasVertex(movingVertex + delta)) {
                         return CanMoveVerticesResult::rejectVertexMove();
                     }
@@ -671,6 +731,10 @@ namespace TrenchBroom {
                 return CanMoveVerticesResult::rejectVertexMove();
             }
 
+            // The fragments are only needed if none of the checks above rejected the move.
+            BrushGeometry remaining(remainingPoints);
+            BrushGeometry moving(movingPoints);
+
             // One of the remaining two ok cases?
             if ((moving.point() && remaining.polygon()) ||
                 (moving.edge() && remaining.edge())) {
@@ -838,7 +902,63 @@ namespace TrenchBroom {
             updateGeometryFromFaces(worldBounds);
         }
 
-        std::vector<Brush> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<const Brush*>& subtrahends) const {
+        static constexpr FloatType MergeFragmentsVolumeEpsilon = 1e-9;
+
+        /**
+         * Repeatedly replaces two fragments by their convex hull if the hull has the same volume as both fragments
+         * together, i.e. if the union of the fragments is convex. Since the fragments don't overlap, the hull then
+         * covers exactly the same space.
+         */
+        static std::vector<BrushGeometry> mergeFragments(std::vector<BrushGeometry> fragments) {
+            std::vector<FloatType> volumes;
+            volumes.reserve(fragments.size());
+            for (const auto& fragment : fragments) {
+                volumes.push_back(fragment.volume());
+            }
+
+            const auto tryMerge = [&](const size_t i, const size_t j) {
+                if (!fragments[i].bounds().intersects(fragments[j].bounds())) {
+                    return false;
+                }
+
+                auto positions = fragments[i].vertexPositions();
+                kdl::vec_append(positions, fragments[j].vertexPositions());
+
+                auto hull = BrushGeometry(std::move(positions));
+                const auto hullVolume = hull.volume();
+                const auto fragmentVolume = volumes[i] + volumes[j];
+                if (!hull.polyhedron() || hullVolume - fragmentVolume > MergeFragmentsVolumeEpsilon * fragmentVolume) {
+                    return false;
+                }
+
+                fragments[i] = std::move(hull);
+                volumes[i] = hullVolume;
+                return true;
+            };
+
+            auto merged = true;
+            while (merged) {
+                merged = false;
+                for (size_t i = 0u; i < fragments.size(); ++i) {
+                    for (size_t j = i + 1u; j < fragments.size(); ) {
+                        if (tryMerge(i, j)) {
+                            fragments.erase(std::next(std::begin(fragments), static_cast<std::ptrdiff_t>(j)));
+                            volumes.erase(std::next(std::begin(volumes), static_cast<std::ptrdiff_t>(j)));
+                            merged = true;
+                        } else {
+                            ++j;
+                        }
+                    }
+                }
+            }
+
+            return fragments;
+        }
+
+        std::vector<Brush> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<const Brush*>& allSubtrahends, const bool mergeFragments) const {
+            // subtrahends which do not overlap `this` can neither change the fragments nor lend their attributes to them
+            const auto subtrahends = kdl::vec_filter(allSubtrahends, [&](const auto* subtrahend) { return bounds().intersects(subtrahend->bounds()); });
+
             auto result = std::vector<BrushGeometry>{*m_geometry};
 
             for (auto* subtrahend : subtrahends) {
@@ -856,6 +976,10 @@ namespace TrenchBroom {
                 result = std::move(nextResults);
             }
 
+            if (mergeFragments && result.size() > 1u) {
+                result = Model::mergeFragments(std::move(result));
+            }
+
             std::vector<Brush> brushes;
             brushes.reserve(result.size());
 
@@ -67,6 +67,27 @@ namespace TrenchBroom {
             void updateGeometryFromFaces(const vm::bbox3& worldBounds);
         public:
             const vm::bbox3& bounds() const;
+        public: // releasing the geometry
+            /**
+             * Indicates whether this brush has a geometry. A brush only lacks a geometry if it was released by calling
+             * releaseGeometry, and until it is restored, only the faces' attributes and boundaries may be accessed.
+             */
+            bool hasGeometry() const;
+
+            /**
+             * Releases the geometry of this brush and unlinks it from the faces.
+             */
+            void releaseGeometry();
+
+            /**
+             * Rebuilds the geometry of a brush whose geometry was released. The faces are clipped in the same order as
+             * when the geometry was built initially, but the faces are not reordered, so face indices remain valid.
+             *
+             * @param worldBounds the world bounds
+             *
+             * @throws GeometryException if the geometry cannot be rebuilt from the faces
+             */
+            void restoreGeometry(const vm::bbox3& worldBounds);
         public: // face management:
             std::optional<size_t> findFace(const std::string& textureName) const;
             std::optional<size_t> findFace(const vm::vec3& normal) const;
@@ -180,11 +201,13 @@ namespace TrenchBroom {
             // CSG operations
             /**
              * Subtracts the given subtrahends from `this`, returning the result but without modifying `this`.
+             * Subtrahends whose bounds do not intersect the bounds of `this` are ignored.
              *
              * @param subtrahends brushes to subtract from `this`. The passed-in brushes are not modified.
+             * @param mergeFragments whether to merge pairs of fragments whose union is convex into one brush
              * @return the subtraction result
              */
-            std::vector<Brush> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<const Brush*>& subtrahends) const;
+            std::vector<Brush> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<const Brush*>& subtrahends, bool mergeFragments = false) const;
             std::vector<Brush> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const Brush& subtrahend) const;
             void intersect(const vm::bbox3& worldBounds, const Brush& brush);
 
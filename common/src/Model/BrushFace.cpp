@@ -145,20 +145,22 @@ namespace TrenchBroom {
             // But it is still desirable to have a deterministic order in which the faces are added to the brush, so I chose
             // to just sort the faces by their normals.
 
-            std::sort(std::begin(faces), std::end(faces), [](const auto& lhs, const auto& rhs) {
-                const auto& lhsBoundary = lhs.boundary();
-                const auto& rhsBoundary = rhs.boundary();
-
-                const auto cmp = vm::compare(lhsBoundary.normal, rhsBoundary.normal);
-                if (cmp < 0) {
-                    return true;
-                } else if (cmp > 0) {
-                    return false;
-                } else {
-                    // normal vectors are identical -- this should never happen
-                    return lhsBoundary.distance < rhsBoundary.distance;
-                }
-            });
+            std::sort(std::begin(faces), std::end(faces), &BrushFace::sortsBefore);
+        }
+
+        bool BrushFace::sortsBefore(const BrushFace& lhs, const BrushFace& rhs) {
+            const auto& lhsBoundary = lhs.boundary();
+            const auto& rhsBoundary = rhs.boundary();
+
+            const auto cmp = vm::compare(lhsBoundary.normal, rhsBoundary.normal);
+            if (cmp < 0) {
+                return true;
+            } else if (cmp > 0) {
+                return false;
+            } else {
+                // normal vectors are identical -- this should never happen
+                return lhsBoundary.distance < rhsBoundary.distance;
+            }
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
@@ -110,8 +110,16 @@ namespace TrenchBroom {
             static BrushFace createParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
             static BrushFace createParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
 
+            /**
+             * Sorts the given faces in the order in which they are added to a brush geometry.
+             */
             static void sortFaces(std::vector<BrushFace>& faces);
 
+            /**
+             * The order established by sortFaces. Returns true if the given lhs face comes before the given rhs face.
+             */
+            static bool sortsBefore(const BrushFace& lhs, const BrushFace& rhs);
+
             std::unique_ptr<TexCoordSystemSnapshot> takeTexCoordSystemSnapshot() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot);
             void copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attributes, const vm::plane3& sourceFacePlane, WrapStyle wrapStyle);
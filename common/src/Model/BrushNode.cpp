@@ -23,6 +23,7 @@
 #include "FloatType.h"
 #include "Polyhedron.h"
 #include "Polyhedron_Matcher.h"
+#include "TaskScheduler.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
@@ -43,6 +44,7 @@
 
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
 #include <vecmath/intersection.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_ext.h>
@@ -53,6 +55,7 @@
 #include <vecmath/util.h>
 
 #include <algorithm> // for std::remove
+#include <cassert>
 #include <iterator>
 #include <set>
 #include <string>
@@ -62,6 +65,11 @@ namespace TrenchBroom {
     namespace Model {
         const HitType::Type BrushNode::BrushHitType = HitType::freeType();
 
+        struct BrushNode::ReleasedGeometry {
+            vm::bbox3 bounds;
+            vm::bbox3 worldBounds;
+        };
+
         BrushNode::BrushNode(Brush brush) :
         m_brushRendererBrushCache(std::make_unique<Renderer::BrushRendererBrushCache>()),
         m_brush(std::move(brush)) {
@@ -102,19 +110,50 @@ namespace TrenchBroom {
         }
 
         const Brush& BrushNode::brush() const {
+            restoreGeometry();
             return m_brush;
         }
         
+        const std::vector<BrushFace>& BrushNode::faces() const {
+            return m_brush.faces();
+        }
+
         void BrushNode::setBrush(Brush brush) {
             const NotifyNodeChange nodeChange(this);
             const NotifyPhysicalBoundsChange boundsChange(this);
             m_brush = std::move(brush);
+            m_releasedGeometry.reset();
             
             updateSelectedFaceCount();
             invalidateIssues();
             invalidateVertexCache();
         }
 
+        void BrushNode::releaseGeometry(const vm::bbox3& worldBounds) {
+            if (m_releasedGeometry) {
+                return;
+            }
+
+            m_releasedGeometry = std::make_unique<ReleasedGeometry>(ReleasedGeometry{m_brush.bounds(), worldBounds});
+            m_brush.releaseGeometry();
+
+            // invalidating the vertex cache would keep its memory, so replace it
+            m_brushRendererBrushCache = std::make_unique<Renderer::BrushRendererBrushCache>();
+        }
+
+        bool BrushNode::hasReleasedGeometry() const {
+            return m_releasedGeometry != nullptr;
+        }
+
+        void BrushNode::restoreGeometry() const {
+            if (m_releasedGeometry) {
+                // other threads might be reading this node concurrently
+                assert(!TaskScheduler::isWorkerThread());
+                m_brush.restoreGeometry(m_releasedGeometry->worldBounds);
+                m_releasedGeometry.reset();
+            }
+        }
+
         bool BrushNode::hasSelectedFaces() const {
             return m_selectedFaceCount > 0u;
         }
@@ -155,7 +194,7 @@ namespace TrenchBroom {
         }
 
         const vm::bbox3& BrushNode::doGetLogicalBounds() const {
-            return m_brush.bounds();
+            return m_releasedGeometry ? m_releasedGeometry->bounds : m_brush.bounds();
         }
 
         const vm::bbox3& BrushNode::doGetPhysicalBounds() const {
@@ -163,7 +202,7 @@ namespace TrenchBroom {
         }
 
         Node* BrushNode::doClone(const vm::bbox3& /* worldBounds */) const {
-            auto* result = new BrushNode(m_brush);
+            auto* result = new BrushNode(brush());
             cloneAttributes(result);
             return result;
         }
@@ -201,6 +240,11 @@ namespace TrenchBroom {
         }
 
         void BrushNode::doPick(const vm::ray3& ray, PickResult& pickResult) {
+            // hidden brushes are never hit, so don't restore their geometry only to discard the hit later
+            if (hasReleasedGeometry() && !visible()) {
+                return;
+            }
+
             if (const auto hit = findFaceHit(ray)) {
                 const auto [distance, faceIndex] = *hit;
                 ensure(!vm::is_nan(distance), "nan hit distance");
@@ -210,15 +254,16 @@ namespace TrenchBroom {
         }
 
         void BrushNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
-            if (m_brush.containsPoint(point)) {
+            if (logicalBounds().contains(point) && brush().containsPoint(point)) {
                 result.push_back(this);
             }
         }
 
         std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(const vm::ray3& ray) const {
             if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
-                for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
-                    const auto& face = m_brush.face(i);
+                const auto& brush = this->brush();
+                for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                    const auto& face = brush.face(i);
                     const auto distance = face.intersectWithRay(ray);
                     if (!vm::is_nan(distance)) {
                         return std::make_tuple(distance, i);
@@ -249,6 +294,7 @@ namespace TrenchBroom {
         void BrushNode::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             const NotifyNodeChange nodeChange(this);
             const NotifyPhysicalBoundsChange boundsChange(this);
+            restoreGeometry();
             m_brush.transform(transformation, lockTextures, worldBounds);
             
             invalidateIssues();
@@ -273,12 +319,12 @@ namespace TrenchBroom {
             }
 
             bool contains(const BrushNode* brush) const {
-                return m_brush.contains(brush->m_brush);
+                return m_brush.contains(brush->brush());
             }
         };
 
         bool BrushNode::doContains(const Node* node) const {
-            Contains contains(m_brush);
+            Contains contains(brush());
             node->accept(contains);
             assert(contains.hasResult());
             return contains.result();
@@ -302,12 +348,12 @@ namespace TrenchBroom {
             }
 
             bool intersects(const BrushNode* brush) {
-                return m_brush.intersects(brush->m_brush);
+                return m_brush.intersects(brush->brush());
             }
         };
 
         bool BrushNode::doIntersects(const Node* node) const {
-            Intersects intersects(m_brush);
+            Intersects intersects(brush());
             node->accept(intersects);
             assert(intersects.hasResult());
             return intersects.result();
@@ -346,14 +392,14 @@ namespace TrenchBroom {
             // Possible optimization: Store the shared face tag mask in the brush and updated it when a face changes.
 
             TagType::Type sharedFaceTags = TagType::AnyType; // set all bits to 1
-            for (const auto& face : m_brush.faces()) {
+            for (const auto& face : faces()) {
                 sharedFaceTags &= face.tagMask();
             }
             return (sharedFaceTags & tagMask) != 0;
         }
 
         bool BrushNode::anyFaceHasAnyTag() const {
-            for (const auto& face : m_brush.faces()) {
+            for (const auto& face : faces()) {
                 if (face.hasAnyTag()) {
                     return true;
                 }
@@ -364,7 +410,7 @@ namespace TrenchBroom {
         bool BrushNode::anyFacesHaveAnyTagInMask(TagType::Type tagMask) const {
             // Possible optimization: Store the shared face tag mask in the brush and updated it when a face changes.
 
-            for (const auto& face : m_brush.faces()) {
+            for (const auto& face : faces()) {
                 if (face.hasTag(tagMask)) {
                     return true;
                 }
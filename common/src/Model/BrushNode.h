@@ -59,9 +59,16 @@ namespace TrenchBroom {
             using VertexList = BrushVertexList;
             using EdgeList = BrushEdgeList;
         private:
+            struct ReleasedGeometry;
+
             mutable std::unique_ptr<Renderer::BrushRendererBrushCache> m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
-            Brush m_brush; // must be destroyed before the brush renderer cache
+            mutable Brush m_brush; // must be destroyed before the brush renderer cache, mutable to restore a released geometry on access
             size_t m_selectedFaceCount = 0u;
+
+            /**
+             * Only set while the geometry of the brush is released, see releaseGeometry.
+             */
+            mutable std::unique_ptr<ReleasedGeometry> m_releasedGeometry;
         public:
             explicit BrushNode(Brush brush);
             ~BrushNode() override;
@@ -70,9 +77,39 @@ namespace TrenchBroom {
 
             AttributableNode* entity() const;
             
+            /**
+             * Returns the brush of this node. If the geometry of the brush was released, it is restored first.
+             *
+             * Restoring the geometry modifies this node, so it must not happen on a worker thread of the task
+             * scheduler. Code that accesses brushes from worker threads must call this on the calling thread first.
+             */
             const Brush& brush() const;
             void setBrush(Brush brush);
 
+            /**
+             * Returns the faces of the brush without restoring a released geometry. The faces keep their attributes,
+             * points and boundary planes while the geometry is released, but their vertices and edges are not
+             * available. Prefer this over brush() when only the face attributes are needed, e.g. when saving the map or
+             * when updating textures, so that hidden brushes stay released.
+             */
+            const std::vector<BrushFace>& faces() const;
+
+            /**
+             * Releases the geometry of the brush to save memory while it is not needed, e.g. while the brush is hidden.
+             * The bounds of the brush are retained, and the geometry is restored when the brush is accessed again.
+             *
+             * Since restoring the geometry modifies this node, the geometry is only restored on threads which are not
+             * workers of the task scheduler, see brush().
+             *
+             * @param worldBounds the world bounds to restore the geometry with
+             */
+            void releaseGeometry(const vm::bbox3& worldBounds);
+
+            /**
+             * Indicates whether the geometry of the brush is currently released.
+             */
+            bool hasReleasedGeometry() const;
+
             bool hasSelectedFaces() const;
             void selectFace(size_t faceIndex);
             void deselectFace(size_t faceIndex);
@@ -83,6 +120,7 @@ namespace TrenchBroom {
             
             using Node::takeSnapshot;
         private:
+            void restoreGeometry() const;
             void updateSelectedFaceCount();
         private: // implement Node interface
             const std::string& doGetName() const override;
@@ -33,6 +33,7 @@
 #include "IO/DkmParser.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/EntParser.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
@@ -49,6 +50,7 @@
 #include "IO/WorldReader.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureLoader.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushBuilder.h"
@@ -65,6 +67,7 @@
 
 #include <vecmath/vec_io.h>
 
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -164,9 +167,18 @@ namespace TrenchBroom {
 
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
-            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-            auto fileReader = file->reader().buffer();
-            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+            const auto fixedPath = IO::Disk::fixPath(path);
+            if (!IO::Disk::fileExists(fixedPath)) {
+                throw FileNotFoundException(fixedPath.asString());
+            }
+
+            // read the file in chunks to avoid holding the entire file in memory while parsing it
+            std::fstream stream(fixedPath.asString().c_str(), std::ios::in | std::ios::binary);
+            if (!stream.is_open()) {
+                throw FileSystemException("Cannot open file: " + fixedPath.asString());
+            }
+
+            IO::WorldReader worldReader(stream);
             return worldReader.read(format, worldBounds, parserStatus);
         }
 
@@ -227,7 +239,8 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(node);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            const IO::TextureCache textureCache(IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache") + IO::Path(m_config.name()));
+            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger, &textureCache);
             textureLoader.loadTextures(paths, textureManager);
         }
 
@@ -319,21 +332,26 @@ namespace TrenchBroom {
             const auto extension = path.extension();
             const auto& defaultColor = m_config.entityConfig().defaultColor;
 
+            const auto fixedPath = IO::Disk::fixPath(path);
+            auto& cache = IO::EntityDefinitionCache::instance();
+
             if (kdl::ci::str_is_equal("fgd", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
-                IO::FgdParser parser(std::begin(reader), std::end(reader), defaultColor, file->path());
-                return parser.parseDefinitions(status);
+                return cache.loadDefinitions(status, fixedPath, defaultColor, [&](IO::ParserStatus& parserStatus, const char* begin, const char* end, std::vector<IO::Path>& includedFiles) {
+                    IO::FgdParser parser(begin, end, defaultColor, fixedPath);
+                    auto definitions = parser.parseDefinitions(parserStatus);
+                    includedFiles = parser.includedFiles();
+                    return definitions;
+                });
             } else if (kdl::ci::str_is_equal("def", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
-                IO::DefParser parser(std::begin(reader), std::end(reader), defaultColor);
-                return parser.parseDefinitions(status);
+                return cache.loadDefinitions(status, fixedPath, defaultColor, [&](IO::ParserStatus& parserStatus, const char* begin, const char* end, std::vector<IO::Path>& /* includedFiles */) {
+                    IO::DefParser parser(begin, end, defaultColor);
+                    return parser.parseDefinitions(parserStatus);
+                });
             } else if (kdl::ci::str_is_equal("ent", extension)) {
-                auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                auto reader = file->reader().buffer();
-                IO::EntParser parser(std::begin(reader), std::end(reader), defaultColor);
-                return parser.parseDefinitions(status);
+                return cache.loadDefinitions(status, fixedPath, defaultColor, [&](IO::ParserStatus& parserStatus, const char* begin, const char* end, std::vector<IO::Path>& /* includedFiles */) {
+                    IO::EntParser parser(begin, end, defaultColor);
+                    return parser.parseDefinitions(parserStatus);
+                });
             } else {
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
             }
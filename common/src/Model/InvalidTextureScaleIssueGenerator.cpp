@@ -86,9 +86,9 @@ namespace TrenchBroom {
         }
 
         void InvalidTextureScaleIssueGenerator::doGenerate(BrushNode* brushNode, IssueList& issues) const {
-            const Brush& brush = brushNode->brush();
-            for (size_t i = 0u; i < brush.faceCount(); ++i) {
-                const BrushFace& face = brush.face(i);
+            const auto& faces = brushNode->faces();
+            for (size_t i = 0u; i < faces.size(); ++i) {
+                const BrushFace& face = faces[i];
                 if (!face.attributes().valid()) {
                     issues.push_back(new InvalidTextureScaleIssue(brushNode, i));
                 }
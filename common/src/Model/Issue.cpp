@@ -119,8 +119,7 @@ namespace TrenchBroom {
 
         const BrushFace& BrushFaceIssue::face() const {
             const BrushNode* brushNode = static_cast<const BrushNode*>(node());
-            const Brush& brush = brushNode->brush();
-            return brush.face(m_faceIndex);
+            return brushNode->faces()[m_faceIndex];
         }
 
         size_t BrushFaceIssue::doGetLineNumber() const {
@@ -53,8 +53,7 @@ namespace TrenchBroom {
         IssueGenerator(MixedBrushContentsIssue::Type, "Mixed brush content flags") {}
 
         void MixedBrushContentsIssueGenerator::doGenerate(BrushNode* brushNode, IssueList& issues) const {
-            const Brush& brush = brushNode->brush();
-            const auto& faces = brush.faces();
+            const auto& faces = brushNode->faces();
             auto it = std::begin(faces);
             auto end = std::end(faces);
             assert(it != end);
@@ -20,8 +20,6 @@
 #ifndef TrenchBroom_Polyhedron_h
 #define TrenchBroom_Polyhedron_h
 
-#include "Allocator.h"
-
 #include "Polyhedron_Forward.h"
 
 #include <kdl/intrusive_circular_list.h>
@@ -65,7 +63,7 @@ namespace TrenchBroom {
          * The payload of a vertex can be used to store user data.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Vertex : public Allocator<Polyhedron_Vertex<T,FP,VP>> {
+        class Polyhedron_Vertex {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Edge<T,FP,VP>;
@@ -202,7 +200,7 @@ namespace TrenchBroom {
          * list.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Edge : public Allocator<Polyhedron_Edge<T,FP,VP>> {
+        class Polyhedron_Edge {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -475,7 +473,7 @@ namespace TrenchBroom {
          * belongs to.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_HalfEdge : public Allocator<Polyhedron_HalfEdge<T,FP,VP>> {
+        class Polyhedron_HalfEdge {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -682,7 +680,7 @@ namespace TrenchBroom {
          * list.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Face : public Allocator<Polyhedron_Face<T,FP,VP>> {
+        class Polyhedron_Face {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -2072,6 +2070,11 @@ namespace TrenchBroom {
              * @return true if this polyhedron intersects the other polyhedron
              */
             bool intersects(const Polyhedron& other) const;
+
+            /**
+             * Returns the volume of this polyhedron, or 0 if this polyhedron is not a convex volume.
+             */
+            T volume() const;
         private: // helper functions for all cases of polygon / polygon intersection
             static bool pointIntersectsPoint(const Polyhedron& lhs, const Polyhedron& rhs);
             static bool pointIntersectsEdge(const Polyhedron& lhs, const Polyhedron& rhs);
@@ -76,8 +76,11 @@ namespace TrenchBroom {
         template <typename T, typename FP, typename VP>
         void Polyhedron<T,FP,VP>::addPoints(std::vector<vm::vec<T,3>> points) {
             if (!points.empty()) {
+                // The points are added in lexicographic order. Adding extreme points first only pays off for point
+                // clouds with many inner points, but it creates more intermediate faces for typical brushes, where
+                // every point is a vertex of the hull, and the hull is less robust against nearly coplanar points.
                 kdl::vec_sort_and_remove_duplicates(points);
-                
+
                 const auto planeEpsilon = computePlaneEpsilon(points);
                 for (const auto& point : points) {
                     addPoint(point, planeEpsilon);
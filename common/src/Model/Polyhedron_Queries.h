@@ -69,6 +69,28 @@ namespace TrenchBroom {
             return true;
         }
 
+        template <typename T, typename FP, typename VP>
+        T Polyhedron<T,FP,VP>::volume() const {
+            if (!polyhedron()) {
+                return static_cast<T>(0);
+            }
+
+            // Sum the signed volumes of the tetrahedra spanned by a reference point and the triangles of a fan
+            // triangulation of each face. The edges incident to the fan's center span degenerate triangles and
+            // contribute nothing. The reference point is a vertex to keep the numbers small.
+            const auto& origin = m_vertices.front()->position();
+            auto result = static_cast<T>(0);
+            for (const Face* face : m_faces) {
+                const auto center = face->boundary().front()->origin()->position() - origin;
+                for (const HalfEdge* halfEdge : face->boundary()) {
+                    const auto p1 = halfEdge->origin()->position() - origin;
+                    const auto p2 = halfEdge->destination()->position() - origin;
+                    result += vm::dot(center, vm::cross(p1, p2));
+                }
+            }
+            return vm::abs(result) / static_cast<T>(6);
+        }
+
         template <typename T, typename FP, typename VP>
         bool Polyhedron<T,FP,VP>::intersects(const Polyhedron& other) const {
             if (!bounds().intersects(other.bounds())) {
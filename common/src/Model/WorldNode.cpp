@@ -26,6 +26,7 @@
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/CollectMatchingNodesVisitor.h"
+#include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/IssueGenerator.h"
@@ -38,8 +39,11 @@
 
 #include <vecmath/bbox_io.h>
 
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -50,7 +54,8 @@ namespace TrenchBroom {
         m_attributableIndex(std::make_unique<AttributableNodeIndex>()),
         m_issueGeneratorRegistry(std::make_unique<IssueGeneratorRegistry>()),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_nodeTreeUpdateDeferralCount(0u) {
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer();
         }
@@ -185,6 +190,188 @@ namespace TrenchBroom {
             acceptAndRecurse(collect);
 
             m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
+            m_deferredNodeTreeUpdates.clear();
+        }
+
+        void WorldNode::beginDeferredNodeTreeUpdates() {
+            ++m_nodeTreeUpdateDeferralCount;
+        }
+
+        void WorldNode::endDeferredNodeTreeUpdates() {
+            assert(m_nodeTreeUpdateDeferralCount > 0u);
+            if (--m_nodeTreeUpdateDeferralCount == 0u) {
+                applyDeferredNodeTreeUpdates();
+            }
+        }
+
+        WorldNode::DeferNodeTreeUpdates::DeferNodeTreeUpdates(WorldNode* world) :
+        m_world(world) {
+            ensure(m_world != nullptr, "world is null");
+            m_world->beginDeferredNodeTreeUpdates();
+        }
+
+        WorldNode::DeferNodeTreeUpdates::~DeferNodeTreeUpdates() {
+            m_world->endDeferredNodeTreeUpdates();
+        }
+
+        void WorldNode::deferNodeTreeUpdateRecursively(Node* node, const NodeTreeUpdate update) {
+            // `node` is the root of a subtree, see the comment in doDescendantWasAdded
+            using CollectTreeNodes = CollectMatchingNodesVisitor<MatchTreeNodes>;
+
+            CollectTreeNodes collect;
+            node->acceptAndRecurse(collect);
+
+            for (auto* treeNode : collect.nodes()) {
+                deferNodeTreeUpdate(treeNode, update);
+            }
+        }
+
+        void WorldNode::deferNodeTreeUpdate(Node* node, const NodeTreeUpdate update) {
+            auto it = m_deferredNodeTreeUpdates.find(node);
+            if (it == std::end(m_deferredNodeTreeUpdates)) {
+                m_deferredNodeTreeUpdates.emplace(node, update);
+                return;
+            }
+
+            // merge the given update with the one already recorded for this node
+            const NodeTreeUpdate previous = it->second;
+            switch (update) {
+                case NodeTreeUpdate::Insert:
+                    // the node was removed earlier and is now added again, possibly with different bounds
+                    assert(previous == NodeTreeUpdate::Remove);
+                    it->second = NodeTreeUpdate::Update;
+                    break;
+                case NodeTreeUpdate::Remove:
+                    if (previous == NodeTreeUpdate::Insert) {
+                        // the node was never added to the tree, so there is nothing to do
+                        m_deferredNodeTreeUpdates.erase(it);
+                    } else {
+                        it->second = NodeTreeUpdate::Remove;
+                    }
+                    break;
+                case NodeTreeUpdate::Update:
+                    // an insertion or update will use the current bounds anyway
+                    assert(previous != NodeTreeUpdate::Remove);
+                    break;
+                switchDefault()
+            }
+        }
+
+        void WorldNode::applyDeferredNodeTreeUpdates() {
+            if (m_deferredNodeTreeUpdates.empty()) {
+                return;
+            }
+
+            // When many nodes have changed, rebuilding the tree in bulk is cheaper than updating it incrementally.
+            if (m_deferredNodeTreeUpdates.size() > m_nodeTree->size() / 2u) {
+                rebuildNodeTree();
+                return;
+            }
+
+            for (const auto& [node, update] : m_deferredNodeTreeUpdates) {
+                switch (update) {
+                    case NodeTreeUpdate::Insert:
+                        m_nodeTree->insert(node->physicalBounds(), node);
+                        break;
+                    case NodeTreeUpdate::Remove:
+                        if (!m_nodeTree->remove(node)) {
+                            auto str = std::stringstream();
+                            str << "Node not found: " << node;
+                            throw NodeTreeException(str.str());
+                        }
+                        break;
+                    case NodeTreeUpdate::Update:
+                        m_nodeTree->update(node->physicalBounds(), node);
+                        break;
+                    switchDefault()
+                }
+            }
+            m_deferredNodeTreeUpdates.clear();
+        }
+
+        std::vector<Node*> WorldNode::findNodes(const std::function<bool(const vm::bbox3&)>& boundsPredicate) {
+            applyDeferredNodeTreeUpdates();
+
+            std::vector<Node*> result;
+            m_nodeTree->findMatching(boundsPredicate, std::back_inserter(result));
+            return result;
+        }
+
+        std::vector<Node*> WorldNode::findIntersecting(const vm::bbox3& bounds) {
+            return findNodes([&](const vm::bbox3& nodeBounds) { return nodeBounds.intersects(bounds); });
+        }
+
+        std::vector<Node*> WorldNode::findContainedIn(const vm::bbox3& bounds) {
+            // containment is not monotonic, so we must search all intersecting subtrees and filter the result
+            return kdl::vec_filter(findIntersecting(bounds), [&](const Node* node) { return bounds.contains(node->physicalBounds()); });
+        }
+
+        /**
+         * Returns the outermost selectable node on the path from the world to the given node which satisfies the given
+         * predicate, or null if there is no such node. This is the node which a traversal of the world would find if it
+         * stopped recursing into matching nodes.
+         */
+        template <typename P>
+        static Node* findOutermostSelectableMatch(Node* node, const EditorContext& editorContext, const P& predicate) {
+            if (node == nullptr) {
+                return nullptr;
+            }
+            if (auto* match = findOutermostSelectableMatch(node->parent(), editorContext, predicate)) {
+                return match;
+            }
+            return editorContext.selectable(node) && predicate(node) ? node : nullptr;
+        }
+
+        /**
+         * Returns whether any proper ancestor of the given node is contained in the given set.
+         */
+        static bool hasAncestorIn(const Node* node, const std::unordered_set<Node*>& nodes) {
+            for (auto* parent = node->parent(); parent != nullptr; parent = parent->parent()) {
+                if (nodes.count(parent) > 0u) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Queries the node tree with the bounds of each of the given brushes and tests the candidates and their
+         * ancestors with the given predicate. Every matching node is returned once, and nodes whose ancestors also
+         * match (possibly for another brush) are omitted.
+         */
+        template <typename P>
+        static std::vector<Node*> findSelectableMatches(WorldNode& world, const std::vector<BrushNode*>& brushes, const EditorContext& editorContext, const P& predicate) {
+            std::vector<Node*> result;
+            std::unordered_set<Node*> matches;
+
+            for (const auto* brush : brushes) {
+                const auto brushPredicate = [&](const Node* node) { return predicate(brush, node); };
+                for (auto* candidate : world.findIntersecting(brush->physicalBounds())) {
+                    auto* match = findOutermostSelectableMatch(candidate, editorContext, brushPredicate);
+                    if (match != nullptr && matches.insert(match).second) {
+                        result.push_back(match);
+                    }
+                }
+            }
+
+            // a traversal that stops recursing into matching nodes would not have visited these
+            return kdl::vec_filter(std::move(result), [&](const Node* node) { return !hasAncestorIn(node, matches); });
+        }
+
+        std::vector<Node*> WorldNode::findSelectableNodesTouching(const std::vector<BrushNode*>& brushes, const EditorContext& editorContext) {
+            const auto queryNodes = std::unordered_set<const Node*>(std::begin(brushes), std::end(brushes));
+            return findSelectableMatches(*this, brushes, editorContext, [&](const BrushNode* brush, const Node* node) {
+                // if `node` is one of the query nodes, don't count it as touching
+                return queryNodes.count(node) == 0u && brush->intersects(node);
+            });
+        }
+
+        std::vector<Node*> WorldNode::findSelectableNodesContainedIn(const std::vector<BrushNode*>& brushes, const EditorContext& editorContext) {
+            // the candidates are found by intersection because a point entity's logical bounds can be contained in a
+            // brush even if its physical bounds are not
+            return findSelectableMatches(*this, brushes, editorContext, [](const BrushNode* brush, const Node* node) {
+                return brush != node && brush->contains(node);
+            });
         }
 
         class WorldNode::InvalidateAllIssuesVisitor : public NodeVisitor {
@@ -286,22 +473,36 @@ namespace TrenchBroom {
             // In some cases, (e.g. if `node` is a Group), `node` will not be added to the spatial index, but some of its descendants may be.
             // We need to recursively search the `node` being connected and add it or any descendants that need to be added.
             if (m_updateNodeTree) {
-                AddNodeToNodeTree visitor(*m_nodeTree);
-                node->acceptAndRecurse(visitor);
+                if (m_nodeTreeUpdateDeferralCount > 0u) {
+                    deferNodeTreeUpdateRecursively(node, NodeTreeUpdate::Insert);
+                } else {
+                    AddNodeToNodeTree visitor(*m_nodeTree);
+                    node->acceptAndRecurse(visitor);
+                }
             }
         }
 
         void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */) {
             if (m_updateNodeTree) {
-                RemoveNodeFromNodeTree visitor(*m_nodeTree);
-                node->acceptAndRecurse(visitor);
+                if (m_nodeTreeUpdateDeferralCount > 0u) {
+                    deferNodeTreeUpdateRecursively(node, NodeTreeUpdate::Remove);
+                } else {
+                    RemoveNodeFromNodeTree visitor(*m_nodeTree);
+                    node->acceptAndRecurse(visitor);
+                }
             }
         }
 
         void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node) {
             if (m_updateNodeTree) {
-                UpdateNodeInNodeTree visitor(*m_nodeTree);
-                node->accept(visitor);
+                if (m_nodeTreeUpdateDeferralCount > 0u) {
+                    if (node->shouldAddToSpacialIndex()) {
+                        deferNodeTreeUpdate(node, NodeTreeUpdate::Update);
+                    }
+                } else {
+                    UpdateNodeInNodeTree visitor(*m_nodeTree);
+                    node->accept(visitor);
+                }
             }
         }
 
@@ -310,12 +511,14 @@ namespace TrenchBroom {
         }
 
         void WorldNode::doPick(const vm::ray3& ray, PickResult& pickResult) {
+            applyDeferredNodeTreeUpdates();
             for (auto* node : m_nodeTree->findIntersectors(ray)) {
                 node->pick(ray, pickResult);
             }
         }
 
         void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result) {
+            applyDeferredNodeTreeUpdates();
             for (auto* node : m_nodeTree->findContainers(point)) {
                 node->findNodesContaining(point, result);
             }
@@ -27,8 +27,10 @@
 #include "Model/ModelFactory.h"
 #include "Model/Node.h"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -36,6 +38,8 @@ namespace TrenchBroom {
 
     namespace Model {
         class AttributableNodeIndex;
+        class BrushNode;
+        class EditorContext;
         class IssueGeneratorRegistry;
         class IssueQuickFix;
         class PickResult;
@@ -50,6 +54,15 @@ namespace TrenchBroom {
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
+
+            enum class NodeTreeUpdate {
+                Insert,
+                Remove,
+                Update
+            };
+
+            size_t m_nodeTreeUpdateDeferralCount;
+            std::unordered_map<Node*, NodeTreeUpdate> m_deferredNodeTreeUpdates;
         public:
             WorldNode(MapFormat mapFormat);
             ~WorldNode() override;
@@ -90,6 +103,67 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Starts recording changes to the node tree instead of applying them immediately. The recorded changes are
+             * applied when the matching call to endDeferredNodeTreeUpdates() is made, or when the node tree is queried
+             * in the meantime. Calls can be nested, in which case the changes are applied when the outermost deferral
+             * ends.
+             *
+             * If many nodes were changed, the node tree is rebuilt in bulk instead of applying the changes one by one.
+             */
+            void beginDeferredNodeTreeUpdates();
+            void endDeferredNodeTreeUpdates();
+
+            /**
+             * Defers node tree updates for the lifetime of an instance of this class.
+             */
+            class DeferNodeTreeUpdates {
+            private:
+                WorldNode* m_world;
+            public:
+                explicit DeferNodeTreeUpdates(WorldNode* world);
+                ~DeferNodeTreeUpdates();
+
+                deleteCopyAndMove(DeferNodeTreeUpdates)
+            };
+        private:
+            void deferNodeTreeUpdateRecursively(Node* node, NodeTreeUpdate update);
+            void deferNodeTreeUpdate(Node* node, NodeTreeUpdate update);
+            void applyDeferredNodeTreeUpdates();
+        public: // spatial queries
+            /**
+             * Returns every node in the node tree whose bounds satisfy the given predicate. Subtrees of the node tree
+             * are skipped if their bounds do not satisfy the predicate, so the predicate must be monotonic: if it does
+             * not hold for a box, it must not hold for any box contained in it.
+             */
+            std::vector<Node*> findNodes(const std::function<bool(const vm::bbox3&)>& boundsPredicate);
+
+            /**
+             * Returns every node in the node tree whose physical bounds intersect the given bounds.
+             */
+            std::vector<Node*> findIntersecting(const vm::bbox3& bounds);
+
+            /**
+             * Returns every node in the node tree whose physical bounds are contained in the given bounds.
+             */
+            std::vector<Node*> findContainedIn(const vm::bbox3& bounds);
+
+            /**
+             * Returns the selectable nodes which are touched by any of the given brushes, excluding the given brushes
+             * themselves. Only the outermost matching node is returned, e.g. a closed group instead of its members.
+             *
+             * The node tree is used to find candidates for each brush, and only these candidates are tested exactly.
+             */
+            std::vector<Node*> findSelectableNodesTouching(const std::vector<BrushNode*>& brushes, const EditorContext& editorContext);
+
+            /**
+             * Returns the selectable nodes which are contained in any of the given brushes. Only the outermost matching
+             * node is returned, e.g. a closed group instead of its members.
+             *
+             * The node tree is used to find candidates for each brush, and only these candidates are tested exactly.
+             */
+            std::vector<Node*> findSelectableNodesContainedIn(const std::vector<BrushNode*>& brushes, const EditorContext& editorContext);
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
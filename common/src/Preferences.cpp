@@ -48,6 +48,7 @@ namespace TrenchBroom {
         Preference<Color> PortalFileBorderColor(IO::Path("Renderer/Colors/Portal file border"), Color(1.0f, 1.0f, 1.0f, 0.5f));
         Preference<Color> PortalFileFillColor(IO::Path("Renderer/Colors/Portal file fill"), Color(1.0f, 0.4f, 0.4f, 0.2f));
         Preference<bool>  ShowFPS(IO::Path("Renderer/Show FPS"), false);
+        Preference<bool>  OcclusionCulling(IO::Path("Renderer/Occlusion culling"), false);
 
         Preference<Color>& axisColor(vm::axis::type axis) {
             switch (axis) {
@@ -134,6 +135,8 @@ namespace TrenchBroom {
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<bool> ReleaseHiddenBrushGeometry(IO::Path("Editor/Release hidden brush geometry"), false);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -206,6 +209,7 @@ namespace TrenchBroom {
                 &PortalFileBorderColor,
                 &PortalFileFillColor,
                 &ShowFPS,
+                &OcclusionCulling,
                 &CompassBackgroundColor,
                 &CompassBackgroundOutlineColor,
                 &CompassAxisOutlineColor,
@@ -261,6 +265,7 @@ namespace TrenchBroom {
                 &TextureMagFilter,
                 &TextureLock,
                 &UVLock,
+                &ReleaseHiddenBrushGeometry,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
@@ -52,6 +52,7 @@ namespace TrenchBroom {
         extern Preference<Color> PortalFileBorderColor;
         extern Preference<Color> PortalFileFillColor;
         extern Preference<bool>  ShowFPS;
+        extern Preference<bool>  OcclusionCulling;
 
         Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -128,6 +129,8 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> ReleaseHiddenBrushGeometry;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Profiler.h"
+
+#include <ostream>
+
+namespace TrenchBroom {
+    Profiler::Profiler() :
+    m_enabled(false),
+    m_epoch(Clock::now()) {}
+
+    Profiler& Profiler::instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    bool Profiler::enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::setEnabled(const bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Profiler::clear() {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        m_events.clear();
+        m_threadIndices.clear();
+        m_epoch = Clock::now();
+    }
+
+    size_t Profiler::eventCount() const {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        return m_events.size();
+    }
+
+    void Profiler::record(const char* name, std::string detail, const Clock::time_point start, const Clock::time_point end) {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        const auto threadIndex = m_threadIndices.emplace(std::this_thread::get_id(), m_threadIndices.size()).first->second;
+        m_events.push_back(Event{name, std::move(detail), start, end, threadIndex});
+    }
+
+    static void writeJsonString(std::ostream& stream, const std::string& str) {
+        stream << '"';
+        for (const char c : str) {
+            switch (c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+                case '\\':
+                    stream << "\\\\";
+                    break;
+                case '\n':
+                    stream << "\\n";
+                    break;
+                case '\t':
+                    stream << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) >= 0x20u) {
+                        stream << c;
+                    }
+                    break;
+            }
+        }
+        stream << '"';
+    }
+
+    void Profiler::writeTrace(std::ostream& stream) const {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+
+        const auto toMicroseconds = [&](const Clock::duration duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0u; i < m_events.size(); ++i) {
+            const auto& event = m_events[i];
+            if (i > 0u) {
+                stream << ",";
+            }
+            stream << "\n{\"name\":";
+            writeJsonString(stream, event.name);
+            stream << ",\"cat\":\"TrenchBroom\",\"ph\":\"X\""
+                   << ",\"ts\":" << toMicroseconds(event.start - m_epoch)
+                   << ",\"dur\":" << toMicroseconds(event.end - event.start)
+                   << ",\"pid\":1,\"tid\":" << event.threadIndex;
+            if (!event.detail.empty()) {
+                stream << ",\"args\":{\"detail\":";
+                writeJsonString(stream, event.detail);
+                stream << "}";
+            }
+            stream << "}";
+        }
+        stream << "\n]}\n";
+    }
+
+    ProfilerZone::ProfilerZone(const char* name) :
+    m_name(Profiler::instance().enabled() ? name : nullptr) {
+        if (m_name != nullptr) {
+            m_start = Profiler::Clock::now();
+        }
+    }
+
+    ProfilerZone::ProfilerZone(const char* name, const std::string& detail) :
+    m_name(Profiler::instance().enabled() ? name : nullptr) {
+        if (m_name != nullptr) {
+            m_detail = detail;
+            m_start = Profiler::Clock::now();
+        }
+    }
+
+    ProfilerZone::~ProfilerZone() {
+        if (m_name != nullptr) {
+            Profiler::instance().record(m_name, std::move(m_detail), m_start, Profiler::Clock::now());
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_Profiler
+#define TrenchBroom_Profiler
+
+#include "Macros.h"
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * Records the durations of named zones of code and writes them in the Chrome trace event format, which can be
+     * viewed with chrome://tracing or Perfetto.
+     *
+     * The profiler is disabled by default, and zones which are entered while it is disabled cost no more than reading
+     * an atomic flag. Zones are usually created with the TB_PROFILE_ZONE macros, which expand to nothing unless
+     * TrenchBroom is built with the TB_ENABLE_PROFILER option.
+     *
+     * Zones can be recorded from any thread. Each thread gets its own track in the trace.
+     */
+    class Profiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+    private:
+        struct Event {
+            const char* name;
+            std::string detail;
+            Clock::time_point start;
+            Clock::time_point end;
+            size_t threadIndex;
+        };
+
+        std::atomic<bool> m_enabled;
+        Clock::time_point m_epoch;
+
+        mutable std::mutex m_mutex;
+        std::vector<Event> m_events;
+        std::unordered_map<std::thread::id, size_t> m_threadIndices;
+    public:
+        Profiler();
+
+        static Profiler& instance();
+
+        bool enabled() const;
+        void setEnabled(bool enabled);
+
+        /**
+         * Discards all recorded events and restarts the time line and the thread numbering.
+         */
+        void clear();
+        size_t eventCount() const;
+
+        /**
+         * Records a zone which was entered at the given start time and left at the given end time on the calling
+         * thread. The name must be a string literal or otherwise outlive the profiler.
+         */
+        void record(const char* name, std::string detail, Clock::time_point start, Clock::time_point end);
+
+        /**
+         * Writes the recorded events to the given stream as a JSON object in the Chrome trace event format.
+         */
+        void writeTrace(std::ostream& stream) const;
+
+        deleteCopyAndMove(Profiler)
+    };
+
+    /**
+     * Records the time between its construction and its destruction as a zone with the given name if the profiler
+     * is enabled when the zone is entered.
+     */
+    class ProfilerZone {
+    private:
+        const char* m_name;
+        std::string m_detail;
+        Profiler::Clock::time_point m_start;
+    public:
+        explicit ProfilerZone(const char* name);
+
+        /**
+         * Creates a zone with additional detail, e.g. the name of a command. The detail is only copied if the profiler
+         * is enabled.
+         */
+        ProfilerZone(const char* name, const std::string& detail);
+        ~ProfilerZone();
+
+        deleteCopyAndMove(ProfilerZone)
+    };
+}
+
+#define TB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TB_PROFILE_CONCAT(a, b) TB_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef TB_ENABLE_PROFILER
+#define TB_PROFILE_ZONE(name) const TrenchBroom::ProfilerZone TB_PROFILE_CONCAT(profilerZone_, __LINE__)(name)
+#define TB_PROFILE_ZONE_DETAIL(name, detail) const TrenchBroom::ProfilerZone TB_PROFILE_CONCAT(profilerZone_, __LINE__)(name, detail)
+#else
+#define TB_PROFILE_ZONE(name)
+#define TB_PROFILE_ZONE_DETAIL(name, detail)
+#endif
+
+#endif /* defined(TrenchBroom_Profiler) */
@@ -21,6 +21,7 @@
 
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "Profiler.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
@@ -31,8 +32,10 @@
 #include "Renderer/BrushRendererBrushCache.h"
 #include "Renderer/RenderContext.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <iterator>
 #include <vector>
 
 namespace TrenchBroom {
@@ -133,7 +136,8 @@ namespace TrenchBroom {
         m_showOccludedEdges(false),
         m_forceTransparent(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_visibleRangesValid(false) {
             clear();
         }
 
@@ -163,6 +167,14 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::removeBrushes(const std::vector<Model::BrushNode*>& brushes) {
+            for (const auto* brush : brushes) {
+                if (m_allBrushes.find(brush) != std::end(m_allBrushes)) {
+                    removeBrush(brush);
+                }
+            }
+        }
+
         void BrushRenderer::invalidate() {
             for (auto& brush : m_allBrushes) {
                 // this will also invalidate already invalid brushes, which
@@ -184,9 +196,24 @@ namespace TrenchBroom {
                     assert(m_invalidBrushes.find(brush) == std::end(m_invalidBrushes));
                     continue;
                 }
-                // if it's not in the invalid set, put it in
+                // the brush might already be invalid with its vertices still in the VBO
+                m_invalidBrushes.insert(brush);
+                removeBrushFromVbo(brush);
+            }
+        }
+
+        void BrushRenderer::invalidateBrushIndices(const std::vector<Model::BrushNode*>& brushes) {
+            for (auto& brush : brushes) {
+                // skip brushes that are not in the renderer
+                if (m_allBrushes.find(brush) == std::end(m_allBrushes)) {
+                    continue;
+                }
+                // if it's not in the invalid set, put it in, and keep its vertices
                 if (m_invalidBrushes.insert(brush).second) {
-                    removeBrushFromVbo(brush);
+                    auto it = m_brushInfo.find(brush);
+                    if (it != std::end(m_brushInfo)) {
+                        removeBrushIndicesFromVbo(it->second);
+                    }
                 }
             }
         }
@@ -208,6 +235,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_visibleRangesValid = false;
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
@@ -263,6 +291,18 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setVisibleBrushes(const std::vector<Model::BrushNode*>& brushes) {
+            m_visibleBrushes = std::vector<const Model::BrushNode*>(std::begin(brushes), std::end(brushes));
+            m_visibleRangesValid = false;
+        }
+
+        void BrushRenderer::clearVisibleBrushes() {
+            if (m_visibleBrushes) {
+                m_visibleBrushes = std::nullopt;
+                m_visibleRangesValid = false;
+            }
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
@@ -273,6 +313,9 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                if (!m_visibleRangesValid) {
+                    updateVisibleRanges();
+                }
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -287,6 +330,9 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                if (!m_visibleRangesValid) {
+                    updateVisibleRanges();
+                }
                 if (renderContext.showFaces()) {
                     renderTransparentFaces(renderBatch);
                 }
@@ -315,6 +361,67 @@ namespace TrenchBroom {
             m_edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
+        static void coalesceRanges(std::vector<AllocationTracker::Range>& ranges) {
+            std::sort(std::begin(ranges), std::end(ranges));
+
+            size_t count = 0u;
+            for (const auto& range : ranges) {
+                if (count > 0u && ranges[count - 1u].pos + ranges[count - 1u].size == range.pos) {
+                    ranges[count - 1u].size += range.size;
+                } else {
+                    ranges[count++] = range;
+                }
+            }
+            ranges.erase(std::next(std::begin(ranges), static_cast<std::ptrdiff_t>(count)), std::end(ranges));
+        }
+
+        void BrushRenderer::updateVisibleRanges() {
+            m_visibleRangesValid = true;
+
+            if (!m_visibleBrushes) {
+                m_opaqueFaceRenderer.setVisibleRanges(nullptr);
+                m_transparentFaceRenderer.setVisibleRanges(nullptr);
+                m_edgeRenderer.setVisibleRanges(nullptr);
+                return;
+            }
+
+            auto opaqueRanges = std::make_shared<FaceRenderer::TextureToIndexRangesMap>();
+            auto transparentRanges = std::make_shared<FaceRenderer::TextureToIndexRangesMap>();
+            auto edgeRanges = std::make_shared<std::vector<AllocationTracker::Range>>();
+
+            for (const auto* brush : *m_visibleBrushes) {
+                const auto it = m_brushInfo.find(brush);
+                if (it == std::end(m_brushInfo)) {
+                    continue;
+                }
+
+                const auto& info = it->second;
+                if (info.edgeIndicesKey != nullptr) {
+                    edgeRanges->emplace_back(info.edgeIndicesKey->pos, info.edgeIndicesKey->size);
+                }
+                for (const auto& [texture, key] : info.opaqueFaceIndicesKeys) {
+                    (*opaqueRanges)[texture].emplace_back(key->pos, key->size);
+                }
+                for (const auto& [texture, key] : info.transparentFaceIndicesKeys) {
+                    (*transparentRanges)[texture].emplace_back(key->pos, key->size);
+                }
+            }
+
+            // brushes are usually added in the order in which they are visited, so neighbouring brushes often have
+            // adjacent index ranges
+            coalesceRanges(*edgeRanges);
+            for (auto& [texture, ranges] : *opaqueRanges) {
+                coalesceRanges(ranges);
+            }
+            for (auto& [texture, ranges] : *transparentRanges) {
+                coalesceRanges(ranges);
+            }
+
+            m_opaqueFaceRenderer.setVisibleRanges(std::move(opaqueRanges));
+            m_transparentFaceRenderer.setVisibleRanges(std::move(transparentRanges));
+            m_edgeRenderer.setVisibleRanges(std::move(edgeRanges));
+        }
+
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
         private:
             const Filter& m_filter;
@@ -339,6 +446,7 @@ namespace TrenchBroom {
         };
 
         void BrushRenderer::validate() {
+            TB_PROFILE_ZONE("BrushRenderer::validate");
             assert(!valid());
 
             for (auto brush : m_invalidBrushes) {
@@ -350,6 +458,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_visibleRangesValid = false;
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -441,7 +550,6 @@ namespace TrenchBroom {
         void BrushRenderer::validateBrush(const Model::BrushNode* brush) {
             assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
             assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
-            assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
 
             const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
 
@@ -451,24 +559,33 @@ namespace TrenchBroom {
 
             if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
                 edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
+                // NOTE: this removes any vertices which were kept in the VBO, and skips inserting the brush into
+                // m_brushInfo
+                removeBrushFromVbo(brush);
                 return;
             }
 
+            // if only the brush's indices were invalidated, its vertices are still in the VBO
             BrushInfo& info = m_brushInfo[brush];
+            assert(info.edgeIndicesKey == nullptr);
+            assert(info.opaqueFaceIndicesKeys.empty());
+            assert(info.transparentFaceIndicesKeys.empty());
 
-            // collect vertices
             auto& brushCache = brush->brushRendererBrushCache();
             brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
 
-            assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
+            if (info.vertexHolderKey == nullptr) {
+                // collect vertices
+                const auto& cachedVertices = brushCache.cachedVertices();
+                ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+
+                assert(m_vertexArray != nullptr);
+                auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+                std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+                info.vertexHolderKey = vertBlock;
+            }
 
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+            const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
 
             // insert edge indices into VBO
             {
@@ -582,13 +699,12 @@ namespace TrenchBroom {
             // update m_brushValid
             assertResult(m_allBrushes.erase(brush) > 0u);
 
-            if (m_invalidBrushes.erase(brush) > 0u) {
-                // invalid brushes are not in the VBO, so we can return  now.
-                assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
-                return;
-            }
-
+            // invalid brushes might still have their vertices in the VBO
+            m_invalidBrushes.erase(brush);
             removeBrushFromVbo(brush);
+
+            // the freed index ranges may be reused by other brushes
+            m_visibleRangesValid = false;
         }
 
         void BrushRenderer::removeBrushFromVbo(const Model::BrushNode* brush) {
@@ -600,10 +716,16 @@ namespace TrenchBroom {
                 return;
             }
 
-            const BrushInfo& info = it->second;
+            BrushInfo& info = it->second;
 
             // update Vbo's
             m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+            removeBrushIndicesFromVbo(info);
+
+            m_brushInfo.erase(it);
+        }
+
+        void BrushRenderer::removeBrushIndicesFromVbo(BrushInfo& info) {
             if (info.edgeIndicesKey != nullptr) {
                 m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
             }
@@ -627,7 +749,9 @@ namespace TrenchBroom {
                 }
             }
 
-            m_brushInfo.erase(it);
+            info.edgeIndicesKey = nullptr;
+            info.opaqueFaceIndicesKeys.clear();
+            info.transparentFaceIndicesKeys.clear();
         }
     }
 }
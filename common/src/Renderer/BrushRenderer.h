@@ -27,6 +27,7 @@
 #include "Renderer/FaceRenderer.h"
 
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -131,7 +132,8 @@ namespace TrenchBroom {
             std::unordered_map<const Model::BrushNode*, BrushInfo> m_brushInfo;
 
             /**
-             * If a brush is in the VBO, it's always valid.
+             * If a brush's indices are in the VBO, it's always valid. An invalid brush may still have its vertices in
+             * the VBO if only its indices were invalidated.
              * If a brush is valid, it might not be in the VBO if it was hidden by the Filter.
              *
              * Do not attempt to use vector_set here, it turns out to be slower.
@@ -162,6 +164,13 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
 
             bool m_showHiddenBrushes;
+
+            /**
+             * If set, only these brushes are rendered. The index ranges of these brushes are collected lazily when
+             * rendering, see updateVisibleRanges().
+             */
+            std::optional<std::vector<const Model::BrushNode*>> m_visibleBrushes;
+            bool m_visibleRangesValid;
         public:
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
@@ -172,7 +181,8 @@ namespace TrenchBroom {
             m_showOccludedEdges(false),
             m_forceTransparent(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_visibleRangesValid(false) {
                 clear();
             }
 
@@ -186,6 +196,10 @@ namespace TrenchBroom {
              * New brushes are invalidated, brushes already in the BrushRenderer are not invalidated.
              */
             void setBrushes(const std::vector<Model::BrushNode*>& brushes);
+            /**
+             * Removes the given brushes from the BrushRenderer. Brushes which are not in the BrushRenderer are ignored.
+             */
+            void removeBrushes(const std::vector<Model::BrushNode*>& brushes);
             void clear();
 
             /**
@@ -200,6 +214,18 @@ namespace TrenchBroom {
              */
             void invalidate();
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
+            /**
+             * Marks the given brushes as invalid, but keeps their vertices in the VBO. Next time one of the render()
+             * methods is called, the Filter will be re-evaluated for these brushes and only their edge and face indices
+             * will be rewritten.
+             *
+             * This is meant for changes that only affect which faces and edges of a brush are rendered, such as
+             * selection or visibility changes. If the geometry or the textures of a brush have changed, the brush
+             * must be invalidated with invalidateBrushes() instead.
+             *
+             * Brushes which are not in the BrushRenderer are ignored.
+             */
+            void invalidateBrushIndices(const std::vector<Model::BrushNode*>& brushes);
             bool valid() const;
 
             /**
@@ -266,6 +292,18 @@ namespace TrenchBroom {
              * Specifies whether or not brushes which are currently hidden should be rendered regardless.
              */
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Restricts rendering to the given brushes until this is called again or clearVisibleBrushes() is called.
+             * Brushes which are not in the BrushRenderer are ignored. This does not invalidate any brushes, it only
+             * selects which of the index ranges already stored in the VBO are drawn.
+             */
+            void setVisibleBrushes(const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Renders all brushes again.
+             */
+            void clearVisibleBrushes();
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -274,6 +312,7 @@ namespace TrenchBroom {
             void renderOpaqueFaces(RenderBatch& renderBatch);
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
+            void updateVisibleRanges();
 
         public:
             /**
@@ -292,6 +331,11 @@ namespace TrenchBroom {
              * The brush's "valid" state is not touched inside here, but the m_brushInfo is updated.
              */
             void removeBrushFromVbo(const Model::BrushNode* brush);
+
+            /**
+             * Zeroes out the edge and face indices of the given brush info, but keeps its vertices in the VBO.
+             */
+            void removeBrushIndicesFromVbo(BrushInfo& info);
         private:
             BrushRenderer(const BrushRenderer& other);
             BrushRenderer& operator=(const BrushRenderer& other);
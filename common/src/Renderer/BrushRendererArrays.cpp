@@ -22,52 +22,12 @@
 #include <cassert>
 #include <algorithm>
 #include <cstring>
-#include <stdexcept>
 
 namespace TrenchBroom {
     // BrushIndexArray
 
     namespace Renderer {
 
-        // DirtyRangeTracker
-
-        DirtyRangeTracker::DirtyRangeTracker(const size_t initial_capacity)
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(initial_capacity) {}
-
-        DirtyRangeTracker::DirtyRangeTracker()
-                : m_dirtyPos(0), m_dirtySize(0), m_capacity(0) {}
-
-        void DirtyRangeTracker::expand(const size_t newcap) {
-            if (newcap <= m_capacity) {
-                throw std::invalid_argument("new capacity must be greater");
-            }
-
-            const size_t oldcap = m_capacity;
-            m_capacity = newcap;
-            markDirty(oldcap, newcap - oldcap);
-        }
-
-        size_t DirtyRangeTracker::capacity() const {
-            return m_capacity;
-        }
-
-        void DirtyRangeTracker::markDirty(const size_t pos, const size_t size) {
-            // bounds check
-            if (pos + size > m_capacity) {
-                throw std::invalid_argument("markDirty provided range out of bounds");
-            }
-
-            const size_t newPos = std::min(pos, m_dirtyPos);
-            const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
-
-            m_dirtyPos = newPos;
-            m_dirtySize = newEnd - newPos;
-        }
-
-        bool DirtyRangeTracker::clean() const {
-            return m_dirtySize == 0;
-        }
-
         // IndexHolder
 
         IndexHolder::IndexHolder() : VboHolder<Index>(VboType::ElementArrayBuffer) {}
@@ -87,6 +47,23 @@ namespace TrenchBroom {
             glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const {
+            if (ranges.empty()) {
+                return;
+            }
+
+            std::vector<GLsizei> counts;
+            std::vector<const GLvoid*> offsets;
+            counts.reserve(ranges.size());
+            offsets.reserve(ranges.size());
+            for (const auto& range : ranges) {
+                counts.push_back(static_cast<GLsizei>(range.size));
+                offsets.push_back(reinterpret_cast<const GLvoid*>(m_vbo->offset() + sizeof(Index) * range.pos));
+            }
+
+            glAssert(glMultiDrawElements(toGL(primType), counts.data(), glType<Index>(), offsets.data(), static_cast<GLsizei>(ranges.size())));
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -136,6 +113,11 @@ namespace TrenchBroom {
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::render(const PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const {
+            assert(m_indexHolder.prepared());
+            m_indexHolder.render(primType, ranges);
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
@@ -22,6 +22,8 @@
 
 #include "Ensure.h"
 #include "Renderer/AllocationTracker.h"
+#include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/DirtyRangeTracker.h"
 #include "Renderer/GL.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/PrimType.h"
@@ -31,6 +33,7 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
@@ -38,41 +41,34 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        struct DirtyRangeTracker {
-            size_t m_dirtyPos;
-            size_t m_dirtySize;
-            size_t m_capacity;
-
-            /**
-             * New trackers are initially clean.
-             */
-            explicit DirtyRangeTracker(size_t initial_capacity);
-            DirtyRangeTracker();
-
-            /**
-             * Expanding marks the new range as dirty.
-             */
-            void expand(size_t newcap);
-            size_t capacity() const;
-            void markDirty(size_t pos, size_t size);
-            bool clean() const;
-        };
-
         /**
          * Wrapper around a std::vector<T> and VboBlock.
          *
          * Non-copyable; meant to be held in a std::shared_ptr.
          * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
          *
-         * Currently uses a single range to track the modified region which might upload much more than necessary;
-         * it might be worth mapping the VBO and editing it directly.
+         * The modified elements are tracked as a set of ranges which are uploaded separately. If most of the buffer
+         * was modified, the buffer is orphaned and rewritten as a whole instead, which saves the driver from waiting
+         * until the GPU no longer uses the old contents.
          */
         template<typename T>
         class VboHolder {
+        public:
+            /**
+             * Dirty ranges which are separated by at most this many bytes are uploaded together.
+             */
+            static constexpr size_t MergeGapBytes = 4096u;
+            static constexpr size_t MergeGap = std::max(MergeGapBytes / sizeof(T), size_t(1));
+
+            /**
+             * The default ratio of dirty elements at which the buffer is orphaned and rewritten as a whole.
+             */
+            static constexpr double DefaultOrphanThreshold = 0.5;
         protected:
             VboType m_type;
             std::vector<T> m_snapshot;
             DirtyRangeTracker m_dirtyRange;
+            double m_orphanThreshold;
             VboManager* m_vboManager;
             Vbo* m_vbo;
         private:
@@ -96,7 +92,7 @@ namespace TrenchBroom {
 
                 m_vbo->writeElements(0, m_snapshot);
 
-                m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
+                m_dirtyRange = DirtyRangeTracker(m_snapshot.size(), MergeGap);
                 assert(m_dirtyRange.clean());
                 assert((m_vbo->capacity() / sizeof(T)) == m_dirtyRange.capacity());
             }
@@ -105,7 +101,8 @@ namespace TrenchBroom {
             explicit VboHolder(const VboType type) :
             m_type(type),
             m_snapshot(),
-            m_dirtyRange(0),
+            m_dirtyRange(0, MergeGap),
+            m_orphanThreshold(DefaultOrphanThreshold),
             m_vboManager(nullptr),
             m_vbo(nullptr) {}
 
@@ -115,7 +112,8 @@ namespace TrenchBroom {
             VboHolder(const VboType type, std::vector<T>& elements) :
             m_type(type),
             m_snapshot(),
-            m_dirtyRange(elements.size()),
+            m_dirtyRange(elements.size(), MergeGap),
+            m_orphanThreshold(DefaultOrphanThreshold),
             m_vboManager(nullptr),
             m_vbo(nullptr) {
 
@@ -182,21 +180,34 @@ namespace TrenchBroom {
                 }
 
                 // otherwise, it's an incremental update of the dirty ranges.
-
-                if (!m_dirtyRange.clean()) {
-                    const size_t pos = m_dirtyRange.m_dirtyPos;
-                    const size_t size = m_dirtyRange.m_dirtySize;
-
-                    const size_t bytesFromStart = pos * sizeof(T);
-                    m_vbo->writeArray(bytesFromStart,
-                                      m_snapshot.data() + pos,
-                                      size);
+                const auto dirtyRatio = static_cast<double>(m_dirtyRange.dirtySize()) / static_cast<double>(m_snapshot.size());
+                if (dirtyRatio >= m_orphanThreshold) {
+                    m_vbo->orphan();
+                    m_vbo->writeElements(0, m_snapshot);
+                } else {
+                    for (const auto& range : m_dirtyRange.ranges()) {
+                        m_vbo->writeArray(range.pos * sizeof(T),
+                                          m_snapshot.data() + range.pos,
+                                          range.size);
+                    }
                 }
 
-                m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
+                m_dirtyRange.clear();
                 assert(prepared());
             }
 
+            /**
+             * Sets the ratio of dirty elements at which the buffer is orphaned and rewritten as a whole instead of
+             * uploading the dirty ranges. A threshold greater than 1 disables orphaning.
+             */
+            void setOrphanThreshold(const double orphanThreshold) {
+                m_orphanThreshold = orphanThreshold;
+            }
+
+            const T* elements() const {
+                return m_snapshot.data();
+            }
+
             bool empty() const {
                 return m_snapshot.empty();
             }
@@ -225,6 +236,10 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            /**
+             * Renders the given ranges of indices with a single draw call.
+             */
+            void render(PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -261,6 +276,10 @@ namespace TrenchBroom {
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
             void render(const PrimType primType) const;
+            /**
+             * Renders only the given ranges of indices. The ranges must have been allocated from this array.
+             */
+            void render(const PrimType primType, const std::vector<AllocationTracker::Range>& ranges) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
 
@@ -315,7 +334,7 @@ namespace TrenchBroom {
          */
         class BrushVertexArray {
         private:
-            using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+            using Vertex = BrushRendererBrushCache::Vertex;
 
             VertexHolder<Vertex> m_vertexHolder;
             AllocationTracker m_allocationTracker;
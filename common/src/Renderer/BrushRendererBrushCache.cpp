@@ -23,6 +23,7 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/Polyhedron.h"
+#include "Renderer/VertexEncoding.h"
 
 #include <algorithm>
 
@@ -70,6 +71,11 @@ namespace TrenchBroom {
 
             for (const Model::BrushFace& face : brush.faces()) {
                 const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
+#ifdef TB_COMPACT_BRUSH_VERTICES
+                const auto normal = encodeByteNormal(vm::vec3f(face.boundary().normal));
+#else
+                const auto normal = vm::vec3f(face.boundary().normal);
+#endif
 
                 // The boundary is in CCW order, but the renderer expects CW order:
                 auto& boundary = face.geometry()->boundary();
@@ -85,7 +91,7 @@ namespace TrenchBroom {
                     vertex->setPayload(static_cast<GLuint>(currentIndex));
 
                     const auto& position = vertex->position();
-                    m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
+                    m_cachedVertices.emplace_back(vm::vec3f(position), normal, face.textureCoords(position));
 
                     current = current->previous();
                 }
@@ -37,7 +37,15 @@ namespace TrenchBroom {
     namespace Renderer {
         class BrushRendererBrushCache {
         public:
+#ifdef TB_COMPACT_BRUSH_VERTICES
+            /**
+             * Stores the normals as bytes, see encodeByteNormal. This reduces the size of a vertex from 32 to 24
+             * bytes.
+             */
+            using VertexSpec = Renderer::GLVertexTypes::P3NbT2;
+#else
             using VertexSpec = Renderer::GLVertexTypes::P3NT2;
+#endif
             using Vertex = VertexSpec::Vertex;
 
             struct CachedFace {
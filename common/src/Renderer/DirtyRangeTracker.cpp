@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DirtyRangeTracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        DirtyRangeTracker::Range::Range(const size_t i_pos, const size_t i_size) :
+        pos(i_pos),
+        size(i_size) {}
+
+        size_t DirtyRangeTracker::Range::end() const {
+            return pos + size;
+        }
+
+        bool DirtyRangeTracker::Range::operator==(const Range& other) const {
+            return pos == other.pos && size == other.size;
+        }
+
+        bool DirtyRangeTracker::Range::operator!=(const Range& other) const {
+            return !(*this == other);
+        }
+
+        DirtyRangeTracker::DirtyRangeTracker(const size_t initialCapacity, const size_t mergeGap) :
+        m_dirtySize(0u),
+        m_capacity(initialCapacity),
+        m_mergeGap(mergeGap) {}
+
+        DirtyRangeTracker::DirtyRangeTracker() :
+        DirtyRangeTracker(0u) {}
+
+        void DirtyRangeTracker::expand(const size_t newcap) {
+            if (newcap <= m_capacity) {
+                throw std::invalid_argument("new capacity must be greater");
+            }
+
+            const size_t oldcap = m_capacity;
+            m_capacity = newcap;
+            markDirty(oldcap, newcap - oldcap);
+        }
+
+        size_t DirtyRangeTracker::capacity() const {
+            return m_capacity;
+        }
+
+        size_t DirtyRangeTracker::mergeGap() const {
+            return m_mergeGap;
+        }
+
+        void DirtyRangeTracker::markDirty(const size_t pos, const size_t size) {
+            // bounds check
+            if (pos + size > m_capacity) {
+                throw std::invalid_argument("markDirty provided range out of bounds");
+            }
+            if (size == 0u) {
+                return;
+            }
+
+            auto newPos = pos;
+            auto newEnd = pos + size;
+
+            // the first range which ends no more than the merge gap before the new range
+            auto first = std::lower_bound(std::begin(m_ranges), std::end(m_ranges), pos, [&](const Range& range, const size_t p) {
+                return range.end() + m_mergeGap < p;
+            });
+
+            // find all ranges which start no more than the merge gap after the new range and merge them
+            auto last = first;
+            while (last != std::end(m_ranges) && last->pos <= newEnd + m_mergeGap) {
+                newPos = std::min(newPos, last->pos);
+                newEnd = std::max(newEnd, last->end());
+                m_dirtySize -= last->size;
+                ++last;
+            }
+
+            if (first == last) {
+                m_ranges.insert(first, Range(newPos, newEnd - newPos));
+            } else {
+                *first = Range(newPos, newEnd - newPos);
+                m_ranges.erase(std::next(first), last);
+            }
+            m_dirtySize += newEnd - newPos;
+            assert(m_dirtySize <= m_capacity);
+        }
+
+        void DirtyRangeTracker::clear() {
+            m_ranges.clear();
+            m_dirtySize = 0u;
+        }
+
+        bool DirtyRangeTracker::clean() const {
+            return m_ranges.empty();
+        }
+
+        const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::ranges() const {
+            return m_ranges;
+        }
+
+        size_t DirtyRangeTracker::dirtySize() const {
+            return m_dirtySize;
+        }
+    }
+}
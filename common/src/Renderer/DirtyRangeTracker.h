@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_DirtyRangeTracker
+#define TrenchBroom_DirtyRangeTracker
+
+#include <cstddef>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Tracks which elements of a buffer were modified since the buffer was last uploaded.
+         *
+         * The modified elements are kept as a sorted set of disjoint ranges so that edits which are far apart can be
+         * uploaded separately. Ranges which are separated by no more than the merge gap are merged, since uploading a
+         * few clean elements is cheaper than issuing another upload.
+         */
+        class DirtyRangeTracker {
+        public:
+            struct Range {
+                size_t pos;
+                size_t size;
+
+                Range(size_t pos, size_t size);
+
+                size_t end() const;
+                bool operator==(const Range& other) const;
+                bool operator!=(const Range& other) const;
+            };
+        private:
+            std::vector<Range> m_ranges;
+            size_t m_dirtySize;
+            size_t m_capacity;
+            size_t m_mergeGap;
+        public:
+            /**
+             * New trackers are initially clean.
+             *
+             * @param initialCapacity the number of elements in the buffer
+             * @param mergeGap ranges separated by at most this many clean elements are merged
+             */
+            explicit DirtyRangeTracker(size_t initialCapacity, size_t mergeGap = 0u);
+            DirtyRangeTracker();
+
+            /**
+             * Expanding marks the new range as dirty.
+             */
+            void expand(size_t newcap);
+            size_t capacity() const;
+            size_t mergeGap() const;
+
+            /**
+             * Marks the given range as dirty and merges it with all ranges which it overlaps or which are at most the
+             * merge gap away from it.
+             *
+             * @throw std::invalid_argument if the given range exceeds the capacity
+             */
+            void markDirty(size_t pos, size_t size);
+
+            /**
+             * Marks all elements as clean without changing the capacity.
+             */
+            void clear();
+
+            bool clean() const;
+
+            /**
+             * Returns the dirty ranges, sorted by their positions.
+             */
+            const std::vector<Range>& ranges() const;
+
+            /**
+             * Returns the number of elements covered by the dirty ranges.
+             */
+            size_t dirtySize() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_DirtyRangeTracker) */
@@ -21,11 +21,13 @@
 #define TrenchBroom_EdgeRenderer
 
 #include "Color.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/VertexArray.h"
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -106,8 +108,9 @@ namespace TrenchBroom {
             private:
                 std::shared_ptr<BrushVertexArray> m_vertexArray;
                 std::shared_ptr<BrushIndexArray> m_indexArray;
+                std::shared_ptr<const std::vector<AllocationTracker::Range>> m_visibleRanges;
             public:
-                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
+                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray, std::shared_ptr<const std::vector<AllocationTracker::Range>> visibleRanges);
             private:
                 void prepareVerticesAndIndices(VboManager& vboManager) override;
                 void doRender(RenderContext& renderContext) override;
@@ -116,6 +119,7 @@ namespace TrenchBroom {
         private:
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<BrushIndexArray> m_indexArray;
+            std::shared_ptr<const std::vector<AllocationTracker::Range>> m_visibleRanges;
         public:
             IndexedEdgeRenderer();
             IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
@@ -123,6 +127,11 @@ namespace TrenchBroom {
             IndexedEdgeRenderer(const IndexedEdgeRenderer& other);
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
 
+            /**
+             * Restricts rendering to the given index ranges. Pass null to render all edges again.
+             */
+            void setVisibleRanges(std::shared_ptr<const std::vector<AllocationTracker::Range>> visibleRanges);
+
             friend void swap(IndexedEdgeRenderer& left, IndexedEdgeRenderer& right);
         private:
             void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
@@ -36,19 +36,32 @@
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
+        using LinkVertex = GLVertexTypes::P3C4::Vertex;
+
+        static std::pair<LinkVertex, LinkVertex> makeLink(const Model::AttributableNode* source, const Model::AttributableNode* target, const Color& defaultColor, const Color& selectedColor) {
+            const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
+            const auto& color = anySelected ? selectedColor : defaultColor;
+            return { LinkVertex(vm::vec3f(source->linkSourceAnchor()), color), LinkVertex(vm::vec3f(target->linkTargetAnchor()), color) };
+        }
+
         EntityLinkRenderer::EntityLinkRenderer(std::weak_ptr<View::MapDocument> document) :
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
         m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
+        m_rebuild(true),
         m_valid(false) {}
 
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
@@ -70,17 +83,53 @@ namespace TrenchBroom {
         }
 
         void EntityLinkRenderer::invalidate() {
+            m_invalidNodes.clear();
+            m_rebuild = true;
             m_valid = false;
         }
 
+        void EntityLinkRenderer::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            if (m_rebuild || nodes.empty()) {
+                return;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            if (document->editorContext().entityLinkMode() != Model::EditorContext::EntityLinkMode_All) {
+                invalidate();
+            } else {
+                m_invalidNodes.insert(std::end(m_invalidNodes), std::begin(nodes), std::end(nodes));
+                m_valid = false;
+            }
+        }
+
+        bool EntityLinkRenderer::valid() const {
+            return m_valid;
+        }
+
+        void EntityLinkRenderer::validate() {
+            if (m_rebuild) {
+                rebuild();
+            } else {
+                update();
+            }
+
+            m_invalidNodes.clear();
+            m_rebuild = false;
+            m_valid = true;
+        }
+
+        size_t EntityLinkRenderer::linkCount() const {
+            return m_entityLinks.count();
+        }
+
         void EntityLinkRenderer::doPrepareVertices(VboManager& vboManager) {
             if (!m_valid) {
                 validate();
-
-                // Upload the VBO's
-                m_entityLinks.prepare(vboManager);
-                m_entityLinkArrows.prepare(vboManager);
             }
+
+            // Upload the changed records
+            m_entityLinks.prepare(vboManager);
+            m_entityLinkArrows.prepare(vboManager);
         }
 
         void EntityLinkRenderer::doRender(RenderContext& renderContext) {
@@ -117,67 +166,21 @@ namespace TrenchBroom {
             m_entityLinkArrows.render(PrimType::Lines);
         }
 
-        void EntityLinkRenderer::validate() {
-            std::vector<Vertex> links;
-            getLinks(links);
-
-            // build the arrows before destroying `links`
-            std::vector<ArrowVertex> arrows;
-            getArrows(arrows, links);
-
-            m_entityLinks = VertexArray::move(std::move(links));
-            m_entityLinkArrows = VertexArray::move(std::move(arrows));
-
-            m_valid = true;
-        }
-
-        void EntityLinkRenderer::getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links) {
-            assert((links.size() % 2) == 0);
-            for (size_t i = 0; i < links.size(); i += 2) {
-                const auto& startVertex = links[i];
-                const auto& endVertex = links[i + 1];
-
-                const auto lineVec = (getVertexComponent<0>(endVertex) - getVertexComponent<0>(startVertex));
-                const auto lineLength = length(lineVec);
-                const auto lineDir = lineVec / lineLength;
-                const auto color = getVertexComponent<1>(startVertex);
-
-                if (lineLength < 512) {
-                    const auto arrowPosition = getVertexComponent<0>(startVertex) + (lineVec * 0.6f);
-                    addArrow(arrows, color, arrowPosition, lineDir);
-                } else if (lineLength < 1024) {
-                    const auto arrowPosition1 = getVertexComponent<0>(startVertex) + (lineVec * 0.2f);
-                    const auto arrowPosition2 = getVertexComponent<0>(startVertex) + (lineVec * 0.6f);
-
-                    addArrow(arrows, color, arrowPosition1, lineDir);
-                    addArrow(arrows, color, arrowPosition2, lineDir);
-                } else {
-                    const auto arrowPosition1 = getVertexComponent<0>(startVertex) + (lineVec * 0.1f);
-                    const auto arrowPosition2 = getVertexComponent<0>(startVertex) + (lineVec * 0.4f);
-                    const auto arrowPosition3 = getVertexComponent<0>(startVertex) + (lineVec * 0.7f);
-
-                    addArrow(arrows, color, arrowPosition1, lineDir);
-                    addArrow(arrows, color, arrowPosition2, lineDir);
-                    addArrow(arrows, color, arrowPosition3, lineDir);
-                }
-            }
-        }
-
-        void EntityLinkRenderer::addArrow(std::vector<ArrowVertex>& arrows, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir) {
-            arrows.emplace_back(vm::vec3f{0, 3, 0}, color, arrowPosition, lineDir);
-            arrows.emplace_back(vm::vec3f{9, 0, 0}, color, arrowPosition, lineDir);
-
-            arrows.emplace_back(vm::vec3f{9, 0, 0}, color, arrowPosition, lineDir);
-            arrows.emplace_back(vm::vec3f{0,-3, 0}, color, arrowPosition, lineDir);
-        }
-
         class EntityLinkRenderer::MatchEntities {
         public:
             bool operator()(const Model::EntityNode*) { return true; }
             bool operator()(const Model::Node*) { return false; }
         };
 
-        class EntityLinkRenderer::CollectEntitiesVisitor : public Model::CollectMatchingNodesVisitor<MatchEntities, Model::UniqueNodeCollectionStrategy> {};
+        class EntityLinkRenderer::MatchAttributables {
+        public:
+            bool operator()(const Model::AttributableNode*) { return true; }
+            bool operator()(const Model::Node*) { return false; }
+        };
+
+        class EntityLinkRenderer::CollectEntitiesVisitor : public Model::CollectMatchingNodesVisitor<MatchEntities, Model::StandardNodeCollectionStrategy> {};
+        class EntityLinkRenderer::CollectUniqueEntitiesVisitor : public Model::CollectMatchingNodesVisitor<MatchEntities, Model::UniqueNodeCollectionStrategy> {};
+        class EntityLinkRenderer::CollectAttributablesVisitor : public Model::CollectMatchingNodesVisitor<MatchAttributables, Model::UniqueNodeCollectionStrategy> {};
 
         class EntityLinkRenderer::CollectLinksVisitor : public Model::NodeVisitor {
         protected:
@@ -207,32 +210,9 @@ namespace TrenchBroom {
             virtual void visitEntity(Model::EntityNode* entity) = 0;
         protected:
             void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target) {
-                const auto anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
-                const auto& sourceColor = anySelected ? m_selectedColor : m_defaultColor;
-                const auto targetColor = anySelected ? m_selectedColor : m_defaultColor;
-
-                m_links.emplace_back(vm::vec3f(source->linkSourceAnchor()), sourceColor);
-                m_links.emplace_back(vm::vec3f(target->linkTargetAnchor()), targetColor);
-            }
-        };
-
-        class EntityLinkRenderer::CollectAllLinksVisitor : public CollectLinksVisitor {
-        public:
-            CollectAllLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, std::vector<Vertex>& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
-        private:
-            void visitEntity(Model::EntityNode* entity) override {
-                if (m_editorContext.visible(entity)) {
-                    addTargets(entity, entity->linkTargets());
-                    addTargets(entity, entity->killTargets());
-                }
-            }
-
-            void addTargets(Model::EntityNode* source, const std::vector<Model::AttributableNode*>& targets) {
-                for (const Model::AttributableNode* target : targets) {
-                    if (m_editorContext.visible(target))
-                        addLink(source, target);
-                }
+                const auto link = makeLink(source, target, m_defaultColor, m_selectedColor);
+                m_links.push_back(link.first);
+                m_links.push_back(link.second);
             }
         };
 
@@ -307,32 +287,20 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
             switch (editorContext.entityLinkMode()) {
-                case Model::EditorContext::EntityLinkMode_All:
-                    getAllLinks(links);
-                    break;
                 case Model::EditorContext::EntityLinkMode_Transitive:
                     getTransitiveSelectedLinks(links);
                     break;
                 case Model::EditorContext::EntityLinkMode_Direct:
                     getDirectSelectedLinks(links);
                     break;
+                case Model::EditorContext::EntityLinkMode_All:
+                    // maintained incrementally, see rebuild()
                 case Model::EditorContext::EntityLinkMode_None:
                     break;
                 switchDefault()
             }
         }
 
-        void EntityLinkRenderer::getAllLinks(std::vector<Vertex>& links) const {
-            auto document = kdl::mem_lock(m_document);
-            const Model::EditorContext& editorContext = document->editorContext();
-
-            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
-
-            Model::WorldNode* world = document->world();
-            if (world != nullptr)
-                world->acceptAndRecurse(collectLinks);
-        }
-
         void EntityLinkRenderer::getTransitiveSelectedLinks(std::vector<Vertex>& links) const {
             auto document = kdl::mem_lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
@@ -353,11 +321,180 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
 
             const auto& selectedNodes = document->selectedNodes().nodes();
-            CollectEntitiesVisitor collectEntities;
+            CollectUniqueEntitiesVisitor collectEntities;
             Model::Node::acceptAndEscalate(std::begin(selectedNodes), std::end(selectedNodes), collectEntities);
 
             const auto& selectedEntities = collectEntities.nodes();
             Model::Node::accept(std::begin(selectedEntities), std::end(selectedEntities), collectLinks);
         }
+
+        void EntityLinkRenderer::rebuild() {
+            m_entityLinks.clear();
+            m_entityLinkArrows.clear();
+            m_linksBySource.clear();
+            m_sourcesByTarget.clear();
+
+            auto document = kdl::mem_lock(m_document);
+            const Model::EditorContext& editorContext = document->editorContext();
+            if (editorContext.entityLinkMode() == Model::EditorContext::EntityLinkMode_All) {
+                Model::WorldNode* world = document->world();
+                if (world != nullptr) {
+                    CollectEntitiesVisitor collectEntities;
+                    world->acceptAndRecurse(collectEntities);
+                    for (auto* node : collectEntities.nodes()) {
+                        addSourceLinks(static_cast<Model::EntityNode*>(node), editorContext);
+                    }
+                }
+            } else {
+                std::vector<Vertex> links;
+                getLinks(links);
+
+                assert((links.size() % 2) == 0);
+                for (size_t i = 0; i < links.size(); i += 2) {
+                    addLink(nullptr, links[i], links[i + 1], nullptr);
+                }
+            }
+        }
+
+        void EntityLinkRenderer::update() {
+            auto document = kdl::mem_lock(m_document);
+            const Model::EditorContext& editorContext = document->editorContext();
+
+            // A link must be updated if its source or its target changed. The targets that a source linked to before
+            // the change are found in the link graph, and the sources that link to a target now are found in the target.
+            CollectAttributablesVisitor collectAttributables;
+            Model::Node::acceptAndEscalate(std::begin(m_invalidNodes), std::end(m_invalidNodes), collectAttributables);
+
+            std::vector<Model::Node*> sources;
+            for (auto* node : collectAttributables.nodes()) {
+                const auto* attributable = static_cast<const Model::AttributableNode*>(node);
+                sources.push_back(node);
+
+                const auto it = m_sourcesByTarget.find(attributable);
+                if (it != std::end(m_sourcesByTarget)) {
+                    sources.insert(std::end(sources), std::begin(it->second), std::end(it->second));
+                }
+                sources.insert(std::end(sources), std::begin(attributable->linkSources()), std::end(attributable->linkSources()));
+                sources.insert(std::end(sources), std::begin(attributable->killSources()), std::end(attributable->killSources()));
+            }
+            kdl::vec_sort_and_remove_duplicates(sources);
+
+            CollectEntitiesVisitor collectSources;
+            Model::Node::accept(std::begin(sources), std::end(sources), collectSources);
+            for (auto* node : collectSources.nodes()) {
+                updateSourceLinks(static_cast<Model::EntityNode*>(node), editorContext);
+            }
+        }
+
+        void EntityLinkRenderer::updateSourceLinks(Model::EntityNode* source, const Model::EditorContext& editorContext) {
+            removeSourceLinks(source);
+            addSourceLinks(source, editorContext);
+        }
+
+        void EntityLinkRenderer::removeSourceLinks(const Model::EntityNode* source) {
+            auto it = m_linksBySource.find(source);
+            if (it == std::end(m_linksBySource)) {
+                return;
+            }
+
+            // remove the entry first so that it is never updated while its records are being removed
+            auto sourceLinks = std::move(it->second);
+            m_linksBySource.erase(it);
+
+            for (const auto* target : sourceLinks.targets) {
+                auto tIt = m_sourcesByTarget.find(target);
+                if (tIt != std::end(m_sourcesByTarget)) {
+                    auto& targetSources = tIt->second;
+                    targetSources.erase(std::remove(std::begin(targetSources), std::end(targetSources), source), std::end(targetSources));
+                    if (targetSources.empty()) {
+                        m_sourcesByTarget.erase(tIt);
+                    }
+                }
+            }
+
+            removeRecords(m_entityLinks, std::move(sourceLinks.lines), &SourceLinks::lines);
+            removeRecords(m_entityLinkArrows, std::move(sourceLinks.arrows), &SourceLinks::arrows);
+        }
+
+        void EntityLinkRenderer::addSourceLinks(Model::EntityNode* source, const Model::EditorContext& editorContext) {
+            if (!editorContext.visible(source)) {
+                return;
+            }
+
+            SourceLinks sourceLinks;
+            for (const auto* targets : { &source->linkTargets(), &source->killTargets() }) {
+                for (Model::AttributableNode* target : *targets) {
+                    if (editorContext.visible(target)) {
+                        const auto link = makeLink(source, target, m_defaultColor, m_selectedColor);
+                        addLink(source, link.first, link.second, &sourceLinks);
+
+                        sourceLinks.targets.push_back(target);
+                        m_sourcesByTarget[target].push_back(source);
+                    }
+                }
+            }
+
+            if (!sourceLinks.targets.empty()) {
+                m_linksBySource.emplace(source, std::move(sourceLinks));
+            }
+        }
+
+        void EntityLinkRenderer::addLink(const Model::EntityNode* owner, const Vertex& startVertex, const Vertex& endVertex, SourceLinks* sourceLinks) {
+            const auto index = m_entityLinks.add(owner, { startVertex, endVertex });
+            if (sourceLinks != nullptr) {
+                sourceLinks->lines.push_back(index);
+            }
+
+            const auto lineVec = (getVertexComponent<0>(endVertex) - getVertexComponent<0>(startVertex));
+            const auto lineLength = length(lineVec);
+            const auto lineDir = lineVec / lineLength;
+            const auto color = getVertexComponent<1>(startVertex);
+
+            if (lineLength < 512) {
+                const auto arrowPosition = getVertexComponent<0>(startVertex) + (lineVec * 0.6f);
+                addArrow(owner, color, arrowPosition, lineDir, sourceLinks);
+            } else if (lineLength < 1024) {
+                const auto arrowPosition1 = getVertexComponent<0>(startVertex) + (lineVec * 0.2f);
+                const auto arrowPosition2 = getVertexComponent<0>(startVertex) + (lineVec * 0.6f);
+
+                addArrow(owner, color, arrowPosition1, lineDir, sourceLinks);
+                addArrow(owner, color, arrowPosition2, lineDir, sourceLinks);
+            } else {
+                const auto arrowPosition1 = getVertexComponent<0>(startVertex) + (lineVec * 0.1f);
+                const auto arrowPosition2 = getVertexComponent<0>(startVertex) + (lineVec * 0.4f);
+                const auto arrowPosition3 = getVertexComponent<0>(startVertex) + (lineVec * 0.7f);
+
+                addArrow(owner, color, arrowPosition1, lineDir, sourceLinks);
+                addArrow(owner, color, arrowPosition2, lineDir, sourceLinks);
+                addArrow(owner, color, arrowPosition3, lineDir, sourceLinks);
+            }
+        }
+
+        void EntityLinkRenderer::addArrow(const Model::EntityNode* owner, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir, SourceLinks* sourceLinks) {
+            const auto index = m_entityLinkArrows.add(owner, {
+                ArrowVertex(vm::vec3f{0, 3, 0}, color, arrowPosition, lineDir),
+                ArrowVertex(vm::vec3f{9, 0, 0}, color, arrowPosition, lineDir),
+
+                ArrowVertex(vm::vec3f{9, 0, 0}, color, arrowPosition, lineDir),
+                ArrowVertex(vm::vec3f{0,-3, 0}, color, arrowPosition, lineDir)
+            });
+            if (sourceLinks != nullptr) {
+                sourceLinks->arrows.push_back(index);
+            }
+        }
+
+        template <typename R>
+        void EntityLinkRenderer::removeRecords(R& records, std::vector<size_t> indices, std::vector<size_t> SourceLinks::*member) {
+            // Removing in descending order ensures that none of the given records is moved while they are removed.
+            std::sort(std::begin(indices), std::end(indices), std::greater<size_t>());
+            for (const auto index : indices) {
+                const auto last = records.count() - 1u;
+                const auto* movedOwner = records.remove(index);
+                if (movedOwner != nullptr) {
+                    auto& ownerIndices = m_linksBySource.at(movedOwner).*member;
+                    std::replace(std::begin(ownerIndices), std::end(ownerIndices), last, index);
+                }
+            }
+        }
     }
 }
@@ -21,17 +21,29 @@
 #define TrenchBroom_EntityLinkRenderer
 
 #include "Color.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/GLVertex.h"
+#include "Renderer/PrimType.h"
 #include "Renderer/Renderable.h"
-#include "Renderer/VertexArray.h"
 
 #include <vecmath/forward.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Model {
+        class AttributableNode;
+        class EditorContext;
+        class EntityNode;
+        class Node;
+    }
+
     namespace View {
         class MapDocument; // FIXME: Renderer should not depend on View
     }
@@ -57,14 +69,100 @@ namespace TrenchBroom {
                     GLVertexAttributeUser<ArrowPositionName, GL_FLOAT, 3, false>,          // arrow position
                     GLVertexAttributeUser<LineDirName,       GL_FLOAT, 3, false>>::Vertex; // direction the arrow is pointing
 
+            /**
+             * Stores records of N vertices each, densely packed so that they can be rendered with a single draw call.
+             * Every record belongs to a source entity. When a record is removed, the last record is moved into its
+             * place, and only the changed records are uploaded again.
+             */
+            template <typename V, size_t N>
+            class VertexRecords {
+            private:
+                VertexHolder<V> m_vertices;
+                std::vector<const Model::EntityNode*> m_owners;
+            public:
+                size_t count() const {
+                    return m_owners.size();
+                }
+
+                void clear() {
+                    m_owners.clear();
+                }
+
+                /**
+                 * Appends a record and returns its index.
+                 */
+                size_t add(const Model::EntityNode* owner, const std::array<V, N>& vertices) {
+                    const auto index = m_owners.size();
+                    if ((index + 1u) * N > m_vertices.size()) {
+                        m_vertices.resize(std::max(2u * m_vertices.size(), (index + 1u) * N));
+                    }
+
+                    std::copy(std::begin(vertices), std::end(vertices), m_vertices.getPointerToWriteElementsTo(index * N, N));
+                    m_owners.push_back(owner);
+                    return index;
+                }
+
+                /**
+                 * Removes the record with the given index by moving the last record into its place. Returns the owner
+                 * of the moved record, or null if the removed record was the last one.
+                 */
+                const Model::EntityNode* remove(const size_t index) {
+                    assert(index < m_owners.size());
+
+                    const auto last = m_owners.size() - 1u;
+                    const Model::EntityNode* movedOwner = nullptr;
+                    if (index != last) {
+                        const auto* lastVertices = m_vertices.elements() + last * N;
+                        std::copy(lastVertices, lastVertices + N, m_vertices.getPointerToWriteElementsTo(index * N, N));
+                        movedOwner = m_owners[last];
+                        m_owners[index] = movedOwner;
+                    }
+
+                    m_owners.pop_back();
+                    return movedOwner;
+                }
+
+                void prepare(VboManager& vboManager) {
+                    m_vertices.prepareVertices(vboManager);
+                }
+
+                void render(const PrimType primType) {
+                    if (!m_owners.empty() && m_vertices.setupVertices()) {
+                        glAssert(glDrawArrays(toGL(primType), 0, static_cast<GLsizei>(m_owners.size() * N)));
+                        m_vertices.cleanupVertices();
+                    }
+                }
+            };
+
+            using LineRecords = VertexRecords<Vertex, 2u>;
+            using ArrowRecords = VertexRecords<ArrowVertex, 4u>;
+
+            /**
+             * The links that start at a source entity and the records that were created for them.
+             */
+            struct SourceLinks {
+                std::vector<Model::AttributableNode*> targets;
+                std::vector<size_t> lines;
+                std::vector<size_t> arrows;
+            };
+
             std::weak_ptr<View::MapDocument> m_document;
 
             Color m_defaultColor;
             Color m_selectedColor;
 
-            VertexArray m_entityLinks;
-            VertexArray m_entityLinkArrows;
+            LineRecords m_entityLinks;
+            ArrowRecords m_entityLinkArrows;
+
+            /**
+             * The link graph for EntityLinkMode_All, which is updated incrementally. For other modes, all records are
+             * rebuilt on each invalidation and these maps are empty.
+             */
+            std::unordered_map<const Model::EntityNode*, SourceLinks> m_linksBySource;
+            std::unordered_map<const Model::AttributableNode*, std::vector<Model::EntityNode*>> m_sourcesByTarget;
 
+            std::vector<Model::Node*> m_invalidNodes;
+            bool m_rebuild;
             bool m_valid;
         public:
             EntityLinkRenderer(std::weak_ptr<View::MapDocument> document);
@@ -73,28 +171,52 @@ namespace TrenchBroom {
             void setSelectedColor(const Color& color);
 
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
+
+            /**
+             * Rebuilds all links on the next validation.
+             */
             void invalidate();
+
+            /**
+             * Rebuilds only the links that start or end at the given nodes or at their containing entities on the next
+             * validation. Falls back to invalidate() unless all links are shown, because the other modes depend on the
+             * selection as a whole.
+             */
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
+
+            bool valid() const;
+            void validate();
+
+            size_t linkCount() const;
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
             void renderLines(RenderContext& renderContext);
             void renderArrows(RenderContext& renderContext);
         private:
-            void validate();
+            void rebuild();
+            void update();
+
+            void updateSourceLinks(Model::EntityNode* source, const Model::EditorContext& editorContext);
+            void removeSourceLinks(const Model::EntityNode* source);
+            void addSourceLinks(Model::EntityNode* source, const Model::EditorContext& editorContext);
 
-            static void getArrows(std::vector<ArrowVertex>& arrows, const std::vector<Vertex>& links);
-            static void addArrow(std::vector<ArrowVertex>& arrows, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir);
+            void addLink(const Model::EntityNode* owner, const Vertex& startVertex, const Vertex& endVertex, SourceLinks* sourceLinks);
+            void addArrow(const Model::EntityNode* owner, const vm::vec4f& color, const vm::vec3f& arrowPosition, const vm::vec3f& lineDir, SourceLinks* sourceLinks);
+            template <typename R>
+            void removeRecords(R& records, std::vector<size_t> indices, std::vector<size_t> SourceLinks::*member);
 
             class MatchEntities;
+            class MatchAttributables;
             class CollectEntitiesVisitor;
+            class CollectUniqueEntitiesVisitor;
+            class CollectAttributablesVisitor;
 
             class CollectLinksVisitor;
-            class CollectAllLinksVisitor;
             class CollectTransitiveSelectedLinksVisitor;
             class CollectDirectSelectedLinksVisitor;
 
             void getLinks(std::vector<Vertex>& links) const;
-            void getAllLinks(std::vector<Vertex>& links) const;
             void getTransitiveSelectedLinks(std::vector<Vertex>& links) const;
             void getDirectSelectedLinks(std::vector<Vertex>& links) const;
             void collectSelectedLinks(CollectLinksVisitor& collectLinks) const;
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityModelBatches.h"
+
+#include <vecmath/bbox.h>
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        EntityModelBatches::EntityModelBatches() :
+        m_instanceCount(0u),
+        m_lodInstanceCount(0u) {}
+
+        void EntityModelBatches::reset(const vm::vec3f& cameraPosition) {
+            m_cameraPosition = cameraPosition;
+            m_batches.clear();
+            m_batchIndices.clear();
+            m_instanceCount = 0u;
+            m_lodInstanceCount = 0u;
+        }
+
+        void EntityModelBatches::add(TexturedRenderer* renderer, TexturedRenderer* lodRenderer, const vm::bbox3f& bounds, const vm::mat4x4f& transformation) {
+            assert(renderer != nullptr);
+
+            if (lodRenderer != nullptr && useLod(bounds, m_cameraPosition)) {
+                renderer = lodRenderer;
+                ++m_lodInstanceCount;
+            }
+
+            const auto [it, inserted] = m_batchIndices.emplace(renderer, m_batches.size());
+            if (inserted) {
+                m_batches.push_back({ renderer, {} });
+            }
+
+            m_batches[it->second].transformations.push_back(transformation);
+            ++m_instanceCount;
+        }
+
+        bool EntityModelBatches::useLod(const vm::bbox3f& bounds, const vm::vec3f& cameraPosition) {
+            const auto size = vm::length(bounds.size());
+            const auto distance = vm::distance(bounds.center(), cameraPosition);
+            return size < distance * LodSizeFactor;
+        }
+
+        const std::vector<EntityModelBatches::Batch>& EntityModelBatches::batches() const {
+            return m_batches;
+        }
+
+        size_t EntityModelBatches::instanceCount() const {
+            return m_instanceCount;
+        }
+
+        size_t EntityModelBatches::lodInstanceCount() const {
+            return m_lodInstanceCount;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityModelBatches
+#define TrenchBroom_EntityModelBatches
+
+#include <vecmath/forward.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class TexturedRenderer;
+
+        /**
+         * Groups entity model instances by their renderers so that each renderer is set up only once per frame for
+         * all instances which share the same model, skin and frame. Models which are small relative to their distance
+         * from the camera are assigned to their LOD renderer if one is available.
+         */
+        class EntityModelBatches {
+        public:
+            struct Batch {
+                TexturedRenderer* renderer;
+                std::vector<vm::mat4x4f> transformations;
+            };
+
+            /**
+             * A model is rendered using its LOD renderer if the diagonal of its bounds is smaller than its distance
+             * from the camera multiplied by this factor.
+             */
+            static constexpr float LodSizeFactor = 0.02f;
+        private:
+            vm::vec3f m_cameraPosition;
+            std::vector<Batch> m_batches;
+            std::unordered_map<TexturedRenderer*, size_t> m_batchIndices;
+            size_t m_instanceCount;
+            size_t m_lodInstanceCount;
+        public:
+            EntityModelBatches();
+
+            /**
+             * Removes all batches and sets the camera position used to decide whether to use LOD renderers.
+             */
+            void reset(const vm::vec3f& cameraPosition);
+
+            /**
+             * Adds an instance of an entity model.
+             *
+             * @param renderer the renderer for the model, must not be null
+             * @param lodRenderer the LOD renderer for the model, may be null
+             * @param bounds the bounds of the instance in world coordinates
+             * @param transformation the model transformation of the instance
+             */
+            void add(TexturedRenderer* renderer, TexturedRenderer* lodRenderer, const vm::bbox3f& bounds, const vm::mat4x4f& transformation);
+
+            /**
+             * Indicates whether a model with the given bounds should be rendered using its LOD renderer when seen from
+             * the given position.
+             */
+            static bool useLod(const vm::bbox3f& bounds, const vm::vec3f& cameraPosition);
+
+            const std::vector<Batch>& batches() const;
+            size_t instanceCount() const;
+            size_t lodInstanceCount() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelBatches) */
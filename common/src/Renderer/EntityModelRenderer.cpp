@@ -30,15 +30,20 @@
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/Camera.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderUtils.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         EntityModelRenderer::EntityModelRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
@@ -59,7 +64,8 @@ namespace TrenchBroom {
 
             auto* renderer = m_entityModelManager.renderer(modelSpec);
             if (renderer != nullptr) {
-                m_entities.insert(std::make_pair(entity, renderer));
+                auto* lodRenderer = m_entityModelManager.lodRenderer(modelSpec);
+                m_entities.insert(std::make_pair(entity, ModelRenderers{ renderer, lodRenderer }));
             }
         }
 
@@ -76,16 +82,22 @@ namespace TrenchBroom {
             }
 
             if (it == std::end(m_entities)) {
-                m_entities.insert(std::make_pair(entity, renderer));
+                auto* lodRenderer = m_entityModelManager.lodRenderer(modelSpec);
+                m_entities.insert(std::make_pair(entity, ModelRenderers{ renderer, lodRenderer }));
             } else {
                 if (renderer == nullptr) {
                     m_entities.erase(it);
-                } else if (it->second != renderer) {
-                    it->second = renderer;
+                } else if (it->second.renderer != renderer) {
+                    auto* lodRenderer = m_entityModelManager.lodRenderer(modelSpec);
+                    it->second = ModelRenderers{ renderer, lodRenderer };
                 }
             }
         }
 
+        void EntityModelRenderer::removeEntity(Model::EntityNode* entity) {
+            m_entities.erase(entity);
+        }
+
         void EntityModelRenderer::clear() {
             m_entities.clear();
         }
@@ -114,6 +126,31 @@ namespace TrenchBroom {
             m_showHiddenEntities = showHiddenEntities;
         }
 
+        /**
+         * Sets up the model matrix of each instance of an entity model.
+         */
+        class EntityModelRenderer::SetModelMatrix : public InstanceRenderFunc {
+        private:
+            ActiveShader& m_shader;
+            Transformation& m_transformation;
+            const std::vector<vm::mat4x4f>& m_modelMatrices;
+        public:
+            SetModelMatrix(ActiveShader& shader, Transformation& transformation, const std::vector<vm::mat4x4f>& modelMatrices) :
+            m_shader(shader),
+            m_transformation(transformation),
+            m_modelMatrices(modelMatrices) {}
+
+            void before(const size_t index) override {
+                const auto& modelMatrix = m_modelMatrices[index];
+                m_transformation.pushModelMatrix(modelMatrix);
+                m_shader.set("ModelMatrix", modelMatrix);
+            }
+
+            void after(const size_t /* index */) override {
+                m_transformation.popModelMatrix();
+            }
+        };
+
         void EntityModelRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -142,20 +179,19 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
-            for (const auto& entry : m_entities) {
-                auto* entity = entry.first;
+            // group the entities by renderer so that every model is only set up once
+            m_batches.reset(renderContext.camera().position());
+            for (const auto& [entity, renderers] : m_entities) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
 
-                auto* renderer = entry.second;
-
-                const auto transformation = entity->modelTransformation();
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
-
-                shader.set("ModelMatrix", vm::mat4x4f(transformation));
+                m_batches.add(renderers.renderer, renderers.lodRenderer, vm::bbox3f(entity->physicalBounds()), vm::mat4x4f(entity->modelTransformation()));
+            }
 
-                renderer->render();
+            for (const auto& batch : m_batches.batches()) {
+                SetModelMatrix setModelMatrix(shader, renderContext.transformation(), batch.transformations);
+                batch.renderer->renderInstances(batch.transformations.size(), setModelMatrix);
             }
         }
     }
@@ -21,6 +21,7 @@
 #define TrenchBroom_EntityModelRenderer
 
 #include "Color.h"
+#include "Renderer/EntityModelBatches.h"
 #include "Renderer/Renderable.h"
 
 #include <map>
@@ -43,7 +44,12 @@ namespace TrenchBroom {
 
         class EntityModelRenderer : public DirectRenderable {
         private:
-            using EntityMap = std::map<Model::EntityNode*, TexturedRenderer*>;
+            struct ModelRenderers {
+                TexturedRenderer* renderer;
+                TexturedRenderer* lodRenderer;
+            };
+
+            using EntityMap = std::map<Model::EntityNode*, ModelRenderers>;
 
             Logger& m_logger;
 
@@ -51,6 +57,7 @@ namespace TrenchBroom {
             const Model::EditorContext& m_editorContext;
 
             EntityMap m_entities;
+            EntityModelBatches m_batches;
 
             bool m_applyTinting;
             Color m_tintColor;
@@ -82,8 +89,17 @@ namespace TrenchBroom {
                 }
             }
 
+            template <typename I>
+            void removeEntities(I cur, I end) {
+                while (cur != end) {
+                    removeEntity(*cur);
+                    ++cur;
+                }
+            }
+
             void addEntity(Model::EntityNode* entity);
             void updateEntity(Model::EntityNode* entity);
+            void removeEntity(Model::EntityNode* entity);
             void clear();
 
             bool applyTinting() const;
@@ -96,6 +112,8 @@ namespace TrenchBroom {
 
             void render(RenderBatch& renderBatch);
         private:
+            class SetModelMatrix;
+
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
         };
@@ -79,10 +79,52 @@ namespace TrenchBroom {
 
         void EntityRenderer::setEntities(const std::vector<Model::EntityNode*>& entities) {
             m_entities = entities;
+            m_entityIndices.clear();
+            for (size_t i = 0u; i < m_entities.size(); ++i) {
+                m_entityIndices.emplace(m_entities[i], i);
+            }
             m_modelRenderer.setEntities(std::begin(m_entities), std::end(m_entities));
             invalidate();
         }
 
+        void EntityRenderer::addEntities(const std::vector<Model::EntityNode*>& entities) {
+            std::vector<Model::EntityNode*> addedEntities;
+            for (auto* entity : entities) {
+                if (m_entityIndices.emplace(entity, m_entities.size()).second) {
+                    m_entities.push_back(entity);
+                    addedEntities.push_back(entity);
+                }
+            }
+
+            if (!addedEntities.empty()) {
+                m_modelRenderer.addEntities(std::begin(addedEntities), std::end(addedEntities));
+                invalidateBounds();
+            }
+        }
+
+        void EntityRenderer::removeEntities(const std::vector<Model::EntityNode*>& entities) {
+            std::vector<Model::EntityNode*> removedEntities;
+            for (auto* entity : entities) {
+                const auto it = m_entityIndices.find(entity);
+                if (it != std::end(m_entityIndices)) {
+                    // the order of the entities doesn't matter, so we move the last entity into the gap
+                    const auto index = it->second;
+                    m_entityIndices.erase(it);
+                    if (index != m_entities.size() - 1u) {
+                        m_entities[index] = m_entities.back();
+                        m_entityIndices[m_entities[index]] = index;
+                    }
+                    m_entities.pop_back();
+                    removedEntities.push_back(entity);
+                }
+            }
+
+            if (!removedEntities.empty()) {
+                m_modelRenderer.removeEntities(std::begin(removedEntities), std::end(removedEntities));
+                invalidateBounds();
+            }
+        }
+
         void EntityRenderer::invalidate() {
             invalidateBounds();
             reloadModels();
@@ -90,6 +132,7 @@ namespace TrenchBroom {
 
         void EntityRenderer::clear() {
             m_entities.clear();
+            m_entityIndices.clear();
             m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
             m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
             m_solidBoundsRenderer = TriangleRenderer();
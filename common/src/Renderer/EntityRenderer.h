@@ -28,6 +28,7 @@
 
 #include <vecmath/forward.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -52,6 +53,7 @@ namespace TrenchBroom {
             Assets::EntityModelManager& m_entityModelManager;
             const Model::EditorContext& m_editorContext;
             std::vector<Model::EntityNode*> m_entities;
+            std::unordered_map<Model::EntityNode*, size_t> m_entityIndices;
 
             DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
             DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
@@ -77,6 +79,17 @@ namespace TrenchBroom {
             EntityRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext);
 
             void setEntities(const std::vector<Model::EntityNode*>& entities);
+
+            /**
+             * Adds the given entities to this renderer. Entities which are already in this renderer are ignored.
+             */
+            void addEntities(const std::vector<Model::EntityNode*>& entities);
+
+            /**
+             * Removes the given entities from this renderer. Entities which are not in this renderer are ignored.
+             */
+            void removeEntities(const std::vector<Model::EntityNode*>& entities);
+
             void invalidate();
             void clear();
             void reloadModels();
@@ -47,7 +47,8 @@ namespace TrenchBroom {
             void before(const Assets::Texture* texture) override {
                 if (texture != nullptr) {
                     texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
+                    // textures are uploaded over several frames, so use the average color until this one is ready
+                    shader.set("ApplyTexture", applyTexture && texture->isPrepared());
                     shader.set("Color", texture->averageColor());
                 } else {
                     shader.set("ApplyTexture", false);
@@ -79,6 +80,7 @@ namespace TrenchBroom {
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_visibleRanges(other.m_visibleRanges),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -95,6 +97,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_visibleRanges, right.m_visibleRanges);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -118,6 +121,10 @@ namespace TrenchBroom {
             m_alpha = alpha;
         }
 
+        void FaceRenderer::setVisibleRanges(std::shared_ptr<const TextureToIndexRangesMap> visibleRanges) {
+            m_visibleRanges = std::move(visibleRanges);
+        }
+
         void FaceRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -193,6 +200,15 @@ namespace TrenchBroom {
                         continue;
                     }
 
+                    const std::vector<AllocationTracker::Range>* ranges = nullptr;
+                    if (m_visibleRanges != nullptr) {
+                        const auto it = m_visibleRanges->find(texture);
+                        if (it == std::end(*m_visibleRanges)) {
+                            continue;
+                        }
+                        ranges = &it->second;
+                    }
+
                     const bool enableMasked = texture != nullptr && texture->masked();
                     
                     // set any per-texture uniforms
@@ -201,7 +217,11 @@ namespace TrenchBroom {
 
                     func.before(texture);
                     brushIndexHolderPtr->setupIndices();
-                    brushIndexHolderPtr->render(PrimType::Triangles);
+                    if (ranges != nullptr) {
+                        brushIndexHolderPtr->render(PrimType::Triangles, *ranges);
+                    } else {
+                        brushIndexHolderPtr->render(PrimType::Triangles);
+                    }
                     brushIndexHolderPtr->cleanupIndices();
                     func.after(texture);
                 }
@@ -46,10 +46,11 @@ namespace TrenchBroom {
 
         FontDescriptor FontManager::selectFontSize(const FontDescriptor& fontDescriptor, const std::string& string, const float maxWidth, const size_t minFontSize) {
             FontDescriptor actualDescriptor = fontDescriptor;
-            vm::vec2f actualBounds = font(actualDescriptor).measure(string);
+            // the runs are cached, and the run for the selected size is likely to be rendered
+            vm::vec2f actualBounds = font(actualDescriptor).layout(string, false)->size;
             while (actualBounds.x() > maxWidth && actualDescriptor.size() > minFontSize) {
                 actualDescriptor = FontDescriptor(actualDescriptor.path(), actualDescriptor.size() - 1);
-                actualBounds = font(actualDescriptor).measure(string);
+                actualBounds = font(actualDescriptor).layout(string, false)->size;
             }
             return actualDescriptor;
         }
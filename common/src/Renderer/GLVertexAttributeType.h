@@ -94,10 +94,12 @@ namespace TrenchBroom {
         };
 
         /**
-         * Vertex normal attribute types.
+         * Vertex normal attribute types. Normals always have three components, but a fourth component can be added
+         * to pad the normal to a multiple of four bytes. The padding component is ignored by OpenGL. Normals with
+         * integer components are mapped to [-1, 1] by OpenGL.
          *
          * @tparam D the vertex component type
-         * @tparam S the number of components
+         * @tparam S the number of components, 3 or 4
          */
         template <GLenum D, const size_t S>
         class GLVertexAttributeNormal {
@@ -107,7 +109,7 @@ namespace TrenchBroom {
             static const size_t Size = sizeof(ElementType);
 
             static void setup(ShaderProgram* /* program */, const size_t /* index */, const size_t stride, const size_t offset) {
-                assert(S == 3);
+                static_assert(S == 3 || S == 4, "normals must have three components and optional padding");
                 glAssert(glEnableClientState(GL_NORMAL_ARRAY))
                 glAssert(glNormalPointer(D, static_cast<GLsizei>(stride), reinterpret_cast<GLvoid*>(offset)))
             }
@@ -181,6 +183,7 @@ namespace TrenchBroom {
             using P2  = GLVertexAttributePosition<GL_FLOAT, 2>;
             using P3  = GLVertexAttributePosition<GL_FLOAT, 3>;
             using N   = GLVertexAttributeNormal<GL_FLOAT, 3>;
+            using Nb  = GLVertexAttributeNormal<GL_BYTE, 4>;
             using T02 = GLVertexAttributeTexCoord0<GL_FLOAT, 2>;
             using C4  = GLVertexAttributeColor<GL_FLOAT, 4>;
         }
@@ -0,0 +1,37 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GlyphRunCache.h"
+
+#include <vecmath/scalar.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        std::vector<vm::vec2f> GlyphRun::translatedVertices(const vm::vec2f& offset) const {
+            const auto roundedOffset = vm::vec2f(vm::round(offset.x()), vm::round(offset.y()));
+
+            auto result = vertices;
+            for (size_t i = 0u; i < result.size(); i += 2u) {
+                result[i] = result[i] + roundedOffset;
+            }
+            return result;
+        }
+    }
+}
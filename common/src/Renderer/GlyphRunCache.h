@@ -0,0 +1,145 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_GlyphRunCache
+#define TrenchBroom_GlyphRunCache
+
+#include <vecmath/forward.h>
+#include <vecmath/vec.h>
+
+#include <cassert>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * A string that was laid out with a font.
+         */
+        struct GlyphRun {
+            /**
+             * The glyph quads as returned by TextureFont::quads for an offset of zero, that is, interleaved positions
+             * and texture coordinates, four vertices per glyph.
+             */
+            std::vector<vm::vec2f> vertices;
+            /**
+             * The size of the string as returned by TextureFont::measure.
+             */
+            vm::vec2f size;
+
+            /**
+             * Returns the glyph quads moved by the given offset, which is rounded to whole pixels like
+             * TextureFont::quads does.
+             */
+            std::vector<vm::vec2f> translatedVertices(const vm::vec2f& offset) const;
+        };
+
+        /**
+         * Caches glyph runs by key and evicts the least recently used run if the number of runs exceeds the capacity.
+         *
+         * Runs are handed out as shared pointers, so a run remains valid for its users if it is evicted.
+         *
+         * @tparam K the key type, must be copyable and ordered by operator<
+         */
+        template <typename K>
+        class GlyphRunCache {
+        private:
+            using Entry = std::pair<K, std::shared_ptr<const GlyphRun>>;
+            using EntryList = std::list<Entry>;
+
+            size_t m_capacity;
+            /**
+             * The cached runs, most recently used first.
+             */
+            EntryList m_entries;
+            std::map<K, typename EntryList::iterator> m_index;
+
+            size_t m_hits;
+            size_t m_misses;
+        public:
+            static constexpr size_t DefaultCapacity = 4096u;
+
+            explicit GlyphRunCache(const size_t capacity = DefaultCapacity) :
+            m_capacity(capacity),
+            m_hits(0u),
+            m_misses(0u) {
+                assert(m_capacity > 0u);
+            }
+
+            /**
+             * Returns the run for the given key. If the run is not cached, it is created by calling the given function
+             * and added to the cache.
+             *
+             * @tparam L the type of the function, must return a GlyphRun
+             * @param key the key
+             * @param layout the function which lays out the run
+             * @return the run
+             */
+            template <typename L>
+            std::shared_ptr<const GlyphRun> getOrCreate(const K& key, const L& layout) {
+                auto it = m_index.find(key);
+                if (it != std::end(m_index)) {
+                    ++m_hits;
+                    m_entries.splice(std::begin(m_entries), m_entries, it->second);
+                    return it->second->second;
+                }
+
+                ++m_misses;
+                auto run = std::make_shared<const GlyphRun>(layout());
+                m_entries.emplace_front(key, run);
+                m_index.emplace(key, std::begin(m_entries));
+
+                if (m_entries.size() > m_capacity) {
+                    m_index.erase(m_entries.back().first);
+                    m_entries.pop_back();
+                }
+
+                return run;
+            }
+
+            size_t size() const {
+                return m_entries.size();
+            }
+
+            size_t capacity() const {
+                return m_capacity;
+            }
+
+            size_t hits() const {
+                return m_hits;
+            }
+
+            size_t misses() const {
+                return m_misses;
+            }
+
+            void clear() {
+                m_entries.clear();
+                m_index.clear();
+            }
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_GlyphRunCache) */
@@ -32,8 +32,6 @@
 
 #include <vector>
 
-#include <vector>
-
 namespace TrenchBroom {
     namespace Renderer {
         class GroupRenderer::GroupNameAnchor : public TextAnchor3D {
@@ -65,15 +63,54 @@ namespace TrenchBroom {
 
         void GroupRenderer::setGroups(const std::vector<Model::GroupNode*>& groups) {
             m_groups = groups;
+            m_groupIndices.clear();
+            for (size_t i = 0u; i < m_groups.size(); ++i) {
+                m_groupIndices.emplace(m_groups[i], i);
+            }
             invalidate();
         }
 
+        void GroupRenderer::addGroups(const std::vector<Model::GroupNode*>& groups) {
+            bool changed = false;
+            for (auto* group : groups) {
+                if (m_groupIndices.emplace(group, m_groups.size()).second) {
+                    m_groups.push_back(group);
+                    changed = true;
+                }
+            }
+            if (changed) {
+                invalidate();
+            }
+        }
+
+        void GroupRenderer::removeGroups(const std::vector<Model::GroupNode*>& groups) {
+            bool changed = false;
+            for (auto* group : groups) {
+                const auto it = m_groupIndices.find(group);
+                if (it != std::end(m_groupIndices)) {
+                    // the order of the groups doesn't matter, so we move the last group into the gap
+                    const auto index = it->second;
+                    m_groupIndices.erase(it);
+                    if (index != m_groups.size() - 1u) {
+                        m_groups[index] = m_groups.back();
+                        m_groupIndices[m_groups[index]] = index;
+                    }
+                    m_groups.pop_back();
+                    changed = true;
+                }
+            }
+            if (changed) {
+                invalidate();
+            }
+        }
+
         void GroupRenderer::invalidate() {
             invalidateBounds();
         }
 
         void GroupRenderer::clear() {
             m_groups.clear();
+            m_groupIndices.clear();
             m_boundsRenderer = DirectEdgeRenderer();
         }
 
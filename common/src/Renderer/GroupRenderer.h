@@ -24,6 +24,7 @@
 #include "Color.h"
 #include "Renderer/EdgeRenderer.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -42,6 +43,7 @@ namespace TrenchBroom {
 
             const Model::EditorContext& m_editorContext;
             std::vector<Model::GroupNode*> m_groups;
+            std::unordered_map<Model::GroupNode*, size_t> m_groupIndices;
 
             DirectEdgeRenderer m_boundsRenderer;
             bool m_boundsValid;
@@ -61,28 +63,15 @@ namespace TrenchBroom {
             void invalidate();
             void clear();
 
-            template <typename Iter>
-            void addGroups(Iter cur, const Iter end) {
-                while (cur != end) {
-                    addGroup(*cur);
-                    ++cur;
-                }
-            }
-            template <typename Iter>
-            void updateGroups(Iter cur, const Iter end) {
-                while (cur != end) {
-                    updateGroup(*cur);
-                    ++cur;
-                }
-            }
-
-            template <typename Iter>
-            void removeGroups(Iter cur, const Iter end) {
-                while (cur != end) {
-                    removeGroup(*cur);
-                    ++cur;
-                }
-            }
+            /**
+             * Adds the given groups to this renderer. Groups which are already in this renderer are ignored.
+             */
+            void addGroups(const std::vector<Model::GroupNode*>& groups);
+
+            /**
+             * Removes the given groups from this renderer. Groups which are not in this renderer are ignored.
+             */
+            void removeGroups(const std::vector<Model::GroupNode*>& groups);
 
             void setShowOverlays(bool showOverlays);
             void setOverlayTextColor(const Color& overlayTextColor);
@@ -22,19 +22,24 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Assets/EntityDefinitionManager.h"
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
+#include "Model/CollectNodesVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/Node.h"
+#include "Model/NodeCollection.h"
 #include "Model/NodeVisitor.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/Camera.h"
 #include "Renderer/EntityLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
@@ -43,8 +48,13 @@
 
 #include <kdl/memory_utils.h>
 #include <kdl/vector_set.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
 
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -130,7 +140,8 @@ namespace TrenchBroom {
         m_defaultRenderer(createDefaultRenderer(m_document)),
         m_selectionRenderer(createSelectionRenderer(m_document)),
         m_lockedRenderer(createLockRenderer(m_document)),
-        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)) {
+        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)),
+        m_occlusionCuller(std::make_unique<OcclusionCuller>()) {
             bindObservers();
             setupRenderers();
         }
@@ -188,6 +199,7 @@ namespace TrenchBroom {
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
+            cullOccludedBrushes(renderContext);
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
             renderLockedOpaque(renderContext, renderBatch);
@@ -205,6 +217,48 @@ namespace TrenchBroom {
             document->commitPendingAssets();
         }
 
+        /**
+         * Only brushes within this distance from the camera are considered as occluders. The culler only rasterizes the
+         * faces that are largest relative to their distance anyway, so there is no need to look at the entire map.
+         */
+        static constexpr FloatType OccluderSearchRadius = 4096.0;
+
+        void MapRenderer::cullOccludedBrushes(RenderContext& renderContext) {
+            // the 2D views share this renderer, so the restriction must be lifted for them
+            if (!renderContext.render3D() || !pref(Preferences::OcclusionCulling)) {
+                m_defaultRenderer->clearVisibleBrushes();
+                return;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            auto* world = document->world();
+            if (world == nullptr) {
+                m_defaultRenderer->clearVisibleBrushes();
+                return;
+            }
+
+            const auto& camera = renderContext.camera();
+            const auto& editorContext = document->editorContext();
+            const auto cameraPosition = vm::vec3(camera.position());
+
+            Model::CollectBrushesVisitor collectOccluders;
+            const auto nearbyNodes = world->findIntersecting(vm::bbox3(cameraPosition - vm::vec3::fill(OccluderSearchRadius), cameraPosition + vm::vec3::fill(OccluderSearchRadius)));
+            Model::Node::accept(std::begin(nearbyNodes), std::end(nearbyNodes), collectOccluders);
+
+            // hidden brushes must not hide anything, and selected brushes are not drawn when the selection is hidden
+            const auto occluders = kdl::vec_filter(collectOccluders.brushes(), [&](const Model::BrushNode* brushNode) {
+                return editorContext.visible(brushNode) && !brushNode->selected();
+            });
+
+            m_occlusionCuller->reset(camera);
+            m_occlusionCuller->addOccluders(occluders);
+
+            Model::CollectBrushesVisitor collectVisible;
+            const auto visibleNodes = m_occlusionCuller->findVisibleNodes(*world);
+            Model::Node::accept(std::begin(visibleNodes), std::end(visibleNodes), collectVisible);
+            m_defaultRenderer->setVisibleBrushes(collectVisible.brushes());
+        }
+
         class SetupGL : public Renderable {
         private:
             void doRender(RenderContext&) override {
@@ -400,7 +454,37 @@ namespace TrenchBroom {
                                              collect.lockedNodes().entities(),
                                              collect.lockedNodes().brushes());
             }
-            invalidateEntityLinkRenderer();
+        }
+
+        /**
+         * Removes the given nodes from the given renderer unless they are among the nodes to render, and adds the nodes
+         * to render. Nodes which are already in the renderer are left untouched.
+         */
+        static void updateRenderer(ObjectRenderer& renderer, const std::vector<Model::Node*>& nodes, const Model::NodeCollection& nodesToRender) {
+            const auto nodesToKeep = std::unordered_set<Model::Node*>(std::begin(nodesToRender), std::end(nodesToRender));
+
+            Model::NodeCollection nodesToRemove;
+            for (auto* node : nodes) {
+                if (nodesToKeep.count(node) == 0u) {
+                    nodesToRemove.addNode(node);
+                }
+            }
+
+            renderer.removeObjects(nodesToRemove.groups(),
+                                   nodesToRemove.entities(),
+                                   nodesToRemove.brushes());
+            renderer.addObjects(nodesToRender.groups(),
+                                nodesToRender.entities(),
+                                nodesToRender.brushes());
+        }
+
+        void MapRenderer::updateRenderers(const std::vector<Model::Node*>& nodes) {
+            CollectRenderableNodes collect(Renderer_All);
+            Model::Node::accept(std::begin(nodes), std::end(nodes), collect);
+
+            updateRenderer(*m_defaultRenderer, nodes, collect.defaultNodes());
+            updateRenderer(*m_selectionRenderer, nodes, collect.selectedNodes());
+            updateRenderer(*m_lockedRenderer, nodes, collect.lockedNodes());
         }
 
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -412,6 +496,18 @@ namespace TrenchBroom {
                 m_lockedRenderer->invalidate();
         }
 
+        void MapRenderer::invalidateObjectsInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes) {
+            if ((renderers & Renderer_Default) != 0) {
+                m_defaultRenderer->invalidateObjects(brushes);
+            }
+            if ((renderers & Renderer_Selection) != 0) {
+                m_selectionRenderer->invalidateObjects(brushes);
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                m_lockedRenderer->invalidateObjects(brushes);
+            }
+        }
+
         void MapRenderer::invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes) {
             if ((renderers & Renderer_Default) != 0) {
                 m_defaultRenderer->invalidateBrushes(brushes);
@@ -424,10 +520,26 @@ namespace TrenchBroom {
             }
         }
 
+        void MapRenderer::invalidateBrushIndicesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes) {
+            if ((renderers & Renderer_Default) != 0) {
+                m_defaultRenderer->invalidateBrushIndices(brushes);
+            }
+            if ((renderers & Renderer_Selection) != 0) {
+                m_selectionRenderer->invalidateBrushIndices(brushes);
+            }
+            if ((renderers& Renderer_Locked) != 0) {
+                m_lockedRenderer->invalidateBrushIndices(brushes);
+            }
+        }
+
         void MapRenderer::invalidateEntityLinkRenderer() {
             m_entityLinkRenderer->invalidate();
         }
 
+        void MapRenderer::invalidateEntityLinksForNodes(const std::vector<Model::Node*>& nodes) {
+            m_entityLinkRenderer->invalidateNodes(nodes);
+        }
+
         void MapRenderer::reloadEntityModels() {
             m_defaultRenderer->reloadModels();
             m_selectionRenderer->reloadModels();
@@ -492,54 +604,98 @@ namespace TrenchBroom {
         void MapRenderer::documentWasNewedOrLoaded(View::MapDocument*) {
             clear();
             updateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>&) {
             updateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>&) {
             updateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
 
-        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>&) {
-            invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+        /**
+         * Returns the given nodes and their descendants, and optionally their ancestors, without duplicates.
+         */
+        static std::vector<Model::Node*> collectRelatedNodes(const std::vector<Model::Node*>& nodes, const bool includeAncestors) {
+            Model::CollectNodesVisitor visitor;
+            Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), visitor);
+            if (includeAncestors) {
+                Model::Node::escalate(std::begin(nodes), std::end(nodes), visitor);
+            }
+
+            auto result = visitor.nodes();
+            kdl::vec_sort_and_remove_duplicates(result);
+            return result;
         }
 
-        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>&) {
-            invalidateRenderers(Renderer_All);
+        static std::vector<Model::BrushNode*> collectBrushes(const std::vector<Model::Node*>& nodes) {
+            Model::NodeCollection collection;
+            collection.addNodes(nodes);
+            return collection.brushes();
+        }
+
+        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            // the changed brushes may also be rendered by the other renderers, e.g. if some of their faces are selected
+            const auto brushes = collectBrushes(collectRelatedNodes(nodes, false));
+            invalidateObjectsInRenderers(Renderer_Selection, brushes);
+            invalidateBrushesInRenderers(Renderer_Default_Locked, brushes);
+            invalidateEntityLinksForNodes(nodes);
         }
 
-        void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>&) {
-            updateRenderers(Renderer_Default_Locked);
+        void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>& nodes) {
+            // hidden brushes are not kept in the renderers, so there is nothing to gain from only invalidating their indices
+            invalidateObjectsInRenderers(Renderer_All, collectBrushes(collectRelatedNodes(nodes, false)));
+            invalidateEntityLinkRenderer();
+        }
+
+        void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>& nodes) {
+            const auto relatedNodes = collectRelatedNodes(nodes, false);
+            updateRenderers(relatedNodes);
+            invalidateBrushIndicesInRenderers(Renderer_All, collectBrushes(relatedNodes));
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasOpened(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasClosed(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
-        void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
-            invalidateRenderers(Renderer_Selection);
+        void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>& faces) {
+            // the brushes may also be rendered by the default renderer if only some of their faces are selected
+            auto brushes = kdl::vec_transform(faces, [](const auto& handle) { return handle.node(); });
+            kdl::vec_sort_and_remove_duplicates(brushes);
+            invalidateBrushesInRenderers(Renderer_All, brushes);
         }
 
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
-            updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
+            const auto changedNodes = kdl::vec_concat(selection.selectedNodes(), selection.deselectedNodes());
 
-            // selecting faces needs to invalidate the brushes
-            if (!selection.selectedBrushFaces().empty()
-                || !selection.deselectedBrushFaces().empty()) {
+            // selecting a node changes how its ancestors and descendants are rendered, too
+            auto nodes = collectRelatedNodes(changedNodes, true);
 
-                
-                const auto toBrush = [](const auto& handle) { return handle.node(); };
-                auto brushes = kdl::vec_concat(kdl::vec_transform(selection.selectedBrushFaces(), toBrush), kdl::vec_transform(selection.deselectedBrushFaces(), toBrush));
-                kdl::vec_sort_and_remove_duplicates(brushes);
-                invalidateBrushesInRenderers(Renderer_All, brushes);
-            }
+            // selecting faces changes how their brushes are rendered
+            const auto toBrush = [](const auto& handle) -> Model::Node* { return handle.node(); };
+            kdl::vec_append(nodes, kdl::vec_transform(selection.selectedBrushFaces(), toBrush), kdl::vec_transform(selection.deselectedBrushFaces(), toBrush));
+            kdl::vec_sort_and_remove_duplicates(nodes);
+
+            // only move the affected nodes between the renderers; this includes moving deselected nodes to the locked
+            // renderer if they were reparented into a locked layer before deselection
+            updateRenderers(nodes);
+
+            // the brushes that stay in a renderer keep their vertices, only their face marks need to be re-evaluated
+            invalidateBrushIndicesInRenderers(Renderer_All, collectBrushes(nodes));
+
+            // only the links of the entities whose selection state changed change their colors
+            invalidateEntityLinksForNodes(changedNodes);
         }
 
         void MapRenderer::textureCollectionsWillChange() {
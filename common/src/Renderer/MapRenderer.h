@@ -50,6 +50,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class EntityLinkRenderer;
         class ObjectRenderer;
+        class OcclusionCuller;
         class RenderBatch;
         class RenderContext;
 
@@ -67,6 +68,7 @@ namespace TrenchBroom {
             std::unique_ptr<ObjectRenderer> m_selectionRenderer;
             std::unique_ptr<ObjectRenderer> m_lockedRenderer;
             std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
+            std::unique_ptr<OcclusionCuller> m_occlusionCuller;
         public:
             explicit MapRenderer(std::weak_ptr<View::MapDocument> document);
             ~MapRenderer();
@@ -84,6 +86,12 @@ namespace TrenchBroom {
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
             void commitPendingChanges();
+
+            /**
+             * Restricts the default renderer to the brushes that are not hidden behind large brushes close to the
+             * camera. Only done in the 3D view and only if occlusion culling is enabled in the preferences.
+             */
+            void cullOccludedBrushes(RenderContext& renderContext);
             void setupGL(RenderBatch& renderBatch);
             void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -117,9 +125,27 @@ namespace TrenchBroom {
              * If brushes are modified, you need to call invalidateRenderers() or invalidateObjectsInRenderers()
              */
             void updateRenderers(Renderer renderers);
+
+            /**
+             * Like updateRenderers(Renderer), but only considers the given nodes instead of the entire map. A node is
+             * only added to or removed from a renderer if it moves between renderers, the other nodes are not touched.
+             */
+            void updateRenderers(const std::vector<Model::Node*>& nodes);
             void invalidateRenderers(Renderer renderers);
+
+            /**
+             * Invalidates all groups and entities in the given renderers, but only the given brushes.
+             */
+            void invalidateObjectsInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes);
             void invalidateBrushesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Only rewrites the edge and face indices of the given brushes, but keeps their vertices. Use this if only
+             * the selection or visibility of the brushes or their faces has changed.
+             */
+            void invalidateBrushIndicesInRenderers(Renderer renderers, const std::vector<Model::BrushNode*>& brushes);
             void invalidateEntityLinkRenderer();
+            void invalidateEntityLinksForNodes(const std::vector<Model::Node*>& nodes);
             void reloadEntityModels();
         private: // notification
             void bindObservers();
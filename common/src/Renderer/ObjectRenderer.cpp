@@ -29,16 +29,38 @@ namespace TrenchBroom {
             m_brushRenderer.setBrushes(brushes);
         }
 
+        void ObjectRenderer::addObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes) {
+            m_groupRenderer.addGroups(groups);
+            m_entityRenderer.addEntities(entities);
+            m_brushRenderer.addBrushes(brushes);
+        }
+
+        void ObjectRenderer::removeObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes) {
+            m_groupRenderer.removeGroups(groups);
+            m_entityRenderer.removeEntities(entities);
+            m_brushRenderer.removeBrushes(brushes);
+        }
+
         void ObjectRenderer::invalidate() {
             m_groupRenderer.invalidate();
             m_entityRenderer.invalidate();
             m_brushRenderer.invalidate();
         }
 
+        void ObjectRenderer::invalidateObjects(const std::vector<Model::BrushNode*>& brushes) {
+            m_groupRenderer.invalidate();
+            m_entityRenderer.invalidate();
+            m_brushRenderer.invalidateBrushes(brushes);
+        }
+
         void ObjectRenderer::invalidateBrushes(const std::vector<Model::BrushNode*>& brushes) {
             m_brushRenderer.invalidateBrushes(brushes);
         }
 
+        void ObjectRenderer::invalidateBrushIndices(const std::vector<Model::BrushNode*>& brushes) {
+            m_brushRenderer.invalidateBrushIndices(brushes);
+        }
+
         void ObjectRenderer::clear() {
             m_groupRenderer.clear();
             m_entityRenderer.clear();
@@ -136,6 +158,14 @@ namespace TrenchBroom {
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
         }
 
+        void ObjectRenderer::setVisibleBrushes(const std::vector<Model::BrushNode*>& brushes) {
+            m_brushRenderer.setVisibleBrushes(brushes);
+        }
+
+        void ObjectRenderer::clearVisibleBrushes() {
+            m_brushRenderer.clearVisibleBrushes();
+        }
+
         void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_brushRenderer.renderOpaque(renderContext, renderBatch);
             m_entityRenderer.render(renderContext, renderBatch);
@@ -58,8 +58,31 @@ namespace TrenchBroom {
             m_brushRenderer(brushFilter) {}
         public: // object management
             void setObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Adds the given objects to this renderer. Objects which are already in this renderer are left untouched.
+             */
+            void addObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Removes the given objects from this renderer. Objects which are not in this renderer are ignored.
+             */
+            void removeObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes);
+
             void invalidate();
+
+            /**
+             * Invalidates all groups and entities, but only the given brushes.
+             */
+            void invalidateObjects(const std::vector<Model::BrushNode*>& brushes);
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Invalidates the edge and face indices of the given brushes, but keeps their vertices.
+             *
+             * @see BrushRenderer::invalidateBrushIndices
+             */
+            void invalidateBrushIndices(const std::vector<Model::BrushNode*>& brushes);
             void clear();
             void reloadModels();
         public: // configuration
@@ -90,6 +113,14 @@ namespace TrenchBroom {
             void setBrushEdgeColor(const Color& brushEdgeColor);
 
             void setShowHiddenObjects(bool showHiddenObjects);
+
+            /**
+             * Restricts rendering to the given brushes. Groups and entities are not affected.
+             *
+             * @see BrushRenderer::setVisibleBrushes
+             */
+            void setVisibleBrushes(const std::vector<Model::BrushNode*>& brushes);
+            void clearVisibleBrushes();
         public: // rendering
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
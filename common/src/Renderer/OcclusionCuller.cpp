@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OcclusionCuller.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/TagAttribute.h"
+#include "Model/WorldNode.h"
+#include "Renderer/Camera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        OcclusionCuller::OcclusionCuller(const size_t width, const size_t height, const FloatType minOccluderArea, const size_t maxOccluders) :
+        m_buffer(width, height),
+        m_minOccluderArea(minOccluderArea),
+        m_maxOccluders(maxOccluders) {}
+
+        void OcclusionCuller::reset(const Camera& camera) {
+            m_buffer.reset(camera.projectionMatrix() * camera.viewMatrix());
+            m_cameraPosition = vm::vec3(camera.position());
+        }
+
+        static FloatType polygonArea(const std::vector<vm::vec3>& vertices) {
+            auto cross = vm::vec3::zero();
+            for (size_t i = 1u; i + 1u < vertices.size(); ++i) {
+                cross = cross + vm::cross(vertices[i] - vertices[0], vertices[i + 1u] - vertices[0]);
+            }
+            return vm::length(cross) / 2.0;
+        }
+
+        size_t OcclusionCuller::addOccluders(const std::vector<Model::BrushNode*>& brushes) {
+            struct Candidate {
+                const Model::BrushFace* face;
+                FloatType score;
+            };
+
+            std::vector<Candidate> candidates;
+            for (const auto* brushNode : brushes) {
+                if (brushNode->hasAttribute(Model::TagAttributes::Transparency)) {
+                    continue;
+                }
+
+                const auto& brush = brushNode->brush();
+                const auto size = brush.bounds().size();
+                // a brush whose two largest dimensions are too small cannot have a face that is large enough
+                if (size.x() * size.y() < m_minOccluderArea && size.x() * size.z() < m_minOccluderArea && size.y() * size.z() < m_minOccluderArea) {
+                    continue;
+                }
+
+                for (const auto& face : brush.faces()) {
+                    if (face.hasAttribute(Model::TagAttributes::Transparency)) {
+                        continue;
+                    }
+
+                    const auto& boundary = face.boundary();
+                    const auto distance = boundary.point_distance(m_cameraPosition);
+                    if (distance <= 0.0) {
+                        // back facing
+                        continue;
+                    }
+
+                    const auto area = polygonArea(face.vertexPositions());
+                    if (area < m_minOccluderArea) {
+                        continue;
+                    }
+
+                    candidates.push_back({ &face, area / (distance * distance) });
+                }
+            }
+
+            if (candidates.size() > m_maxOccluders) {
+                const auto mid = std::next(std::begin(candidates), static_cast<std::ptrdiff_t>(m_maxOccluders));
+                std::nth_element(std::begin(candidates), mid, std::end(candidates), [](const Candidate& lhs, const Candidate& rhs) {
+                    return lhs.score > rhs.score;
+                });
+                candidates.erase(mid, std::end(candidates));
+            }
+
+            std::vector<vm::vec3f> vertices;
+            for (const auto& candidate : candidates) {
+                vertices.clear();
+                for (const auto& position : candidate.face->vertexPositions()) {
+                    vertices.push_back(vm::vec3f(position));
+                }
+                m_buffer.addOccluder(vertices);
+            }
+
+            return candidates.size();
+        }
+
+        bool OcclusionCuller::visible(const vm::bbox3& bounds) const {
+            return !m_buffer.occluded(vm::bbox3f(bounds));
+        }
+
+        std::vector<Model::Node*> OcclusionCuller::findVisibleNodes(Model::WorldNode& world) const {
+            // if a box is hidden, then so is every box it contains, so we can skip hidden subtrees
+            return world.findNodes([&](const vm::bbox3& bounds) { return visible(bounds); });
+        }
+
+        const SoftwareOcclusionBuffer& OcclusionCuller::buffer() const {
+            return m_buffer;
+        }
+    }
+}
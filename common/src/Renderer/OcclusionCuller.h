@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_OcclusionCuller
+#define TrenchBroom_OcclusionCuller
+
+#include "FloatType.h"
+#include "Renderer/SoftwareOcclusionBuffer.h"
+
+#include <vecmath/forward.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushNode;
+        class Node;
+        class WorldNode;
+    }
+
+    namespace Renderer {
+        class Camera;
+
+        /**
+         * Determines which nodes are hidden behind large brushes from the point of view of a camera.
+         *
+         * The culler is used in three steps: First, it is reset to the current camera. Then, the brushes which might
+         * hide other nodes are added as occluders. Of these, only the faces that are large and close to the camera are
+         * rasterized into a software occlusion buffer. Finally, the nodes of the world's node tree are tested against
+         * the buffer, skipping entire subtrees whose bounds are hidden.
+         */
+        class OcclusionCuller {
+        private:
+            SoftwareOcclusionBuffer m_buffer;
+            FloatType m_minOccluderArea;
+            size_t m_maxOccluders;
+            vm::vec3 m_cameraPosition;
+        public:
+            /**
+             * Creates a new culler.
+             *
+             * @param width the width of the occlusion buffer in pixels
+             * @param height the height of the occlusion buffer in pixels
+             * @param minOccluderArea the minimal area of a brush face to be considered as an occluder
+             * @param maxOccluders the maximum number of faces to rasterize per frame
+             */
+            OcclusionCuller(size_t width = 256u, size_t height = 128u, FloatType minOccluderArea = 64.0 * 64.0, size_t maxOccluders = 512u);
+
+            /**
+             * Clears the occlusion buffer and sets it up for the given camera.
+             */
+            void reset(const Camera& camera);
+
+            /**
+             * Rasterizes the faces of the given brushes which are suitable as occluders. A face is suitable if it is
+             * opaque, faces the camera, and is sufficiently large. If there are more suitable faces than allowed, the
+             * faces with the largest area relative to their squared distance from the camera are chosen.
+             *
+             * @param brushes the brushes to consider
+             * @return the number of faces that were rasterized
+             */
+            size_t addOccluders(const std::vector<Model::BrushNode*>& brushes);
+
+            /**
+             * Indicates whether the given bounds might be visible.
+             */
+            bool visible(const vm::bbox3& bounds) const;
+
+            /**
+             * Returns the nodes in the given world's node tree which might be visible. Subtrees of the node tree that
+             * are hidden are skipped entirely.
+             */
+            std::vector<Model::Node*> findVisibleNodes(Model::WorldNode& world) const;
+
+            const SoftwareOcclusionBuffer& buffer() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_OcclusionCuller) */
@@ -75,6 +75,10 @@ namespace TrenchBroom {
             }
         }
 
+        InstanceRenderFunc::~InstanceRenderFunc() {}
+        void InstanceRenderFunc::before(const size_t /* index */) {}
+        void InstanceRenderFunc::after(const size_t /* index */) {}
+
         std::vector<vm::vec2f> circle2D(const float radius, const size_t segments) {
             std::vector<vm::vec2f> vertices = circle2D(radius, 0.0f, vm::Cf::two_pi(), segments);
             vertices.push_back(vm::vec2f::zero());
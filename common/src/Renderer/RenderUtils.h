@@ -52,6 +52,16 @@ namespace TrenchBroom {
             void after(const Assets::Texture* texture) override;
         };
 
+        /**
+         * Callbacks for rendering several instances of the same primitives, e.g. to set up per instance transformations.
+         */
+        class InstanceRenderFunc {
+        public:
+            virtual ~InstanceRenderFunc();
+            virtual void before(size_t index);
+            virtual void after(size_t index);
+        };
+
         std::vector<vm::vec2f> circle2D(float radius, size_t segments);
         std::vector<vm::vec2f> circle2D(float radius, float startAngle, float angleLength, size_t segments);
         std::vector<vm::vec3f> circle2D(float radius, vm::axis::type axis, float startAngle, float angleLength, size_t segments);
@@ -0,0 +1,353 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoftwareOcclusionBuffer.h"
+
+#include "Ensure.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_OCCLUSION_BUFFER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace TrenchBroom {
+    namespace Renderer {
+        struct ClipVertex {
+            float x, y, z, w;
+        };
+
+        static ClipVertex toClipSpace(const vm::mat4x4f& m, const vm::vec3f& p) {
+            return ClipVertex {
+                m[0][0] * p.x() + m[1][0] * p.y() + m[2][0] * p.z() + m[3][0],
+                m[0][1] * p.x() + m[1][1] * p.y() + m[2][1] * p.z() + m[3][1],
+                m[0][2] * p.x() + m[1][2] * p.y() + m[2][2] * p.z() + m[3][2],
+                m[0][3] * p.x() + m[1][3] * p.y() + m[2][3] * p.z() + m[3][3]
+            };
+        }
+
+        // the signed distance to the near plane in clip space, positive values are in front of the near plane
+        static float nearDistance(const ClipVertex& v) {
+            return v.z + v.w;
+        }
+
+        static constexpr float MinW = 1.0e-6f;
+
+        SoftwareOcclusionBuffer::SoftwareOcclusionBuffer(const size_t width, const size_t height) :
+        m_width(width),
+        m_height(height),
+        m_stride((width + 3u) & ~size_t(3u)),
+        m_depth(m_stride * height, 1.0f),
+        m_transformation(vm::mat4x4f::identity()) {
+            ensure(m_width > 0u && m_height > 0u, "occlusion buffer must not be empty");
+        }
+
+        size_t SoftwareOcclusionBuffer::width() const {
+            return m_width;
+        }
+
+        size_t SoftwareOcclusionBuffer::height() const {
+            return m_height;
+        }
+
+        void SoftwareOcclusionBuffer::reset(const vm::mat4x4f& transformation) {
+            m_transformation = transformation;
+            std::fill(std::begin(m_depth), std::end(m_depth), 1.0f);
+        }
+
+        void SoftwareOcclusionBuffer::addOccluder(const std::vector<vm::vec3f>& vertices) {
+            if (vertices.size() < 3u) {
+                return;
+            }
+
+            std::vector<ClipVertex> clipVertices;
+            clipVertices.reserve(vertices.size());
+            for (const auto& vertex : vertices) {
+                clipVertices.push_back(toClipSpace(m_transformation, vertex));
+            }
+
+            // clip against the near plane
+            std::vector<ClipVertex> clipped;
+            clipped.reserve(clipVertices.size() + 1u);
+            for (size_t i = 0u; i < clipVertices.size(); ++i) {
+                const auto& cur = clipVertices[i];
+                const auto& next = clipVertices[(i + 1u) % clipVertices.size()];
+                const auto curDist = nearDistance(cur);
+                const auto nextDist = nearDistance(next);
+
+                if (curDist >= 0.0f) {
+                    clipped.push_back(cur);
+                }
+                if ((curDist >= 0.0f) != (nextDist >= 0.0f)) {
+                    const auto t = curDist / (curDist - nextDist);
+                    clipped.push_back(ClipVertex {
+                        cur.x + t * (next.x - cur.x),
+                        cur.y + t * (next.y - cur.y),
+                        cur.z + t * (next.z - cur.z),
+                        cur.w + t * (next.w - cur.w)
+                    });
+                }
+            }
+
+            if (clipped.size() < 3u) {
+                return;
+            }
+
+            const auto width = static_cast<float>(m_width);
+            const auto height = static_cast<float>(m_height);
+
+            std::vector<ScreenVertex> screenVertices;
+            screenVertices.reserve(clipped.size());
+            for (const auto& v : clipped) {
+                if (v.w < MinW) {
+                    return;
+                }
+                screenVertices.push_back(ScreenVertex {
+                    (v.x / v.w + 1.0f) * 0.5f * width,
+                    (v.y / v.w + 1.0f) * 0.5f * height,
+                    (v.z / v.w + 1.0f) * 0.5f
+                });
+            }
+
+            rasterize(screenVertices);
+        }
+
+        bool SoftwareOcclusionBuffer::occluded(const vm::bbox3f& bounds) const {
+            auto minX = std::numeric_limits<float>::max();
+            auto minY = std::numeric_limits<float>::max();
+            auto maxX = std::numeric_limits<float>::lowest();
+            auto maxY = std::numeric_limits<float>::lowest();
+            auto minDepth = std::numeric_limits<float>::max();
+
+            for (size_t i = 0u; i < 8u; ++i) {
+                const auto corner = vm::vec3f(
+                    (i & 1u) ? bounds.max.x() : bounds.min.x(),
+                    (i & 2u) ? bounds.max.y() : bounds.min.y(),
+                    (i & 4u) ? bounds.max.z() : bounds.min.z());
+                const auto v = toClipSpace(m_transformation, corner);
+                if (nearDistance(v) < 0.0f || v.w < MinW) {
+                    // the box intersects the near plane or lies behind it, so we treat it as visible
+                    return false;
+                }
+
+                const auto x = (v.x / v.w + 1.0f) * 0.5f * static_cast<float>(m_width);
+                const auto y = (v.y / v.w + 1.0f) * 0.5f * static_cast<float>(m_height);
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+                minDepth = std::min(minDepth, (v.z / v.w + 1.0f) * 0.5f);
+            }
+
+            if (maxX <= 0.0f || maxY <= 0.0f || minX >= static_cast<float>(m_width) || minY >= static_cast<float>(m_height) || minDepth > 1.0f) {
+                // outside of the view
+                return true;
+            }
+
+            const auto firstX = static_cast<size_t>(std::max(0.0f, std::floor(minX)));
+            const auto firstY = static_cast<size_t>(std::max(0.0f, std::floor(minY)));
+            const auto lastX = std::max(firstX, std::min(m_width - 1u, static_cast<size_t>(std::max(0.0f, std::ceil(maxX) - 1.0f))));
+            const auto lastY = std::max(firstY, std::min(m_height - 1u, static_cast<size_t>(std::max(0.0f, std::ceil(maxY) - 1.0f))));
+
+            return !visible(firstX, lastX, firstY, lastY, minDepth);
+        }
+
+        float SoftwareOcclusionBuffer::depth(const size_t x, const size_t y) const {
+            assert(x < m_width && y < m_height);
+            return m_depth[y * m_stride + x];
+        }
+
+        void SoftwareOcclusionBuffer::rasterize(const std::vector<ScreenVertex>& vertices) {
+            const auto count = vertices.size();
+
+            // determine the winding order using the signed area
+            auto area = 0.0f;
+            for (size_t i = 0u; i < count; ++i) {
+                const auto& cur = vertices[i];
+                const auto& next = vertices[(i + 1u) % count];
+                area += cur.x * next.y - next.x * cur.y;
+            }
+            if (std::abs(area) < 1.0e-6f) {
+                return;
+            }
+            const auto sign = area > 0.0f ? 1.0f : -1.0f;
+
+            // Compute the edge functions E(x, y) = a * x + b * y + c, which are positive inside of the polygon. A pixel is
+            // only covered if its center is further inside than half of its extents, which guarantees that the polygon
+            // covers the entire pixel. The threshold is subtracted from c.
+            std::vector<float> edges;
+            edges.reserve(3u * count);
+            for (size_t i = 0u; i < count; ++i) {
+                const auto& cur = vertices[i];
+                const auto& next = vertices[(i + 1u) % count];
+                const auto a = -sign * (next.y - cur.y);
+                const auto b = sign * (next.x - cur.x);
+                const auto c = -(a * cur.x + b * cur.y);
+                const auto threshold = 0.5f * (std::abs(a) + std::abs(b));
+
+                // skip degenerate edges
+                if (a != 0.0f || b != 0.0f) {
+                    edges.push_back(a);
+                    edges.push_back(b);
+                    edges.push_back(c - threshold);
+                }
+            }
+            const auto edgeCount = edges.size() / 3u;
+
+            // Compute the depth plane using the vertex triangle with the largest area to minimize numerical errors.
+            auto bestDet = 0.0f;
+            size_t best = 0u;
+            const auto& v0 = vertices[0];
+            for (size_t i = 1u; i + 1u < count; ++i) {
+                const auto& v1 = vertices[i];
+                const auto& v2 = vertices[i + 1u];
+                const auto det = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+                if (std::abs(det) > std::abs(bestDet)) {
+                    bestDet = det;
+                    best = i;
+                }
+            }
+            if (std::abs(bestDet) < 1.0e-6f) {
+                return;
+            }
+
+            const auto& v1 = vertices[best];
+            const auto& v2 = vertices[best + 1u];
+            const auto da = ((v1.depth - v0.depth) * (v2.y - v0.y) - (v2.depth - v0.depth) * (v1.y - v0.y)) / bestDet;
+            const auto db = ((v1.x - v0.x) * (v2.depth - v0.depth) - (v2.x - v0.x) * (v1.depth - v0.depth)) / bestDet;
+            // the depth is evaluated at the pixel center, add the maximum difference to any point in the pixel
+            const auto dc = v0.depth - da * v0.x - db * v0.y + 0.5f * (std::abs(da) + std::abs(db));
+            const float depthPlane[] = { da, db, dc };
+
+            // compute the bounds of the polygon in pixels
+            auto minX = vertices[0].x, maxX = vertices[0].x;
+            auto minY = vertices[0].y, maxY = vertices[0].y;
+            for (const auto& v : vertices) {
+                minX = std::min(minX, v.x);
+                maxX = std::max(maxX, v.x);
+                minY = std::min(minY, v.y);
+                maxY = std::max(maxY, v.y);
+            }
+
+            if (maxX <= 0.0f || maxY <= 0.0f || minX >= static_cast<float>(m_width) || minY >= static_cast<float>(m_height)) {
+                return;
+            }
+
+            const auto firstX = static_cast<size_t>(std::max(0.0f, std::floor(minX)));
+            const auto firstY = static_cast<size_t>(std::max(0.0f, std::floor(minY)));
+            const auto lastX = std::min(m_width - 1u, static_cast<size_t>(std::max(0.0f, std::ceil(maxX) - 1.0f)));
+            const auto lastY = std::min(m_height - 1u, static_cast<size_t>(std::max(0.0f, std::ceil(maxY) - 1.0f)));
+
+            for (size_t y = firstY; y <= lastY; ++y) {
+                rasterizeRow(y, firstX, lastX, edges, edgeCount, depthPlane);
+            }
+        }
+
+#ifdef TB_OCCLUSION_BUFFER_SSE2
+        void SoftwareOcclusionBuffer::rasterizeRow(const size_t y, const size_t minX, const size_t maxX, const std::vector<float>& edges, const size_t edgeCount, const float* depthPlane) {
+            const auto py = static_cast<float>(y) + 0.5f;
+            float* row = &m_depth[y * m_stride];
+
+            const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 depthA = _mm_set1_ps(depthPlane[0]);
+            const __m128 depthRow = _mm_set1_ps(depthPlane[1] * py + depthPlane[2]);
+            const __m128 first = _mm_set1_ps(static_cast<float>(minX));
+            const __m128 last = _mm_set1_ps(static_cast<float>(maxX) + 1.0f);
+
+            for (size_t x = minX & ~size_t(3u); x <= maxX; x += 4u) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+                // only consider the pixels in [minX, maxX]
+                __m128 mask = _mm_and_ps(_mm_cmpgt_ps(px, first), _mm_cmplt_ps(px, last));
+                for (size_t i = 0u; i < edgeCount; ++i) {
+                    const __m128 e = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[3u * i]), px), _mm_set1_ps(edges[3u * i + 1u] * py + edges[3u * i + 2u]));
+                    mask = _mm_and_ps(mask, _mm_cmpge_ps(e, zero));
+                }
+
+                if (_mm_movemask_ps(mask) != 0) {
+                    const __m128 depth = _mm_min_ps(one, _mm_max_ps(zero, _mm_add_ps(_mm_mul_ps(depthA, px), depthRow)));
+                    const __m128 current = _mm_loadu_ps(row + x);
+                    const __m128 updated = _mm_min_ps(current, depth);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, updated), _mm_andnot_ps(mask, current)));
+                }
+            }
+        }
+
+        bool SoftwareOcclusionBuffer::visible(const size_t minX, const size_t maxX, const size_t minY, const size_t maxY, const float depth) const {
+            const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            const __m128 first = _mm_set1_ps(static_cast<float>(minX));
+            const __m128 last = _mm_set1_ps(static_cast<float>(maxX) + 1.0f);
+            const __m128 boxDepth = _mm_set1_ps(depth);
+
+            for (size_t y = minY; y <= maxY; ++y) {
+                const float* row = &m_depth[y * m_stride];
+                for (size_t x = minX & ~size_t(3u); x <= maxX; x += 4u) {
+                    const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                    const __m128 mask = _mm_and_ps(_mm_cmpgt_ps(px, first), _mm_cmplt_ps(px, last));
+                    const __m128 unoccluded = _mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth);
+                    if (_mm_movemask_ps(_mm_and_ps(mask, unoccluded)) != 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+#else
+        void SoftwareOcclusionBuffer::rasterizeRow(const size_t y, const size_t minX, const size_t maxX, const std::vector<float>& edges, const size_t edgeCount, const float* depthPlane) {
+            const auto py = static_cast<float>(y) + 0.5f;
+            float* row = &m_depth[y * m_stride];
+
+            for (size_t x = minX; x <= maxX; ++x) {
+                const auto px = static_cast<float>(x) + 0.5f;
+
+                bool inside = true;
+                for (size_t i = 0u; i < edgeCount && inside; ++i) {
+                    inside = edges[3u * i] * px + edges[3u * i + 1u] * py + edges[3u * i + 2u] >= 0.0f;
+                }
+
+                if (inside) {
+                    const auto depth = std::clamp(depthPlane[0] * px + depthPlane[1] * py + depthPlane[2], 0.0f, 1.0f);
+                    row[x] = std::min(row[x], depth);
+                }
+            }
+        }
+
+        bool SoftwareOcclusionBuffer::visible(const size_t minX, const size_t maxX, const size_t minY, const size_t maxY, const float depth) const {
+            for (size_t y = minY; y <= maxY; ++y) {
+                const float* row = &m_depth[y * m_stride];
+                for (size_t x = minX; x <= maxX; ++x) {
+                    if (row[x] >= depth) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+#endif
+    }
+}
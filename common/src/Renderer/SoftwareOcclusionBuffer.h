@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_SoftwareOcclusionBuffer
+#define TrenchBroom_SoftwareOcclusionBuffer
+
+#include <vecmath/forward.h>
+#include <vecmath/mat.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * A low resolution depth buffer that is rendered on the CPU. Large convex polygons (occluders) are rasterized
+         * into the buffer, and afterwards, bounding boxes can be tested against the buffer to find out whether they are
+         * completely hidden behind the occluders.
+         *
+         * The buffer is conservative: Occluders only cover the pixels which they cover completely, and they are written
+         * using the largest depth they have within each pixel. Therefore, a box is only reported as occluded if it is
+         * actually hidden.
+         *
+         * Depth values are normalized to [0, 1], where 1 is the far plane.
+         */
+        class SoftwareOcclusionBuffer {
+        private:
+            size_t m_width;
+            size_t m_height;
+            /**
+             * The number of floats per row; this is m_width rounded up to a multiple of 4 so that rows can be processed
+             * in blocks of four pixels.
+             */
+            size_t m_stride;
+            std::vector<float> m_depth;
+            vm::mat4x4f m_transformation;
+        public:
+            /**
+             * Creates a new buffer of the given size.
+             *
+             * @param width the width in pixels, must be greater than 0
+             * @param height the height in pixels, must be greater than 0
+             */
+            SoftwareOcclusionBuffer(size_t width, size_t height);
+
+            size_t width() const;
+            size_t height() const;
+
+            /**
+             * Clears this buffer and sets the transformation from world coordinates to clip space, usually the product
+             * of a camera's projection and view matrices.
+             */
+            void reset(const vm::mat4x4f& transformation);
+
+            /**
+             * Rasterizes the given convex polygon into this buffer. The polygon is clipped against the near plane.
+             *
+             * @param vertices the vertices of the polygon in world coordinates, in either winding order
+             */
+            void addOccluder(const std::vector<vm::vec3f>& vertices);
+
+            /**
+             * Indicates whether the given box is hidden behind the occluders added to this buffer or outside the
+             * buffer's view entirely.
+             */
+            bool occluded(const vm::bbox3f& bounds) const;
+
+            /**
+             * Returns the depth stored at the given pixel.
+             */
+            float depth(size_t x, size_t y) const;
+        private:
+            struct ScreenVertex {
+                float x, y, depth;
+            };
+
+            void rasterize(const std::vector<ScreenVertex>& vertices);
+            void rasterizeRow(size_t y, size_t minX, size_t maxX, const std::vector<float>& edges, size_t edgeCount, const float* depthPlane);
+            bool visible(size_t minX, size_t maxX, size_t minY, size_t maxY, float depth) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_SoftwareOcclusionBuffer) */
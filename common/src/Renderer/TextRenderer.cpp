@@ -23,6 +23,7 @@
 #include "Renderer/ActiveShader.h"
 #include "Renderer/Camera.h"
 #include "Renderer/FontManager.h"
+#include "Renderer/GlyphRunCache.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
@@ -43,14 +44,12 @@ namespace TrenchBroom {
         const size_t TextRenderer::RectCornerSegments = 3;
         const float TextRenderer::RectCornerRadius = 3.0f;
 
-        TextRenderer::Entry::Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        TextRenderer::Entry::Entry(std::shared_ptr<const GlyphRun> i_run, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        run(std::move(i_run)),
         size(i_size),
         offset(i_offset),
         textColor(i_textColor),
-        backgroundColor(i_backgroundColor) {
-            using std::swap;
-            swap(vertices, i_vertices);
-        }
+        backgroundColor(i_backgroundColor) {}
 
         TextRenderer::EntryCollection::EntryCollection() :
         textVertexCount(0),
@@ -83,17 +82,17 @@ namespace TrenchBroom {
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
 
-            std::vector<vm::vec2f> vertices = font.quads(string, true);
+            auto run = font.layout(string, true);
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const vm::vec2f size = font.measure(string);
+            const vm::vec2f size = run->size;
             const vm::vec3f offset = position.offset(camera, size);
 
             if (onTop)
-                addEntry(m_entriesOnTop, Entry(vertices, size, offset,
+                addEntry(m_entriesOnTop, Entry(std::move(run), size, offset,
                                                Color(textColor, alphaFactor * textColor.a()),
                                                Color(backgroundColor, alphaFactor * backgroundColor.a())));
             else
-                addEntry(m_entries, Entry(vertices, size, offset,
+                addEntry(m_entries, Entry(std::move(run), size, offset,
                                           Color(textColor, alphaFactor * textColor.a()),
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
@@ -136,14 +135,14 @@ namespace TrenchBroom {
 
         void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry) {
             collection.entries.push_back(entry);
-            collection.textVertexCount += entry.vertices.size();
+            collection.textVertexCount += entry.run->vertices.size() / 2u;
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
 
         vm::vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
-            return round(font.measure(string));
+            return round(font.layout(string, true)->size);
         }
 
         void TextRenderer::doPrepareVertices(VboManager& vboManager) {
@@ -170,7 +169,7 @@ namespace TrenchBroom {
         }
 
         void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices) {
-            const std::vector<vm::vec2f>& stringVertices = entry.vertices;
+            const std::vector<vm::vec2f>& stringVertices = entry.run->vertices;
             const vm::vec2f& stringSize = entry.size;
 
             const vm::vec3f& offset = entry.offset;
@@ -29,11 +29,13 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         class AttrString;
+        struct GlyphRun;
         class RenderContext;
         class TextAnchor;
 
@@ -46,13 +48,13 @@ namespace TrenchBroom {
             static const float RectCornerRadius;
 
             struct Entry {
-                std::vector<vm::vec2f> vertices;
+                std::shared_ptr<const GlyphRun> run;
                 vm::vec2f size;
                 vm::vec3f offset;
                 Color textColor;
                 Color backgroundColor;
 
-                Entry(std::vector<vm::vec2f>& i_vertices, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
+                Entry(std::shared_ptr<const GlyphRun> i_run, const vm::vec2f& i_size, const vm::vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
             };
 
             using EntryList = std::vector<Entry>;
@@ -19,7 +19,6 @@
 
 #include "TextureFont.h"
 
-#include "AttrString.h"
 #include "Renderer/FontGlyph.h"
 #include "Renderer/FontTexture.h"
 
@@ -227,6 +226,18 @@ namespace TrenchBroom {
             return result;
         }
 
+        std::shared_ptr<const GlyphRun> TextureFont::layout(const AttrString& string, const bool clockwise) const {
+            return m_attrStringRuns.getOrCreate(std::make_pair(string, clockwise), [&]() {
+                return GlyphRun{ quads(string, clockwise), measure(string) };
+            });
+        }
+
+        std::shared_ptr<const GlyphRun> TextureFont::layout(const std::string& string, const bool clockwise) const {
+            return m_stringRuns.getOrCreate(std::make_pair(string, clockwise), [&]() {
+                return GlyphRun{ quads(string, clockwise), measure(string) };
+            });
+        }
+
         void TextureFont::activate() {
             m_texture->activate();
         }
@@ -21,17 +21,19 @@
 #define TrenchBroom_Font
 
 #include "Macros.h"
+#include "Renderer/AttrString.h"
+#include "Renderer/GlyphRunCache.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
-        class AttrString;
         class FontGlyph;
         class FontTexture;
 
@@ -43,6 +45,12 @@ namespace TrenchBroom {
 
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            /**
+             * Runs of strings that were laid out with this font, keyed by the string and the winding order.
+             */
+            mutable GlyphRunCache<std::pair<AttrString, bool>> m_attrStringRuns;
+            mutable GlyphRunCache<std::pair<std::string, bool>> m_stringRuns;
         public:
             TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, int lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -55,6 +63,13 @@ namespace TrenchBroom {
             std::vector<vm::vec2f> quads(const std::string& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero()) const;
             vm::vec2f measure(const std::string& string) const;
 
+            /**
+             * Returns the quads and the size of the given string. The result is cached, so calling this repeatedly for
+             * the same string, e.g. once per frame, only lays out the string once.
+             */
+            std::shared_ptr<const GlyphRun> layout(const AttrString& string, bool clockwise) const;
+            std::shared_ptr<const GlyphRun> layout(const std::string& string, bool clockwise) const;
+
             void activate();
             void deactivate();
         };
@@ -124,6 +124,22 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeMap::render(VertexArray& vertexArray, const size_t instanceCount, InstanceRenderFunc& instanceFunc) {
+            DefaultTextureRenderFunc func;
+            for (const auto& entry : *m_data) {
+                const auto* texture = entry.first;
+                const auto& indexArray = entry.second;
+
+                func.before(texture);
+                for (size_t i = 0u; i < instanceCount; ++i) {
+                    instanceFunc.before(i);
+                    indexArray.render(vertexArray);
+                    instanceFunc.after(i);
+                }
+                func.after(texture);
+            }
+        }
+
         void TexturedIndexRangeMap::forEachPrimitive(std::function<void(const Texture*, PrimType, size_t, size_t)> func) const {
             for (const auto& entry : *m_data) {
                 const auto* texture = entry.first;
@@ -30,6 +30,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class InstanceRenderFunc;
         class TextureRenderFunc;
         class VertexArray;
 
@@ -169,6 +170,17 @@ namespace TrenchBroom {
              */
             void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+            /**
+             * Renders the primitives stored in this index range map the given number of times using the vertices in the
+             * given vertex array. Each texture is activated only once, and all instances are rendered while it is
+             * active. The given instance callbacks are invoked before and after each instance is rendered.
+             *
+             * @param vertexArray the vertex array to render with
+             * @param instanceCount the number of instances to render
+             * @param instanceFunc the instance callbacks
+             */
+            void render(VertexArray& vertexArray, size_t instanceCount, InstanceRenderFunc& instanceFunc);
+
             /**
              * Invokes the given function for each primitive stored in this map.
              *
@@ -57,6 +57,13 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, InstanceRenderFunc& func) {
+            if (m_vertexArray.setup()) {
+                m_indexRange.render(m_vertexArray, instanceCount, func);
+                m_vertexArray.cleanup();
+            }
+        }
+
         MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers) :
         m_renderers(std::move(renderers)) {}
 
@@ -88,5 +95,11 @@ namespace TrenchBroom {
                 renderer->render(func);
             }
         }
+
+        void MultiTexturedIndexRangeRenderer::renderInstances(const size_t instanceCount, InstanceRenderFunc& func) {
+            for (auto& renderer : m_renderers) {
+                renderer->renderInstances(instanceCount, func);
+            }
+        }
     }
 }
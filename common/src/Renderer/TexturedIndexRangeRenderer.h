@@ -32,6 +32,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class InstanceRenderFunc;
         class VboManager;
         class TextureRenderFunc;
 
@@ -44,6 +45,15 @@ namespace TrenchBroom {
             virtual void prepare(VboManager& vboManager) = 0;
             virtual void render() = 0;
             virtual void render(TextureRenderFunc& func) = 0;
+
+            /**
+             * Renders the given number of instances. Vertex buffers and textures are only bound once for all
+             * instances, so this is cheaper than calling render() for each instance.
+             *
+             * @param instanceCount the number of instances to render
+             * @param func callbacks which are invoked before and after each instance is rendered
+             */
+            virtual void renderInstances(size_t instanceCount, InstanceRenderFunc& func) = 0;
         };
 
         class TexturedIndexRangeRenderer : public TexturedRenderer {
@@ -61,6 +71,7 @@ namespace TrenchBroom {
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, InstanceRenderFunc& func) override;
         };
 
         class MultiTexturedIndexRangeRenderer : public TexturedRenderer {
@@ -75,6 +86,7 @@ namespace TrenchBroom {
             void prepare(VboManager& vboManager) override;
             void render() override;
             void render(TextureRenderFunc& func) override;
+            void renderInstances(size_t instanceCount, InstanceRenderFunc& func) override;
         };
     }
 }
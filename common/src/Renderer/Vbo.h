@@ -40,6 +40,7 @@ namespace TrenchBroom {
              */
             GLenum m_type;
             size_t m_capacity;
+            GLenum m_usage;
             GLuint m_bufferId;
 
             /**
@@ -66,6 +67,13 @@ namespace TrenchBroom {
             void bind();
             void unbind();
 
+            /**
+             * Replaces the storage of the buffer with new storage of the same capacity and usage. The contents are
+             * unspecified afterwards, but the driver does not need to wait until the GPU no longer uses the old
+             * storage before the buffer can be written to.
+             */
+            void orphan();
+
             template <typename T>
             size_t writeElements(const size_t address, const std::vector<T>& elements) {
                 return writeArray(address, elements.data(), elements.size());
@@ -77,7 +77,7 @@ namespace TrenchBroom {
                     if (m_vertexCount > 0 && m_vbo == nullptr) {
                         m_vboManager = &vboManager;
                         m_vbo = vboManager.allocateVbo(VboType::ArrayBuffer, sizeInBytes());;
-                        m_vbo->writeBuffer(0, doGetVertices());
+                        m_vbo->writeArray(0, doGetVertices(), m_vertexCount);
                     }
                 }
 
@@ -106,8 +106,7 @@ namespace TrenchBroom {
                     }
                 }
             private:
-                using VertexList = std::vector<typename VertexSpec::Vertex>;
-                virtual const VertexList& doGetVertices() const = 0;
+                virtual const typename VertexSpec::Vertex* doGetVertices() const = 0;
             };
 
             template <typename VertexSpec>
@@ -130,8 +129,8 @@ namespace TrenchBroom {
                     kdl::vec_clear_to_zero(m_vertices);
                 }
             private:
-                const VertexList& doGetVertices() const override {
-                    return m_vertices;
+                const typename VertexSpec::Vertex* doGetVertices() const override {
+                    return m_vertices.data();
                 }
             };
 
@@ -146,7 +145,21 @@ namespace TrenchBroom {
                 Holder<VertexSpec>(vertices.size()),
                 m_vertices(vertices) {}
             private:
-                const VertexList& doGetVertices() const override {
+                const typename VertexSpec::Vertex* doGetVertices() const override {
+                    return m_vertices.data();
+                }
+            };
+
+            template <typename VertexSpec>
+            class ByPointerHolder : public Holder<VertexSpec> {
+            private:
+                const typename VertexSpec::Vertex* m_vertices;
+            public:
+                ByPointerHolder(const typename VertexSpec::Vertex* vertices, const size_t vertexCount) :
+                Holder<VertexSpec>(vertexCount),
+                m_vertices(vertices) {}
+            private:
+                const typename VertexSpec::Vertex* doGetVertices() const override {
                     return m_vertices;
                 }
             };
@@ -201,6 +214,21 @@ namespace TrenchBroom {
                 return VertexArray(std::make_shared<ByRefHolder<typename GLVertex<Attrs...>::Type>>(vertices));
             }
 
+            /**
+             * Creates a new vertex array by referencing the given number of vertices starting at the given pointer.
+             *
+             * A caller must ensure that this vertex array does not outlive the referenced vertices.
+             *
+             * @tparam Attrs the vertex attribute types
+             * @param vertices the first vertex to reference
+             * @param vertexCount the number of vertices to reference
+             * @return the vertex array
+             */
+            template <typename... Attrs>
+            static VertexArray ref(const GLVertex<Attrs...>* vertices, const size_t vertexCount) {
+                return VertexArray(std::make_shared<ByPointerHolder<typename GLVertex<Attrs...>::Type>>(vertices, vertexCount));
+            }
+
             /**
              * Indicates whether this vertex array is empty.
              *
@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "VertexEncoding.h"
+
+#include <vecmath/scalar.h>
+
+#include <cmath>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static GLbyte encodeNormalComponent(const float c) {
+            // inverse of decodeNormalComponent, the result lies in [-128, 127] for any c in [-1, 1]
+            return static_cast<GLbyte>(std::round((vm::clamp(c, -1.0f, 1.0f) * 255.0f - 1.0f) / 2.0f));
+        }
+
+        vm::vec<GLbyte,4> encodeByteNormal(const vm::vec3f& normal) {
+            return vm::vec<GLbyte,4>(encodeNormalComponent(normal.x()), encodeNormalComponent(normal.y()), encodeNormalComponent(normal.z()), 0);
+        }
+
+        static float decodeNormalComponent(const GLbyte c) {
+            return (2.0f * static_cast<float>(c) + 1.0f) / 255.0f;
+        }
+
+        vm::vec3f decodeByteNormal(const vm::vec<GLbyte,4>& encodedNormal) {
+            return vm::vec3f(decodeNormalComponent(encodedNormal.x()), decodeNormalComponent(encodedNormal.y()), decodeNormalComponent(encodedNormal.z()));
+        }
+    }
+}
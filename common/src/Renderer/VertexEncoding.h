@@ -0,0 +1,45 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_VertexEncoding
+#define TrenchBroom_VertexEncoding
+
+#include "Renderer/GL.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Encodes the given unit normal as three signed bytes followed by a padding byte. When the normal is passed
+         * with glNormalPointer, OpenGL 2.1 maps a component c to (2c + 1) / 255, so -1 and 1 are represented exactly,
+         * but 0 is not. The largest error of a component is 1/255.
+         */
+        vm::vec<GLbyte,4> encodeByteNormal(const vm::vec3f& normal);
+
+        /**
+         * Decodes a normal which was encoded by encodeByteNormal in the same way as OpenGL 2.1 does.
+         */
+        vm::vec3f decodeByteNormal(const vm::vec<GLbyte,4>& encodedNormal);
+    }
+}
+
+#endif /* defined(TrenchBroom_VertexEncoding) */
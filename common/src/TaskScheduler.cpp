@@ -0,0 +1,268 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TaskScheduler.h"
+
+#include <chrono>
+
+namespace TrenchBroom {
+    /**
+     * The scheduler and the queue index of the worker running on the current thread, if any.
+     */
+    struct WorkerContext {
+        const TaskScheduler* scheduler = nullptr;
+        size_t queueIndex = 0u;
+    };
+
+    static thread_local WorkerContext currentWorker;
+
+    TaskScheduler::TaskScheduler(const size_t threadCount) :
+    m_nextQueue(0u),
+    m_queuedTaskCount(0u),
+    m_stopping(false) {
+        for (size_t i = 0u; i < std::max(threadCount, size_t(1)); ++i) {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        m_threads.reserve(threadCount);
+        for (size_t i = 0u; i < threadCount; ++i) {
+            m_threads.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    TaskScheduler::~TaskScheduler() {
+        {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    TaskScheduler& TaskScheduler::instance() {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+
+    size_t TaskScheduler::defaultThreadCount() {
+        return std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1u;
+    }
+
+    size_t TaskScheduler::threadCount() const {
+        return m_threads.size();
+    }
+
+    bool TaskScheduler::isWorkerThread() {
+        return currentWorker.scheduler != nullptr;
+    }
+
+    void TaskScheduler::submit(Task task) {
+        const auto queueIndex = currentWorker.scheduler == this ? currentWorker.queueIndex : m_nextQueue++ % m_queues.size();
+        {
+            auto& queue = *m_queues[queueIndex];
+            const auto lock = std::lock_guard<std::mutex>(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+            // count the task under the queue lock like tryPop and trySteal do, otherwise they could take the task and
+            // decrement the count before it was incremented
+            ++m_queuedTaskCount;
+        }
+        {
+            // a worker checks the count while holding this mutex, so it either sees the new task or gets notified
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        }
+        m_condition.notify_one();
+    }
+
+    bool TaskScheduler::runPendingTask() {
+        if (currentWorker.scheduler == this) {
+            return tryRunTask(currentWorker.queueIndex);
+        }
+
+        Task task;
+        if (trySteal(m_nextQueue % m_queues.size(), task)) {
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    void TaskScheduler::postToMainThread(Task task) {
+        std::function<void()> wakeup;
+        {
+            const auto lock = std::lock_guard<std::mutex>(m_mainThreadMutex);
+            if (m_mainThreadTasks.empty()) {
+                wakeup = m_mainThreadWakeup;
+            }
+            m_mainThreadTasks.push_back(std::move(task));
+        }
+
+        if (wakeup) {
+            wakeup();
+        }
+    }
+
+    void TaskScheduler::setMainThreadWakeup(std::function<void()> wakeup) {
+        bool hasPendingTasks;
+        {
+            const auto lock = std::lock_guard<std::mutex>(m_mainThreadMutex);
+            m_mainThreadWakeup = wakeup;
+            hasPendingTasks = !m_mainThreadTasks.empty();
+        }
+
+        if (wakeup && hasPendingTasks) {
+            wakeup();
+        }
+    }
+
+    size_t TaskScheduler::runMainThreadTasks() {
+        std::vector<Task> tasks;
+        {
+            const auto lock = std::lock_guard<std::mutex>(m_mainThreadMutex);
+            using std::swap;
+            swap(tasks, m_mainThreadTasks);
+        }
+
+        for (auto& task : tasks) {
+            task();
+        }
+        return tasks.size();
+    }
+
+    void TaskScheduler::work(const size_t queueIndex) {
+        currentWorker = WorkerContext{this, queueIndex};
+
+        while (true) {
+            if (tryRunTask(queueIndex)) {
+                continue;
+            }
+
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            m_condition.wait(lock, [&]() { return m_stopping || m_queuedTaskCount > 0u; });
+            if (m_stopping) {
+                return;
+            }
+        }
+    }
+
+    bool TaskScheduler::tryRunTask(const size_t queueIndex) {
+        Task task;
+        if (tryPop(queueIndex, task) || trySteal(queueIndex, task)) {
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    bool TaskScheduler::tryPop(const size_t queueIndex, Task& task) {
+        auto& queue = *m_queues[queueIndex];
+        const auto lock = std::lock_guard<std::mutex>(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+
+        // the most recently added task is likely to use data which is still in the cache
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        --m_queuedTaskCount;
+        return true;
+    }
+
+    bool TaskScheduler::trySteal(const size_t queueIndex, Task& task) {
+        for (size_t i = 1u; i <= m_queues.size(); ++i) {
+            auto& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+            const auto lock = std::lock_guard<std::mutex>(queue.mutex);
+            if (!queue.tasks.empty()) {
+                // the oldest task is likely to be the largest one, e.g. half of the range of a parallel loop
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                --m_queuedTaskCount;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    TaskGroup::TaskGroup(TaskScheduler& scheduler) :
+    m_scheduler(scheduler),
+    m_pendingTaskCount(0u),
+    m_failed(false) {}
+
+    TaskGroup::~TaskGroup() {
+        waitForPendingTasks();
+    }
+
+    void TaskGroup::run(TaskScheduler::Task task) {
+        ++m_pendingTaskCount;
+        m_scheduler.submit([this, task = std::move(task)]() {
+            if (!m_failed) {
+                try {
+                    task();
+                } catch (...) {
+                    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                    if (!m_failed) {
+                        m_exception = std::current_exception();
+                        m_failed = true;
+                    }
+                }
+            }
+            taskDone();
+        });
+    }
+
+    void TaskGroup::wait() {
+        waitForPendingTasks();
+
+        if (m_failed) {
+            auto exception = std::move(m_exception);
+            m_exception = nullptr;
+            m_failed = false;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void TaskGroup::waitForPendingTasks() {
+        while (true) {
+            if (m_pendingTaskCount == 0u) {
+                // synchronize with the last call to taskDone so that it has released the mutex
+                const auto lock = std::lock_guard<std::mutex>(m_mutex);
+                return;
+            }
+
+            if (!m_scheduler.runPendingTask()) {
+                // the remaining tasks are being executed by other threads, but they may still add tasks which this
+                // thread can help with, so don't wait for too long
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                m_condition.wait_for(lock, std::chrono::microseconds(100), [&]() { return m_pendingTaskCount == 0u; });
+            }
+        }
+    }
+
+    void TaskGroup::taskDone() {
+        // the count must be decremented while holding the mutex, otherwise the group could be destroyed by a waiting
+        // thread before the condition is notified
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        if (--m_pendingTaskCount == 0u) {
+            m_condition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,257 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TaskScheduler
+#define TrenchBroom_TaskScheduler
+
+#include "Macros.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    class TaskGroup;
+
+    /**
+     * A pool of worker threads that execute tasks. Every worker owns a queue of tasks. Tasks submitted from a worker
+     * are added to that worker's queue, and tasks submitted from other threads are distributed over the queues in
+     * turn. A worker takes the most recently added task from its own queue, and when its queue is empty, it steals
+     * the oldest task from the queue of another worker.
+     *
+     * Tasks are usually run as part of a TaskGroup, which allows waiting for them. A thread that waits for a task
+     * group executes pending tasks in the meantime, so task groups can be nested and waited for from within tasks.
+     *
+     * The scheduler also maintains a queue of tasks that must run on the main thread. These are executed whenever
+     * the main thread calls runMainThreadTasks(). The application arranges for this to happen by installing a
+     * wakeup function which is called when a task is posted to an empty main thread queue.
+     */
+    class TaskScheduler {
+    public:
+        using Task = std::function<void()>;
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::atomic<size_t> m_nextQueue;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        // only modified while holding the lock of the queue that the task is added to or removed from
+        std::atomic<size_t> m_queuedTaskCount;
+        bool m_stopping;
+
+        std::mutex m_mainThreadMutex;
+        std::vector<Task> m_mainThreadTasks;
+        std::function<void()> m_mainThreadWakeup;
+    public:
+        /**
+         * Creates a scheduler with the given number of worker threads. If the given number is 0, tasks are only
+         * executed by threads which wait for a task group.
+         */
+        explicit TaskScheduler(size_t threadCount = defaultThreadCount());
+
+        /**
+         * Stops the worker threads after they finished their current tasks. Tasks which have not been started are
+         * discarded.
+         */
+        ~TaskScheduler();
+
+        /**
+         * Returns the scheduler shared by the entire application.
+         */
+        static TaskScheduler& instance();
+
+        /**
+         * Returns one less than the number of hardware threads, but at least 1, since the thread which waits for
+         * the tasks participates in the work.
+         */
+        static size_t defaultThreadCount();
+
+        size_t threadCount() const;
+
+        /**
+         * Indicates whether the calling thread is a worker thread of any scheduler. Threads which only participate in
+         * the work while waiting for a task group are not worker threads.
+         */
+        static bool isWorkerThread();
+
+        /**
+         * Adds the given task to a work queue. The task must not throw; use a TaskGroup to run tasks that may throw
+         * or that must be waited for.
+         */
+        void submit(Task task);
+
+        /**
+         * Executes one pending task on the calling thread if there is any.
+         *
+         * @return true if a task was executed and false otherwise
+         */
+        bool runPendingTask();
+
+        /**
+         * Calls the given function once for every index in [0, count) and returns once all calls have returned. The
+         * calling thread participates in the work.
+         *
+         * If any of the calls throws an exception, the calls which have not been started are skipped and the first
+         * exception is rethrown to the caller.
+         *
+         * @tparam F the type of the function to call, must be callable with a size_t and safe to call concurrently
+         * @param count the number of indices
+         * @param f the function to call
+         */
+        template <typename F>
+        void parallelFor(const size_t count, const F& f) {
+            const auto grainSize = std::max(count / ((threadCount() + 1u) * 8u), size_t(1));
+            parallelForRange(0u, count, grainSize, [&](const size_t begin, const size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    f(i);
+                }
+            });
+        }
+
+        /**
+         * Splits the range [begin, end) into subranges of at most grainSize indices and calls the given function
+         * once for every subrange. The range is split in halves recursively, so that idle workers steal large
+         * subranges first. The calling thread participates in the work.
+         *
+         * If any of the calls throws an exception, the calls which have not been started are skipped and the first
+         * exception is rethrown to the caller.
+         *
+         * @tparam F the type of the function to call, must be callable with the first and the past-the-end index of a
+         * subrange and safe to call concurrently
+         * @param begin the first index
+         * @param end the past-the-end index
+         * @param grainSize the maximum number of indices per call, values less than 1 are treated as 1
+         * @param f the function to call
+         */
+        template <typename F>
+        void parallelForRange(size_t begin, size_t end, size_t grainSize, const F& f);
+
+        /**
+         * Adds the given task to the main thread queue. If the queue was empty, the main thread wakeup function is
+         * called. This can be called from any thread.
+         */
+        void postToMainThread(Task task);
+
+        /**
+         * Sets the function which is called when a task is posted to the empty main thread queue. The function is
+         * called on the posting thread, and it must cause runMainThreadTasks() to be called on the main thread
+         * eventually.
+         */
+        void setMainThreadWakeup(std::function<void()> wakeup);
+
+        /**
+         * Executes the tasks that were posted to the main thread queue so far. Must be called on the main thread.
+         *
+         * @return the number of tasks which were executed
+         */
+        size_t runMainThreadTasks();
+    private:
+        void work(size_t queueIndex);
+        bool tryRunTask(size_t queueIndex);
+        bool tryPop(size_t queueIndex, Task& task);
+        bool trySteal(size_t queueIndex, Task& task);
+
+        template <typename F>
+        void splitRange(TaskGroup& group, size_t begin, size_t end, size_t grainSize, const F& f);
+
+        deleteCopyAndMove(TaskScheduler)
+    };
+
+    /**
+     * Runs tasks on a task scheduler and waits for them. If a task throws an exception, the tasks of this group which
+     * have not been started yet are skipped, and the exception is rethrown by wait().
+     *
+     * The destructor waits for all tasks of this group, but does not rethrow exceptions.
+     */
+    class TaskGroup {
+    private:
+        TaskScheduler& m_scheduler;
+        std::atomic<size_t> m_pendingTaskCount;
+        std::atomic<bool> m_failed;
+        std::exception_ptr m_exception;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+        ~TaskGroup();
+
+        /**
+         * Submits the given task to the scheduler.
+         */
+        void run(TaskScheduler::Task task);
+
+        /**
+         * Waits until all tasks of this group have finished, executing pending tasks on the calling thread in the
+         * meantime. Tasks may add further tasks to this group while it is waited for.
+         *
+         * @throws the first exception thrown by any task of this group
+         */
+        void wait();
+    private:
+        void waitForPendingTasks();
+        void taskDone();
+
+        deleteCopyAndMove(TaskGroup)
+    };
+
+    template <typename F>
+    void TaskScheduler::parallelForRange(const size_t begin, const size_t end, size_t grainSize, const F& f) {
+        if (end <= begin) {
+            return;
+        }
+
+        grainSize = std::max(grainSize, size_t(1));
+        if (end - begin <= grainSize) {
+            f(begin, end);
+            return;
+        }
+
+        TaskGroup group(*this);
+        group.run([&]() { splitRange(group, begin, end, grainSize, f); });
+        group.wait();
+    }
+
+    template <typename F>
+    void TaskScheduler::splitRange(TaskGroup& group, const size_t begin, size_t end, const size_t grainSize, const F& f) {
+        while (end - begin > grainSize) {
+            const auto mid = begin + (end - begin) / 2u;
+            group.run([&group, &f, this, mid, end, grainSize]() { splitRange(group, mid, end, grainSize, f); });
+            end = mid;
+        }
+        f(begin, end);
+    }
+}
+
+#endif /* defined(TrenchBroom_TaskScheduler) */
@@ -21,7 +21,9 @@
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "RecoverableExceptions.h"
+#include "TaskScheduler.h"
 #include "TrenchBroomStackWalker.h"
 #include "IO/Path.h"
 #include "IO/PathQt.h"
@@ -157,7 +159,13 @@ namespace TrenchBroom {
 
 #endif
 
+            // tasks can be posted to the main thread from any thread, so the slot must be invoked through the event loop
+            TaskScheduler::instance().setMainThreadWakeup([this]() {
+                QMetaObject::invokeMethod(this, "runMainThreadTasks", Qt::QueuedConnection);
+            });
+
             connect(this, &QCoreApplication::aboutToQuit, this, []() {
+                TaskScheduler::instance().setMainThreadWakeup(nullptr);
                 Model::GameFactory::instance().saveAllConfigs();
             });
         }
@@ -167,7 +175,22 @@ namespace TrenchBroom {
 
         void TrenchBroomApp::parseCommandLineAndShowFrame() {
             QCommandLineParser parser;
+#ifdef TB_ENABLE_PROFILER
+            const auto profileOption = QCommandLineOption("profile", "Record profiling zones and write them to <file> in the Chrome trace format on exit.", "file");
+            parser.addOption(profileOption);
+#endif
             parser.process(*this);
+
+#ifdef TB_ENABLE_PROFILER
+            if (parser.isSet(profileOption)) {
+                Profiler::instance().setEnabled(true);
+                connect(this, &QCoreApplication::aboutToQuit, this, [tracePath = parser.value(profileOption).toStdString()]() {
+                    std::ofstream stream(tracePath);
+                    Profiler::instance().writeTrace(stream);
+                });
+            }
+#endif
+
             openFilesOrWelcomeFrame(parser.positionalArguments());
         }
 
@@ -688,5 +711,9 @@ namespace TrenchBroom {
             return false;
 #endif
         }
+
+        void TrenchBroomApp::runMainThreadTasks() {
+            TaskScheduler::instance().runMainThreadTasks();
+        }
     }
 }
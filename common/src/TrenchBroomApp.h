@@ -94,6 +94,8 @@ namespace TrenchBroom {
             void closeWelcomeWindow();
         private:
             static bool useSDI();
+        private slots:
+            void runMainThreadTasks();
         signals:
             void recentDocumentsDidChange();
         };
@@ -1097,6 +1097,13 @@ namespace TrenchBroom {
                 [](ActionExecutionContext& context) {
                     return context.hasDocument() && context.frame()->canDoCsgSubtract();
                 }));
+            csgMenu.addItem(createMenuAction(IO::Path("Menu/Edit/CSG/Subtract and Merge Fragments"), QObject::tr("Subtract and Merge Fragments"), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->csgSubtractAndMergeFragments();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument() && context.frame()->canDoCsgSubtract();
+                }));
             csgMenu.addItem(createMenuAction(IO::Path("Menu/Edit/CSG/Hollow"), QObject::tr("Hollow"), Qt::CTRL + Qt::SHIFT + Qt::Key_K,
                 [](ActionExecutionContext& context) {
                     context.frame()->csgHollow();
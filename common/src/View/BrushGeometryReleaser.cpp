@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BrushGeometryReleaser.h"
+
+#include "Model/AssortNodesVisitor.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+#include "View/MapDocument.h"
+
+#include <kdl/memory_utils.h>
+
+#include <vecmath/bbox.h>
+
+namespace TrenchBroom {
+    namespace View {
+        BrushGeometryReleaser::BrushGeometryReleaser(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds delay) :
+        m_document(std::move(document)),
+        m_delay(delay) {}
+
+        static size_t releaseGeometry(Model::LayerNode* layer, const vm::bbox3& worldBounds) {
+            Model::CollectBrushesVisitor collect;
+            layer->acceptAndRecurse(collect);
+
+            size_t count = 0u;
+            for (auto* brushNode : collect.brushes()) {
+                // a brush may be shown explicitly even if its layer is hidden
+                if (!brushNode->visible() && !brushNode->selected() && !brushNode->hasReleasedGeometry()) {
+                    brushNode->releaseGeometry(worldBounds);
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        size_t BrushGeometryReleaser::triggerRelease() {
+            if (kdl::mem_expired(m_document)) {
+                return 0u;
+            }
+
+            auto document = kdl::mem_lock(m_document);
+            const auto* world = document->world();
+            if (world == nullptr) {
+                m_hiddenSince.clear();
+                return 0u;
+            }
+
+            const auto currentTime = Clock::now();
+
+            // rebuilt on every call so that layers which were shown or removed in the meantime are forgotten
+            std::unordered_map<const Model::LayerNode*, std::chrono::time_point<Clock>> hiddenSince;
+            size_t count = 0u;
+
+            for (auto* layer : world->allLayers()) {
+                if (layer->visible()) {
+                    continue;
+                }
+
+                const auto it = m_hiddenSince.find(layer);
+                const auto since = it != std::end(m_hiddenSince) ? it->second : currentTime;
+                hiddenSince.emplace(layer, since);
+
+                if (currentTime - since >= m_delay) {
+                    count += releaseGeometry(layer, document->worldBounds());
+                }
+            }
+
+            m_hiddenSince = std::move(hiddenSince);
+            return count;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_BrushGeometryReleaser
+#define TrenchBroom_BrushGeometryReleaser
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Model {
+        class LayerNode;
+    }
+
+    namespace View {
+        class MapDocument;
+
+        /**
+         * Releases the geometry of the brushes in layers that have been hidden for a while. The geometry of such a
+         * brush is restored once it is accessed again, e.g. when the layer is shown.
+         */
+        class BrushGeometryReleaser {
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            std::weak_ptr<MapDocument> m_document;
+
+            /**
+             * The time for which a layer must have been hidden until the geometry of its brushes is released.
+             */
+            std::chrono::milliseconds m_delay;
+
+            /**
+             * The time at which each of the currently hidden layers was first found to be hidden.
+             */
+            std::unordered_map<const Model::LayerNode*, std::chrono::time_point<Clock>> m_hiddenSince;
+        public:
+            explicit BrushGeometryReleaser(std::weak_ptr<MapDocument> document, std::chrono::milliseconds delay = std::chrono::milliseconds(60 * 1000));
+
+            /**
+             * Releases the geometry of the hidden brushes in every layer that has been hidden for at least the delay.
+             * Since the layers are only inspected when this function is called, the delay is measured from the first
+             * call that finds a layer hidden. The geometry of brushes which was restored in the meantime is released
+             * again.
+             *
+             * @return the number of brushes whose geometry was released
+             */
+            size_t triggerRelease();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_BrushGeometryReleaser) */
@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "Profiler.h"
 #include "View/Command.h"
 #include "View/UndoableCommand.h"
 
@@ -285,6 +286,10 @@ namespace TrenchBroom {
         }
 
         CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(std::unique_ptr<UndoableCommand> command, const bool collate, const bool repeatable) {
+            if (willCollateWithTransaction(*command, collate)) {
+                return executeAndCollateCommand(std::move(command));
+            }
+
             auto commandResult = executeCommand(command.get());
             if (!commandResult->success()) {
                 return SubmitAndStoreResult(std::move(commandResult), false);
@@ -295,7 +300,35 @@ namespace TrenchBroom {
             return SubmitAndStoreResult(std::move(commandResult), commandStored);
         }
 
+        CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndCollateCommand(std::unique_ptr<UndoableCommand> command) {
+            TB_PROFILE_ZONE_DETAIL("CommandProcessor::executeAndCollateCommand", command->name());
+            assert(willCollateWithTransaction(*command, true));
+
+            notifyCommandIfNotType(commandDoNotifier, TransactionCommand::Type, command.get());
+            auto commandResult = command->performCollatedDo(m_document);
+            if (!commandResult->success()) {
+                notifyCommandIfNotType(commandDoFailedNotifier, TransactionCommand::Type, command.get());
+                return SubmitAndStoreResult(std::move(commandResult), false);
+            }
+            notifyCommandIfNotType(commandDoneNotifier, TransactionCommand::Type, command.get());
+
+            auto& lastCommand = m_transactionStack.back().commands.back();
+            assertResult(lastCommand->collateWith(command.get()))
+            m_redoStack.clear();
+            return SubmitAndStoreResult(std::move(commandResult), false);
+        }
+
+        bool CommandProcessor::willCollateWithTransaction(const UndoableCommand& command, const bool collate) const {
+            if (!collate || m_transactionStack.empty()) {
+                return false;
+            }
+
+            const auto& transaction = m_transactionStack.back();
+            return !transaction.commands.empty() && transaction.commands.back()->willCollateWith(command);
+        }
+
         std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command* command) {
+            TB_PROFILE_ZONE_DETAIL("CommandProcessor::executeCommand", command->name());
             notifyCommandIfNotType(commandDoNotifier, TransactionCommand::Type, command);
             auto result = command->performDo(m_document);
             if (result->success()) {
@@ -310,6 +343,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<CommandResult> CommandProcessor::undoCommand(UndoableCommand* command) {
+            TB_PROFILE_ZONE_DETAIL("CommandProcessor::undoCommand", command->name());
             notifyCommandIfNotType(commandUndoNotifier, TransactionCommand::Type, command);
             auto result = command->performUndo(m_document);
             if (result->success()) {
@@ -50,6 +50,11 @@ namespace TrenchBroom {
          *
          * The command processor supports nested transactions. Each transaction can be committed or rolled back
          * individually. Committing a nested transaction adds it as a command to the containing transaction.
+         *
+         * Within a transaction, a command that will be collated with the transaction's last command is executed by
+         * calling its `performCollatedDo` method, which allows the command to skip recording the information needed
+         * to undo it. Tools that submit a command for every mouse move during a drag rely on this, since only the
+         * first command of a drag has to record the state of the affected objects.
          */
         class CommandProcessor {
         private:
@@ -307,6 +312,29 @@ namespace TrenchBroom {
              */
             SubmitAndStoreResult executeAndStoreCommand(std::unique_ptr<UndoableCommand> command, bool collate, bool repeatable);
 
+            /**
+             * Executes the given command by calling its `performCollatedDo` method and collates it with the last command
+             * of the currently executing transaction if it was executed successfully. Triggers the same notifications
+             * as `executeCommand`.
+             *
+             * Precondition: willCollateWithTransaction(*command, true) == true
+             *
+             * @param command the command to execute and collate
+             * @return a struct containing the result of executing the given command, the command is never stored
+             */
+            SubmitAndStoreResult executeAndCollateCommand(std::unique_ptr<UndoableCommand> command);
+
+            /**
+             * Indicates whether the given command will be collated with the last command of the currently executing
+             * transaction once it is executed.
+             *
+             * @param command the command to check
+             * @param collate whether or not the given command should be collated at all
+             * @return true if a transaction is currently executing and its last command will be collated with the given
+             * command
+             */
+            bool willCollateWithTransaction(const UndoableCommand& command, bool collate) const;
+
             /**
              * Executes the given command by calling its `performDo` method and triggers the corresponding
              * notifications.
@@ -401,7 +401,7 @@ namespace TrenchBroom {
                         const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
 
                         auto& font = fontManager().font(defaultDescriptor);
-                        const auto quads = font.quads(title, false, offset);
+                        const auto quads = font.layout(title, false)->translatedVertices(offset);
                         const auto titleVertices = TextVertex::toList(
                             quads.size() / 2,
                             kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
@@ -419,7 +419,7 @@ namespace TrenchBroom {
                                 const auto offset = vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y) - titleBounds.height());
 
                                 Renderer::TextureFont& font = fontManager().font(cellData(cell).fontDescriptor);
-                                const auto quads = font.quads(cellData(cell).entityDefinition->name(), false, offset);
+                                const auto quads = font.layout(cellData(cell).entityDefinition->name(), false)->translatedVertices(offset);
                                 const auto titleVertices = TextVertex::toList(
                                     quads.size() / 2,
                                     kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
@@ -20,6 +20,7 @@
 #include "IssueBrowserView.h"
 
 #include "Ensure.h"
+#include "Profiler.h"
 #include "Model/CollectMatchingIssuesVisitor.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
@@ -130,6 +131,7 @@ namespace TrenchBroom {
         }
 
         void IssueBrowserView::updateIssues() {
+            TB_PROFILE_ZONE("IssueBrowserView::updateIssues");
             auto document = kdl::mem_lock(m_document);
             Model::WorldNode* world = document->world();
             if (world != nullptr) {
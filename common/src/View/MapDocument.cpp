@@ -21,6 +21,8 @@
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
+#include "TaskScheduler.h"
 #include "Assets/AssetUtils.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionGroup.h"
@@ -42,14 +44,12 @@
 #include "Model/BrushGeometry.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/CollectAttributableNodesVisitor.h"
-#include "Model/CollectContainedNodesVisitor.h"
 #include "Model/CollectMatchingBrushFacesVisitor.h"
 #include "Model/CollectNodesVisitor.h"
 #include "Model/CollectSelectableNodesVisitor.h"
 #include "Model/CollectSelectableBrushFacesVisitor.h"
 #include "Model/CollectSelectableNodesWithFilePositionVisitor.h"
 #include "Model/CollectSelectedNodesVisitor.h"
-#include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/EmptyAttributeNameIssueGenerator.h"
@@ -135,12 +135,14 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib> // for std::abs
 #include <map>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -323,6 +325,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::newDocument(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game) {
+            TB_PROFILE_ZONE("MapDocument::newDocument");
             info("Creating new document");
 
             clearDocument();
@@ -339,6 +342,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadDocument(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path) {
+            TB_PROFILE_ZONE("MapDocument::loadDocument");
             info("Loading document from " + path.asString());
 
             clearDocument();
@@ -361,6 +365,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::saveDocumentTo(const IO::Path& path) {
+            TB_PROFILE_ZONE("MapDocument::saveDocumentTo");
             ensure(m_game.get() != nullptr, "game is null");
             ensure(m_world != nullptr, "world is null");
             m_game->writeMap(*m_world, path);
@@ -409,6 +414,7 @@ namespace TrenchBroom {
         }
 
         PasteType MapDocument::paste(const std::string& str) {
+            TB_PROFILE_ZONE("MapDocument::paste");
             try {
                 const std::vector<Model::Node*> nodes = m_game->parseNodes(str, *m_world, m_worldBounds, logger());
                 if (!nodes.empty() && pasteNodes(nodes))
@@ -627,12 +633,8 @@ namespace TrenchBroom {
         }
 
         void MapDocument::selectTouching(const bool del) {
-            const std::vector<Model::BrushNode*>& brushes = m_selectedNodes.brushes();
-
-            Model::CollectTouchingNodesVisitor<std::vector<Model::BrushNode*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const std::vector<Model::Node*> nodes = visitor.nodes();
+            TB_PROFILE_ZONE("MapDocument::selectTouching");
+            const std::vector<Model::Node*> nodes = m_world->findSelectableNodesTouching(m_selectedNodes.brushes(), editorContext());
 
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -643,12 +645,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::selectInside(const bool del) {
-            const std::vector<Model::BrushNode*>& brushes = m_selectedNodes.brushes();
-
-            Model::CollectContainedNodesVisitor<std::vector<Model::BrushNode*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-
-            const std::vector<Model::Node*> nodes = visitor.nodes();
+            const std::vector<Model::Node*> nodes = m_world->findSelectableNodesContainedIn(m_selectedNodes.brushes(), editorContext());
 
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -1491,6 +1488,7 @@ namespace TrenchBroom {
         }
 
         bool MapDocument::csgConvexMerge() {
+            TB_PROFILE_ZONE("MapDocument::csgConvexMerge");
             if (!hasSelectedBrushFaces() && !selectedNodes().hasOnlyBrushes()) {
                 return false;
             }
@@ -1546,7 +1544,8 @@ namespace TrenchBroom {
             return true;
         }
 
-        bool MapDocument::csgSubtract() {
+        bool MapDocument::csgSubtract(const bool mergeFragments) {
+            TB_PROFILE_ZONE("MapDocument::csgSubtract");
             const auto subtrahendNodes = std::vector<Model::BrushNode*>{selectedNodes().brushes()};
             if (subtrahendNodes.empty()) {
                 return false;
@@ -1560,11 +1559,39 @@ namespace TrenchBroom {
 
             std::map<Model::Node*, std::vector<Model::Node*>> toAdd;
             std::vector<Model::Node*> toRemove(std::begin(subtrahendNodes), std::end(subtrahendNodes));
-            const std::vector<const Model::Brush*> subtrahends = kdl::vec_transform(subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
-            
-            for (Model::BrushNode* minuendNode : minuendNodes) {
-                const Model::Brush& minuend = minuendNode->brush();
-                std::vector<Model::Brush> resultBrushes = minuend.subtract(*m_world, m_worldBounds, currentTextureName(), subtrahends);
+
+            std::unordered_map<const Model::Node*, size_t> subtrahendIndices;
+            for (size_t i = 0u; i < subtrahendNodes.size(); ++i) {
+                subtrahendIndices.emplace(subtrahendNodes[i], i);
+            }
+
+            // only the subtrahends whose bounds intersect a minuend can affect it, but they must be applied in
+            // selection order to produce the same fragments
+            const auto subtrahendsPerMinuend = kdl::vec_transform(minuendNodes, [&](const Model::BrushNode* minuendNode) {
+                std::vector<size_t> indices;
+                for (const auto* node : m_world->findIntersecting(minuendNode->physicalBounds())) {
+                    const auto it = subtrahendIndices.find(node);
+                    if (it != std::end(subtrahendIndices)) {
+                        indices.push_back(it->second);
+                    }
+                }
+                std::sort(std::begin(indices), std::end(indices));
+                return kdl::vec_transform(indices, [&](const size_t index) { return &subtrahendNodes[index]->brush(); });
+            });
+
+            // the minuends don't depend on each other, so we can subtract from them concurrently
+            const std::string& textureName = currentTextureName();
+            // access the brushes here since released brush geometry can only be restored on this thread
+            const auto minuends = kdl::vec_transform(minuendNodes, [](const Model::BrushNode* minuendNode) { return &minuendNode->brush(); });
+            std::vector<std::vector<Model::Brush>> resultBrushesPerMinuend(minuendNodes.size());
+            TaskScheduler::instance().parallelFor(minuendNodes.size(), [&](const size_t i) {
+                const Model::Brush& minuend = *minuends[i];
+                resultBrushesPerMinuend[i] = minuend.subtract(*m_world, m_worldBounds, textureName, subtrahendsPerMinuend[i], mergeFragments);
+            });
+
+            for (size_t i = 0u; i < minuendNodes.size(); ++i) {
+                Model::BrushNode* minuendNode = minuendNodes[i];
+                std::vector<Model::Brush>& resultBrushes = resultBrushesPerMinuend[i];
                 if (!resultBrushes.empty()) {
                     const std::vector<Model::BrushNode*> resultNodes = kdl::vec_transform(std::move(resultBrushes), [&](auto brush) { return m_world->createBrush(std::move(brush)); });
                     kdl::vec_append(toAdd[minuendNode->parent()], resultNodes);
@@ -1581,6 +1608,7 @@ namespace TrenchBroom {
         }
 
         bool MapDocument::csgIntersect() {
+            TB_PROFILE_ZONE("MapDocument::csgIntersect");
             const std::vector<Model::BrushNode*> brushes = selectedNodes().brushes();
             if (brushes.size() < 2u) {
                 return false;
@@ -1618,6 +1646,7 @@ namespace TrenchBroom {
         }
 
         bool MapDocument::csgHollow() {
+            TB_PROFILE_ZONE("MapDocument::csgHollow");
             const std::vector<Model::BrushNode*> brushNodes = selectedNodes().brushes();
             if (brushNodes.empty()) {
                 return false;
@@ -1913,6 +1942,10 @@ namespace TrenchBroom {
             m_textureManager->commitChanges();
         }
 
+        bool MapDocument::hasPendingAssets() const {
+            return m_textureManager->hasPendingUploads();
+        }
+
         void MapDocument::pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const {
             if (m_world != nullptr)
                 m_world->pick(pickRay, pickResult);
@@ -2014,6 +2047,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadEntityDefinitions() {
+            TB_PROFILE_ZONE("MapDocument::loadEntityDefinitions");
             const Assets::EntityDefinitionFileSpec spec = entityDefinitionFile();
             try {
                 const IO::Path path = m_game->findEntityDefinitionFile(spec, externalSearchPaths());
@@ -2038,6 +2072,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadEntityModels() {
+            TB_PROFILE_ZONE("MapDocument::loadEntityModels");
             m_entityModelManager->setLoader(m_game.get());
             setEntityModels();
         }
@@ -2054,6 +2089,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadTextures() {
+            TB_PROFILE_ZONE("MapDocument::loadTextures");
             try {
                 const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
                 m_game->loadTextureCollections(*m_world, docDir, *m_textureManager, logger());
@@ -2079,9 +2115,9 @@ namespace TrenchBroom {
             void doVisit(Model::GroupNode*) override   {}
             void doVisit(Model::EntityNode*) override {}
             void doVisit(Model::BrushNode* brushNode) override   {
-                const Model::Brush& brush = brushNode->brush();
-                for (size_t i = 0u; i < brush.faceCount(); ++i) {
-                    const Model::BrushFace& face = brush.face(i);
+                const auto& faces = brushNode->faces();
+                for (size_t i = 0u; i < faces.size(); ++i) {
+                    const Model::BrushFace& face = faces[i];
                     Assets::Texture* texture = m_manager.texture(face.attributes().textureName());
                     brushNode->setFaceTexture(i, texture);
                 }
@@ -2095,8 +2131,8 @@ namespace TrenchBroom {
             void doVisit(Model::GroupNode*) override   {}
             void doVisit(Model::EntityNode*) override {}
             void doVisit(Model::BrushNode* brushNode) override   {
-                const Model::Brush& brush = brushNode->brush();
-                for (size_t i = 0u; i < brush.faceCount(); ++i) {
+                const auto faceCount = brushNode->faces().size();
+                for (size_t i = 0u; i < faceCount; ++i) {
                     brushNode->setFaceTexture(i, nullptr);
                 }
             }
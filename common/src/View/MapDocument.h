@@ -393,7 +393,11 @@ namespace TrenchBroom {
         public: // CSG operations, declared in MapFacade interface
             bool createBrush(const std::vector<vm::vec3>& points);
             bool csgConvexMerge();
-            bool csgSubtract();
+            /**
+             * Subtracts the selected brushes from all brushes touching them. If mergeFragments is true, fragments of the
+             * same minuend whose union is convex are replaced by a single brush.
+             */
+            bool csgSubtract(bool mergeFragments = false);
             bool csgIntersect();
             bool csgHollow();
         public: // Clipping operations, declared in MapFacade interface
@@ -467,6 +471,11 @@ namespace TrenchBroom {
             virtual std::unique_ptr<CommandResult> doExecuteAndStore(std::unique_ptr<UndoableCommand>&& command) = 0;
         public: // asset state management
             void commitPendingAssets();
+            /**
+             * Indicates whether commitPendingAssets() has work left, e.g. textures that were not uploaded yet because
+             * the upload budget was exhausted.
+             */
+            bool hasPendingAssets() const;
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
             std::vector<Model::Node*> findNodesContaining(const vm::vec3& point) const;
@@ -239,11 +239,14 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
 
             std::vector<Model::Node*> addedNodes;
-            for (const auto& entry : nodes) {
-                Model::Node* parent = entry.first;
-                const std::vector<Model::Node*>& children = entry.second;
-                parent->addChildren(children);
-                kdl::vec_append(addedNodes, children);
+            {
+                Model::WorldNode::DeferNodeTreeUpdates deferNodeTreeUpdates(m_world.get());
+                for (const auto& entry : nodes) {
+                    Model::Node* parent = entry.first;
+                    const std::vector<Model::Node*>& children = entry.second;
+                    parent->addChildren(children);
+                    kdl::vec_append(addedNodes, children);
+                }
             }
 
             setEntityDefinitions(addedNodes);
@@ -261,13 +264,16 @@ namespace TrenchBroom {
             const std::vector<Model::Node*> allChildren = collectChildren(nodes);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyChildren(nodesWillBeRemovedNotifier, nodesWereRemovedNotifier, allChildren);
 
-            for (const auto& entry : nodes) {
-                Model::Node* parent = entry.first;
-                const std::vector<Model::Node*>& children = entry.second;
-                unsetEntityModels(children);
-                unsetEntityDefinitions(children);
-                unsetTextures(children);
-                parent->removeChildren(std::begin(children), std::end(children));
+            {
+                Model::WorldNode::DeferNodeTreeUpdates deferNodeTreeUpdates(m_world.get());
+                for (const auto& entry : nodes) {
+                    Model::Node* parent = entry.first;
+                    const std::vector<Model::Node*>& children = entry.second;
+                    unsetEntityModels(children);
+                    unsetEntityDefinitions(children);
+                    unsetTextures(children);
+                    parent->removeChildren(std::begin(children), std::end(children));
+                }
             }
 
             invalidateSelectionBounds();
@@ -779,6 +785,29 @@ namespace TrenchBroom {
             return true;
         }
 
+        /**
+         * Moves the given handles of each of the given brushes by applying the given function to a copy of each brush
+         * and setting the moved copy on the brush node.
+         *
+         * Unlike the validation of the move, this cannot run concurrently: moving a brush copies and destroys brush
+         * faces, which updates the usage counts of their textures and notifies the texture browser.
+         *
+         * @return the new handle positions, sorted and without duplicates
+         */
+        template <typename H, typename M>
+        static std::vector<H> moveBrushHandles(const std::map<Model::BrushNode*, std::vector<H>>& brushHandles, const M& move) {
+            std::vector<H> result;
+            for (const auto& entry : brushHandles) {
+                Model::BrushNode* brushNode = entry.first;
+                Model::Brush brush = brushNode->brush();
+                kdl::vec_append(result, move(brush, entry.second));
+                brushNode->setBrush(std::move(brush));
+            }
+
+            kdl::vec_sort_and_remove_duplicates(result);
+            return result;
+        }
+
         std::vector<vm::vec3> MapDocumentCommandFacade::performMoveVertices(const std::map<Model::BrushNode*, std::vector<vm::vec3>>& vertices, const vm::vec3& delta) {
             const std::vector<Model::Node*>& nodes = m_selectedNodes.nodes();
             const std::vector<Model::Node*> parents = collectParents(nodes);
@@ -786,20 +815,13 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
-            std::vector<vm::vec3> newVertexPositions;
-            for (const auto& entry : vertices) {
-                Model::BrushNode* brushNode = entry.first;
-                Model::Brush brush = brushNode->brush();
-                const std::vector<vm::vec3>& oldPositions = entry.second;
-                const std::vector<vm::vec3> newPositions = brush.moveVertices(m_worldBounds, oldPositions, delta, pref(Preferences::UVLock));
-                kdl::vec_append(newVertexPositions, newPositions);
-                brushNode->setBrush(std::move(brush));
-            }
+            const bool uvLock = pref(Preferences::UVLock);
+            auto newPositions = moveBrushHandles(vertices, [&](Model::Brush& brush, const std::vector<vm::vec3>& oldPositions) {
+                return brush.moveVertices(m_worldBounds, oldPositions, delta, uvLock);
+            });
 
             invalidateSelectionBounds();
-
-            kdl::vec_sort_and_remove_duplicates(newVertexPositions);
-            return newVertexPositions;
+            return newPositions;
         }
 
         std::vector<vm::segment3> MapDocumentCommandFacade::performMoveEdges(const std::map<Model::BrushNode*, std::vector<vm::segment3>>& edges, const vm::vec3& delta) {
@@ -809,20 +831,13 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
-            std::vector<vm::segment3> newEdgePositions;
-            for (const auto& entry : edges) {
-                Model::BrushNode* brushNode = entry.first;
-                Model::Brush brush = brushNode->brush();
-                const std::vector<vm::segment3>& oldPositions = entry.second;
-                const std::vector<vm::segment3> newPositions = brush.moveEdges(m_worldBounds, oldPositions, delta, pref(Preferences::UVLock));
-                brushNode->setBrush(brush);
-                kdl::vec_append(newEdgePositions, newPositions);
-            }
+            const bool uvLock = pref(Preferences::UVLock);
+            auto newPositions = moveBrushHandles(edges, [&](Model::Brush& brush, const std::vector<vm::segment3>& oldPositions) {
+                return brush.moveEdges(m_worldBounds, oldPositions, delta, uvLock);
+            });
 
             invalidateSelectionBounds();
-
-            kdl::vec_sort_and_remove_duplicates(newEdgePositions);
-            return newEdgePositions;
+            return newPositions;
         }
 
         std::vector<vm::polygon3> MapDocumentCommandFacade::performMoveFaces(const std::map<Model::BrushNode*, std::vector<vm::polygon3>>& faces, const vm::vec3& delta) {
@@ -832,20 +847,13 @@ namespace TrenchBroom {
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
-            std::vector<vm::polygon3> newFacePositions;
-            for (const auto& entry : faces) {
-                Model::BrushNode* brushNode = entry.first;
-                Model::Brush brush = brushNode->brush();
-                const std::vector<vm::polygon3>& oldPositions = entry.second;
-                const std::vector<vm::polygon3> newPositions = brush.moveFaces(m_worldBounds, oldPositions, delta, pref(Preferences::UVLock));
-                brushNode->setBrush(std::move(brush));
-                kdl::vec_append(newFacePositions, newPositions);
-            }
+            const bool uvLock = pref(Preferences::UVLock);
+            auto newPositions = moveBrushHandles(faces, [&](Model::Brush& brush, const std::vector<vm::polygon3>& oldPositions) {
+                return brush.moveFaces(m_worldBounds, oldPositions, delta, uvLock);
+            });
 
             invalidateSelectionBounds();
-
-            kdl::vec_sort_and_remove_duplicates(newFacePositions);
-            return newFacePositions;
+            return newPositions;
         }
 
         void MapDocumentCommandFacade::performAddVertices(const std::map<vm::vec3, std::vector<Model::BrushNode*>>& vertices) {
@@ -1038,11 +1046,18 @@ namespace TrenchBroom {
         }
 
         void MapDocumentCommandFacade::doStartTransaction(const std::string& name) {
+            // node tree updates are collected while the transaction runs and applied in one pass when it is committed
+            if (m_world != nullptr) {
+                m_world->beginDeferredNodeTreeUpdates();
+            }
             m_commandProcessor->startTransaction(name);
         }
 
         void MapDocumentCommandFacade::doCommitTransaction() {
             m_commandProcessor->commitTransaction();
+            if (m_world != nullptr) {
+                m_world->endDeferredNodeTreeUpdates();
+            }
         }
 
         void MapDocumentCommandFacade::doRollbackTransaction() {
@@ -39,6 +39,7 @@
 #include "Model/Node.h"
 #include "View/Actions.h"
 #include "View/Autosaver.h"
+#include "View/BrushGeometryReleaser.h"
 #if !defined __APPLE__
 #include "View/BorderLine.h"
 #endif
@@ -105,6 +106,8 @@ namespace TrenchBroom {
         m_lastInputTime(std::chrono::system_clock::now()),
         m_autosaver(std::make_unique<Autosaver>(m_document)),
         m_autosaveTimer(nullptr),
+        m_brushGeometryReleaser(std::make_unique<BrushGeometryReleaser>(m_document)),
+        m_brushGeometryReleaseTimer(nullptr),
         m_toolBar(nullptr),
         m_hSplitter(nullptr),
         m_vSplitter(nullptr),
@@ -144,6 +147,9 @@ namespace TrenchBroom {
             m_autosaveTimer = new QTimer(this);
             m_autosaveTimer->start(1000);
 
+            m_brushGeometryReleaseTimer = new QTimer(this);
+            m_brushGeometryReleaseTimer->start(1000);
+
             bindObservers();
             bindEvents();
 
@@ -678,6 +684,7 @@ namespace TrenchBroom {
 
         void MapFrame::bindEvents() {
             connect(m_autosaveTimer, &QTimer::timeout, this, &MapFrame::triggerAutosave);
+            connect(m_brushGeometryReleaseTimer, &QTimer::timeout, this, &MapFrame::triggerBrushGeometryRelease);
             connect(qApp, &QApplication::focusChanged, this, &MapFrame::focusChange);
             connect(m_gridChoice, QOverload<int>::of(&QComboBox::activated), this, [this](const int index) { setGridSize(index + Grid::MinSize); });
             connect(QApplication::clipboard(), &QClipboard::dataChanged, this, [this]() {
@@ -1321,6 +1328,12 @@ namespace TrenchBroom {
             }
         }
 
+        void MapFrame::csgSubtractAndMergeFragments() {
+            if (canDoCsgSubtract()) {
+                m_document->csgSubtract(true);
+            }
+        }
+
         bool MapFrame::canDoCsgSubtract() const {
             return m_document->selectedNodes().hasOnlyBrushes() && m_document->selectedNodes().brushCount() >= 1;
         }
@@ -1727,6 +1740,12 @@ namespace TrenchBroom {
             }
         }
 
+        void MapFrame::triggerBrushGeometryRelease() {
+            if (pref(Preferences::ReleaseHiddenBrushGeometry)) {
+                m_brushGeometryReleaser->triggerRelease();
+            }
+        }
+
         // DebugPaletteWindow
 
         DebugPaletteWindow::DebugPaletteWindow(QWidget *parent)
@@ -59,6 +59,7 @@ namespace TrenchBroom {
     namespace View {
         class Action;
         class Autosaver;
+        class BrushGeometryReleaser;
         class Console;
         class FrameManager;
         class GLContextManager;
@@ -80,6 +81,8 @@ namespace TrenchBroom {
             std::chrono::time_point<std::chrono::system_clock> m_lastInputTime;
             std::unique_ptr<Autosaver> m_autosaver;
             QTimer* m_autosaveTimer;
+            std::unique_ptr<BrushGeometryReleaser> m_brushGeometryReleaser;
+            QTimer* m_brushGeometryReleaseTimer;
 
             QToolBar* m_toolBar;
 
@@ -275,6 +278,7 @@ namespace TrenchBroom {
             bool canDoCsgConvexMerge() const;
 
             void csgSubtract();
+            void csgSubtractAndMergeFragments();
             bool canDoCsgSubtract() const;
 
             void csgHollow();
@@ -366,6 +370,7 @@ namespace TrenchBroom {
             bool eventFilter(QObject* target, QEvent* event) override;
         private:
             void triggerAutosave();
+            void triggerBrushGeometryRelease();
         };
 
         class DebugPaletteWindow : public QDialog {
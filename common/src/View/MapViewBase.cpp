@@ -893,6 +893,11 @@ namespace TrenchBroom {
             renderFPS(renderContext, renderBatch);
 
             renderBatch.render(renderContext);
+
+            // textures are uploaded over several frames
+            if (document->hasPendingAssets()) {
+                update();
+            }
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
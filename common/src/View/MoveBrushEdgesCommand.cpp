@@ -55,15 +55,9 @@ namespace TrenchBroom {
 
         bool MoveBrushEdgesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const vm::bbox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_edges) {
-                const Model::BrushNode* brushNode = entry.first;
-                const std::vector<vm::segment3>& edges = entry.second;
-                const Model::Brush& brush = brushNode->brush();
-                if (!brush.canMoveEdges(worldBounds, edges, m_delta)) {
-                    return false;
-                }
-            }
-            return true;
+            return allBrushes(m_edges, [&](const Model::Brush& brush, const std::vector<vm::segment3>& handles) {
+                return brush.canMoveEdges(worldBounds, handles, m_delta);
+            });
         }
 
         bool MoveBrushEdgesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -71,17 +65,17 @@ namespace TrenchBroom {
             return true;
         }
 
-        bool MoveBrushEdgesCommand::doCollateWith(UndoableCommand* command) {
-            MoveBrushEdgesCommand* other = static_cast<MoveBrushEdgesCommand*>(command);
-
-            if (!canCollateWith(*other)) {
-                return false;
-            }
+        bool MoveBrushEdgesCommand::doWillCollateWith(const UndoableCommand& command) const {
+            const auto& other = static_cast<const MoveBrushEdgesCommand&>(command);
+            return canCollateWith(other) && m_newEdgePositions == other.m_oldEdgePositions;
+        }
 
-            if (m_newEdgePositions != other->m_oldEdgePositions) {
+        bool MoveBrushEdgesCommand::doCollateWith(UndoableCommand* command) {
+            if (!doWillCollateWith(*command)) {
                 return false;
             }
 
+            MoveBrushEdgesCommand* other = static_cast<MoveBrushEdgesCommand*>(command);
             m_newEdgePositions = other->m_newEdgePositions;
             m_delta = m_delta + other->m_delta;
 
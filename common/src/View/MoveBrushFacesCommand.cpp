@@ -54,15 +54,9 @@ namespace TrenchBroom {
 
         bool MoveBrushFacesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const vm::bbox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_faces) {
-                const Model::BrushNode* brushNode = entry.first;
-                const Model::Brush& brush = brushNode->brush();
-                const std::vector<vm::polygon3>& faces = entry.second;
-                if (!brush.canMoveFaces(worldBounds, faces, m_delta)) {
-                    return false;
-                }
-            }
-            return true;
+            return allBrushes(m_faces, [&](const Model::Brush& brush, const std::vector<vm::polygon3>& handles) {
+                return brush.canMoveFaces(worldBounds, handles, m_delta);
+            });
         }
 
         bool MoveBrushFacesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -70,17 +64,17 @@ namespace TrenchBroom {
             return true;
         }
 
-        bool MoveBrushFacesCommand::doCollateWith(UndoableCommand* command) {
-            MoveBrushFacesCommand* other = static_cast<MoveBrushFacesCommand*>(command);
-
-            if (!canCollateWith(*other)) {
-                return false;
-            }
+        bool MoveBrushFacesCommand::doWillCollateWith(const UndoableCommand& command) const {
+            const auto& other = static_cast<const MoveBrushFacesCommand&>(command);
+            return canCollateWith(other) && m_newFacePositions == other.m_oldFacePositions;
+        }
 
-            if (m_newFacePositions != other->m_oldFacePositions) {
+        bool MoveBrushFacesCommand::doCollateWith(UndoableCommand* command) {
+            if (!doWillCollateWith(*command)) {
                 return false;
             }
 
+            MoveBrushFacesCommand* other = static_cast<MoveBrushFacesCommand*>(command);
             m_newFacePositions = other->m_newFacePositions;
             m_delta = m_delta + other->m_delta;
 
@@ -45,6 +45,7 @@ namespace TrenchBroom {
             bool doCanDoVertexOperation(const MapDocument* document) const override;
             bool doVertexOperation(MapDocumentCommandFacade* document) override;
 
+            bool doWillCollateWith(const UndoableCommand& command) const override;
             bool doCollateWith(UndoableCommand* command) override;
 
             void doSelectNewHandlePositions(VertexHandleManagerBaseT<vm::polygon3>& manager) const override;
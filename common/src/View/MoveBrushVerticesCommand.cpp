@@ -61,15 +61,9 @@ namespace TrenchBroom {
 
         bool MoveBrushVerticesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const vm::bbox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_vertices) {
-                const Model::BrushNode* brushNode = entry.first;
-                const Model::Brush& brush = brushNode->brush();
-                const std::vector<vm::vec3>& vertices = entry.second;
-                if (!brush.canMoveVertices(worldBounds, vertices, m_delta)) {
-                    return false;
-                }
-            }
-            return true;
+            return allBrushes(m_vertices, [&](const Model::Brush& brush, const std::vector<vm::vec3>& handles) {
+                return brush.canMoveVertices(worldBounds, handles, m_delta);
+            });
         }
 
         bool MoveBrushVerticesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -81,17 +75,17 @@ namespace TrenchBroom {
             return std::make_unique<MoveBrushVerticesCommandResult>(success, !m_newVertexPositions.empty());
         }
 
-        bool MoveBrushVerticesCommand::doCollateWith(UndoableCommand* command) {
-            MoveBrushVerticesCommand* other = static_cast<MoveBrushVerticesCommand*>(command);
-
-            if (!canCollateWith(*other)) {
-                return false;
-            }
+        bool MoveBrushVerticesCommand::doWillCollateWith(const UndoableCommand& command) const {
+            const auto& other = static_cast<const MoveBrushVerticesCommand&>(command);
+            return canCollateWith(other) && m_newVertexPositions == other.m_oldVertexPositions;
+        }
 
-            if (m_newVertexPositions != other->m_oldVertexPositions) {
+        bool MoveBrushVerticesCommand::doCollateWith(UndoableCommand* command) {
+            if (!doWillCollateWith(*command)) {
                 return false;
             }
 
+            MoveBrushVerticesCommand* other = static_cast<MoveBrushVerticesCommand*>(command);
             m_newVertexPositions = other->m_newVertexPositions;
             m_delta = m_delta + other->m_delta;
 
@@ -54,6 +54,7 @@ namespace TrenchBroom {
             bool doVertexOperation(MapDocumentCommandFacade* document) override;
             std::unique_ptr<CommandResult> doCreateCommandResult(bool success) override;
 
+            bool doWillCollateWith(const UndoableCommand& command) const override;
             bool doCollateWith(UndoableCommand* command) override;
 
             void doSelectNewHandlePositions(VertexHandleManagerBaseT<vm::vec3>& manager) const override;
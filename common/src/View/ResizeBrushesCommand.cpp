@@ -48,15 +48,20 @@ namespace TrenchBroom {
             return false;
         }
 
+        bool ResizeBrushesCommand::doWillCollateWith(const UndoableCommand& command) const {
+            const auto& other = static_cast<const ResizeBrushesCommand&>(command);
+            return other.m_faces == m_newFaces;
+        }
+
         bool ResizeBrushesCommand::doCollateWith(UndoableCommand* command) {
-            ResizeBrushesCommand* other = static_cast<ResizeBrushesCommand*>(command);
-            if (other->m_faces == m_newFaces) {
-                m_newFaces = other->m_newFaces;
-                m_delta = m_delta + other->m_delta;
-                return true;
-            } else {
+            if (!doWillCollateWith(*command)) {
                 return false;
             }
+
+            ResizeBrushesCommand* other = static_cast<ResizeBrushesCommand*>(command);
+            m_newFaces = other->m_newFaces;
+            m_delta = m_delta + other->m_delta;
+            return true;
         }
     }
 }
@@ -48,6 +48,7 @@ namespace TrenchBroom {
 
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
+            bool doWillCollateWith(const UndoableCommand& command) const override;
             bool doCollateWith(UndoableCommand* command) override;
 
             deleteCopyAndMove(ResizeBrushesCommand)
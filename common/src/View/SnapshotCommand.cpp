@@ -41,6 +41,11 @@ namespace TrenchBroom {
             return result;
         }
 
+        std::unique_ptr<CommandResult> SnapshotCommand::performCollatedDo(MapDocumentCommandFacade* document) {
+            // the preceding command's snapshot already contains the state to restore when undoing this command
+            return DocumentCommand::performDo(document);
+        }
+
         std::unique_ptr<CommandResult> SnapshotCommand::doPerformUndo(MapDocumentCommandFacade *document) {
             return restoreSnapshot(document);
         }
@@ -40,6 +40,7 @@ namespace TrenchBroom {
             ~SnapshotCommand();
         public:
             std::unique_ptr<CommandResult> performDo(MapDocumentCommandFacade* document) override;
+            std::unique_ptr<CommandResult> performCollatedDo(MapDocumentCommandFacade* document) override;
             std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) override;
         private:
             void takeSnapshot(MapDocumentCommandFacade* document);
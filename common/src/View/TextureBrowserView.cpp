@@ -44,7 +44,9 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 
+#include <algorithm>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <QTextStream>
@@ -63,7 +65,9 @@ namespace TrenchBroom {
         m_group(false),
         m_hideUnused(false),
         m_sortOrder(TextureSortOrder::Name),
-        m_selectedTexture(nullptr) {
+        m_selectedTexture(nullptr),
+        m_titleMetricsFont(IO::Path(), 0),
+        m_titleMetricsCellWidth(0.0f) {
             auto doc = kdl::mem_lock(m_document);
             doc->textureManager().usageCountDidChange.addObserver(this, &TextureBrowserView::usageCountDidChange);
         }
@@ -155,33 +159,31 @@ namespace TrenchBroom {
 
             const Renderer::FontDescriptor font(fontPath, static_cast<size_t>(fontSize));
 
+            // Titles are single lines, so their height does not depend on the text. The titles are only measured when
+            // their cells become visible, see collectStringVertices.
+            const auto titleHeight = 2.0f * fontManager().font(font).measure("").y() + 4.0f;
+
+            // The filter is matched against all textures at once and then applied to every collection.
+            const auto matchingTextures = m_filterText.empty() ? std::unordered_set<const Assets::Texture*>() : findTexturesMatchingFilter();
+
             if (m_group) {
                 for (const Assets::TextureCollection* collection : getCollections()) {
                     layout.addGroup(collection->name(), static_cast<float>(fontSize) + 2.0f);
-                    for (Assets::Texture* texture : getTextures(collection))
-                        addTextureToLayout(layout, texture, font);
+                    for (Assets::Texture* texture : getTextures(collection, matchingTextures))
+                        addTextureToLayout(layout, texture, titleHeight);
                 }
             } else {
-                for (Assets::Texture* texture : getTextures())
-                    addTextureToLayout(layout, texture, font);
+                for (Assets::Texture* texture : getTextures(matchingTextures))
+                    addTextureToLayout(layout, texture, titleHeight);
             }
         }
 
-        void TextureBrowserView::addTextureToLayout(Layout& layout, Assets::Texture* texture, const Renderer::FontDescriptor& font) {
+        void TextureBrowserView::addTextureToLayout(Layout& layout, Assets::Texture* texture, const float titleHeight) {
             const float maxCellWidth = layout.maxCellWidth();
 
             const auto& groupName   = texture->collection()->name();
             const auto  textureName = IO::Path(texture->name()).lastComponent().asString();
 
-            const auto textureFont = fontManager().selectFontSize(font, textureName, maxCellWidth, 6);
-            const auto groupFont   = fontManager().selectFontSize(font, groupName, maxCellWidth, 6);
-
-            const auto defaultTextHeight = fontManager().font(font).measure(groupName + textureName).y();
-            const auto textureNameSize   = fontManager().font(textureFont).measure(textureName);
-            const auto groupNameSize     = fontManager().font(groupFont).measure(groupName);
-
-            const auto totalSize = vm::vec2f(vm::max(groupNameSize.x(), textureNameSize.x()), 2.0f * defaultTextHeight + 4.0f);
-
             const float scaleFactor = pref(Preferences::TextureBrowserIconSize);
             const float scaledTextureWidth = vm::round(scaleFactor * static_cast<float>(texture->width()));
             const float scaledTextureHeight = vm::round(scaleFactor * static_cast<float>(texture->height()));
@@ -189,18 +191,14 @@ namespace TrenchBroom {
             auto cellData = std::shared_ptr<TextureCellData>(new TextureCellData{
                 texture,
                 textureName,
-                groupName,
-                vm::vec2f((maxCellWidth - textureNameSize.x()) / 2.0f, defaultTextHeight + 3.0f),
-                vm::vec2f((maxCellWidth - groupNameSize.x()) / 2.0f, 1.0f),
-                textureFont,
-                groupFont
+                groupName
             });
 
             layout.addItem(QVariant::fromValue(cellData),
             scaledTextureWidth,
             scaledTextureHeight,
             maxCellWidth,
-            totalSize.y());
+            titleHeight);
         }
 
         struct TextureBrowserView::CompareByUsageCount {
@@ -233,16 +231,6 @@ namespace TrenchBroom {
             }
         };
 
-        struct TextureBrowserView::MatchName {
-            std::string pattern;
-
-            explicit MatchName(const std::string& i_pattern) : pattern(i_pattern) {}
-
-            bool operator()(const Assets::Texture* texture) const {
-                return !kdl::ci::str_contains(texture->name(), pattern);
-            }
-        };
-
         std::vector<Assets::TextureCollection*> TextureBrowserView::getCollections() const {
             auto doc = kdl::mem_lock(m_document);
             std::vector<Assets::TextureCollection*> collections = doc->textureManager().collections();
@@ -255,26 +243,27 @@ namespace TrenchBroom {
             return collections;
         }
 
-        std::vector<Assets::Texture*> TextureBrowserView::getTextures(const Assets::TextureCollection* collection) const {
+        std::vector<Assets::Texture*> TextureBrowserView::getTextures(const Assets::TextureCollection* collection, const std::unordered_set<const Assets::Texture*>& matchingTextures) {
             std::vector<Assets::Texture*> textures = collection->textures();
-            filterTextures(textures);
+            filterTextures(textures, matchingTextures);
             sortTextures(textures);
             return textures;
         }
 
-        std::vector<Assets::Texture*> TextureBrowserView::getTextures() const {
+        std::vector<Assets::Texture*> TextureBrowserView::getTextures(const std::unordered_set<const Assets::Texture*>& matchingTextures) {
             auto doc = kdl::mem_lock(m_document);
             std::vector<Assets::Texture*> textures = doc->textureManager().textures();
-            filterTextures(textures);
+            filterTextures(textures, matchingTextures);
             sortTextures(textures);
             return textures;
         }
 
-        void TextureBrowserView::filterTextures(std::vector<Assets::Texture*>& textures) const {
+        void TextureBrowserView::filterTextures(std::vector<Assets::Texture*>& textures, const std::unordered_set<const Assets::Texture*>& matchingTextures) {
             if (m_hideUnused)
                 kdl::vec_erase_if(textures, MatchUsageCount());
-            if (!m_filterText.empty())
-                kdl::vec_erase_if(textures, MatchName(m_filterText));
+            if (!m_filterText.empty()) {
+                kdl::vec_erase_if(textures, [&](const Assets::Texture* texture) { return matchingTextures.count(texture) == 0u; });
+            }
         }
 
         void TextureBrowserView::sortTextures(std::vector<Assets::Texture*>& textures) const {
@@ -288,6 +277,22 @@ namespace TrenchBroom {
             }
         }
 
+        std::unordered_set<const Assets::Texture*> TextureBrowserView::findTexturesMatchingFilter() {
+            auto doc = kdl::mem_lock(m_document);
+            const auto& textures = doc->textureManager().textures();
+
+            if (!std::equal(std::begin(textures), std::end(textures), std::begin(m_indexedTextures), std::end(m_indexedTextures))) {
+                m_indexedTextures = std::vector<const Assets::Texture*>(std::begin(textures), std::end(textures));
+                m_nameIndex = TextureNameIndex(kdl::vec_transform(m_indexedTextures, [](const auto* texture) { return texture->name(); }));
+            }
+
+            std::unordered_set<const Assets::Texture*> result;
+            for (const auto i : m_nameIndex.find(m_filterText)) {
+                result.insert(m_indexedTextures[i]);
+            }
+            return result;
+        }
+
         void TextureBrowserView::doClear() {}
 
         void TextureBrowserView::doRender(Layout& layout, const float y, const float height) {
@@ -309,6 +314,11 @@ namespace TrenchBroom {
             renderBounds(layout, y, height);
             renderTextures(layout, y, height);
             renderNames(layout, y, height);
+
+            // textures are uploaded over several frames
+            if (doc->textureManager().hasPendingUploads()) {
+                update();
+            }
         }
 
         bool TextureBrowserView::doShouldRenderFocusIndicator() const {
@@ -383,7 +393,10 @@ namespace TrenchBroom {
                                     TextureVertex(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f))
                                 }));
 
+                                // textures are uploaded over several frames, so show the average color until this one is ready
                                 shader.set("GrayScale", texture->overridden());
+                                shader.set("ApplyTexture", texture->isPrepared());
+                                shader.set("Color", texture->averageColor());
                                 texture->activate();
 
                                 vertexArray.prepare(vboManager());
@@ -457,6 +470,9 @@ namespace TrenchBroom {
             Renderer::FontDescriptor defaultDescriptor(pref(Preferences::RendererFontPath()),
                                                        static_cast<size_t>(pref(Preferences::BrowserFontSize)));
 
+            const auto cellWidth = layout.maxCellWidth();
+            const auto defaultTextHeight = fontManager().font(defaultDescriptor).measure("").y();
+
             const std::vector<Color> textColor{ pref(Preferences::BrowserTextColor) };
             const std::vector<Color> subTextColor{ pref(Preferences::BrowserSubTextColor) };
 
@@ -470,7 +486,7 @@ namespace TrenchBroom {
                         const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
 
                         auto& font = fontManager().font(defaultDescriptor);
-                        const auto quads = font.quads(title, false, offset);
+                        const auto quads = font.layout(title, false)->translatedVertices(offset);
                         const auto titleVertices = TextVertex::toList(
                             quads.size() / 2,
                             kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
@@ -486,20 +502,23 @@ namespace TrenchBroom {
                             for (unsigned int k = 0; k < row.size(); k++) {
                                 const auto& cell = row[k];
                                 const auto titleBounds = cell.titleBounds();
-                                const auto& textureFont = fontManager().font(cellData(cell).mainTitleFont);
-                                const auto& groupFont   = fontManager().font(cellData(cell).subTitleFont);
+                                const auto& textureName = cellData(cell).mainTitle;
+                                const auto& groupName   = cellData(cell).subTitle;
+
+                                const auto textureNameMetrics = titleMetrics(textureName, defaultDescriptor, cellWidth);
+                                const auto groupNameMetrics   = titleMetrics(groupName, defaultDescriptor, cellWidth);
+
+                                const auto& textureFont = fontManager().font(textureNameMetrics.font);
+                                const auto& groupFont   = fontManager().font(groupNameMetrics.font);
 
                                 // y is relative to top, but OpenGL coords are relative to bottom, so invert
                                 const auto titleOffset = vm::vec2f(titleBounds.left(), y + height - titleBounds.bottom());
 
-                                const auto textureNameOffset = titleOffset + cellData(cell).mainTitleOffset;
-                                const auto groupNameOffset   = titleOffset + cellData(cell).subTitleOffset;
+                                const auto textureNameOffset = titleOffset + vm::vec2f((cellWidth - textureNameMetrics.width) / 2.0f, defaultTextHeight + 3.0f);
+                                const auto groupNameOffset   = titleOffset + vm::vec2f((cellWidth - groupNameMetrics.width) / 2.0f, 1.0f);
 
-                                const auto& textureName = cellData(cell).mainTitle;
-                                const auto& groupName   = cellData(cell).subTitle;
-
-                                const auto textureNameQuads = textureFont.quads(textureName, false, textureNameOffset);
-                                const auto groupNameQuads   = groupFont.quads(groupName, false, groupNameOffset);
+                                const auto textureNameQuads = textureFont.layout(textureName, false)->translatedVertices(textureNameOffset);
+                                const auto groupNameQuads   = groupFont.layout(groupName, false)->translatedVertices(groupNameOffset);
 
                                 const auto textureNameVertices = TextVertex::toList(
                                     textureNameQuads.size() / 2,
@@ -513,8 +532,8 @@ namespace TrenchBroom {
                                     kdl::skip_iterator(std::begin(groupNameQuads), std::end(groupNameQuads), 1, 2),
                                     kdl::skip_iterator(std::begin(subTextColor), std::end(subTextColor), 0, 0));
 
-                                kdl::vec_append(stringVertices[cellData(cell).mainTitleFont], textureNameVertices);
-                                kdl::vec_append(stringVertices[cellData(cell).subTitleFont], groupNameVertices);
+                                kdl::vec_append(stringVertices[textureNameMetrics.font], textureNameVertices);
+                                kdl::vec_append(stringVertices[groupNameMetrics.font], groupNameVertices);
                             }
                         }
                     }
@@ -524,6 +543,22 @@ namespace TrenchBroom {
             return stringVertices;
         }
 
+        const TextureBrowserView::TitleMetrics& TextureBrowserView::titleMetrics(const std::string& title, const Renderer::FontDescriptor& font, const float cellWidth) {
+            if (font.compare(m_titleMetricsFont) != 0 || cellWidth != m_titleMetricsCellWidth) {
+                m_titleMetrics.clear();
+                m_titleMetricsFont = font;
+                m_titleMetricsCellWidth = cellWidth;
+            }
+
+            auto it = m_titleMetrics.find(title);
+            if (it == std::end(m_titleMetrics)) {
+                const auto titleFont = fontManager().selectFontSize(font, title, cellWidth, 6);
+                const auto titleWidth = fontManager().font(titleFont).layout(title, false)->size.x();
+                it = m_titleMetrics.emplace(title, TitleMetrics{titleFont, titleWidth}).first;
+            }
+            return it->second;
+        }
+
         void TextureBrowserView::doLeftClick(Layout& layout, const float x, const float y) {
             const Cell* result = nullptr;
             if (layout.cellAt(x, y, &result)) {
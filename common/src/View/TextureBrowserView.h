@@ -23,10 +23,13 @@
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
 #include "View/CellView.h"
+#include "View/TextureNameIndex.h"
 
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class QScrollBar;
@@ -46,10 +49,6 @@ namespace TrenchBroom {
             Assets::Texture* texture;
             std::string mainTitle;
             std::string subTitle;
-            vm::vec2f mainTitleOffset;
-            vm::vec2f subTitleOffset;
-            Renderer::FontDescriptor mainTitleFont;
-            Renderer::FontDescriptor subTitleFont;
         };
 
         enum class TextureSortOrder {
@@ -70,6 +69,30 @@ namespace TrenchBroom {
             std::string m_filterText;
 
             Assets::Texture* m_selectedTexture;
+
+            /**
+             * The textures covered by the name index, in the order in which they were passed to it. The index is
+             * rebuilt if the texture manager's textures differ from these.
+             */
+            std::vector<const Assets::Texture*> m_indexedTextures;
+            TextureNameIndex m_nameIndex;
+
+            /**
+             * The font and the width of a cell title after shrinking the font to fit the cell.
+             */
+            struct TitleMetrics {
+                Renderer::FontDescriptor font;
+                float width;
+            };
+
+            /**
+             * Title metrics by title for the font and cell width stored alongside. Titles are only measured when
+             * their cells are rendered for the first time, and the cache is kept across layout reloads so that
+             * filtering and resizing do not measure any titles again.
+             */
+            std::unordered_map<std::string, TitleMetrics> m_titleMetrics;
+            Renderer::FontDescriptor m_titleMetricsFont;
+            float m_titleMetricsCellWidth;
         public:
             TextureBrowserView(QScrollBar* scrollBar,
                                GLContextManager& contextManager,
@@ -90,19 +113,19 @@ namespace TrenchBroom {
 
             void doInitLayout(Layout& layout) override;
             void doReloadLayout(Layout& layout) override;
-            void addTextureToLayout(Layout& layout, Assets::Texture* texture, const Renderer::FontDescriptor& font);
+            void addTextureToLayout(Layout& layout, Assets::Texture* texture, float titleHeight);
 
             struct CompareByUsageCount;
             struct CompareByName;
             struct MatchUsageCount;
-            struct MatchName;
 
             std::vector<Assets::TextureCollection*> getCollections() const;
-            std::vector<Assets::Texture*> getTextures(const Assets::TextureCollection* collection) const;
-            std::vector<Assets::Texture*> getTextures() const;
+            std::vector<Assets::Texture*> getTextures(const Assets::TextureCollection* collection, const std::unordered_set<const Assets::Texture*>& matchingTextures);
+            std::vector<Assets::Texture*> getTextures(const std::unordered_set<const Assets::Texture*>& matchingTextures);
 
-            void filterTextures(std::vector<Assets::Texture*>& textures) const;
+            void filterTextures(std::vector<Assets::Texture*>& textures, const std::unordered_set<const Assets::Texture*>& matchingTextures);
             void sortTextures(std::vector<Assets::Texture*>& textures) const;
+            std::unordered_set<const Assets::Texture*> findTexturesMatchingFilter();
 
             void doClear() override;
             void doRender(Layout& layout, float y, float height) override;
@@ -115,6 +138,7 @@ namespace TrenchBroom {
             void renderGroupTitleBackgrounds(Layout& layout, float y, float height);
             void renderStrings(Layout& layout, float y, float height);
             StringMap collectStringVertices(Layout& layout, float y, float height);
+            const TitleMetrics& titleMetrics(const std::string& title, const Renderer::FontDescriptor& font, float cellWidth);
 
             void doLeftClick(Layout& layout, float x, float y) override;
             QString tooltip(const Cell& cell) override;
@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureNameIndex.h"
+
+#include <kdl/string_format.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace View {
+        TextureNameIndex::TextureNameIndex() = default;
+
+        TextureNameIndex::TextureNameIndex(const std::vector<std::string>& names) {
+            m_names.reserve(names.size());
+            for (size_t i = 0u; i < names.size(); ++i) {
+                const auto& name = m_names.emplace_back(kdl::str_to_lower(names[i]));
+                for (size_t j = 0u; j + 3u <= name.size(); ++j) {
+                    auto& positions = m_trigrams[trigram(name, j)];
+                    // a name can contain the same trigram more than once
+                    if (positions.empty() || positions.back() != i) {
+                        positions.push_back(i);
+                    }
+                }
+            }
+        }
+
+        size_t TextureNameIndex::size() const {
+            return m_names.size();
+        }
+
+        std::vector<size_t> TextureNameIndex::find(const std::string& pattern) {
+            const auto lowerPattern = kdl::str_to_lower(pattern);
+
+            auto candidates = std::vector<size_t>();
+            if (!m_lastPattern.empty() && lowerPattern.find(m_lastPattern) != std::string::npos) {
+                candidates = std::move(m_lastMatches);
+            } else {
+                candidates = findCandidates(lowerPattern);
+            }
+
+            auto matches = std::vector<size_t>();
+            std::copy_if(std::begin(candidates), std::end(candidates), std::back_inserter(matches), [&](const size_t i) {
+                return m_names[i].find(lowerPattern) != std::string::npos;
+            });
+
+            m_lastPattern = lowerPattern;
+            m_lastMatches = matches;
+            return matches;
+        }
+
+        TextureNameIndex::Trigram TextureNameIndex::trigram(const std::string& str, const size_t pos) {
+            return static_cast<Trigram>(static_cast<unsigned char>(str[pos]))
+                 | static_cast<Trigram>(static_cast<unsigned char>(str[pos + 1u])) << 8u
+                 | static_cast<Trigram>(static_cast<unsigned char>(str[pos + 2u])) << 16u;
+        }
+
+        std::vector<size_t> TextureNameIndex::findCandidates(const std::string& pattern) const {
+            if (pattern.size() < 3u) {
+                auto result = std::vector<size_t>(m_names.size());
+                for (size_t i = 0u; i < result.size(); ++i) {
+                    result[i] = i;
+                }
+                return result;
+            }
+
+            auto postings = std::vector<const std::vector<size_t>*>();
+            for (size_t i = 0u; i + 3u <= pattern.size(); ++i) {
+                const auto it = m_trigrams.find(trigram(pattern, i));
+                if (it == std::end(m_trigrams)) {
+                    return {};
+                }
+                postings.push_back(&it->second);
+            }
+
+            // intersect the shortest lists first to keep the intermediate results small
+            std::sort(std::begin(postings), std::end(postings), [](const auto* lhs, const auto* rhs) {
+                return lhs->size() < rhs->size();
+            });
+
+            auto result = *postings.front();
+            for (size_t i = 1u; i < postings.size() && !result.empty(); ++i) {
+                auto intersection = std::vector<size_t>();
+                std::set_intersection(std::begin(result), std::end(result), std::begin(*postings[i]), std::end(*postings[i]), std::back_inserter(intersection));
+                result = std::move(intersection);
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TextureNameIndex
+#define TrenchBroom_TextureNameIndex
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Answers case insensitive substring queries over a fixed list of names without scanning every name.
+         *
+         * Every name is split into its trigrams (substrings of three characters), and for every trigram, the index
+         * records the names which contain it. A query for a pattern of at least three characters only considers the
+         * names which contain every trigram of the pattern, and only these candidates are checked exactly. Shorter
+         * patterns are answered by scanning the names.
+         *
+         * The result of the most recent query is remembered. If the next pattern contains the previous one, as is the
+         * case when the user types another character into a filter box, only the previous matches are checked.
+         */
+        class TextureNameIndex {
+        private:
+            using Trigram = uint32_t;
+
+            std::vector<std::string> m_names;
+            std::unordered_map<Trigram, std::vector<size_t>> m_trigrams;
+
+            std::string m_lastPattern;
+            std::vector<size_t> m_lastMatches;
+        public:
+            TextureNameIndex();
+            explicit TextureNameIndex(const std::vector<std::string>& names);
+
+            /**
+             * Returns the number of indexed names.
+             */
+            size_t size() const;
+
+            /**
+             * Returns the positions of the names which contain the given pattern, ignoring case, in ascending order.
+             * An empty pattern matches every name.
+             *
+             * @param pattern the pattern to search for
+             * @return the positions of the matching names in the list passed to the constructor
+             */
+            std::vector<size_t> find(const std::string& pattern);
+        private:
+            static Trigram trigram(const std::string& str, size_t pos);
+            std::vector<size_t> findCandidates(const std::string& pattern) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureNameIndex) */
@@ -79,16 +79,19 @@ namespace TrenchBroom {
             return std::make_unique<TransformObjectsCommand>(m_action, m_name, m_transform, m_lockTextures);
         }
 
+        bool TransformObjectsCommand::doWillCollateWith(const UndoableCommand& command) const {
+            const auto& other = static_cast<const TransformObjectsCommand&>(command);
+            return other.m_lockTextures == m_lockTextures && other.m_action == m_action;
+        }
+
         bool TransformObjectsCommand::doCollateWith(UndoableCommand* command) {
-            auto* other = static_cast<TransformObjectsCommand*>(command);
-            if (other->m_lockTextures != m_lockTextures) {
+            if (!doWillCollateWith(*command)) {
                 return false;
-            } else if (other->m_action != m_action) {
-                return false;
-            } else {
-                m_transform = m_transform * other->m_transform;
-                return true;
             }
+
+            auto* other = static_cast<TransformObjectsCommand*>(command);
+            m_transform = m_transform * other->m_transform;
+            return true;
         }
     }
 }
@@ -60,6 +60,7 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
             std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade* document) const override;
 
+            bool doWillCollateWith(const UndoableCommand& command) const override;
             bool doCollateWith(UndoableCommand* command) override;
 
             deleteCopyAndMove(TransformObjectsCommand)
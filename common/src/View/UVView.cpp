@@ -180,6 +180,10 @@ namespace TrenchBroom {
                 renderTextureAxes(renderContext, renderBatch);
 
                 renderBatch.render(renderContext);
+
+                if (document->hasPendingAssets()) {
+                    update();
+                }
             }
         }
 
@@ -255,7 +259,8 @@ namespace TrenchBroom {
                 texture->activate();
 
                 Renderer::ActiveShader shader(renderContext.shaderManager(), Renderer::Shaders::UVViewShader);
-                shader.set("ApplyTexture", true);
+                // textures are uploaded over several frames, so show the average color until this one is ready
+                shader.set("ApplyTexture", texture->isPrepared());
                 shader.set("Color", texture->averageColor());
                 shader.set("Brightness", pref(Preferences::Brightness));
                 shader.set("RenderGrid", true);
@@ -53,6 +53,17 @@ namespace TrenchBroom {
             return doRepeat(document);
         }
 
+        std::unique_ptr<CommandResult> UndoableCommand::performCollatedDo(MapDocumentCommandFacade* document) {
+            return performDo(document);
+        }
+
+        bool UndoableCommand::willCollateWith(const UndoableCommand& command) const {
+            assert(&command != this);
+            if (command.type() != m_type)
+                return false;
+            return doWillCollateWith(command);
+        }
+
         bool UndoableCommand::collateWith(UndoableCommand* command) {
             assert(command != this);
             if (command->type() != m_type)
@@ -64,6 +75,10 @@ namespace TrenchBroom {
             return false;
         }
 
+        bool UndoableCommand::doWillCollateWith(const UndoableCommand&) const {
+            return false;
+        }
+
         std::unique_ptr<UndoableCommand> UndoableCommand::doRepeat(MapDocumentCommandFacade*) const {
             throw CommandProcessorException("Command is not repeatable");
         }
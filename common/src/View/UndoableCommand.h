@@ -42,6 +42,21 @@ namespace TrenchBroom {
             bool isRepeatable(MapDocumentCommandFacade* document) const;
             std::unique_ptr<UndoableCommand> repeat(MapDocumentCommandFacade* document) const;
 
+            /**
+             * Executes this command without recording the information needed to undo it. This must only be called if
+             * `willCollateWith` returns true when the preceding command is passed this command, because this command
+             * will then be collated with its predecessor, which undoes the effects of both commands.
+             *
+             * By default, this just calls `performDo`.
+             */
+            virtual std::unique_ptr<CommandResult> performCollatedDo(MapDocumentCommandFacade* document);
+
+            /**
+             * Indicates whether this command will be collated with the given command once the given command was
+             * executed successfully. Unlike `collateWith`, this does not modify this command, and it can be called
+             * before the given command is executed.
+             */
+            bool willCollateWith(const UndoableCommand& command) const;
             virtual bool collateWith(UndoableCommand* command);
         private:
             virtual std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) = 0;
@@ -50,6 +65,7 @@ namespace TrenchBroom {
             virtual bool doIsRepeatable(MapDocumentCommandFacade* document) const = 0;
             virtual std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade* document) const;
 
+            virtual bool doWillCollateWith(const UndoableCommand& command) const;
             virtual bool doCollateWith(UndoableCommand* command) = 0;
         public: // this method is just a service for DocumentCommand and should never be called from anywhere else
             virtual size_t documentModificationCount() const;
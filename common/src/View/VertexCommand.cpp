@@ -27,6 +27,7 @@
 #include "View/MapDocumentCommandFacade.h"
 #include "View/VertexTool.h"
 
+#include <kdl/set_temp.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/polygon.h>
@@ -38,7 +39,8 @@ namespace TrenchBroom {
     namespace View {
         VertexCommand::VertexCommand(const CommandType type, const std::string& name, const std::vector<Model::BrushNode*>& brushes) :
         DocumentCommand(type, name),
-        m_brushes(brushes) {}
+        m_brushes(brushes),
+        m_skipSnapshot(false) {}
 
         VertexCommand::~VertexCommand() = default;
 
@@ -83,6 +85,12 @@ namespace TrenchBroom {
             return result;
         }
 
+        std::unique_ptr<CommandResult> VertexCommand::performCollatedDo(MapDocumentCommandFacade* document) {
+            // the preceding command's snapshot already contains the state to restore when undoing this command
+            const kdl::set_temp skipSnapshot(m_skipSnapshot);
+            return DocumentCommand::performDo(document);
+        }
+
         std::unique_ptr<CommandResult> VertexCommand::doPerformDo(MapDocumentCommandFacade* document) {
             if (m_snapshot != nullptr) {
                 restoreAndTakeNewSnapshot(document);
@@ -92,7 +100,9 @@ namespace TrenchBroom {
                     return doCreateCommandResult(false);
                 }
 
-                takeSnapshot();
+                if (!m_skipSnapshot) {
+                    takeSnapshot();
+                }
                 const auto success = doVertexOperation(document);
                 return doCreateCommandResult(success);
             }
@@ -22,12 +22,14 @@
 
 #include "FloatType.h"
 #include "Macros.h"
+#include "TaskScheduler.h"
 #include "Model/BrushGeometry.h"
 #include "View/DocumentCommand.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -36,6 +38,7 @@
 
 namespace TrenchBroom {
     namespace Model {
+        class Brush;
         class BrushNode;
         class Snapshot;
     }
@@ -57,6 +60,7 @@ namespace TrenchBroom {
         private:
             std::vector<Model::BrushNode*> m_brushes;
             std::unique_ptr<Model::Snapshot> m_snapshot;
+            bool m_skipSnapshot;
         protected:
             VertexCommand(CommandType type, const std::string& name, const std::vector<Model::BrushNode*>& brushes);
         public:
@@ -78,12 +82,48 @@ namespace TrenchBroom {
                 }
             }
 
+            /**
+             * Checks whether the given predicate holds for every brush and its handles in the given map. The brushes
+             * are checked concurrently, and once the predicate fails for one brush, the remaining brushes are skipped.
+             *
+             * The brushes are accessed on the calling thread before the check starts because accessing a brush may
+             * restore its released geometry, which must not happen on a worker thread.
+             *
+             * @tparam H the handle type
+             * @tparam P the predicate type, must be callable with a brush and its handles and safe to call
+             * concurrently
+             * @param brushToHandles the brushes and their handles
+             * @param predicate the predicate to check
+             * @return true if the predicate holds for every brush and false otherwise
+             */
+            template <typename H, typename P>
+            static bool allBrushes(const std::map<Model::BrushNode*, std::vector<H>>& brushToHandles, const P& predicate) {
+                std::vector<const Model::Brush*> brushes;
+                std::vector<const std::vector<H>*> handles;
+                brushes.reserve(brushToHandles.size());
+                handles.reserve(brushToHandles.size());
+                for (const auto& entry : brushToHandles) {
+                    brushes.push_back(&entry.first->brush());
+                    handles.push_back(&entry.second);
+                }
+
+                std::atomic<bool> result(true);
+                TaskScheduler::instance().parallelFor(brushes.size(), [&](const std::size_t i) {
+                    if (result && !predicate(*brushes[i], *handles[i])) {
+                        result = false;
+                    }
+                });
+                return result;
+            }
+
             static void extractVertexMap(const VertexToBrushesMap& vertices, std::vector<Model::BrushNode*>& brushes, BrushVerticesMap& brushVertices, std::vector<vm::vec3>& vertexPositions);
             static void extractEdgeMap(const EdgeToBrushesMap& edges, std::vector<Model::BrushNode*>& brushes, BrushEdgesMap& brushEdges, std::vector<vm::segment3>& edgePositions);
             static void extractFaceMap(const FaceToBrushesMap& faces, std::vector<Model::BrushNode*>& brushes, BrushFacesMap& brushFaces, std::vector<vm::polygon3>& facePositions);
 
             static BrushVerticesMap brushVertexMap(const BrushEdgesMap& edges);
             static BrushVerticesMap brushVertexMap(const BrushFacesMap& faces);
+        public:
+            std::unique_ptr<CommandResult> performCollatedDo(MapDocumentCommandFacade* document) override;
         private:
             std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
             std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade* document) override;
@@ -116,6 +116,12 @@ namespace TrenchBroom {
             m_showAxes = new QCheckBox();
             m_showAxes->setToolTip("Toggle showing the coordinate system axes in the 3D editing view.");
 
+            m_releaseHiddenBrushGeometry = new QCheckBox();
+            m_releaseHiddenBrushGeometry->setToolTip("Release the geometry of brushes in layers that have been hidden for a minute to save memory. The geometry is rebuilt when the brushes are needed again.");
+
+            m_occlusionCulling = new QCheckBox();
+            m_occlusionCulling->setToolTip("Skip rendering brushes that are hidden behind large brushes close to the camera in the 3D editing view.");
+
             m_textureModeCombo = new QComboBox();
             m_textureModeCombo->setToolTip("Sets the texture filtering mode in the editing views.");
             for (const auto& textureMode : TextureModes) {
@@ -160,6 +166,8 @@ namespace TrenchBroom {
             layout->addRow("Grid", m_gridAlphaSlider);
             layout->addRow("FOV", m_fovSlider);
             layout->addRow("Show axes", m_showAxes);
+            layout->addRow("Release hidden brushes", m_releaseHiddenBrushGeometry);
+            layout->addRow("Occlusion culling", m_occlusionCulling);
             layout->addRow("Texture mode", m_textureModeCombo);
 
             layout->addSection("Colors");
@@ -185,6 +193,8 @@ namespace TrenchBroom {
             connect(m_gridAlphaSlider, &SliderWithLabel::valueChanged, this, &ViewPreferencePane::gridAlphaChanged);
             connect(m_fovSlider, &SliderWithLabel::valueChanged, this, &ViewPreferencePane::fovChanged);
             connect(m_showAxes, &QCheckBox::stateChanged, this, &ViewPreferencePane::showAxesChanged);
+            connect(m_releaseHiddenBrushGeometry, &QCheckBox::stateChanged, this, &ViewPreferencePane::releaseHiddenBrushGeometryChanged);
+            connect(m_occlusionCulling, &QCheckBox::stateChanged, this, &ViewPreferencePane::occlusionCullingChanged);
             connect(m_backgroundColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::backgroundColorChanged);
             connect(m_gridColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::gridColorChanged);
             connect(m_edgeColorButton, &ColorButton::colorChanged, this, &ViewPreferencePane::edgeColorChanged);
@@ -205,6 +215,8 @@ namespace TrenchBroom {
             prefs.resetToDefault(Preferences::GridAlpha);
             prefs.resetToDefault(Preferences::CameraFov);
             prefs.resetToDefault(Preferences::ShowAxes);
+            prefs.resetToDefault(Preferences::ReleaseHiddenBrushGeometry);
+            prefs.resetToDefault(Preferences::OcclusionCulling);
             prefs.resetToDefault(Preferences::TextureMinFilter);
             prefs.resetToDefault(Preferences::TextureMagFilter);
             prefs.resetToDefault(Preferences::BackgroundColor);
@@ -225,6 +237,8 @@ namespace TrenchBroom {
             m_textureModeCombo->setCurrentIndex(int(textureModeIndex));
 
             m_showAxes->setChecked(pref(Preferences::ShowAxes));
+            m_releaseHiddenBrushGeometry->setChecked(pref(Preferences::ReleaseHiddenBrushGeometry));
+            m_occlusionCulling->setChecked(pref(Preferences::OcclusionCulling));
 
             m_backgroundColorButton->setColor(toQColor(pref(Preferences::BackgroundColor)));
             m_gridColorButton->setColor(toQColor(pref(Preferences::GridColor2D)));
@@ -303,6 +317,18 @@ namespace TrenchBroom {
             prefs.set(Preferences::ShowAxes, value);
         }
 
+        void ViewPreferencePane::releaseHiddenBrushGeometryChanged(const int state) {
+            const auto value = state == Qt::Checked;
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::ReleaseHiddenBrushGeometry, value);
+        }
+
+        void ViewPreferencePane::occlusionCullingChanged(const int state) {
+            const auto value = state == Qt::Checked;
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::OcclusionCulling, value);
+        }
+
         void ViewPreferencePane::textureModeChanged(const int value) {
             const auto index = static_cast<size_t>(value);
             assert(index < TextureModes.size());
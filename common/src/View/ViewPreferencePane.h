@@ -38,6 +38,8 @@ namespace TrenchBroom {
             SliderWithLabel* m_gridAlphaSlider;
             SliderWithLabel* m_fovSlider;
             QCheckBox* m_showAxes;
+            QCheckBox* m_releaseHiddenBrushGeometry;
+            QCheckBox* m_occlusionCulling;
             QComboBox* m_textureModeCombo;
             ColorButton* m_backgroundColorButton;
             ColorButton* m_gridColorButton;
@@ -66,6 +68,8 @@ namespace TrenchBroom {
             void gridAlphaChanged(int value);
             void fovChanged(int value);
             void showAxesChanged(int state);
+            void releaseHiddenBrushGeometryChanged(int state);
+            void occlusionCullingChanged(int state);
             void textureModeChanged(int index);
             void backgroundColorChanged(const QColor& color);
             void gridColorChanged(const QColor& color);
@@ -27,6 +27,7 @@
 
 #include <set>
 #include <sstream>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, size_t>;
@@ -440,6 +441,37 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
     }
 
 
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+
+        std::vector<size_t> data;
+        for (size_t i = 0u; i < 64u; ++i) {
+            data.push_back(i);
+        }
+
+        const auto getBounds = [](const size_t i) {
+            const auto min = VEC(static_cast<double>(i) * 2.0, -1.0, -1.0);
+            return BOX(min, min + VEC(1.0, 2.0, 2.0));
+        };
+
+        tree.clearAndBuild(data, getBounds);
+
+        ASSERT_EQ(64u, tree.size());
+        ASSERT_EQ(7u, tree.height());
+        ASSERT_EQ(BOX(VEC(0.0, -1.0, -1.0), VEC(127.0, 1.0, 1.0)), tree.bounds());
+        for (const size_t i : data) {
+            assertTreeContains(tree, getBounds(i), i);
+        }
+
+        assertIntersectors(tree, RAY(VEC(-1.0, 0.0, 0.0), VEC::neg_x()), {});
+        assertIntersectors(tree, RAY(VEC(20.5, 0.0, -2.0), VEC::pos_z()), { 10u });
+
+        ASSERT_THROW(tree.clearAndBuild(std::vector<size_t>{ 1u, 1u }, getBounds), NodeTreeException);
+        ASSERT_TRUE(tree.empty());
+        ASSERT_EQ(0u, tree.size());
+    }
+
     template <typename K>
     BOX makeBounds(const K min, const K max) {
         return BOX(VEC(static_cast<double>(min), -1.0, -1.0), VEC(static_cast<double>(max), 1.0, 1.0));
@@ -489,6 +521,23 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
 
+    TEST_CASE("AABBTreeTest.findMatching", "[AABBTreeTest]") {
+        AABB tree;
+        tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+        tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+        tree.insert(BOX(VEC(+5.0, -1.0, -1.0), VEC(+6.0, +1.0, +1.0)), 3u);
+
+        const auto findMatching = [&](const BOX& query) {
+            std::set<AABB::DataType> result;
+            tree.findMatching([&](const BOX& bounds) { return bounds.intersects(query); }, std::inserter(result, std::end(result)));
+            return result;
+        };
+
+        ASSERT_EQ(std::set<AABB::DataType>({}), findMatching(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0))));
+        ASSERT_EQ(std::set<AABB::DataType>({ 1u }), findMatching(BOX(VEC(-3.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0))));
+        ASSERT_EQ(std::set<AABB::DataType>({ 2u, 3u }), findMatching(BOX(VEC(+3.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0))));
+    }
+
     void assertTree(const std::string& exp, const AABB& actual) {
         std::stringstream str;
         actual.print(str);
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Assets/EntityModelSimplifier.h"
+#include "Renderer/GLVertex.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static EntityModelVertex makeVertex(const float x, const float y, const float z) {
+            return EntityModelVertex(vm::vec3f(x, y, z), vm::vec2f(x, y));
+        }
+
+        static std::vector<vm::vec3f> positions(const std::vector<EntityModelVertex>& vertices) {
+            std::vector<vm::vec3f> result;
+            for (const auto& vertex : vertices) {
+                result.push_back(Renderer::getVertexComponent<0>(vertex));
+            }
+            return result;
+        }
+
+        /**
+         * Creates a flat grid of quads in the XY plane, each quad consisting of two triangles.
+         */
+        static std::vector<EntityModelVertex> makeGrid(const size_t quadsPerAxis) {
+            std::vector<EntityModelVertex> result;
+            for (size_t i = 0u; i < quadsPerAxis; ++i) {
+                for (size_t j = 0u; j < quadsPerAxis; ++j) {
+                    const auto x = static_cast<float>(i);
+                    const auto y = static_cast<float>(j);
+                    result.push_back(makeVertex(x, y, 0.0f));
+                    result.push_back(makeVertex(x + 1.0f, y, 0.0f));
+                    result.push_back(makeVertex(x + 1.0f, y + 1.0f, 0.0f));
+                    result.push_back(makeVertex(x, y, 0.0f));
+                    result.push_back(makeVertex(x + 1.0f, y + 1.0f, 0.0f));
+                    result.push_back(makeVertex(x, y + 1.0f, 0.0f));
+                }
+            }
+            return result;
+        }
+
+        TEST_CASE("EntityModelSimplifierTest.appendTriangles", "[EntityModelSimplifierTest]") {
+            const auto vertices = std::vector<EntityModelVertex>({
+                makeVertex(0.0f, 0.0f, 0.0f),
+                makeVertex(1.0f, 0.0f, 0.0f),
+                makeVertex(1.0f, 1.0f, 0.0f),
+                makeVertex(0.0f, 1.0f, 0.0f)
+            });
+
+            std::vector<EntityModelVertex> triangles;
+            appendTriangles(vertices, Renderer::PrimType::Lines, 0u, 4u, triangles);
+            ASSERT_TRUE(triangles.empty());
+
+            appendTriangles(vertices, Renderer::PrimType::TriangleFan, 0u, 4u, triangles);
+            ASSERT_EQ(std::vector<vm::vec3f>({
+                vm::vec3f(0.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f),
+                vm::vec3f(0.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f), vm::vec3f(0.0f, 1.0f, 0.0f)
+            }), positions(triangles));
+
+            triangles.clear();
+            appendTriangles(vertices, Renderer::PrimType::TriangleStrip, 0u, 4u, triangles);
+            ASSERT_EQ(std::vector<vm::vec3f>({
+                vm::vec3f(0.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f),
+                vm::vec3f(1.0f, 0.0f, 0.0f), vm::vec3f(0.0f, 1.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f)
+            }), positions(triangles));
+
+            triangles.clear();
+            appendTriangles(vertices, Renderer::PrimType::Triangles, 1u, 3u, triangles);
+            ASSERT_EQ(std::vector<vm::vec3f>({
+                vm::vec3f(1.0f, 0.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f), vm::vec3f(0.0f, 1.0f, 0.0f)
+            }), positions(triangles));
+        }
+
+        TEST_CASE("EntityModelSimplifierTest.simplifyEmptyList", "[EntityModelSimplifierTest]") {
+            ASSERT_TRUE(simplifyTriangles({}, 4u).empty());
+        }
+
+        TEST_CASE("EntityModelSimplifierTest.keepLargeTriangle", "[EntityModelSimplifierTest]") {
+            const auto triangles = std::vector<EntityModelVertex>({
+                makeVertex(0.0f, 0.0f, 0.0f),
+                makeVertex(8.0f, 0.0f, 0.0f),
+                makeVertex(8.0f, 8.0f, 0.0f)
+            });
+
+            const auto simplified = simplifyTriangles(triangles, 4u);
+            ASSERT_EQ(positions(triangles), positions(simplified));
+        }
+
+        TEST_CASE("EntityModelSimplifierTest.simplifyGrid", "[EntityModelSimplifierTest]") {
+            const auto triangles = makeGrid(16u);
+            ASSERT_EQ(16u * 16u * 6u, triangles.size());
+
+            const auto simplified = simplifyTriangles(triangles, 4u);
+            ASSERT_EQ(0u, simplified.size() % 3u);
+            ASSERT_FALSE(simplified.empty());
+            ASSERT_LE(simplified.size(), 4u * 4u * 6u);
+
+            const auto bounds = vm::bbox3f(vm::vec3f(0.0f, 0.0f, 0.0f), vm::vec3f(16.0f, 16.0f, 0.0f));
+            for (const auto& position : positions(simplified)) {
+                ASSERT_TRUE(bounds.contains(position));
+            }
+
+            // no degenerate triangles
+            const auto simplifiedPositions = positions(simplified);
+            for (size_t i = 0u; i < simplifiedPositions.size(); i += 3u) {
+                ASSERT_NE(simplifiedPositions[i], simplifiedPositions[i + 1u]);
+                ASSERT_NE(simplifiedPositions[i], simplifiedPositions[i + 2u]);
+                ASSERT_NE(simplifiedPositions[i + 1u], simplifiedPositions[i + 2u]);
+            }
+        }
+
+        TEST_CASE("EntityModelSimplifierTest.collapseSingleCell", "[EntityModelSimplifierTest]") {
+            ASSERT_TRUE(simplifyTriangles(makeGrid(4u), 1u).empty());
+        }
+    }
+}
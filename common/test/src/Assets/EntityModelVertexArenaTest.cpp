@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelVertexArena.h"
+#include "Renderer/GLVertex.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/PrimType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<EntityModelVertex> makeArenaVertices(const size_t count, const float z) {
+            std::vector<EntityModelVertex> result;
+            for (size_t i = 0u; i < count; ++i) {
+                result.emplace_back(vm::vec3f(static_cast<float>(i), 0.0f, z), vm::vec2f::zero());
+            }
+            return result;
+        }
+
+        TEST_CASE("EntityModelVertexArenaTest.add", "[EntityModelVertexArenaTest]") {
+            EntityModelVertexArena arena;
+            ASSERT_EQ(0u, arena.vertexCount());
+            ASSERT_EQ(0u, arena.blockCount());
+            ASSERT_TRUE(arena.add({}).empty());
+
+            const auto first = arena.add(makeArenaVertices(3u, 1.0f));
+            const auto second = arena.add(makeArenaVertices(2u, 2.0f));
+            ASSERT_EQ(5u, arena.vertexCount());
+            ASSERT_EQ(1u, arena.blockCount());
+            ASSERT_EQ(EntityModelVertexArena::MinBlockSize * sizeof(EntityModelVertex), arena.sizeInBytes());
+
+            ASSERT_EQ(3u, first.size());
+            ASSERT_EQ(2u, second.size());
+            ASSERT_EQ(first.end(), second.begin());
+            ASSERT_EQ(vm::vec3f(2.0f, 0.0f, 1.0f), Renderer::getVertexComponent<0>(first[2]));
+            ASSERT_EQ(vm::vec3f(1.0f, 0.0f, 2.0f), Renderer::getVertexComponent<0>(second[1]));
+        }
+
+        TEST_CASE("EntityModelVertexArenaTest.addKeepsAddresses", "[EntityModelVertexArenaTest]") {
+            EntityModelVertexArena arena;
+            const auto first = arena.add(makeArenaVertices(EntityModelVertexArena::MinBlockSize - 1u, 1.0f));
+            const auto* firstData = first.data();
+
+            // does not fit into the first block
+            const auto second = arena.add(makeArenaVertices(2u, 2.0f));
+            ASSERT_EQ(2u, arena.blockCount());
+
+            // larger than all blocks so far
+            const auto third = arena.add(makeArenaVertices(4u * EntityModelVertexArena::MinBlockSize, 3.0f));
+            ASSERT_EQ(3u, arena.blockCount());
+            ASSERT_EQ(5u * EntityModelVertexArena::MinBlockSize + 1u, arena.vertexCount());
+
+            ASSERT_EQ(firstData, first.data());
+            ASSERT_EQ(vm::vec3f(0.0f, 0.0f, 1.0f), Renderer::getVertexComponent<0>(first[0]));
+            ASSERT_EQ(vm::vec3f(1.0f, 0.0f, 2.0f), Renderer::getVertexComponent<0>(second[1]));
+            ASSERT_EQ(vm::vec3f(3.0f, 0.0f, 3.0f), Renderer::getVertexComponent<0>(third[3]));
+        }
+
+        TEST_CASE("EntityModelVertexArenaTest.modelMeshesShareArena", "[EntityModelVertexArenaTest]") {
+            EntityModel model("model", PitchType::Normal);
+            model.addFrames(2u);
+            auto& surface = model.addSurface("surface");
+
+            const auto vertices = std::vector<EntityModelVertex>{
+                EntityModelVertex(vm::vec3f(-1.0f, -1.0f, 0.0f), vm::vec2f::zero()),
+                EntityModelVertex(vm::vec3f(+1.0f, -1.0f, 0.0f), vm::vec2f::zero()),
+                EntityModelVertex(vm::vec3f(+1.0f, +1.0f, 0.0f), vm::vec2f::zero()),
+            };
+
+            auto& frame1 = model.loadFrame(0u, "frame1", vm::bbox3f(1.0f));
+            surface.addIndexedMesh(frame1, vertices, EntityModelIndices(Renderer::PrimType::Triangles, 0u, 3u));
+            auto& frame2 = model.loadFrame(1u, "frame2", vm::bbox3f(1.0f));
+            surface.addIndexedMesh(frame2, vertices, EntityModelIndices(Renderer::PrimType::Triangles, 0u, 3u));
+
+            ASSERT_EQ(6u, model.vertexArena().vertexCount());
+            ASSERT_EQ(1u, model.vertexArena().blockCount());
+
+            // the spacial tree is built when the frame is first hit tested
+            ASSERT_FLOAT_EQ(1.0f, frame1.intersect(vm::ray3f(vm::vec3f(0.5f, -0.5f, 1.0f), vm::vec3f::neg_z())));
+            ASSERT_TRUE(vm::is_nan(frame1.intersect(vm::ray3f(vm::vec3f(-0.5f, 0.5f, 1.0f), vm::vec3f::neg_z()))));
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Assets/Palette.h"
+#include "IO/Reader.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Palette createPalette() {
+            // index i maps to (i, 255 - i, i / 2)
+            auto data = std::vector<unsigned char>(768);
+            for (size_t i = 0u; i < 256u; ++i) {
+                data[i * 3u + 0u] = static_cast<unsigned char>(i);
+                data[i * 3u + 1u] = static_cast<unsigned char>(255u - i);
+                data[i * 3u + 2u] = static_cast<unsigned char>(i / 2u);
+            }
+            return Palette(std::move(data));
+        }
+
+        TEST_CASE("PaletteTest.indexedToRgba", "[PaletteTest]") {
+            const auto palette = createPalette();
+
+            // an odd number of pixels to cover the pixels that don't fill a whole batch
+            const auto indices = std::vector<unsigned char>{ 0, 1, 2, 255, 128, 128, 10 };
+            auto rgba = std::vector<unsigned char>(indices.size() * 4u);
+
+            Color averageColor;
+            ASSERT_FALSE(palette.indexedToRgba(indices, indices.size(), rgba, PaletteTransparency::Opaque, averageColor));
+            ASSERT_EQ((std::vector<unsigned char>{
+                0,   255, 0,   255,
+                1,   254, 0,   255,
+                2,   253, 1,   255,
+                255, 0,   127, 255,
+                128, 127, 64,  255,
+                128, 127, 64,  255,
+                10,  245, 5,   255
+            }), rgba);
+
+            const auto sum = 0.0f + 1.0f + 2.0f + 255.0f + 128.0f + 128.0f + 10.0f;
+            ASSERT_FLOAT_EQ(sum / 7.0f / 255.0f, averageColor.r());
+            ASSERT_FLOAT_EQ((7.0f * 255.0f - sum) / 7.0f / 255.0f, averageColor.g());
+            ASSERT_FLOAT_EQ((0.0f + 0.0f + 1.0f + 127.0f + 64.0f + 64.0f + 5.0f) / 7.0f / 255.0f, averageColor.b());
+            ASSERT_FLOAT_EQ(1.0f, averageColor.a());
+        }
+
+        TEST_CASE("PaletteTest.indexedToRgbaWithTransparency", "[PaletteTest]") {
+            const auto palette = createPalette();
+
+            auto indices = std::vector<unsigned char>{ 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+            auto rgba = std::vector<unsigned char>(indices.size() * 4u);
+
+            Color averageColor;
+            ASSERT_FALSE(palette.indexedToRgba(indices, indices.size(), rgba, PaletteTransparency::Index255Transparent, averageColor));
+            for (size_t i = 0u; i < indices.size(); ++i) {
+                ASSERT_EQ(0xFF, rgba[i * 4u + 3u]);
+            }
+
+            indices[8] = 255;
+            ASSERT_TRUE(palette.indexedToRgba(indices, indices.size(), rgba, PaletteTransparency::Index255Transparent, averageColor));
+            ASSERT_EQ(0x00, rgba[8u * 4u + 3u]);
+            ASSERT_EQ(0xFF, rgba[0u * 4u + 3u]);
+
+            // the color of transparent pixels is kept
+            ASSERT_EQ(255, rgba[8u * 4u + 0u]);
+
+            ASSERT_FALSE(palette.indexedToRgba(indices, indices.size(), rgba, PaletteTransparency::Opaque, averageColor));
+            ASSERT_EQ(0xFF, rgba[8u * 4u + 3u]);
+        }
+
+        TEST_CASE("PaletteTest.indexedToRgbaFromReader", "[PaletteTest]") {
+            const auto palette = createPalette();
+
+            const char buffer[] = { 42, 1, 2, 3, 4, 5 };
+            auto reader = IO::Reader::from(std::begin(buffer), std::end(buffer));
+            reader.seekFromBegin(1u);
+
+            auto rgba = std::vector<unsigned char>(4u * 4u);
+            Color averageColor;
+            palette.indexedToRgba(reader, 4u, rgba, PaletteTransparency::Opaque, averageColor);
+
+            ASSERT_EQ(5u, reader.position());
+            ASSERT_EQ((std::vector<unsigned char>{
+                1, 254, 0, 255,
+                2, 253, 1, 255,
+                3, 252, 1, 255,
+                4, 251, 2, 255
+            }), rgba);
+
+            ASSERT_THROW(palette.indexedToRgba(reader, 2u, rgba, PaletteTransparency::Opaque, averageColor), ReaderException);
+        }
+
+        TEST_CASE("PaletteTest.incompletePalette", "[PaletteTest]") {
+            const auto palette = Palette(std::vector<unsigned char>{ 10, 20, 30 });
+
+            const auto indices = std::vector<unsigned char>{ 0, 1 };
+            auto rgba = std::vector<unsigned char>(indices.size() * 4u);
+
+            Color averageColor;
+            palette.indexedToRgba(indices, indices.size(), rgba, PaletteTransparency::Opaque, averageColor);
+            ASSERT_EQ((std::vector<unsigned char>{ 10, 20, 30, 255, 0, 0, 0, 255 }), rgba);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static double srgbToLinear(const unsigned char c) {
+            const auto srgb = static_cast<double>(c) / 255.0;
+            return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+        }
+
+        static unsigned char linearToSrgb(const double linear) {
+            const auto srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            return static_cast<unsigned char>(std::round(std::clamp(srgb, 0.0, 1.0) * 255.0));
+        }
+
+        /**
+         * Computes the next mip level with double precision.
+         */
+        static TextureBuffer referenceMip(const TextureBuffer& src, const size_t srcWidth, const size_t srcHeight, const size_t bytesPerPixel) {
+            const auto dstWidth = std::max(size_t(1), srcWidth / 2u);
+            const auto dstHeight = std::max(size_t(1), srcHeight / 2u);
+
+            auto result = TextureBuffer(dstWidth * dstHeight * bytesPerPixel);
+            for (size_t y = 0u; y < dstHeight; ++y) {
+                for (size_t x = 0u; x < dstWidth; ++x) {
+                    const size_t xs[] = { std::min(2u * x, srcWidth - 1u), std::min(2u * x + 1u, srcWidth - 1u) };
+                    const size_t ys[] = { std::min(2u * y, srcHeight - 1u), std::min(2u * y + 1u, srcHeight - 1u) };
+
+                    for (size_t c = 0u; c < bytesPerPixel; ++c) {
+                        double sum = 0.0;
+                        for (const auto sy : ys) {
+                            for (const auto sx : xs) {
+                                const auto value = src[(sy * srcWidth + sx) * bytesPerPixel + c];
+                                sum += c == 3u ? static_cast<double>(value) : srgbToLinear(value);
+                            }
+                        }
+
+                        auto& out = result[(y * dstWidth + x) * bytesPerPixel + c];
+                        out = c == 3u ? static_cast<unsigned char>(std::round(sum / 4.0)) : linearToSrgb(sum / 4.0);
+                    }
+                }
+            }
+            return result;
+        }
+
+        static TextureBuffer randomImage(const size_t width, const size_t height, const size_t bytesPerPixel) {
+            auto result = TextureBuffer(width * height * bytesPerPixel);
+            unsigned int random = 1u;
+            for (auto& value : result) {
+                random = random * 1664525u + 1013904223u;
+                value = static_cast<unsigned char>(random >> 24u);
+            }
+            return result;
+        }
+
+        static void assertMipsMatchReference(const size_t width, const size_t height, const GLenum format) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+
+            auto buffers = TextureBufferList{ randomImage(width, height, bytesPerPixel) };
+            generateMips(buffers, width, height, format);
+            ASSERT_EQ(mipLevelCount(width, height), buffers.size());
+
+            for (size_t level = 1u; level < buffers.size(); ++level) {
+                const auto srcSize = sizeAtMipLevel(width, height, level - 1u);
+                const auto dstSize = sizeAtMipLevel(width, height, level);
+                const auto expected = referenceMip(buffers[level - 1u], srcSize.x(), srcSize.y(), bytesPerPixel);
+
+                ASSERT_EQ(dstSize.x() * dstSize.y() * bytesPerPixel, buffers[level].size());
+                for (size_t i = 0u; i < expected.size(); ++i) {
+                    // the lookup tables may round differently for values close to a boundary
+                    ASSERT_LE(std::abs(static_cast<int>(expected[i]) - static_cast<int>(buffers[level][i])), 1);
+                }
+            }
+        }
+
+        TEST_CASE("TextureBufferTest.mipLevelCount", "[TextureBufferTest]") {
+            ASSERT_EQ(1u, mipLevelCount(1u, 1u));
+            ASSERT_EQ(2u, mipLevelCount(2u, 1u));
+            ASSERT_EQ(2u, mipLevelCount(3u, 3u));
+            ASSERT_EQ(9u, mipLevelCount(256u, 256u));
+            ASSERT_EQ(9u, mipLevelCount(64u, 256u));
+            ASSERT_EQ(10u, mipLevelCount(513u, 1u));
+        }
+
+        TEST_CASE("TextureBufferTest.generateMips", "[TextureBufferTest]") {
+            assertMipsMatchReference(64u, 64u, GL_RGBA);
+            assertMipsMatchReference(64u, 16u, GL_BGRA);
+            assertMipsMatchReference(37u, 23u, GL_RGB);
+            assertMipsMatchReference(1u, 8u, GL_BGR);
+        }
+
+        TEST_CASE("TextureBufferTest.generateMipsIsGammaCorrect", "[TextureBufferTest]") {
+            // a black and white checkerboard with an alpha channel that is opaque on the white pixels
+            auto buffers = TextureBufferList{ TextureBuffer{
+                0,   0,   0,   0,       255, 255, 255, 255,
+                255, 255, 255, 255,     0,   0,   0,   0
+            }};
+            generateMips(buffers, 2u, 2u, GL_RGBA);
+
+            // half of the light of white is sRGB 188, not 128, but alpha is averaged linearly
+            ASSERT_EQ(2u, buffers.size());
+            ASSERT_EQ((TextureBuffer{ 188, 188, 188, 128 }), buffers[1]);
+        }
+
+        TEST_CASE("TextureBufferTest.generateMipsOfUniformImage", "[TextureBufferTest]") {
+            for (size_t value = 0u; value < 256u; ++value) {
+                auto buffers = TextureBufferList{ TextureBuffer(4u * 4u * 3u, static_cast<unsigned char>(value)) };
+                generateMips(buffers, 4u, 4u, GL_RGB);
+
+                ASSERT_EQ(3u, buffers.size());
+                ASSERT_EQ(TextureBuffer(2u * 2u * 3u, static_cast<unsigned char>(value)), buffers[1]);
+                ASSERT_EQ(TextureBuffer(3u, static_cast<unsigned char>(value)), buffers[2]);
+            }
+        }
+
+        TEST_CASE("TextureBufferTest.textureGenerateMips", "[TextureBufferTest]") {
+            auto opaque = Texture("opaque", 8u, 4u, Color(), TextureBuffer(8u * 4u * 4u), GL_RGBA, TextureType::Opaque);
+            opaque.generateMips();
+            ASSERT_EQ(4u, opaque.buffersIfUnprepared().size());
+
+            auto masked = Texture("masked", 8u, 4u, Color(), TextureBuffer(8u * 4u * 4u), GL_RGBA, TextureType::Masked);
+            masked.generateMips();
+            ASSERT_EQ(1u, masked.buffersIfUnprepared().size());
+
+            auto withMips = Texture("withMips", 8u, 4u, Color(), TextureBufferList{ TextureBuffer(8u * 4u * 4u), TextureBuffer(4u * 2u * 4u) }, GL_RGBA, TextureType::Opaque);
+            withMips.generateMips();
+            ASSERT_EQ(2u, withMips.buffersIfUnprepared().size());
+        }
+    }
+}
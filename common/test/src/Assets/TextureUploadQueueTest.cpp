@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Color.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureUploadQueue.h"
+#include "IO/Path.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * Records the uploads instead of performing them.
+         */
+        class RecordingUploadSink : public TextureUploadSink {
+        public:
+            std::vector<std::string> uploadedNames;
+            std::vector<GLuint> uploadedIds;
+        private:
+            void upload(Texture& texture, const GLuint textureId) override {
+                uploadedNames.push_back(texture.name());
+                uploadedIds.push_back(textureId);
+            }
+        };
+
+        static Texture* createUploadTestTexture(const std::string& name, const size_t size, const size_t usageCount = 0u) {
+            auto* texture = new Texture(name, size, size, Color(), TextureBuffer(size * size * 4u), GL_RGBA, TextureType::Opaque);
+            for (size_t i = 0u; i < usageCount; ++i) {
+                texture->incUsageCount();
+            }
+            return texture;
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadSize", "[TextureUploadQueueTest]") {
+            auto texture = std::unique_ptr<Texture>(createUploadTestTexture("a", 16u));
+            ASSERT_EQ(16u * 16u * 4u, texture->uploadSize());
+
+            texture->generateMips();
+            ASSERT_EQ((256u + 64u + 16u + 4u + 1u) * 4u, texture->uploadSize());
+
+            auto masked = Texture("m", 16u, 16u, Color(), TextureBuffer(16u * 16u * 4u), GL_RGBA, TextureType::Masked);
+            ASSERT_EQ(16u * 16u * 4u, masked.uploadSize());
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadWithinBudget", "[TextureUploadQueueTest]") {
+            auto collection = TextureCollection(IO::Path("textures"), {
+                createUploadTestTexture("a", 16u),
+                createUploadTestTexture("b", 16u),
+                createUploadTestTexture("c", 16u),
+            });
+
+            auto queue = TextureUploadQueue();
+            for (size_t i = 0u; i < collection.textureCount(); ++i) {
+                queue.enqueue(collection.textureByIndex(i), static_cast<GLuint>(i + 1u));
+            }
+
+            ASSERT_EQ(3u, queue.pendingCount());
+            ASSERT_EQ(3u * 1024u, queue.pendingBytes());
+
+            auto sink = RecordingUploadSink();
+            ASSERT_EQ(2u * 1024u, queue.upload(sink, 2u * 1024u + 512u));
+            ASSERT_EQ((std::vector<std::string>{ "a", "b" }), sink.uploadedNames);
+            ASSERT_EQ((std::vector<GLuint>{ 1u, 2u }), sink.uploadedIds);
+            ASSERT_EQ(1u, queue.pendingCount());
+
+            ASSERT_EQ(1024u, queue.upload(sink, 2u * 1024u + 512u));
+            ASSERT_EQ((std::vector<std::string>{ "a", "b", "c" }), sink.uploadedNames);
+            ASSERT_TRUE(queue.empty());
+
+            ASSERT_EQ(0u, queue.upload(sink, 2u * 1024u));
+            ASSERT_EQ(3u, sink.uploadedNames.size());
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadAtLeastOneTexture", "[TextureUploadQueueTest]") {
+            auto collection = TextureCollection(IO::Path("textures"), {
+                createUploadTestTexture("large", 64u),
+                createUploadTestTexture("small", 1u),
+            });
+
+            auto queue = TextureUploadQueue();
+            queue.enqueue(collection.textureByIndex(0u), 1u);
+            queue.enqueue(collection.textureByIndex(1u), 2u);
+
+            auto sink = RecordingUploadSink();
+            ASSERT_EQ(64u * 64u * 4u, queue.upload(sink, 1u));
+            ASSERT_EQ(std::vector<std::string>{ "large" }, sink.uploadedNames);
+
+            ASSERT_EQ(4u, queue.upload(sink, 1u));
+            ASSERT_EQ((std::vector<std::string>{ "large", "small" }), sink.uploadedNames);
+        }
+
+        TEST_CASE("TextureUploadQueueTest.uploadByUsageCount", "[TextureUploadQueueTest]") {
+            auto collection = TextureCollection(IO::Path("textures"), {
+                createUploadTestTexture("unused1", 16u),
+                createUploadTestTexture("rare", 16u, 1u),
+                createUploadTestTexture("unused2", 16u),
+                createUploadTestTexture("common", 16u, 5u),
+            });
+
+            auto queue = TextureUploadQueue();
+            for (size_t i = 0u; i < collection.textureCount(); ++i) {
+                queue.enqueue(collection.textureByIndex(i), static_cast<GLuint>(i + 1u));
+            }
+
+            auto sink = RecordingUploadSink();
+            queue.upload(sink, 1024u);
+            ASSERT_EQ(std::vector<std::string>{ "common" }, sink.uploadedNames);
+
+            // the order is recomputed for every batch
+            collection.textureByName("unused2")->incUsageCount();
+            collection.textureByName("unused2")->incUsageCount();
+
+            queue.upload(sink, 3u * 1024u);
+            ASSERT_EQ((std::vector<std::string>{ "common", "unused2", "rare", "unused1" }), sink.uploadedNames);
+        }
+
+        TEST_CASE("TextureUploadQueueTest.remove", "[TextureUploadQueueTest]") {
+            auto collection1 = TextureCollection(IO::Path("textures1"), {
+                createUploadTestTexture("a", 16u),
+                createUploadTestTexture("b", 16u),
+            });
+            auto collection2 = TextureCollection(IO::Path("textures2"), {
+                createUploadTestTexture("c", 16u),
+            });
+
+            auto queue = TextureUploadQueue();
+            queue.enqueue(collection1.textureByIndex(0u), 1u);
+            queue.enqueue(collection2.textureByIndex(0u), 2u);
+            queue.enqueue(collection1.textureByIndex(1u), 3u);
+
+            queue.remove({ &collection1 });
+            ASSERT_EQ(1u, queue.pendingCount());
+
+            auto sink = RecordingUploadSink();
+            queue.upload(sink, 1024u * 1024u);
+            ASSERT_EQ(std::vector<std::string>{ "c" }, sink.uploadedNames);
+        }
+    }
+}
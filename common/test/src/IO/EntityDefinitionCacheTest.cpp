@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Color.h"
+#include "Logger.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class EntityDefinitionCacheEnvironment : public TestEnvironment {
+        public:
+            EntityDefinitionCacheEnvironment() :
+            TestEnvironment("EntityDefinitionCacheTest") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                createFile(Path("host.fgd"),
+                    "@BaseClass = Targetname [ targetname(target_source) : \"Name\" ]\n"
+                    "@include \"include.fgd\"\n");
+                createFile(Path("include.fgd"),
+                    "@PointClass base(Targetname) = info_null : \"Invisible\" []\n");
+            }
+        };
+
+        static std::vector<Assets::EntityDefinition*> loadCachedDefinitions(EntityDefinitionCache& cache, const Path& path, const Color& defaultColor, size_t& parseCount, ParserStatus& status) {
+            return cache.loadDefinitions(status, path, defaultColor, [&](ParserStatus& parserStatus, const char* begin, const char* end, std::vector<Path>& includedFiles) {
+                ++parseCount;
+                FgdParser parser(begin, end, defaultColor, path);
+                auto definitions = parser.parseDefinitions(parserStatus);
+                includedFiles = parser.includedFiles();
+                return definitions;
+            });
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.reuseUnchangedDefinitions", "[EntityDefinitionCacheTest]") {
+            EntityDefinitionCacheEnvironment env;
+            EntityDefinitionCache cache;
+
+            const auto path = env.dir() + Path("host.fgd");
+            const auto defaultColor = Color(1.0f, 1.0f, 1.0f, 1.0f);
+            size_t parseCount = 0u;
+
+            TestParserStatus status;
+            auto definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(1u, parseCount);
+            ASSERT_EQ(1u, definitions.size());
+
+            auto cachedDefinitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(1u, parseCount);
+            ASSERT_EQ(1u, cachedDefinitions.size());
+            ASSERT_NE(definitions.front(), cachedDefinitions.front());
+            ASSERT_EQ(Assets::EntityDefinitionType::PointEntity, cachedDefinitions.front()->type());
+            ASSERT_EQ("info_null", cachedDefinitions.front()->name());
+            ASSERT_EQ("Invisible", cachedDefinitions.front()->description());
+            ASSERT_NE(nullptr, cachedDefinitions.front()->attributeDefinition("targetname"));
+
+            kdl::vec_clear_and_delete(definitions);
+            kdl::vec_clear_and_delete(cachedDefinitions);
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.reparseChangedIncludedFile", "[EntityDefinitionCacheTest]") {
+            EntityDefinitionCacheEnvironment env;
+            EntityDefinitionCache cache;
+
+            const auto path = env.dir() + Path("host.fgd");
+            const auto defaultColor = Color(1.0f, 1.0f, 1.0f, 1.0f);
+            size_t parseCount = 0u;
+
+            TestParserStatus status;
+            auto definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(1u, parseCount);
+            kdl::vec_clear_and_delete(definitions);
+
+            env.createFile(Path("include.fgd"),
+                "@PointClass base(Targetname) = info_notnull : \"Invisible\" []\n"
+                "@SolidClass = func_wall : \"Wall\" []\n");
+
+            definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(2u, parseCount);
+            ASSERT_EQ(2u, definitions.size());
+            ASSERT_EQ("info_notnull", definitions[0]->name());
+            ASSERT_EQ("func_wall", definitions[1]->name());
+            kdl::vec_clear_and_delete(definitions);
+
+            definitions = loadCachedDefinitions(cache, path, Color(0.5f, 0.5f, 0.5f, 1.0f), parseCount, status);
+            ASSERT_EQ(3u, parseCount);
+            kdl::vec_clear_and_delete(definitions);
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.replayMessages", "[EntityDefinitionCacheTest]") {
+            EntityDefinitionCacheEnvironment env;
+            env.createFile(Path("include.fgd"),
+                "@PointClass base(Targetname) = info_null : \"Invisible\" []\n"
+                "@include \"missing.fgd\"\n");
+
+            EntityDefinitionCache cache;
+
+            const auto path = env.dir() + Path("host.fgd");
+            const auto defaultColor = Color(1.0f, 1.0f, 1.0f, 1.0f);
+            size_t parseCount = 0u;
+
+            TestParserStatus status;
+            auto definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(1u, status.countStatus(LogLevel::Error));
+            kdl::vec_clear_and_delete(definitions);
+
+            definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(1u, parseCount);
+            ASSERT_EQ(2u, status.countStatus(LogLevel::Error));
+            kdl::vec_clear_and_delete(definitions);
+
+            // the missing file appears, so the definitions are parsed again
+            env.createFile(Path("missing.fgd"),
+                "@SolidClass = func_wall : \"Wall\" []\n");
+
+            definitions = loadCachedDefinitions(cache, path, defaultColor, parseCount, status);
+            ASSERT_EQ(2u, parseCount);
+            ASSERT_EQ(2u, status.countStatus(LogLevel::Error));
+            ASSERT_EQ(2u, definitions.size());
+            ASSERT_EQ("func_wall", definitions[1]->name());
+            kdl::vec_clear_and_delete(definitions);
+        }
+    }
+}
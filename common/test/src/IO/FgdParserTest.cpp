@@ -33,10 +33,12 @@
 #include "IO/Reader.h"
 #include "IO/TestParserStatus.h"
 
+#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -876,6 +878,61 @@ decor_goddess_statue : "Goddess Statue" [])";
             kdl::vec_clear_and_delete(defs);
         }
 
+        TEST_CASE("FgdParserTest.parseMultipleIncludes", "[FgdParserTest]") {
+            const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseMultipleIncludes/host.fgd");
+            auto file = Disk::openFile(path);
+            auto reader = file->reader().buffer();
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(std::begin(reader), std::end(reader), defaultColor, file->path());
+
+            TestParserStatus status;
+            auto defs = parser.parseDefinitions(status);
+
+            // the definitions are returned in file order, and base classes are visible to all subsequent classes
+            const auto names = kdl::vec_transform(defs, [](const auto* def) { return def->name(); });
+            ASSERT_EQ((std::vector<std::string>{ "info_player_start", "light", "func_wall", "func_door" }), names);
+            ASSERT_NE(nullptr, defs[0]->attributeDefinition("spawnflags"));
+            ASSERT_NE(nullptr, defs[1]->attributeDefinition("targetname"));
+            ASSERT_NE(nullptr, defs[1]->attributeDefinition("spawnflags"));
+            ASSERT_NE(nullptr, defs[3]->attributeDefinition("targetname"));
+
+            ASSERT_EQ((std::vector<Path>{ path.deleteLastComponent() + Path("base.fgd"), path.deleteLastComponent() + Path("entities.fgd") }), parser.includedFiles());
+
+            kdl::vec_clear_and_delete(defs);
+        }
+
+        TEST_CASE("FgdParserTest.parseIncludeMessages", "[FgdParserTest]") {
+            const Path path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Fgd/parseIncludeMessages/host.fgd");
+            auto file = Disk::openFile(path);
+            auto reader = file->reader().buffer();
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(std::begin(reader), std::end(reader), defaultColor, file->path());
+
+            TestParserStatus status;
+            auto defs = parser.parseDefinitions(status);
+            ASSERT_EQ(5u, defs.size());
+
+            // the messages of the included file and of resolving the classes appear in file order
+            const auto expected = std::vector<std::string>{
+                "Solid entity definition must not have a size (line 1,",
+                "Parsing included file 'included.fgd' (line 2)",
+                "Resolved 'included.fgd' to 'included.fgd' (line 2)",
+                "Found multiple color attributes (line 1,",
+                "Solid entity definition must not have a size (line 2,",
+                "Found multiple color attributes (line 3,",
+                "Solid entity definition must not have a size (line 4,",
+            };
+            const auto& messages = status.messages();
+            ASSERT_EQ(expected.size(), messages.size());
+            for (size_t i = 0u; i < expected.size(); ++i) {
+                ASSERT_TRUE(kdl::cs::str_is_prefix(messages[i], expected[i]));
+            }
+
+            kdl::vec_clear_and_delete(defs);
+        }
+
         TEST_CASE("FgdParserTest.parseStringContinuations", "[FgdParserTest]") {
             const std::string file =
                 "@PointClass = cont_description :\n"
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "IO/MapChunkReader.h"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        using Chunk = std::tuple<std::string, size_t>;
+
+        static std::vector<Chunk> readChunks(const std::string& data, const size_t readSize) {
+            std::istringstream stream(data);
+            MapChunkReader reader(stream, readSize);
+
+            std::vector<Chunk> result;
+            auto [begin, end, line] = reader.nextChunk();
+            while (begin != end) {
+                result.emplace_back(std::string(begin, end), line);
+                std::tie(begin, end, line) = reader.nextChunk();
+            }
+            return result;
+        }
+
+        TEST_CASE("MapChunkReaderTest.readEmptyStream", "[MapChunkReaderTest]") {
+            ASSERT_TRUE(readChunks("", 4u).empty());
+        }
+
+        TEST_CASE("MapChunkReaderTest.splitAfterEntitiesAndBrushes", "[MapChunkReaderTest]") {
+            const std::string data(R"({
+"classname" "worldspawn"
+{
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+}
+)");
+
+            ASSERT_EQ(std::vector<Chunk>({
+                { "{\n\"classname\" \"worldspawn\"\n{\n( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex 0 0 0 1 1\n}", 1u },
+                { "\n}", 5u },
+                { "\n{\n\"classname\" \"info_player_start\"\n}", 6u },
+                { "\n", 9u }
+            }), readChunks(data, 1u));
+
+            // all complete entities that were read are returned at once
+            ASSERT_EQ(std::vector<Chunk>({
+                { data.substr(0u, data.size() - 1u), 1u },
+                { "\n", 9u }
+            }), readChunks(data, data.size()));
+        }
+
+        TEST_CASE("MapChunkReaderTest.ignoreBracesInStringsAndComments", "[MapChunkReaderTest]") {
+            const std::string data(R"(// comment }
+{
+"message" "}"
+; comment }
+"path" "c:\"
+}
+)");
+
+            ASSERT_EQ(std::vector<Chunk>({
+                { data.substr(0u, data.size() - 1u), 1u },
+                { "\n", 6u }
+            }), readChunks(data, 1u));
+        }
+
+        TEST_CASE("MapChunkReaderTest.ignoreBracesInTextureNames", "[MapChunkReaderTest]") {
+            const std::string data(R"({
+{
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) {FENCE 0 0 0 1 1
+}
+}
+)");
+
+            ASSERT_EQ(std::vector<Chunk>({
+                { "{\n{\n( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) {FENCE 0 0 0 1 1\n}", 1u },
+                { "\n}", 4u },
+                { "\n", 5u }
+            }), readChunks(data, 1u));
+        }
+
+        TEST_CASE("MapChunkReaderTest.countWindowsLineBreaks", "[MapChunkReaderTest]") {
+            ASSERT_EQ(std::vector<Chunk>({
+                { "{\r\n}", 1u },
+                { "\r\n{\r}", 2u },
+                { "\r\n", 4u }
+            }), readChunks("{\r\n}\r\n{\r}\r\n", 1u));
+        }
+
+        TEST_CASE("MapChunkReaderTest.readRemainderIfUnbalanced", "[MapChunkReaderTest]") {
+            const std::string data("{\n}\n}\n{\n}\n");
+
+            ASSERT_EQ(std::vector<Chunk>({
+                { "{\n}", 1u },
+                { "\n}\n{\n}\n", 2u }
+            }), readChunks(data, 1u));
+        }
+
+        TEST_CASE("MapChunkReaderTest.peakBufferSize", "[MapChunkReaderTest]") {
+            std::string data;
+            for (size_t i = 0u; i < 1000u; ++i) {
+                data += "{\n\"classname\" \"info_null\"\n}\n";
+            }
+
+            std::istringstream stream(data);
+            MapChunkReader reader(stream, 64u);
+
+            auto [begin, end, line] = reader.nextChunk();
+            while (begin != end) {
+                std::tie(begin, end, line) = reader.nextChunk();
+            }
+
+            ASSERT_EQ(3001u, line);
+            ASSERT_LT(reader.peakBufferSize(), 256u);
+        }
+    }
+}
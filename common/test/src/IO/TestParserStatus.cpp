@@ -20,6 +20,7 @@
 #include "TestParserStatus.h"
 
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -34,10 +35,15 @@ namespace TrenchBroom {
             return it->second;
         }
 
+        const std::vector<std::string>& TestParserStatus::messages() const {
+            return m_messages;
+        }
+
         void TestParserStatus::doProgress(const double) {}
 
-        void TestParserStatus::doLog(const LogLevel level, const std::string& /* str */) {
+        void TestParserStatus::doLog(const LogLevel level, const std::string& str) {
             m_statusCounts[level]++; // unknown map values are value constructed, which initializes to 0 for size_t
+            m_messages.push_back(str);
         }
     }
 }
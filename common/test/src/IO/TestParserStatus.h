@@ -25,6 +25,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -33,10 +34,12 @@ namespace TrenchBroom {
             static NullLogger _logger;
             using StatusCounts = std::map<LogLevel, size_t>;
             StatusCounts m_statusCounts;
+            std::vector<std::string> m_messages;
         public:
             TestParserStatus();
         public:
             size_t countStatus(LogLevel level) const;
+            const std::vector<std::string>& messages() const;
         private:
             void doProgress(double progress) override;
             void doLog(LogLevel level, const std::string& str) override;
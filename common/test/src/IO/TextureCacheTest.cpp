@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Color.h"
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/TextureReader.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::unique_ptr<Assets::Texture> createTexture(const std::string& name, const unsigned char value) {
+            auto buffers = Assets::TextureBufferList{
+                Assets::TextureBuffer(4u * 2u * 4u, value),
+                Assets::TextureBuffer(2u * 1u * 4u, static_cast<unsigned char>(value + 1u))
+            };
+            return std::make_unique<Assets::Texture>(name, 4u, 2u, Color(0.1f, 0.2f, 0.3f, 1.0f), std::move(buffers), GL_RGBA, Assets::TextureType::Masked);
+        }
+
+        TEST_CASE("TextureCacheTest.writeAndReadCollection", "[TextureCacheTest]") {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            auto texture1 = createTexture("texture1", 1u);
+            texture1->setSurfaceParms({ "nodraw", "trans" });
+            texture1->setCulling(Assets::TextureCulling::CullNone);
+            texture1->setBlendFunc(GL_ONE, GL_ZERO);
+
+            auto texture2 = createTexture("texture2", 2u);
+            texture2->disableBlend();
+
+            cache.writeCollection("key", {
+                TextureCache::Entry{ Path("textures/texture1.png"), 1u, texture1.get() },
+                TextureCache::Entry{ Path("textures/texture2.png"), 2u, texture2.get() }
+            });
+
+            const auto collection = cache.readCollection("key");
+            ASSERT_EQ(2u, collection.textureCount());
+
+            const auto cached1 = collection.readTexture(Path("textures/texture1.png"), 1u);
+            ASSERT_NE(nullptr, cached1);
+            ASSERT_EQ("texture1", cached1->name());
+            ASSERT_EQ(4u, cached1->width());
+            ASSERT_EQ(2u, cached1->height());
+            ASSERT_EQ(texture1->averageColor(), cached1->averageColor());
+            ASSERT_EQ(static_cast<GLenum>(GL_RGBA), cached1->format());
+            ASSERT_EQ(Assets::TextureType::Masked, cached1->type());
+            ASSERT_EQ((std::set<std::string>{ "nodraw", "trans" }), cached1->surfaceParms());
+            ASSERT_EQ(Assets::TextureCulling::CullNone, cached1->culling());
+            ASSERT_EQ(Assets::TextureBlendFunc::Enable::UseFactors, cached1->blendFunc().enable);
+            ASSERT_EQ(static_cast<GLenum>(GL_ONE), cached1->blendFunc().srcFactor);
+            ASSERT_EQ(static_cast<GLenum>(GL_ZERO), cached1->blendFunc().destFactor);
+            ASSERT_EQ(texture1->buffersIfUnprepared(), cached1->buffersIfUnprepared());
+
+            const auto cached2 = collection.readTexture(Path("textures/texture2.png"), 2u);
+            ASSERT_NE(nullptr, cached2);
+            ASSERT_EQ("texture2", cached2->name());
+            ASSERT_EQ(Assets::TextureBlendFunc::Enable::DisableBlend, cached2->blendFunc().enable);
+            ASSERT_EQ(texture2->buffersIfUnprepared(), cached2->buffersIfUnprepared());
+
+            // changed contents and unknown paths are not found
+            ASSERT_EQ(nullptr, collection.readTexture(Path("textures/texture1.png"), 2u));
+            ASSERT_EQ(nullptr, collection.readTexture(Path("textures/texture3.png"), 1u));
+        }
+
+        TEST_CASE("TextureCacheTest.readMissingCollection", "[TextureCacheTest]") {
+            TestEnvironment env("TextureCacheTest");
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+
+            ASSERT_EQ(0u, cache.readCollection("key").textureCount());
+
+            auto texture = createTexture("texture", 1u);
+            cache.writeCollection("key", { TextureCache::Entry{ Path("texture.png"), 1u, texture.get() } });
+
+            ASSERT_EQ(1u, cache.readCollection("key").textureCount());
+            ASSERT_EQ(0u, cache.readCollection("otherKey").textureCount());
+        }
+
+        TEST_CASE("TextureCacheTest.evictLeastRecentlyUsed", "[TextureCacheTest]") {
+            TestEnvironment env("TextureCacheTest");
+
+            auto texture = createTexture("texture", 1u);
+            const auto entries = std::vector<TextureCache::Entry>{ TextureCache::Entry{ Path("texture.png"), 1u, texture.get() } };
+
+            // determine the size of a cache file
+            const auto sizeDir = env.dir() + Path("size");
+            TextureCache(sizeDir).writeCollection("key1", entries);
+            const auto sizeDirContents = Disk::getDirectoryContents(sizeDir);
+            ASSERT_EQ(1u, sizeDirContents.size());
+            const auto fileSize = Disk::openFile(sizeDir + sizeDirContents.front())->size();
+
+            // room for two cache files
+            const auto cache = TextureCache(env.dir() + Path("cache"), 2u * fileSize + fileSize / 2u);
+            cache.writeCollection("key1", entries);
+            cache.writeCollection("key2", entries);
+            ASSERT_EQ(1u, cache.readCollection("key1").textureCount());
+            ASSERT_EQ(1u, cache.readCollection("key2").textureCount());
+
+            cache.writeCollection("key3", entries);
+            ASSERT_EQ(2u, Disk::getDirectoryContents(cache.directory()).size());
+            ASSERT_EQ(1u, cache.readCollection("key3").textureCount());
+        }
+
+        /**
+         * Creates a texture from the first byte of a file and counts the number of textures it reads.
+         */
+        class CountingTextureReader : public TextureReader {
+        public:
+            mutable size_t readCount = 0u;
+
+            CountingTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger) :
+            TextureReader(nameStrategy, fs, logger) {}
+        private:
+            Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override {
+                ++readCount;
+                const auto value = static_cast<unsigned char>(file->reader().readChar<char>());
+                return new Assets::Texture(textureName(file->path()), 2u, 2u, Color(), Assets::TextureBuffer(2u * 2u * 4u, value), GL_RGBA, Assets::TextureType::Opaque);
+            }
+        };
+
+        TEST_CASE("TextureCacheTest.loadTextureCollection", "[TextureCacheTest]") {
+            TestEnvironment env("TextureCacheTest");
+            env.createDirectory(Path("textures"));
+            env.createFile(Path("textures/a.tex"), "a");
+            env.createFile(Path("textures/b.tex"), "b");
+
+            NullLogger logger;
+            DiskFileSystem fs(env.dir());
+            const auto cache = TextureCache(env.dir() + Path("cache"));
+            CountingTextureReader reader(TextureReader::TextureNameStrategy(), fs, logger);
+            DirectoryTextureCollectionLoader loader(logger, fs, {});
+
+            const auto load = [&]() {
+                auto collection = loader.loadTextureCollection(Path("textures"), { "tex" }, reader, &cache, "key");
+                ASSERT_EQ(2u, collection->textureCount());
+                return collection;
+            };
+
+            // the first load decodes all textures and fills the cache
+            auto collection = load();
+            ASSERT_EQ(2u, reader.readCount);
+
+            // the second load reads all textures from the cache, including the generated mips
+            collection = load();
+            ASSERT_EQ(2u, reader.readCount);
+            const auto* texture = collection->textureByName("a.tex");
+            ASSERT_NE(nullptr, texture);
+            ASSERT_EQ(2u, texture->buffersIfUnprepared().size());
+            ASSERT_EQ(static_cast<unsigned char>('a'), texture->buffersIfUnprepared().front().front());
+
+            // only changed textures are decoded again
+            env.createFile(Path("textures/b.tex"), "c");
+            collection = load();
+            ASSERT_EQ(3u, reader.readCount);
+            ASSERT_EQ(static_cast<unsigned char>('c'), collection->textureByName("b.tex")->buffersIfUnprepared().front().front());
+
+            collection = load();
+            ASSERT_EQ(3u, reader.readCount);
+        }
+    }
+}
@@ -242,5 +242,26 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST_CASE("TokenizerTest.tokenValues", "[TokenizerTest]") {
+            using Token = TokenTemplate<SimpleToken::Type>;
+
+            // the token values must not depend on what follows the token in the buffer
+            const char data[] = { '1', '2', '3', '.', '5' };
+            ASSERT_EQ("12", Token(SimpleToken::Integer, data, data + 2, 0, 1, 1).view());
+            ASSERT_EQ(12, Token(SimpleToken::Integer, data, data + 2, 0, 1, 1).toInteger<int>());
+            ASSERT_DOUBLE_EQ(123.0, Token(SimpleToken::Decimal, data, data + 3, 0, 1, 1).toFloat<double>());
+            ASSERT_DOUBLE_EQ(123.5, Token(SimpleToken::Decimal, data, data + 5, 0, 1, 1).toFloat<double>());
+
+            const std::string invalid("abc");
+            ASSERT_EQ(0, Token(SimpleToken::String, invalid.data(), invalid.data() + invalid.size(), 0, 1, 1).toInteger<int>());
+            ASSERT_DOUBLE_EQ(0.0, Token(SimpleToken::String, invalid.data(), invalid.data() + invalid.size(), 0, 1, 1).toFloat<double>());
+
+            const std::string empty;
+            ASSERT_EQ(0, Token(SimpleToken::String, empty.data(), empty.data(), 0, 1, 1).toInteger<int>());
+
+            const auto large = "1" + std::string(70u, '0');
+            ASSERT_DOUBLE_EQ(1e70, Token(SimpleToken::Decimal, large.data(), large.data() + large.size(), 0, 1, 1).toFloat<double>());
+        }
     }
 }
@@ -35,6 +35,7 @@
 
 #include <vecmath/vec.h>
 
+#include <sstream>
 #include <string>
 
 namespace TrenchBroom {
@@ -1374,5 +1375,53 @@ common/caulk
                 CHECK(face.attributes().textureName() == Model::BrushFaceAttributes::NoTextureName);
             }
         }
+
+        TEST_CASE("WorldReaderTest.parseFromStream", "[WorldReaderTest]") {
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) {FENCE 0 0 0 1 1
+}
+"message" "}"
+}
+{
+"classname" "info_player_deathmatch"
+"origin" "1 22 -3"
+}
+)");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            // read a single byte at a time to split the map at every possible position
+            std::istringstream stream(data);
+            IO::TestParserStatus status;
+            WorldReader reader(stream, 1u);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+
+            ASSERT_TRUE(world != nullptr);
+            ASSERT_STREQ("}", world->attribute("message").c_str());
+            ASSERT_EQ(2u, world->lineNumber());
+
+            ASSERT_EQ(1u, world->childCount());
+            auto* defaultLayer = world->children().front();
+            ASSERT_EQ(2u, defaultLayer->childCount());
+
+            auto* brush = dynamic_cast<Model::BrushNode*>(defaultLayer->children()[0]);
+            ASSERT_NE(nullptr, brush);
+            ASSERT_EQ(4u, brush->lineNumber());
+            ASSERT_EQ(6u, brush->brush().faceCount());
+
+            auto* entity = dynamic_cast<Model::EntityNode*>(defaultLayer->children()[1]);
+            ASSERT_NE(nullptr, entity);
+            ASSERT_EQ(14u, entity->lineNumber());
+            ASSERT_STREQ("1 22 -3", entity->attribute("origin").c_str());
+        }
     }
 }
@@ -35,14 +35,18 @@
 #include "Model/BrushSnapshot.h"
 #include "Model/Hit.h"
 #include "Model/HitAdapter.h"
+#include "Model/LayerNode.h"
 #include "Model/MapFormat.h"
 #include "Model/PickResult.h"
 #include "Model/Polyhedron.h"
+#include "Model/VisibilityState.h"
 #include "Model/WorldNode.h"
 
 #include <kdl/collection_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
@@ -440,6 +444,74 @@ namespace TrenchBroom {
             delete clone;
         }
 
+        TEST_CASE("BrushNodeTest.releaseGeometry", "[BrushNodeTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+            WorldNode world(MapFormat::Standard);
+
+            const BrushBuilder builder(&world, worldBounds);
+            BrushNode* brushNode = world.createBrush(builder.createCube(64.0, "texture"));
+            world.defaultLayer()->addChild(brushNode);
+
+            const auto bounds = brushNode->logicalBounds();
+            const auto vertexPositions = brushNode->brush().vertexPositions();
+
+            brushNode->releaseGeometry(worldBounds);
+            REQUIRE(brushNode->hasReleasedGeometry());
+
+            // the bounds are retained, so the brush stays in the spacial index
+            CHECK(brushNode->logicalBounds() == bounds);
+            CHECK(brushNode->physicalBounds() == bounds);
+            CHECK_THAT(world.findIntersecting(bounds), Catch::UnorderedEquals(std::vector<Node*>{brushNode}));
+
+            SECTION("Accessing the brush restores the geometry") {
+                CHECK(brushNode->brush().vertexPositions() == vertexPositions);
+                CHECK_FALSE(brushNode->hasReleasedGeometry());
+            }
+
+            SECTION("Accessing the faces does not restore the geometry") {
+                CHECK(brushNode->faces().size() == 6u);
+                for (const auto& face : brushNode->faces()) {
+                    CHECK(face.attributes().textureName() == "texture");
+                }
+                CHECK(brushNode->hasReleasedGeometry());
+            }
+
+            SECTION("Picking a hidden brush does not restore the geometry") {
+                world.defaultLayer()->setVisibilityState(VisibilityState::Visibility_Hidden);
+
+                PickResult pickResult;
+                brushNode->pick(vm::ray3(vm::vec3(0.0, 0.0, 128.0), vm::vec3::neg_z()), pickResult);
+                CHECK(pickResult.empty());
+                CHECK(brushNode->hasReleasedGeometry());
+            }
+
+            SECTION("Picking a visible brush restores the geometry") {
+                PickResult pickResult;
+                brushNode->pick(vm::ray3(vm::vec3(0.0, 0.0, 128.0), vm::vec3::neg_z()), pickResult);
+                CHECK(pickResult.size() == 1u);
+                CHECK_FALSE(brushNode->hasReleasedGeometry());
+            }
+
+            SECTION("Picking outside of the bounds does not restore the geometry") {
+                PickResult pickResult;
+                brushNode->pick(vm::ray3(vm::vec3(128.0, 128.0, 128.0), vm::vec3::neg_z()), pickResult);
+                CHECK(pickResult.empty());
+                CHECK(brushNode->hasReleasedGeometry());
+            }
+
+            SECTION("Transforming restores the geometry") {
+                brushNode->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false, worldBounds);
+                CHECK_FALSE(brushNode->hasReleasedGeometry());
+                CHECK(brushNode->logicalBounds() == bounds.translate(vm::vec3(16.0, 0.0, 0.0)));
+            }
+
+            SECTION("Setting the brush discards the released geometry") {
+                brushNode->setBrush(builder.createCube(32.0, "texture"));
+                CHECK_FALSE(brushNode->hasReleasedGeometry());
+                CHECK(brushNode->logicalBounds() == vm::bbox3(16.0));
+            }
+        }
+
         TEST_CASE("BrushNodeTest.testAlmostDegenerateBrush", "[BrushNodeTest]") {
             // https://github.com/kduske/TrenchBroom/issues/1194
             const std::string data("{\n"
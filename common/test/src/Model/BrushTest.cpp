@@ -359,6 +359,36 @@ namespace TrenchBroom {
             CHECK(brush.fullySpecified());
         }
 
+        TEST_CASE("BrushTest.releaseAndRestoreGeometry", "[BrushTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+            WorldNode world(MapFormat::Standard);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush brush = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom");
+            brush.moveVertices(worldBounds, std::vector<vm::vec3>{vm::vec3(32.0, 32.0, 32.0)}, vm::vec3(-16.0, -16.0, 0.0));
+
+            const auto faces = brush.faces();
+            const auto faceVertexPositions = kdl::vec_transform(brush.faces(), [](const auto& face) { return face.vertexPositions(); });
+            const auto vertexPositions = brush.vertexPositions();
+            const auto bounds = brush.bounds();
+
+            brush.releaseGeometry();
+            REQUIRE_FALSE(brush.hasGeometry());
+            CHECK(brush.faces() == faces);
+            for (const auto& face : brush.faces()) {
+                CHECK(face.geometry() == nullptr);
+            }
+
+            brush.restoreGeometry(worldBounds);
+            REQUIRE(brush.hasGeometry());
+            CHECK(brush.bounds() == bounds);
+            CHECK(brush.vertexPositions() == vertexPositions);
+
+            // the faces must not have been reordered
+            CHECK(brush.faces() == faces);
+            CHECK(kdl::vec_transform(brush.faces(), [](const auto& face) { return face.vertexPositions(); }) == faceVertexPositions);
+        }
+
         TEST_CASE("BrushTest.clip", "[BrushTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
@@ -3144,6 +3174,40 @@ namespace TrenchBroom {
             ASSERT_EQ(0u, result.size());
         }
 
+        TEST_CASE("BrushTest.subtractAndMergeFragments", "[BrushTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+            WorldNode world(MapFormat::Standard);
+
+            // punch a square hole through a cube, the remaining ring consists of at least four convex pieces
+            const vm::bbox3 minuendBounds(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0));
+            const vm::bbox3 holeBounds(vm::vec3(16.0, 16.0, -8.0), vm::vec3(48.0, 48.0, 72.0));
+            const vm::bbox3 farAwayBounds(vm::vec3(256.0, 256.0, 256.0), vm::vec3(288.0, 288.0, 288.0));
+
+            BrushBuilder builder(&world, worldBounds);
+            const Brush minuend = builder.createCuboid(minuendBounds, "texture");
+            const Brush hole = builder.createCuboid(holeBounds, "texture");
+            const Brush farAway = builder.createCuboid(farAwayBounds, "texture");
+
+            const auto volume = [](const vm::bbox3& bounds) {
+                const auto size = bounds.size();
+                return size.x() * size.y() * size.z();
+            };
+
+            const auto fragments = minuend.subtract(world, worldBounds, "texture", std::vector<const Brush*>{&hole, &farAway}, false);
+            const auto merged = minuend.subtract(world, worldBounds, "texture", std::vector<const Brush*>{&hole, &farAway}, true);
+
+            ASSERT_GE(merged.size(), 4u);
+            ASSERT_LE(merged.size(), fragments.size());
+
+            // all fragments are cuboids, so their bounds must fill the ring exactly without covering the hole
+            FloatType mergedVolume = 0.0;
+            for (const auto& brush : merged) {
+                mergedVolume += volume(brush.bounds());
+                ASSERT_FALSE(brush.bounds().intersects(vm::bbox3(vm::vec3(17.0, 17.0, 1.0), vm::vec3(47.0, 47.0, 63.0))));
+            }
+            ASSERT_DOUBLE_EQ(volume(minuendBounds) - 32.0 * 32.0 * 64.0, mergedVolume);
+        }
+
         TEST_CASE("BrushTest.subtractTruncatedCones", "[BrushTest]") {
             // https://github.com/kduske/TrenchBroom/issues/1469
 
@@ -509,5 +509,118 @@ namespace TrenchBroom {
 
             CHECK(std::vector<Node*>{brush2} == visitor.nodes());
         }
+
+        TEST_CASE("WorldNode.findIntersectingAndContainedIn", "[NodeVisitorTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+
+            WorldNode map(Model::MapFormat::Standard);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            BrushBuilder builder(&map, worldBounds);
+            BrushNode* brush1 = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* brush2 = map.createBrush(builder.createCube(64.0, "none"));
+            brush2->transform(vm::translation_matrix(vm::vec3(100.0, 0.0, 0.0)), false, worldBounds);
+
+            map.defaultLayer()->addChild(brush1);
+            map.defaultLayer()->addChild(brush2);
+
+            const auto bounds = vm::bbox3(vm::vec3(-40.0, -40.0, -40.0), vm::vec3(80.0, 40.0, 40.0));
+            CHECK_THAT(map.findIntersecting(bounds), Catch::UnorderedEquals(std::vector<Node*>{brush1, brush2}));
+            CHECK(map.findContainedIn(bounds) == std::vector<Node*>{brush1});
+            CHECK(map.findIntersecting(vm::bbox3(vm::vec3(200.0, 200.0, 200.0), vm::vec3(300.0, 300.0, 300.0))).empty());
+        }
+
+        TEST_CASE("WorldNode.findSelectableNodesTouching", "[NodeVisitorTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            EditorContext context;
+
+            WorldNode map(Model::MapFormat::Standard);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            BrushBuilder builder(&map, worldBounds);
+            BrushNode* brush1 = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* brush2 = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* brush3 = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* brush4 = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* brush5 = map.createBrush(builder.createCube(64.0, "none"));
+
+            brush2->transform(vm::translation_matrix(vm::vec3(10.0, 0.0, 0.0)), false, worldBounds);
+            brush3->transform(vm::translation_matrix(vm::vec3(100.0, 0.0, 0.0)), false, worldBounds);
+            brush4->transform(vm::translation_matrix(vm::vec3(-10.0, 0.0, 0.0)), false, worldBounds);
+            brush5->transform(vm::translation_matrix(vm::vec3(0.0, 10.0, 0.0)), false, worldBounds);
+
+            GroupNode* group = new GroupNode("group");
+            group->addChild(brush4);
+
+            map.defaultLayer()->addChild(brush1);
+            map.defaultLayer()->addChild(brush2);
+            map.defaultLayer()->addChild(brush3);
+            map.defaultLayer()->addChild(group);
+            map.defaultLayer()->addChild(brush5);
+
+            // the closed group is returned instead of its member, and query nodes are never returned
+            const auto touching = map.findSelectableNodesTouching(std::vector<BrushNode*>{brush1, brush5}, context);
+            CHECK_THAT(touching, Catch::UnorderedEquals(std::vector<Node*>{brush2, group}));
+        }
+
+        TEST_CASE("WorldNode.findSelectableNodesContainedIn", "[NodeVisitorTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            EditorContext context;
+
+            WorldNode map(Model::MapFormat::Standard);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            BrushBuilder builder(&map, worldBounds);
+            BrushNode* container = map.createBrush(builder.createCube(128.0, "none"));
+            BrushNode* inside = map.createBrush(builder.createCube(32.0, "none"));
+            BrushNode* overlapping = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* grouped = map.createBrush(builder.createCube(16.0, "none"));
+
+            overlapping->transform(vm::translation_matrix(vm::vec3(64.0, 0.0, 0.0)), false, worldBounds);
+
+            GroupNode* group = new GroupNode("group");
+            group->addChild(grouped);
+
+            map.defaultLayer()->addChild(container);
+            map.defaultLayer()->addChild(inside);
+            map.defaultLayer()->addChild(overlapping);
+            map.defaultLayer()->addChild(group);
+
+            const auto contained = map.findSelectableNodesContainedIn(std::vector<BrushNode*>{container}, context);
+            CHECK_THAT(contained, Catch::UnorderedEquals(std::vector<Node*>{inside, group}));
+        }
+
+        TEST_CASE("WorldNode.findSelectableNodesContainedInOmitsDescendantsOfMatches", "[NodeVisitorTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            EditorContext context;
+
+            WorldNode map(Model::MapFormat::Standard);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            BrushBuilder builder(&map, worldBounds);
+            BrushNode* smallContainer = map.createBrush(builder.createCube(64.0, "none"));
+            BrushNode* largeContainer = map.createBrush(builder.createCube(1024.0, "none"));
+            BrushNode* innerBrush = map.createBrush(builder.createCube(16.0, "none"));
+            BrushNode* outerBrush = map.createBrush(builder.createCube(16.0, "none"));
+
+            outerBrush->transform(vm::translation_matrix(vm::vec3(200.0, 0.0, 0.0)), false, worldBounds);
+
+            GroupNode* innerGroup = new GroupNode("inner");
+            innerGroup->addChild(innerBrush);
+
+            GroupNode* outerGroup = new GroupNode("outer");
+            outerGroup->addChild(innerGroup);
+            outerGroup->addChild(outerBrush);
+
+            map.defaultLayer()->addChild(smallContainer);
+            map.defaultLayer()->addChild(largeContainer);
+            map.defaultLayer()->addChild(outerGroup);
+
+            // the inner brush and the outer group are both selectable, but the outer group is found by another brush
+            innerGroup->open();
+
+            const auto contained = map.findSelectableNodesContainedIn(std::vector<BrushNode*>{smallContainer, largeContainer}, context);
+            CHECK_THAT(contained, Catch::UnorderedEquals(std::vector<Node*>{smallContainer, outerGroup}));
+        }
     }
 }
@@ -277,6 +277,20 @@ namespace TrenchBroom {
             CHECK(p.vertexCount() == 9u);
         }
 
+        TEST_CASE("PolyhedronTest.convexHullContainsAllPoints", "[PolyhedronTest]") {
+            // Adding the points in a different order than lexicographically sorted left some of these points outside
+            // of the hull.
+
+            std::vector<vm::vec3d> vertices;
+            vm::parse_all<double, 3>("(132 10 -128) (29 -239 -31) (-89 -42 57) (-39 28 -199) (-97 -40 -229) (65 -14 32) (-194 22 -126) (57 137 206) (-239 12 -47) (-141 -121 166) (81 201 14) (39 11 92) (-54 58 -5) (165 2 -174) (-119 79 -199) (239 18 38) (231 -17 100) (-58 141 -150) (166 38 -25) (-123 -171 -43) (49 -31 164) (51 -26 121) (147 -41 159) (75 216 -7) (-223 27 -37) (-162 -32 113) (-206 43 -79) (-152 -147 -78) (95 52 150) (-93 110 189) (-211 -12 -112) (235 34 68) (63 -85 189) (2 145 -36) (91 -72 -224) (-21 130 75) (13 212 -9) (-70 -53 115) (-88 72 -58) (39 -138 -154) (21 -119 -206) (-121 -54 -93) (55 -73 -158) (210 40 -139) (-86 36 -190) (-59 -161 -69) (-33 26 -244) (99 211 -101) (96 58 182) (-6 103 -232) (-178 60 -85) (168 31 -163) (-16 -206 -121) (-104 38 -222) (87 -102 201) (-12 -24 -126) (60 -184 152) (17 177 -3) (-169 85 -172) (-4 -57 -224) (185 -75 36) (-3 50 -164) (-53 -105 142) (-206 -18 127)", std::back_inserter(vertices));
+
+            const Polyhedron3d p(vertices);
+            ASSERT_TRUE(p.polyhedron());
+            for (const auto& vertex : vertices) {
+                ASSERT_TRUE(p.contains(vertex, vm::constants<double>::almost_zero()));
+            }
+        }
+
 /*
 TEST_CASE("PolyhedronTest.testImpossibleSplit", "[PolyhedronTest]") {
     const vm::vec3d p1( 0.0, 4.0, 8.0);
@@ -1559,6 +1573,17 @@ TEST_CASE("PolyhedronTest.testWeaveSimpleCap", "[PolyhedronTest]") {
             ASSERT_EQ(3u, result.size());
         }
 
+        TEST_CASE("PolyhedronTest.volume", "[PolyhedronTest]") {
+            const Polyhedron3d polygon { vm::vec3d(1.0, 0.0, 0.0), vm::vec3d(2.0, 0.0, 0.0), vm::vec3d(0.0, 1.0, 0.0) };
+            ASSERT_DOUBLE_EQ(0.0, polygon.volume());
+
+            const Polyhedron3d tetrahedron { vm::vec3d(0.0, 0.0, 0.0), vm::vec3d(3.0, 0.0, 0.0), vm::vec3d(0.0, 3.0, 0.0), vm::vec3d(0.0, 0.0, 3.0) };
+            ASSERT_DOUBLE_EQ(4.5, tetrahedron.volume());
+
+            const Polyhedron3d cuboid(vm::bbox3d(vm::vec3d(1000.0, 1000.0, 1000.0), vm::vec3d(1002.0, 1003.0, 1004.0)));
+            ASSERT_DOUBLE_EQ(24.0, cuboid.volume());
+        }
+
         TEST_CASE("PolyhedronTest.intersection_empty_polyhedron", "[PolyhedronTest]") {
             const Polyhedron3d empty;
             const Polyhedron3d point      { vm::vec3d(1.0, 0.0, 0.0) };
@@ -470,6 +470,7 @@ namespace TrenchBroom {
             "Menu/Edit/Tools/Face Tool",
             "Menu/Edit/CSG/Convex Merge",
             "Menu/Edit/CSG/Subtract",
+            "Menu/Edit/CSG/Subtract and Merge Fragments",
             "Menu/Edit/CSG/Hollow",
             "Menu/Edit/CSG/Intersect",
             "Menu/Edit/Snap Vertices to Integer",
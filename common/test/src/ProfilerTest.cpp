@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Profiler.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace TrenchBroom {
+    TEST_CASE("ProfilerTest.disabledProfilerRecordsNothing", "[ProfilerTest]") {
+        auto& profiler = Profiler::instance();
+        profiler.setEnabled(false);
+        profiler.clear();
+
+        {
+            const ProfilerZone zone("zone");
+        }
+
+        ASSERT_EQ(0u, profiler.eventCount());
+    }
+
+    TEST_CASE("ProfilerTest.recordZones", "[ProfilerTest]") {
+        auto& profiler = Profiler::instance();
+        profiler.clear();
+        profiler.setEnabled(true);
+
+        {
+            const ProfilerZone outer("outer");
+            const ProfilerZone inner("inner", "some \"detail\"");
+        }
+
+        std::thread thread([]() {
+            const ProfilerZone zone("thread");
+        });
+        thread.join();
+
+        profiler.setEnabled(false);
+        ASSERT_EQ(3u, profiler.eventCount());
+
+        std::stringstream str;
+        profiler.writeTrace(str);
+        const auto trace = str.str();
+
+        ASSERT_NE(std::string::npos, trace.find("\"traceEvents\":["));
+        ASSERT_NE(std::string::npos, trace.find("\"name\":\"outer\""));
+        ASSERT_NE(std::string::npos, trace.find("\"name\":\"inner\""));
+        ASSERT_NE(std::string::npos, trace.find("\"args\":{\"detail\":\"some \\\"detail\\\"\"}"));
+        ASSERT_NE(std::string::npos, trace.find("\"name\":\"thread\""));
+        ASSERT_NE(std::string::npos, trace.find("\"tid\":0"));
+        ASSERT_NE(std::string::npos, trace.find("\"tid\":1"));
+
+        profiler.clear();
+        ASSERT_EQ(0u, profiler.eventCount());
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/DirtyRangeTracker.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using Range = DirtyRangeTracker::Range;
+
+        TEST_CASE("DirtyRangeTrackerTest.constructor", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100u, 4u);
+            EXPECT_EQ(100u, t.capacity());
+            EXPECT_EQ(4u, t.mergeGap());
+            EXPECT_TRUE(t.clean());
+            EXPECT_EQ(0u, t.dirtySize());
+            EXPECT_EQ(std::vector<Range>{}, t.ranges());
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirty", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100u);
+
+            t.markDirty(10u, 5u);
+            EXPECT_FALSE(t.clean());
+            EXPECT_EQ((std::vector<Range>{{10u, 5u}}), t.ranges());
+
+            // disjoint ranges are kept separate and sorted
+            t.markDirty(90u, 10u);
+            t.markDirty(0u, 2u);
+            EXPECT_EQ((std::vector<Range>{{0u, 2u}, {10u, 5u}, {90u, 10u}}), t.ranges());
+            EXPECT_EQ(17u, t.dirtySize());
+
+            // empty ranges are ignored
+            t.markDirty(50u, 0u);
+            EXPECT_EQ((std::vector<Range>{{0u, 2u}, {10u, 5u}, {90u, 10u}}), t.ranges());
+
+            // adjacent and overlapping ranges are merged
+            t.markDirty(15u, 5u);
+            EXPECT_EQ((std::vector<Range>{{0u, 2u}, {10u, 10u}, {90u, 10u}}), t.ranges());
+            t.markDirty(8u, 4u);
+            EXPECT_EQ((std::vector<Range>{{0u, 2u}, {8u, 12u}, {90u, 10u}}), t.ranges());
+
+            // a range can bridge several ranges
+            t.markDirty(1u, 95u);
+            EXPECT_EQ((std::vector<Range>{{0u, 100u}}), t.ranges());
+            EXPECT_EQ(100u, t.dirtySize());
+
+            EXPECT_THROW(t.markDirty(95u, 6u), std::invalid_argument);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.markDirtyWithMergeGap", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100u, 4u);
+
+            t.markDirty(10u, 5u);
+            t.markDirty(30u, 5u);
+            EXPECT_EQ((std::vector<Range>{{10u, 5u}, {30u, 5u}}), t.ranges());
+
+            // a gap of 4 elements is merged
+            t.markDirty(19u, 2u);
+            EXPECT_EQ((std::vector<Range>{{10u, 11u}, {30u, 5u}}), t.ranges());
+
+            // a gap of 5 elements is not merged
+            t.markDirty(40u, 1u);
+            EXPECT_EQ((std::vector<Range>{{10u, 11u}, {30u, 5u}, {40u, 1u}}), t.ranges());
+
+            // merging with the gap on both sides
+            t.markDirty(25u, 1u);
+            EXPECT_EQ((std::vector<Range>{{10u, 25u}, {40u, 1u}}), t.ranges());
+            EXPECT_EQ(26u, t.dirtySize());
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.expand", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100u);
+            t.markDirty(10u, 5u);
+
+            t.expand(150u);
+            EXPECT_EQ(150u, t.capacity());
+            EXPECT_EQ((std::vector<Range>{{10u, 5u}, {100u, 50u}}), t.ranges());
+
+            EXPECT_THROW(t.expand(150u), std::invalid_argument);
+        }
+
+        TEST_CASE("DirtyRangeTrackerTest.clear", "[DirtyRangeTrackerTest]") {
+            DirtyRangeTracker t(100u);
+            t.markDirty(10u, 5u);
+            t.markDirty(50u, 5u);
+
+            t.clear();
+            EXPECT_TRUE(t.clean());
+            EXPECT_EQ(0u, t.dirtySize());
+            EXPECT_EQ(100u, t.capacity());
+        }
+    }
+}
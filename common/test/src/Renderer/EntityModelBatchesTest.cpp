@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/EntityModelBatches.h"
+#include "Renderer/TexturedIndexRangeRenderer.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TEST_CASE("EntityModelBatchesTest.groupByRenderer", "[EntityModelBatchesTest]") {
+            TexturedIndexRangeRenderer renderer1, renderer2;
+
+            const auto bounds = vm::bbox3f(16.0f);
+            const auto t1 = vm::translation_matrix(vm::vec3f(1.0f, 0.0f, 0.0f));
+            const auto t2 = vm::translation_matrix(vm::vec3f(2.0f, 0.0f, 0.0f));
+            const auto t3 = vm::translation_matrix(vm::vec3f(3.0f, 0.0f, 0.0f));
+
+            EntityModelBatches batches;
+            batches.reset(vm::vec3f::zero());
+            batches.add(&renderer1, nullptr, bounds, t1);
+            batches.add(&renderer2, nullptr, bounds, t2);
+            batches.add(&renderer1, nullptr, bounds, t3);
+
+            ASSERT_EQ(3u, batches.instanceCount());
+            ASSERT_EQ(0u, batches.lodInstanceCount());
+            ASSERT_EQ(2u, batches.batches().size());
+
+            const auto& batch1 = batches.batches()[0];
+            ASSERT_EQ(&renderer1, batch1.renderer);
+            ASSERT_EQ(std::vector<vm::mat4x4f>({ t1, t3 }), batch1.transformations);
+
+            const auto& batch2 = batches.batches()[1];
+            ASSERT_EQ(&renderer2, batch2.renderer);
+            ASSERT_EQ(std::vector<vm::mat4x4f>({ t2 }), batch2.transformations);
+
+            batches.reset(vm::vec3f::zero());
+            ASSERT_EQ(0u, batches.instanceCount());
+            ASSERT_TRUE(batches.batches().empty());
+        }
+
+        TEST_CASE("EntityModelBatchesTest.useLodForDistantModels", "[EntityModelBatchesTest]") {
+            TexturedIndexRangeRenderer renderer, lodRenderer;
+
+            const auto nearBounds = vm::bbox3f(vm::vec3f(64.0f, -16.0f, -16.0f), vm::vec3f(96.0f, 16.0f, 16.0f));
+            const auto farBounds = vm::bbox3f(vm::vec3f(8192.0f, -16.0f, -16.0f), vm::vec3f(8224.0f, 16.0f, 16.0f));
+            ASSERT_FALSE(EntityModelBatches::useLod(nearBounds, vm::vec3f::zero()));
+            ASSERT_TRUE(EntityModelBatches::useLod(farBounds, vm::vec3f::zero()));
+
+            EntityModelBatches batches;
+            batches.reset(vm::vec3f::zero());
+            batches.add(&renderer, &lodRenderer, nearBounds, vm::mat4x4f::identity());
+            batches.add(&renderer, &lodRenderer, farBounds, vm::mat4x4f::identity());
+            batches.add(&renderer, nullptr, farBounds, vm::mat4x4f::identity());
+
+            ASSERT_EQ(3u, batches.instanceCount());
+            ASSERT_EQ(1u, batches.lodInstanceCount());
+            ASSERT_EQ(2u, batches.batches().size());
+            ASSERT_EQ(&renderer, batches.batches()[0].renderer);
+            ASSERT_EQ(2u, batches.batches()[0].transformations.size());
+            ASSERT_EQ(&lodRenderer, batches.batches()[1].renderer);
+            ASSERT_EQ(1u, batches.batches()[1].transformations.size());
+        }
+    }
+}
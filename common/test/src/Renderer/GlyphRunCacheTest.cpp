@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/GlyphRunCache.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static GlyphRun makeRun(const std::string& str) {
+            return GlyphRun{ std::vector<vm::vec2f>(str.size() * 8u), vm::vec2f(static_cast<float>(str.size()), 1.0f) };
+        }
+
+        TEST_CASE("GlyphRunCacheTest.getOrCreate", "[GlyphRunCacheTest]") {
+            auto cache = GlyphRunCache<std::string>(4u);
+            size_t layoutCount = 0u;
+            const auto layout = [&](const std::string& str) {
+                return [&layoutCount, str]() {
+                    ++layoutCount;
+                    return makeRun(str);
+                };
+            };
+
+            const auto first = cache.getOrCreate("abc", layout("abc"));
+            ASSERT_EQ(1u, layoutCount);
+            ASSERT_EQ(vm::vec2f(3.0f, 1.0f), first->size);
+            ASSERT_EQ(24u, first->vertices.size());
+
+            const auto second = cache.getOrCreate("abc", layout("abc"));
+            ASSERT_EQ(1u, layoutCount);
+            ASSERT_EQ(first, second);
+
+            cache.getOrCreate("de", layout("de"));
+            ASSERT_EQ(2u, layoutCount);
+            ASSERT_EQ(2u, cache.size());
+            ASSERT_EQ(1u, cache.hits());
+            ASSERT_EQ(2u, cache.misses());
+        }
+
+        TEST_CASE("GlyphRunCacheTest.evictLeastRecentlyUsed", "[GlyphRunCacheTest]") {
+            auto cache = GlyphRunCache<std::string>(2u);
+            const auto layout = [](const std::string& str) {
+                return [str]() { return makeRun(str); };
+            };
+
+            const auto a = cache.getOrCreate("a", layout("a"));
+            cache.getOrCreate("b", layout("b"));
+
+            // "a" becomes the most recently used run, so adding "c" evicts "b"
+            cache.getOrCreate("a", layout("a"));
+            cache.getOrCreate("c", layout("c"));
+            ASSERT_EQ(2u, cache.size());
+
+            const auto misses = cache.misses();
+            ASSERT_EQ(a, cache.getOrCreate("a", layout("a")));
+            ASSERT_EQ(misses, cache.misses());
+
+            cache.getOrCreate("b", layout("b"));
+            ASSERT_EQ(misses + 1u, cache.misses());
+            ASSERT_EQ(2u, cache.size());
+        }
+
+        TEST_CASE("GlyphRunCacheTest.evictedRunsRemainValid", "[GlyphRunCacheTest]") {
+            auto cache = GlyphRunCache<std::string>(1u);
+            const auto a = cache.getOrCreate("abcd", []() { return makeRun("abcd"); });
+            cache.getOrCreate("b", []() { return makeRun("b"); });
+
+            ASSERT_EQ(1u, cache.size());
+            ASSERT_EQ(vm::vec2f(4.0f, 1.0f), a->size);
+        }
+
+        TEST_CASE("GlyphRunCacheTest.clear", "[GlyphRunCacheTest]") {
+            auto cache = GlyphRunCache<std::string>();
+            cache.getOrCreate("a", []() { return makeRun("a"); });
+            cache.clear();
+            ASSERT_EQ(0u, cache.size());
+        }
+
+        TEST_CASE("GlyphRunCacheTest.translatedVertices", "[GlyphRunCacheTest]") {
+            const auto run = GlyphRun{ { vm::vec2f(1.0f, 2.0f), vm::vec2f(0.5f, 0.5f), vm::vec2f(3.0f, 4.0f), vm::vec2f(0.25f, 0.75f) }, vm::vec2f(2.0f, 2.0f) };
+
+            // only the positions are moved, and the offset is rounded
+            ASSERT_EQ((std::vector<vm::vec2f>{ vm::vec2f(11.0f, 22.0f), vm::vec2f(0.5f, 0.5f), vm::vec2f(13.0f, 24.0f), vm::vec2f(0.25f, 0.75f) }), run.translatedVertices(vm::vec2f(9.6f, 20.4f)));
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/SoftwareOcclusionBuffer.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // With the identity transformation, clip space coordinates equal world coordinates, and the near plane is at z = -1.
+        static SoftwareOcclusionBuffer makeBufferWithQuad() {
+            SoftwareOcclusionBuffer buffer(10u, 10u);
+            buffer.reset(vm::mat4x4f::identity());
+            buffer.addOccluder({
+                vm::vec3f(-0.5f, -0.5f, 0.0f),
+                vm::vec3f(+0.5f, -0.5f, 0.0f),
+                vm::vec3f(+0.5f, +0.5f, 0.0f),
+                vm::vec3f(-0.5f, +0.5f, 0.0f)
+            });
+            return buffer;
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.emptyBuffer", "[SoftwareOcclusionBufferTest]") {
+            SoftwareOcclusionBuffer buffer(10u, 10u);
+            buffer.reset(vm::mat4x4f::identity());
+
+            for (size_t y = 0u; y < buffer.height(); ++y) {
+                for (size_t x = 0u; x < buffer.width(); ++x) {
+                    ASSERT_EQ(1.0f, buffer.depth(x, y));
+                }
+            }
+            ASSERT_FALSE(buffer.occluded(vm::bbox3f(vm::vec3f(-0.3f, -0.3f, 0.2f), vm::vec3f(0.3f, 0.3f, 0.5f))));
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.rasterizeQuad", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+
+            // the quad covers pixels 2.5 to 7.5 in both directions, but only the pixels 3 to 6 are covered completely
+            for (size_t y = 0u; y < buffer.height(); ++y) {
+                for (size_t x = 0u; x < buffer.width(); ++x) {
+                    const auto covered = x >= 3u && x <= 6u && y >= 3u && y <= 6u;
+                    ASSERT_EQ((covered ? 0.5f : 1.0f), buffer.depth(x, y));
+                }
+            }
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.rasterizeTriangleInEitherWindingOrder", "[SoftwareOcclusionBufferTest]") {
+            SoftwareOcclusionBuffer ccw(10u, 10u);
+            ccw.reset(vm::mat4x4f::identity());
+            ccw.addOccluder({ vm::vec3f(-1.0f, -1.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f), vm::vec3f(-1.0f, 1.0f, 0.0f) });
+
+            SoftwareOcclusionBuffer cw(10u, 10u);
+            cw.reset(vm::mat4x4f::identity());
+            cw.addOccluder({ vm::vec3f(-1.0f, -1.0f, 0.0f), vm::vec3f(-1.0f, 1.0f, 0.0f), vm::vec3f(1.0f, 1.0f, 0.0f) });
+
+            for (size_t y = 0u; y < 10u; ++y) {
+                for (size_t x = 0u; x < 10u; ++x) {
+                    // pixels on the diagonal are only partially covered
+                    const auto covered = x < y;
+                    ASSERT_EQ((covered ? 0.5f : 1.0f), ccw.depth(x, y));
+                    ASSERT_EQ((covered ? 0.5f : 1.0f), cw.depth(x, y));
+                }
+            }
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.boxBehindOccluder", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+            ASSERT_TRUE(buffer.occluded(vm::bbox3f(vm::vec3f(-0.3f, -0.3f, 0.2f), vm::vec3f(0.3f, 0.3f, 0.5f))));
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.boxInFrontOfOccluder", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+            ASSERT_FALSE(buffer.occluded(vm::bbox3f(vm::vec3f(-0.3f, -0.3f, -0.5f), vm::vec3f(0.3f, 0.3f, -0.2f))));
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.boxPartiallyBehindOccluder", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+            ASSERT_FALSE(buffer.occluded(vm::bbox3f(vm::vec3f(-0.3f, -0.3f, 0.2f), vm::vec3f(0.7f, 0.3f, 0.5f))));
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.boxIntersectingNearPlane", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+            ASSERT_FALSE(buffer.occluded(vm::bbox3f(vm::vec3f(-0.3f, -0.3f, -2.0f), vm::vec3f(0.3f, 0.3f, 0.5f))));
+        }
+
+        TEST_CASE("SoftwareOcclusionBufferTest.boxOutsideOfView", "[SoftwareOcclusionBufferTest]") {
+            const auto buffer = makeBufferWithQuad();
+            ASSERT_TRUE(buffer.occluded(vm::bbox3f(vm::vec3f(2.0f, 2.0f, 0.2f), vm::vec3f(3.0f, 3.0f, 0.5f))));
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/VertexEncoding.h"
+
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <cmath>
+#include <random>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using EncodedNormal = vm::vec<GLbyte,4>;
+
+        TEST_CASE("VertexEncodingTest.encodeAxisNormals", "[VertexEncodingTest]") {
+            // OpenGL 2.1 decodes a component c as (2c + 1) / 255, so 0 is encoded as -1 and decoded as -1/255
+            ASSERT_EQ(EncodedNormal(127, -1, -1, 0), encodeByteNormal(vm::vec3f::pos_x()));
+            ASSERT_EQ(EncodedNormal(-1, -128, -1, 0), encodeByteNormal(vm::vec3f::neg_y()));
+            ASSERT_EQ(EncodedNormal(-1, -1, 127, 0), encodeByteNormal(vm::vec3f::pos_z()));
+
+            ASSERT_EQ(vm::vec3f(1.0f, -1.0f / 255.0f, -1.0f / 255.0f), decodeByteNormal(encodeByteNormal(vm::vec3f::pos_x())));
+            ASSERT_EQ(vm::vec3f(-1.0f / 255.0f, -1.0f, -1.0f / 255.0f), decodeByteNormal(encodeByteNormal(vm::vec3f::neg_y())));
+            ASSERT_EQ(vm::vec3f(-1.0f / 255.0f, -1.0f / 255.0f, 1.0f), decodeByteNormal(encodeByteNormal(vm::vec3f::pos_z())));
+        }
+
+        TEST_CASE("VertexEncodingTest.decodeMatchesOpenGL", "[VertexEncodingTest]") {
+            ASSERT_EQ(vm::vec3f(-1.0f, 1.0f, 1.0f / 255.0f), decodeByteNormal(EncodedNormal(-128, 127, 0, 0)));
+        }
+
+        TEST_CASE("VertexEncodingTest.encodeClampsComponents", "[VertexEncodingTest]") {
+            ASSERT_EQ(EncodedNormal(127, -128, -1, 0), encodeByteNormal(vm::vec3f(2.0f, -2.0f, 0.0f)));
+        }
+
+        TEST_CASE("VertexEncodingTest.encodeRandomNormals", "[VertexEncodingTest]") {
+            std::mt19937 rng(0u);
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+            const auto maxComponentError = 1.0f / 255.0f + 1.0e-6f;
+            const auto maxAngleError = std::cos(vm::to_radians(0.5f));
+
+            for (size_t i = 0u; i < 10000u; ++i) {
+                const auto normal = vm::normalize(vm::vec3f(dist(rng), dist(rng), dist(rng)));
+                const auto decoded = decodeByteNormal(encodeByteNormal(normal));
+
+                for (size_t j = 0u; j < 3u; ++j) {
+                    ASSERT_LE(std::abs(normal[j] - decoded[j]), maxComponentError);
+                }
+                ASSERT_GE(vm::dot(normal, vm::normalize(decoded)), maxAngleError);
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "TaskScheduler.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    TEST_CASE("TaskSchedulerTest.parallelFor", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(3u);
+
+        std::vector<std::atomic<int>> counts(1000u);
+        scheduler.parallelFor(counts.size(), [&](const size_t i) {
+            ++counts[i];
+        });
+
+        for (const auto& count : counts) {
+            ASSERT_EQ(1, count.load());
+        }
+
+        scheduler.parallelFor(0u, [](const size_t) {
+            FAIL();
+        });
+    }
+
+    TEST_CASE("TaskSchedulerTest.parallelForRethrows", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(3u);
+
+        ASSERT_THROW(scheduler.parallelFor(100u, [](const size_t i) {
+            if (i == 50u) {
+                throw std::runtime_error("error");
+            }
+        }), std::runtime_error);
+
+        // the scheduler is still usable afterwards
+        std::atomic<size_t> count(0u);
+        scheduler.parallelFor(100u, [&](const size_t) { ++count; });
+        ASSERT_EQ(100u, count.load());
+    }
+
+    TEST_CASE("TaskSchedulerTest.parallelForRange", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(3u);
+
+        std::vector<std::atomic<int>> counts(1000u);
+        std::atomic<bool> exceedsGrainSize(false);
+        scheduler.parallelForRange(10u, counts.size(), 7u, [&](const size_t begin, const size_t end) {
+            if (end - begin > 7u) {
+                exceedsGrainSize = true;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                ++counts[i];
+            }
+        });
+
+        ASSERT_FALSE(exceedsGrainSize);
+        for (size_t i = 0u; i < counts.size(); ++i) {
+            ASSERT_EQ((i < 10u ? 0 : 1), counts[i].load());
+        }
+    }
+
+    TEST_CASE("TaskSchedulerTest.withoutWorkerThreads", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(0u);
+        ASSERT_EQ(0u, scheduler.threadCount());
+
+        // the waiting thread executes all tasks
+        const auto callerId = std::this_thread::get_id();
+        std::atomic<size_t> count(0u);
+        std::atomic<bool> otherThread(false);
+        scheduler.parallelFor(100u, [&](const size_t) {
+            if (std::this_thread::get_id() != callerId) {
+                otherThread = true;
+            }
+            ++count;
+        });
+
+        ASSERT_EQ(100u, count.load());
+        ASSERT_FALSE(otherThread);
+    }
+
+    TEST_CASE("TaskSchedulerTest.isWorkerThread", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(3u);
+        ASSERT_FALSE(TaskScheduler::isWorkerThread());
+
+        // the waiting thread participates in the work, but it is not a worker thread
+        const auto callerId = std::this_thread::get_id();
+        std::atomic<bool> mismatch(false);
+        scheduler.parallelFor(1000u, [&](const size_t) {
+            if (TaskScheduler::isWorkerThread() != (std::this_thread::get_id() != callerId)) {
+                mismatch = true;
+            }
+        });
+
+        ASSERT_FALSE(mismatch);
+    }
+
+    TEST_CASE("TaskSchedulerTest.nestedTaskGroups", "[TaskSchedulerTest]") {
+        // more outer tasks than workers, each of which waits for a nested group
+        TaskScheduler scheduler(2u);
+
+        std::atomic<size_t> count(0u);
+        TaskGroup outer(scheduler);
+        for (size_t i = 0u; i < 16u; ++i) {
+            outer.run([&]() {
+                TaskGroup inner(scheduler);
+                for (size_t j = 0u; j < 16u; ++j) {
+                    inner.run([&]() { ++count; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+
+        ASSERT_EQ(16u * 16u, count.load());
+    }
+
+    TEST_CASE("TaskSchedulerTest.taskGroupRethrows", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(2u);
+
+        TaskGroup group(scheduler);
+        group.run([]() { throw std::logic_error("error"); });
+        ASSERT_THROW(group.wait(), std::logic_error);
+
+        // the exception is only thrown once
+        std::atomic<bool> ran(false);
+        group.run([&]() { ran = true; });
+        group.wait();
+        ASSERT_TRUE(ran);
+    }
+
+    TEST_CASE("TaskSchedulerTest.mainThreadTasks", "[TaskSchedulerTest]") {
+        TaskScheduler scheduler(2u);
+
+        std::atomic<size_t> wakeupCount(0u);
+        scheduler.setMainThreadWakeup([&]() { ++wakeupCount; });
+
+        const auto mainThreadId = std::this_thread::get_id();
+        std::vector<size_t> results;
+        std::mutex resultsMutex;
+        std::atomic<bool> otherThread(false);
+
+        TaskGroup group(scheduler);
+        for (size_t i = 0u; i < 10u; ++i) {
+            group.run([&, i]() {
+                scheduler.postToMainThread([&, i]() {
+                    if (std::this_thread::get_id() != mainThreadId) {
+                        otherThread = true;
+                    }
+                    const auto lock = std::lock_guard<std::mutex>(resultsMutex);
+                    results.push_back(i);
+                });
+            });
+        }
+        group.wait();
+
+        // the wakeup is only requested once for all tasks posted while the queue was not empty
+        ASSERT_EQ(1u, wakeupCount.load());
+        ASSERT_TRUE(results.empty());
+
+        ASSERT_EQ(10u, scheduler.runMainThreadTasks());
+        ASSERT_EQ(10u, results.size());
+        ASSERT_FALSE(otherThread);
+        ASSERT_EQ(0u, scheduler.runMainThreadTasks());
+
+        scheduler.postToMainThread([]() {});
+        ASSERT_EQ(2u, wakeupCount.load());
+        ASSERT_EQ(1u, scheduler.runMainThreadTasks());
+    }
+}
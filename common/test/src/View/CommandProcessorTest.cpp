@@ -103,12 +103,14 @@ namespace TrenchBroom {
         struct DoPerformUndo { bool returnSuccess; };
         struct DoRepeat      { std::unique_ptr<UndoableCommand> repeatCommandToReturn; };
         struct DoCollateWith { bool returnCanCollate; UndoableCommand* expectedOtherCommand; };
+        struct DoPerformCollatedDo { bool returnSuccess; };
 
-        using TestCommandCall = std::variant<DoPerformDo, DoPerformUndo, DoRepeat, DoCollateWith>;
+        using TestCommandCall = std::variant<DoPerformDo, DoPerformUndo, DoRepeat, DoCollateWith, DoPerformCollatedDo>;
 
         class TestCommand : public UndoableCommand {
         private:
             bool m_isRepeatDelimiter;
+            std::vector<const UndoableCommand*> m_willCollateWith;
 
             mutable std::vector<TestCommandCall> m_expectedCalls;
         public:
@@ -122,6 +124,11 @@ namespace TrenchBroom {
             UndoableCommand(Type, name),
             m_isRepeatDelimiter(isRepeatDelimiter) {}
 
+            std::unique_ptr<CommandResult> performCollatedDo(MapDocumentCommandFacade*) override {
+                const auto expectedCall = popCall<DoPerformCollatedDo>();
+                return std::make_unique<CommandResult>(expectedCall.returnSuccess);
+            }
+
             ~TestCommand() {
                 ASSERT_TRUE(m_expectedCalls.empty());
             }
@@ -163,6 +170,10 @@ namespace TrenchBroom {
                 return false;
             }
 
+            bool doWillCollateWith(const UndoableCommand& otherCommand) const override {
+                return kdl::vec_contains(m_willCollateWith, &otherCommand);
+            }
+
             bool doCollateWith(UndoableCommand* otherCommand) override {
                 const auto expectedCall = popCall<DoCollateWith>();
 
@@ -196,6 +207,21 @@ namespace TrenchBroom {
                 m_expectedCalls.emplace_back(DoCollateWith{returnCanCollate, expectedOtherCommand});
             }
 
+            /**
+             * Makes doWillCollateWith() return true for the given command.
+             */
+            void willCollateWith(UndoableCommand* otherCommand) {
+                m_willCollateWith.push_back(otherCommand);
+            }
+
+            /**
+             * Sets an expectation that performCollatedDo() should be called instead of doPerformDo().
+             * When called, it will return the given `returnSuccess` value.
+             */
+            void expectCollatedDo(const bool returnSuccess) {
+                m_expectedCalls.emplace_back(DoPerformCollatedDo{returnSuccess});
+            }
+
             /**
              * Sets an expectation that doRepeat() should be called.
              * If repeatable is true, this creates a TestCommand that doRepeat() will return.
@@ -776,6 +802,66 @@ namespace TrenchBroom {
             }), observer.popNotifications());
         }
 
+        TEST_CASE("CommandProcessorTest.collateCommandsInTransaction", "[CommandProcessorTest]") {
+            /*
+             * Execute a command in a transaction and collate the next command without letting it record its undo
+             * information, then commit the transaction and undo it.
+             */
+
+            CommandProcessor commandProcessor(nullptr);
+            TestObserver observer(commandProcessor);
+
+            const auto commandName1 = "test command 1";
+            auto command1 = TestCommand::create(commandName1, false);
+
+            const auto commandName2 = "test command 2";
+            auto command2 = TestCommand::create(commandName2, false);
+
+            const auto commandName3 = "test command 3";
+            auto command3 = TestCommand::create(commandName3, false);
+
+            command1->expectDo(true);
+            command1->willCollateWith(command2.get());
+            command2->expectCollatedDo(true);
+            command1->expectCollate(command2.get(), true);
+
+            // a failing step is neither collated nor stored
+            command1->willCollateWith(command3.get());
+            command3->expectCollatedDo(false);
+
+            command1->expectUndo(true);
+
+            const auto transactionName = "transaction";
+            commandProcessor.startTransaction(transactionName);
+            ASSERT_TRUE(commandProcessor.executeAndStore(std::move(command1))->success());
+            ASSERT_TRUE(commandProcessor.executeAndStore(std::move(command2))->success());
+            ASSERT_FALSE(commandProcessor.executeAndStore(std::move(command3))->success());
+            commandProcessor.commitTransaction();
+
+            ASSERT_EQ((std::vector<NotificationTuple>{
+                {CommandNotif::CommandDo, commandName1},
+                {CommandNotif::CommandDone, commandName1},
+                {CommandNotif::CommandDo, commandName2},
+                {CommandNotif::CommandDone, commandName2},
+                {CommandNotif::CommandDo, commandName3},
+                {CommandNotif::CommandDoFailed, commandName3},
+                {CommandNotif::TransactionDone, transactionName}
+            }), observer.popNotifications());
+
+            ASSERT_TRUE(commandProcessor.canUndo());
+            ASSERT_EQ(transactionName, commandProcessor.undoCommandName());
+
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+
+            // NOTE: commandName2 is gone because it was coalesced into commandName1
+            ASSERT_EQ((std::vector<NotificationTuple>{
+                {CommandNotif::CommandUndo, commandName1},
+                {CommandNotif::CommandUndone, commandName1},
+                {CommandNotif::TransactionUndone, transactionName}
+            }), observer.popNotifications());
+        }
+
         TEST_CASE("CommandProcessorTest.collationInterval", "[CommandProcessorTest]") {
             /*
              * Execute two commands, with time passing between their execution exceeding the collation interval.
@@ -493,6 +493,43 @@ namespace TrenchBroom {
             EXPECT_EQ(expectedBBox2, remainder2->logicalBounds());
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.csgSubtractMergesFragmentsOnlyIfRequested") {
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* entity = new Model::EntityNode();
+            document->addNode(entity, document->parentForNodes());
+
+            // the second subtrahend cuts the fragments left by the first one, leaving an L shaped remainder in three pieces
+            Model::BrushNode* minuend = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture"));
+            Model::BrushNode* subtrahend1 = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(-8, -8, -8), vm::vec3(16, 16, 72)), "texture"));
+            Model::BrushNode* subtrahend2 = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(-8, -8, -8), vm::vec3(32, 16, 72)), "texture"));
+
+            document->addNodes(std::vector<Model::Node*>{minuend, subtrahend1, subtrahend2}, entity);
+
+            const auto totalVolume = [&]() {
+                FloatType volume = 0.0;
+                for (const auto* child : entity->children()) {
+                    const auto size = static_cast<const Model::BrushNode*>(child)->logicalBounds().size();
+                    volume += size.x() * size.y() * size.z();
+                }
+                return volume;
+            };
+            const FloatType expectedVolume = 64.0 * 64.0 * 64.0 - 32.0 * 16.0 * 64.0;
+
+            document->select(std::vector<Model::Node*>{subtrahend1, subtrahend2});
+            ASSERT_TRUE(document->csgSubtract());
+            ASSERT_EQ(3u, entity->children().size());
+            ASSERT_EQ(expectedVolume, totalVolume());
+
+            document->undoCommand();
+            ASSERT_EQ(3u, entity->children().size());
+            ASSERT_EQ(2u, document->selectedNodes().brushCount());
+
+            ASSERT_TRUE(document->csgSubtract(true));
+            ASSERT_EQ(2u, entity->children().size());
+            ASSERT_EQ(expectedVolume, totalVolume());
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.csgSubtractAndUndoRestoresSelection") {
             const Model::BrushBuilder builder(document->world(), document->worldBounds());
 
@@ -661,6 +698,43 @@ namespace TrenchBroom {
             ASSERT_TRUE(pickResult.query().all().empty());
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.pickInsideTransaction") {
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* brushNode1 = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture"));
+            auto* brushNode2 = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)).translate(vm::vec3(0, 0, 128)), "texture"));
+
+            {
+                Transaction transaction(document);
+                document->addNode(brushNode1, document->parentForNodes());
+                document->addNode(brushNode2, document->parentForNodes());
+
+                // node tree updates are deferred, but picking must see the added brushes
+                Model::PickResult pickResult;
+                document->pick(vm::ray3(vm::vec3(32, 32, -32), vm::vec3::pos_z()), pickResult);
+                ASSERT_EQ(2u, pickResult.query().type(Model::BrushNode::BrushHitType).all().size());
+
+                document->deselectAll();
+                document->select(brushNode2);
+                document->deleteObjects();
+
+                document->select(brushNode1);
+                document->translateObjects(vm::vec3(0, 0, 64));
+                document->deselectAll();
+            }
+
+            Model::PickResult pickResult;
+            document->pick(vm::ray3(vm::vec3(32, 32, -32), vm::vec3::pos_z()), pickResult);
+
+            const auto hits = pickResult.query().type(Model::BrushNode::BrushHitType).all();
+            ASSERT_EQ(1u, hits.size());
+            ASSERT_DOUBLE_EQ(96.0, hits.front().distance());
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.pickSingleEntity") {
             // delete default brush
             document->selectAllNodes();
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "View/TextureNameIndex.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE("TextureNameIndexTest.findEmptyPattern", "[TextureNameIndexTest]") {
+            auto index = TextureNameIndex({ "base/wall", "base/floor", "sky" });
+            ASSERT_EQ(3u, index.size());
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u, 2u }), index.find(""));
+        }
+
+        TEST_CASE("TextureNameIndexTest.findShortPattern", "[TextureNameIndexTest]") {
+            auto index = TextureNameIndex({ "base/wall", "base/floor", "sky" });
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u }), index.find("l"));
+            ASSERT_EQ((std::vector<size_t>{ 2u }), index.find("ky"));
+            ASSERT_EQ(std::vector<size_t>{}, index.find("xy"));
+        }
+
+        TEST_CASE("TextureNameIndexTest.findLongPattern", "[TextureNameIndexTest]") {
+            auto index = TextureNameIndex({ "base/wall", "base/floor", "sky", "wallwall", "lava" });
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u }), index.find("base/"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 3u }), index.find("wall"));
+            ASSERT_EQ((std::vector<size_t>{ 3u }), index.find("lwa"));
+            ASSERT_EQ(std::vector<size_t>{}, index.find("walls"));
+
+            // contains every trigram of the pattern, but not the pattern itself
+            ASSERT_EQ(std::vector<size_t>{}, index.find("allava"));
+        }
+
+        TEST_CASE("TextureNameIndexTest.findIgnoresCase", "[TextureNameIndexTest]") {
+            auto index = TextureNameIndex({ "Base/Wall", "base/floor" });
+            ASSERT_EQ((std::vector<size_t>{ 0u }), index.find("WALL"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u }), index.find("bAsE"));
+        }
+
+        TEST_CASE("TextureNameIndexTest.findIncrementally", "[TextureNameIndexTest]") {
+            auto index = TextureNameIndex({ "base/wall", "base/floor", "sky", "wallwall" });
+
+            // simulate typing, deleting and retyping a pattern
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u, 3u }), index.find("a"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 3u }), index.find("wa"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 3u }), index.find("wal"));
+            ASSERT_EQ((std::vector<size_t>{ 3u }), index.find("lwal"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 3u }), index.find("wal"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u }), index.find("ba"));
+            ASSERT_EQ((std::vector<size_t>{ 0u, 1u, 2u, 3u }), index.find(""));
+        }
+    }
+}
@@ -271,32 +271,35 @@ namespace kdl {
      * @return the unescaped string
      */
     inline std::string str_unescape(const std::string_view str, const std::string_view chars, char esc = EscapeChar) {
-        if (str.empty()) {
-            return "";
+        if (str.find(esc) == std::string_view::npos) {
+            // nothing to unescape
+            return std::string(str);
         }
 
-        std::stringstream buffer;
+        std::string buffer;
+        buffer.reserve(str.size());
+
         auto escaped = false;
         for (const auto c : str) {
             if (c == esc) {
                 if (escaped) {
-                    buffer << c;
+                    buffer.push_back(c);
                 }
                 escaped = !escaped;
             } else {
                 if (escaped && chars.find_first_of(c) == std::string::npos) {
-                    buffer << '\\';
+                    buffer.push_back('\\');
                 }
-                buffer << c;
+                buffer.push_back(c);
                 escaped = false;
             }
         }
 
         if (escaped) {
-            buffer << '\\';
+            buffer.push_back('\\');
         }
 
-        return buffer.str();
+        return buffer;
     }
 
     /**
@@ -45,6 +45,7 @@ xvfb-run -a ./common-test || exit 1
 
 cd "$BUILD_DIR/common/benchmark"
 xvfb-run -a ./common-benchmark || exit 1
+xvfb-run -a ./common-tokenizer-benchmark || exit 1
 
 cd "$BUILD_DIR"
 
@@ -57,6 +57,7 @@ cd "$BUILD_DIR/common/test"
 
 cd "$BUILD_DIR/common/benchmark"
 ./common-benchmark || exit 1
+./common-tokenizer-benchmark || exit 1
 
 cd "$BUILD_DIR"
 